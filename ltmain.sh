@@ -1 +0,0 @@
-/usr/share/libtool/config/ltmain.sh
\ No newline at end of file
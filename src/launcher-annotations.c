@@ -0,0 +1,568 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "launcher-annotations.h"
+
+/*
+ * An index of file -> line -> cost built from a profile. Profiles can be 
+ * hundreds of megabytes, so they are read a line at a time on a worker thread 
+ * and only the per line totals are kept. While parsing, every file has a flat 
+ * array of costs indexed by line number, which is compacted into a sorted 
+ * array of the lines that have a cost once the whole profile has been read.
+ */
+
+static void launcher_annotations_class_init  (LauncherAnnotationsClass *klass);
+static void launcher_annotations_init        (LauncherAnnotations      *annotations);
+static void launcher_annotations_finalize    (LauncherAnnotations      *annotations);
+
+static void load_thread                      (GTask                    *task,
+                                              LauncherAnnotations      *annotations,
+                                              gpointer                  task_data,
+                                              GCancellable             *cancellable);
+static gboolean parse_callgrind              (LauncherAnnotations      *annotations,
+                                              GDataInputStream         *stream,
+                                              GCancellable             *cancellable,
+                                              GError                  **error);
+static gboolean parse_perf                   (LauncherAnnotations      *annotations,
+                                              GDataInputStream         *stream,
+                                              GCancellable             *cancellable,
+                                              GError                  **error);
+static GArray* get_costs                     (LauncherAnnotations      *annotations,
+                                              const gchar              *file_name);
+static void add_cost                         (LauncherAnnotations      *annotations,
+                                              GArray                   *costs,
+                                              gint64                    line,
+                                              guint64                   cost);
+static GArray* parse_file_name               (LauncherAnnotations      *annotations,
+                                              GHashTable               *names,
+                                              const gchar              *spec);
+static void compact                          (LauncherAnnotations      *annotations);
+
+#define LAUNCHER_ANNOTATIONS_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_ANNOTATIONS_TYPE, LauncherAnnotationsPrivate))
+
+typedef struct _LauncherAnnotationsPrivate LauncherAnnotationsPrivate;
+
+struct _LauncherAnnotationsPrivate
+{
+  LauncherProfiler  profiler;
+  gchar            *profile_path;
+  gchar            *event;
+  guint64           total;
+  GHashTable       *files;
+};
+
+#define MAX_POSITIONS 4
+#define CANCEL_CHECK_INTERVAL 4096
+
+G_DEFINE_TYPE (LauncherAnnotations, launcher_annotations, G_TYPE_OBJECT)
+
+static void
+launcher_annotations_class_init (LauncherAnnotationsClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_annotations_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherAnnotationsPrivate));
+}
+
+static void
+launcher_annotations_init (LauncherAnnotations *annotations)
+{
+  LauncherAnnotationsPrivate *priv;
+  priv = LAUNCHER_ANNOTATIONS_GET_PRIVATE (annotations);
+  priv->profiler = LAUNCHER_PROFILER_NONE;
+  priv->profile_path = NULL;
+  priv->event = NULL;
+  priv->total = 0;
+  priv->files = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, 
+                                       (GDestroyNotify) g_array_unref);
+}
+
+static void
+launcher_annotations_finalize (LauncherAnnotations *annotations)
+{
+  LauncherAnnotationsPrivate *priv;
+  priv = LAUNCHER_ANNOTATIONS_GET_PRIVATE (annotations);
+  g_free (priv->profile_path);
+  g_free (priv->event);
+  g_hash_table_destroy (priv->files);
+  G_OBJECT_CLASS (launcher_annotations_parent_class)->finalize (G_OBJECT (annotations));
+}
+
+void
+launcher_annotations_load_async (LauncherProfiler     profiler,
+                                 const gchar         *profile_path,
+                                 GCancellable        *cancellable,
+                                 GAsyncReadyCallback  callback,
+                                 gpointer             user_data)
+{
+  LauncherAnnotationsPrivate *priv;
+  LauncherAnnotations *annotations;
+  GTask *task;
+
+  annotations = LAUNCHER_ANNOTATIONS (g_object_new (launcher_annotations_get_type (), NULL));
+  priv = LAUNCHER_ANNOTATIONS_GET_PRIVATE (annotations);
+  priv->profiler = profiler;
+  priv->profile_path = g_strdup (profile_path);
+
+  task = g_task_new (annotations, cancellable, callback, user_data);
+  g_task_run_in_thread (task, (GTaskThreadFunc) load_thread);
+  g_object_unref (task);
+  g_object_unref (annotations);
+}
+
+LauncherAnnotations*
+launcher_annotations_load_finish (GAsyncResult  *result,
+                                  GError       **error)
+{
+  if (!g_task_propagate_boolean (G_TASK (result), error))
+    return NULL;
+  return g_object_ref (g_task_get_source_object (G_TASK (result)));
+}
+
+const gchar*
+launcher_annotations_get_event (LauncherAnnotations *annotations)
+{
+  return LAUNCHER_ANNOTATIONS_GET_PRIVATE (annotations)->event;
+}
+
+guint64
+launcher_annotations_get_total (LauncherAnnotations *annotations)
+{
+  return LAUNCHER_ANNOTATIONS_GET_PRIVATE (annotations)->total;
+}
+
+/*
+ * Profiles name files the way the compiler saw them, which is often relative 
+ * to the build folder, so when there is no exact match the longest name that 
+ * is a trailing part of the path is used.
+ */
+GArray*
+launcher_annotations_get_lines (LauncherAnnotations *annotations,
+                                const gchar         *file_path)
+{
+  LauncherAnnotationsPrivate *priv;
+  GHashTableIter iter;
+  gpointer key;
+  gpointer value;
+  GArray *lines;
+  gsize length;
+  gsize best = 0;
+  
+  priv = LAUNCHER_ANNOTATIONS_GET_PRIVATE (annotations);
+  
+  lines = g_hash_table_lookup (priv->files, file_path);
+  if (lines != NULL)
+    return lines;
+  
+  length = strlen (file_path);
+
+  g_hash_table_iter_init (&iter, priv->files);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      const gchar *name = key;
+      gsize name_length = strlen (name);
+      
+      if (g_path_is_absolute (name) || name_length >= length || name_length <= best)
+        continue;
+      
+      if (file_path[length - name_length - 1] == G_DIR_SEPARATOR &&
+          g_str_has_suffix (file_path, name))
+        {
+          lines = value;
+          best = name_length;
+        }
+    }
+
+  return lines;
+}
+
+static void
+load_thread (GTask               *task,
+             LauncherAnnotations *annotations,
+             gpointer             task_data,
+             GCancellable        *cancellable)
+{
+  LauncherAnnotationsPrivate *priv;
+  GDataInputStream *stream;
+  GSubprocess *subprocess = NULL;
+  GInputStream *input = NULL;
+  GError *error = NULL;
+  gboolean result;
+  
+  priv = LAUNCHER_ANNOTATIONS_GET_PRIVATE (annotations);
+  
+  if (priv->profiler == LAUNCHER_PROFILER_CALLGRIND)
+    {
+      GFile *file;
+      file = g_file_new_for_path (priv->profile_path);
+      input = G_INPUT_STREAM (g_file_read (file, cancellable, &error));
+      g_object_unref (file);
+    }
+  else if (priv->profiler == LAUNCHER_PROFILER_PERF)
+    {
+      subprocess = g_subprocess_new (G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, 
+                                     &error, "perf", "report", "-i", priv->profile_path, 
+                                     "--stdio", "--no-children", "-g", "none", "-n", 
+                                     "--sort", "srcline", NULL);
+      if (subprocess != NULL)
+        input = g_object_ref (g_subprocess_get_stdout_pipe (subprocess));
+    }
+  else
+    {
+      g_set_error (&error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, 
+                   "Line costs are only available for callgrind and perf profiles");
+    }
+  
+  if (input == NULL)
+    {
+      g_task_return_error (task, error);
+      return;
+    }
+  
+  stream = g_data_input_stream_new (input);
+  g_data_input_stream_set_newline_type (stream, G_DATA_STREAM_NEWLINE_TYPE_LF);
+  g_object_unref (input);
+  
+  if (priv->profiler == LAUNCHER_PROFILER_CALLGRIND)
+    result = parse_callgrind (annotations, stream, cancellable, &error);
+  else
+    result = parse_perf (annotations, stream, cancellable, &error);
+  
+  g_object_unref (stream);
+
+  if (subprocess != NULL)
+    {
+      if (!result)
+        g_subprocess_force_exit (subprocess);
+      else if (g_subprocess_wait_check (subprocess, cancellable, &error))
+        result = TRUE;
+      else
+        result = g_hash_table_size (priv->files) > 0;
+      g_object_unref (subprocess);
+    }
+  
+  if (!result)
+    {
+      g_task_return_error (task, error);
+      return;
+    }
+  
+  g_clear_error (&error);
+  compact (annotations);
+  g_task_return_boolean (task, TRUE);
+}
+
+/*
+ * Only the self cost of the first event is taken, so the line after a 
+ * calls= line, which holds the inclusive cost of the call, is skipped. 
+ * Positions can be relative to the previous cost line and file names can 
+ * be compressed to an id that was defined the first time the name was used.
+ */
+static gboolean
+parse_callgrind (LauncherAnnotations  *annotations,
+                 GDataInputStream     *stream,
+                 GCancellable         *cancellable,
+                 GError              **error)
+{
+  LauncherAnnotationsPrivate *priv;
+  GHashTable *names;
+  GArray *file_costs = NULL;
+  GArray *costs = NULL;
+  gint64 positions[MAX_POSITIONS] = { 0 };
+  gint n_positions = 1;
+  gint line_position = 0;
+  gboolean skip_next = FALSE;
+  guint count = 0;
+  gchar *line;
+  
+  priv = LAUNCHER_ANNOTATIONS_GET_PRIVATE (annotations);
+  names = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+
+  while ((line = g_data_input_stream_read_line (stream, NULL, cancellable, error)) != NULL)
+    {
+      if (++count % CANCEL_CHECK_INTERVAL == 0 && 
+          g_cancellable_set_error_if_cancelled (cancellable, error))
+        {
+          g_free (line);
+          g_hash_table_destroy (names);
+          return FALSE;
+        }
+
+      if (g_ascii_isdigit (line[0]) || line[0] == '+' || line[0] == '-' || line[0] == '*')
+        {
+          gchar *pointer = line;
+          gint i;
+          
+          if (skip_next)
+            {
+              skip_next = FALSE;
+              g_free (line);
+              continue;
+            }
+          
+          for (i = 0; i < n_positions; i++)
+            {
+              gchar *end;
+              while (*pointer == ' ')
+                pointer++;
+              if (*pointer == '*')
+                end = pointer + 1;
+              else if (*pointer == '+' || *pointer == '-')
+                positions[i] += g_ascii_strtoll (pointer, &end, 0);
+              else
+                positions[i] = g_ascii_strtoll (pointer, &end, 0);
+              pointer = end;
+            }
+          
+          if (costs != NULL)
+            add_cost (annotations, costs, positions[line_position], 
+                      g_ascii_strtoull (pointer, NULL, 10));
+        }
+      else if (g_str_has_prefix (line, "fl="))
+        {
+          file_costs = parse_file_name (annotations, names, line + 3);
+          costs = file_costs;
+        }
+      else if (g_str_has_prefix (line, "fi=") || g_str_has_prefix (line, "fe="))
+        {
+          costs = parse_file_name (annotations, names, line + 3);
+        }
+      else if (g_str_has_prefix (line, "fn="))
+        {
+          costs = file_costs;
+        }
+      else if (g_str_has_prefix (line, "cfi=") || g_str_has_prefix (line, "cfl="))
+        {
+          /* only defines the compressed name */
+          parse_file_name (annotations, names, line + 4);
+        }
+      else if (g_str_has_prefix (line, "calls="))
+        {
+          skip_next = TRUE;
+        }
+      else if (g_str_has_prefix (line, "positions:"))
+        {
+          gchar **tokens;
+          gint i;
+          tokens = g_strsplit_set (g_strstrip (line + 10), " \t", -1);
+          n_positions = MIN (MAX (g_strv_length (tokens), 1), MAX_POSITIONS);
+          for (i = 0; i < n_positions && tokens[i] != NULL; i++)
+            {
+              if (g_strcmp0 (tokens[i], "line") == 0)
+                line_position = i;
+            }
+          g_strfreev (tokens);
+        }
+      else if (g_str_has_prefix (line, "events:") && priv->event == NULL)
+        {
+          gchar **tokens;
+          tokens = g_strsplit_set (g_strstrip (line + 7), " \t", 2);
+          priv->event = g_strdup (tokens[0]);
+          g_strfreev (tokens);
+        }
+      
+      g_free (line);
+    }
+
+  g_hash_table_destroy (names);
+  return error == NULL || *error == NULL;
+}
+
+/*
+ * Parses the output of perf report sorted by srcline, for example
+ *
+ *   12.34%   1234  foo.c:42
+ *
+ * where the number of samples is used as the cost.
+ */
+static gboolean
+parse_perf (LauncherAnnotations  *annotations,
+            GDataInputStream     *stream,
+            GCancellable         *cancellable,
+            GError              **error)
+{
+  LauncherAnnotationsPrivate *priv;
+  guint count = 0;
+  gchar *line;
+  
+  priv = LAUNCHER_ANNOTATIONS_GET_PRIVATE (annotations);
+  priv->event = g_strdup ("samples");
+  
+  while ((line = g_data_input_stream_read_line (stream, NULL, cancellable, error)) != NULL)
+    {
+      gchar *pointer;
+      gchar *end;
+      gchar *colon;
+      guint64 samples;
+      gint64 line_number;
+      
+      if (++count % CANCEL_CHECK_INTERVAL == 0 && 
+          g_cancellable_set_error_if_cancelled (cancellable, error))
+        {
+          g_free (line);
+          return FALSE;
+        }
+      
+      pointer = g_strstrip (line);
+      if (*pointer == '#' || (end = strchr (pointer, '%')) == NULL)
+        {
+          g_free (line);
+          continue;
+        }
+      
+      samples = g_ascii_strtoull (end + 1, &end, 10);
+      pointer = g_strchug (end);
+      
+      end = strstr (pointer, " (discriminator");
+      if (end != NULL)
+        *end = '\0';
+      
+      colon = strrchr (pointer, ':');
+      if (colon != NULL && colon != pointer && samples > 0)
+        {
+          line_number = g_ascii_strtoll (colon + 1, NULL, 10);
+          *colon = '\0';
+          if (g_strcmp0 (pointer, "??") != 0)
+            add_cost (annotations, get_costs (annotations, pointer), line_number, samples);
+        }
+      
+      g_free (line);
+    }
+
+  return error == NULL || *error == NULL;
+}
+
+static GArray*
+parse_file_name (LauncherAnnotations *annotations,
+                 GHashTable          *names,
+                 const gchar         *spec)
+{
+  const gchar *name = spec;
+  
+  if (*spec == '(')
+    {
+      gchar *end;
+      gint id;
+      
+      id = strtol (spec + 1, &end, 10);
+      if (*end == ')')
+        end++;
+      while (*end == ' ')
+        end++;
+      
+      if (*end == '\0')
+        {
+          name = g_hash_table_lookup (names, GINT_TO_POINTER (id));
+          if (name == NULL)
+            return NULL;
+        }
+      else
+        {
+          name = end;
+          g_hash_table_insert (names, GINT_TO_POINTER (id), g_strdup (name));
+        }
+    }
+  
+  if (g_strcmp0 (name, "???") == 0)
+    return NULL;
+
+  return get_costs (annotations, name);
+}
+
+static GArray*
+get_costs (LauncherAnnotations *annotations,
+           const gchar         *file_name)
+{
+  LauncherAnnotationsPrivate *priv;
+  GArray *costs;
+  
+  priv = LAUNCHER_ANNOTATIONS_GET_PRIVATE (annotations);
+  
+  costs = g_hash_table_lookup (priv->files, file_name);
+  if (costs == NULL)
+    {
+      costs = g_array_new (FALSE, TRUE, sizeof (guint64));
+      g_hash_table_insert (priv->files, g_strdup (file_name), costs);
+    }
+
+  return costs;
+}
+
+static void
+add_cost (LauncherAnnotations *annotations,
+          GArray              *costs,
+          gint64               line,
+          guint64              cost)
+{
+  LauncherAnnotationsPrivate *priv;
+  
+  if (line <= 0 || line > G_MAXINT || cost == 0)
+    return;
+  
+  priv = LAUNCHER_ANNOTATIONS_GET_PRIVATE (annotations);
+
+  if (costs->len <= line)
+    g_array_set_size (costs, line + 1);
+  
+  g_array_index (costs, guint64, line) += cost;
+  priv->total += cost;
+}
+
+static void
+compact (LauncherAnnotations *annotations)
+{
+  LauncherAnnotationsPrivate *priv;
+  GHashTableIter iter;
+  gpointer key;
+  gpointer value;
+  
+  priv = LAUNCHER_ANNOTATIONS_GET_PRIVATE (annotations);
+
+  g_hash_table_iter_init (&iter, priv->files);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      GArray *costs = value;
+      GArray *lines;
+      guint i;
+      
+      lines = g_array_new (FALSE, FALSE, sizeof (LauncherAnnotationsLine));
+      
+      for (i = 1; i < costs->len; i++)
+        {
+          LauncherAnnotationsLine line;
+          line.cost = g_array_index (costs, guint64, i);
+          if (line.cost == 0)
+            continue;
+          line.line = i;
+          g_array_append_val (lines, line);
+        }
+      
+      if (lines->len == 0)
+        {
+          g_array_unref (lines);
+          g_hash_table_iter_remove (&iter);
+        }
+      else
+        {
+          g_hash_table_iter_replace (&iter, lines);
+        }
+    }
+}
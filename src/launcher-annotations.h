@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_ANNOTATIONS_H__
+#define	__LAUNCHER_ANNOTATIONS_H__
+
+#include <gio/gio.h>
+#include "launcher-config.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_ANNOTATIONS_TYPE            (launcher_annotations_get_type ())
+#define LAUNCHER_ANNOTATIONS(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_ANNOTATIONS_TYPE, LauncherAnnotations))
+#define LAUNCHER_ANNOTATIONS_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_ANNOTATIONS_TYPE, LauncherAnnotationsClass))
+#define IS_LAUNCHER_ANNOTATIONS(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_ANNOTATIONS_TYPE))
+#define IS_LAUNCHER_ANNOTATIONS_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_ANNOTATIONS_TYPE))
+
+typedef struct _LauncherAnnotations LauncherAnnotations;
+typedef struct _LauncherAnnotationsClass LauncherAnnotationsClass;
+
+typedef struct
+{
+  gint    line;
+  guint64 cost;
+} LauncherAnnotationsLine;
+
+struct _LauncherAnnotations
+{
+  GObject parent_instance;
+};
+
+struct _LauncherAnnotationsClass
+{
+  GObjectClass parent_class;
+};
+
+GType launcher_annotations_get_type (void) G_GNUC_CONST;
+
+void                  launcher_annotations_load_async   (LauncherProfiler      profiler,
+                                                         const gchar          *profile_path,
+                                                         GCancellable         *cancellable,
+                                                         GAsyncReadyCallback   callback,
+                                                         gpointer              user_data);
+LauncherAnnotations*  launcher_annotations_load_finish  (GAsyncResult         *result,
+                                                         GError              **error);
+
+const gchar*          launcher_annotations_get_event    (LauncherAnnotations  *annotations);
+guint64               launcher_annotations_get_total    (LauncherAnnotations  *annotations);
+GArray*               launcher_annotations_get_lines    (LauncherAnnotations  *annotations,
+                                                         const gchar          *file_path);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_ANNOTATIONS_H__ */
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <gtksourceview/gtksourceview.h>
+#include <gtksourceview/gtksourcemarkattributes.h>
+#include "launcher-annotator.h"
+
+/*
+ * Shows the line costs of the last profile in the open editors. Each line 
+ * with a noticeable share of the total gets a source mark whose category 
+ * decides the heat colour of the line, and the gutter tooltip of the mark 
+ * shows the cost itself.
+ */
+
+static void launcher_annotator_class_init  (LauncherAnnotatorClass *klass);
+static void launcher_annotator_init        (LauncherAnnotator      *annotator);
+static void launcher_annotator_finalize    (LauncherAnnotator      *annotator);
+
+static void editor_added_action            (LauncherAnnotator      *annotator,
+                                            CodeSlayerEditor       *editor);
+static void annotate_editor                (LauncherAnnotator      *annotator,
+                                            CodeSlayerEditor       *editor);
+static void clear_editor                   (CodeSlayerEditor       *editor);
+static void set_mark_attributes            (GtkSourceView          *source_view);
+static gchar* query_tooltip_action         (GtkSourceMarkAttributes *attributes,
+                                            GtkSourceMark          *mark);
+
+#define LAUNCHER_ANNOTATOR_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_ANNOTATOR_TYPE, LauncherAnnotatorPrivate))
+
+typedef struct _LauncherAnnotatorPrivate LauncherAnnotatorPrivate;
+
+struct _LauncherAnnotatorPrivate
+{
+  CodeSlayer          *codeslayer;
+  LauncherAnnotations *annotations;
+  gulong               editor_added_id;
+};
+
+#define COST "launcher-cost"
+#define MARK_ATTRIBUTES "launcher-mark-attributes"
+#define N_HEATS 3
+
+/* the share of the total cost, in parts per 10000, a line needs for each heat */
+static const gint64 thresholds[N_HEATS] = { 10, 100, 1000 };
+static const gchar *categories[N_HEATS] = { "launcher-heat-low", "launcher-heat-medium", "launcher-heat-high" };
+static const gchar *colors[N_HEATS] = { "#fff4d6", "#ffd9a8", "#ffb3a8" };
+
+G_DEFINE_TYPE (LauncherAnnotator, launcher_annotator, G_TYPE_OBJECT)
+
+static void
+launcher_annotator_class_init (LauncherAnnotatorClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_annotator_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherAnnotatorPrivate));
+}
+
+static void
+launcher_annotator_init (LauncherAnnotator *annotator)
+{
+  LauncherAnnotatorPrivate *priv;
+  priv = LAUNCHER_ANNOTATOR_GET_PRIVATE (annotator);
+  priv->annotations = NULL;
+  priv->editor_added_id = 0;
+}
+
+static void
+launcher_annotator_finalize (LauncherAnnotator *annotator)
+{
+  LauncherAnnotatorPrivate *priv;
+  priv = LAUNCHER_ANNOTATOR_GET_PRIVATE (annotator);
+  g_signal_handler_disconnect (priv->codeslayer, priv->editor_added_id);
+  launcher_annotator_set_annotations (annotator, NULL);
+  G_OBJECT_CLASS (launcher_annotator_parent_class)->finalize (G_OBJECT (annotator));
+}
+
+LauncherAnnotator*
+launcher_annotator_new (CodeSlayer *codeslayer)
+{
+  LauncherAnnotatorPrivate *priv;
+  LauncherAnnotator *annotator;
+
+  annotator = LAUNCHER_ANNOTATOR (g_object_new (launcher_annotator_get_type (), NULL));
+  priv = LAUNCHER_ANNOTATOR_GET_PRIVATE (annotator);
+  priv->codeslayer = codeslayer;
+  
+  priv->editor_added_id = g_signal_connect_swapped (G_OBJECT (codeslayer), "editor-added",
+                                                    G_CALLBACK (editor_added_action), annotator);
+
+  return annotator;
+}
+
+void
+launcher_annotator_set_annotations (LauncherAnnotator   *annotator,
+                                    LauncherAnnotations *annotations)
+{
+  LauncherAnnotatorPrivate *priv;
+  GList *editors;
+  GList *list;
+  
+  priv = LAUNCHER_ANNOTATOR_GET_PRIVATE (annotator);
+  
+  if (priv->annotations != NULL)
+    g_object_unref (priv->annotations);
+  priv->annotations = annotations != NULL ? g_object_ref (annotations) : NULL;
+  
+  editors = codeslayer_get_all_editors (priv->codeslayer);
+  for (list = editors; list != NULL; list = g_list_next (list))
+    {
+      CodeSlayerEditor *editor = list->data;
+      clear_editor (editor);
+      if (priv->annotations != NULL)
+        annotate_editor (annotator, editor);
+    }
+  g_list_free (editors);
+}
+
+static void
+editor_added_action (LauncherAnnotator *annotator,
+                     CodeSlayerEditor  *editor)
+{
+  LauncherAnnotatorPrivate *priv;
+  priv = LAUNCHER_ANNOTATOR_GET_PRIVATE (annotator);
+  if (priv->annotations != NULL)
+    annotate_editor (annotator, editor);
+}
+
+static void
+annotate_editor (LauncherAnnotator *annotator,
+                 CodeSlayerEditor  *editor)
+{
+  LauncherAnnotatorPrivate *priv;
+  GtkSourceBuffer *buffer;
+  const gchar *file_path;
+  const gchar *event;
+  GArray *lines;
+  guint64 total;
+  guint i;
+  
+  priv = LAUNCHER_ANNOTATOR_GET_PRIVATE (annotator);
+  
+  file_path = codeslayer_editor_get_file_path (editor);
+  if (file_path == NULL)
+    return;
+  
+  lines = launcher_annotations_get_lines (priv->annotations, file_path);
+  total = launcher_annotations_get_total (priv->annotations);
+  if (lines == NULL || total == 0)
+    return;
+  
+  event = launcher_annotations_get_event (priv->annotations);
+  buffer = GTK_SOURCE_BUFFER (gtk_text_view_get_buffer (GTK_TEXT_VIEW (editor)));
+  
+  set_mark_attributes (GTK_SOURCE_VIEW (editor));
+  
+  for (i = 0; i < lines->len; i++)
+    {
+      LauncherAnnotationsLine *line;
+      GtkSourceMark *mark;
+      GtkTextIter iter;
+      gint64 share;
+      gint heat;
+      
+      line = &g_array_index (lines, LauncherAnnotationsLine, i);
+      if (line->line > gtk_text_buffer_get_line_count (GTK_TEXT_BUFFER (buffer)))
+        break;
+      
+      share = (gint64) (line->cost * 10000.0 / total);
+      for (heat = N_HEATS - 1; heat >= 0 && share < thresholds[heat]; heat--);
+      if (heat < 0)
+        continue;
+      
+      gtk_text_buffer_get_iter_at_line (GTK_TEXT_BUFFER (buffer), &iter, line->line - 1);
+      mark = gtk_source_buffer_create_source_mark (buffer, NULL, categories[heat], &iter);
+      g_object_set_data_full (G_OBJECT (mark), COST, 
+                              g_strdup_printf ("%" G_GUINT64_FORMAT " %s (%.2f%%)", 
+                                               line->cost, event, share / 100.0), 
+                              g_free);
+    }
+}
+
+static void
+clear_editor (CodeSlayerEditor *editor)
+{
+  GtkTextBuffer *buffer;
+  GtkTextIter start;
+  GtkTextIter end;
+  gint i;
+  
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (editor));
+  gtk_text_buffer_get_bounds (buffer, &start, &end);
+  
+  for (i = 0; i < N_HEATS; i++)
+    gtk_source_buffer_remove_source_marks (GTK_SOURCE_BUFFER (buffer), &start, &end, categories[i]);
+}
+
+static void
+set_mark_attributes (GtkSourceView *source_view)
+{
+  gint i;
+  
+  if (g_object_get_data (G_OBJECT (source_view), MARK_ATTRIBUTES) != NULL)
+    return;
+  
+  for (i = 0; i < N_HEATS; i++)
+    {
+      GtkSourceMarkAttributes *attributes;
+      GdkRGBA rgba;
+      
+      gdk_rgba_parse (&rgba, colors[i]);
+      attributes = gtk_source_mark_attributes_new ();
+      gtk_source_mark_attributes_set_background (attributes, &rgba);
+      gtk_source_mark_attributes_set_icon_name (attributes, "utilities-system-monitor");
+      g_signal_connect (G_OBJECT (attributes), "query-tooltip-text",
+                        G_CALLBACK (query_tooltip_action), NULL);
+      gtk_source_view_set_mark_attributes (source_view, categories[i], attributes, i);
+      g_object_unref (attributes);
+    }
+  
+  gtk_source_view_set_show_line_marks (source_view, TRUE);
+  g_object_set_data (G_OBJECT (source_view), MARK_ATTRIBUTES, GINT_TO_POINTER (TRUE));
+}
+
+static gchar*
+query_tooltip_action (GtkSourceMarkAttributes *attributes,
+                      GtkSourceMark           *mark)
+{
+  return g_strdup (g_object_get_data (G_OBJECT (mark), COST));
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_ANNOTATOR_H__
+#define	__LAUNCHER_ANNOTATOR_H__
+
+#include <gtk/gtk.h>
+#include <codeslayer/codeslayer.h>
+#include "launcher-annotations.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_ANNOTATOR_TYPE            (launcher_annotator_get_type ())
+#define LAUNCHER_ANNOTATOR(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_ANNOTATOR_TYPE, LauncherAnnotator))
+#define LAUNCHER_ANNOTATOR_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_ANNOTATOR_TYPE, LauncherAnnotatorClass))
+#define IS_LAUNCHER_ANNOTATOR(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_ANNOTATOR_TYPE))
+#define IS_LAUNCHER_ANNOTATOR_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_ANNOTATOR_TYPE))
+
+typedef struct _LauncherAnnotator LauncherAnnotator;
+typedef struct _LauncherAnnotatorClass LauncherAnnotatorClass;
+
+struct _LauncherAnnotator
+{
+  GObject parent_instance;
+};
+
+struct _LauncherAnnotatorClass
+{
+  GObjectClass parent_class;
+};
+
+GType launcher_annotator_get_type (void) G_GNUC_CONST;
+
+LauncherAnnotator*  launcher_annotator_new              (CodeSlayer          *codeslayer);
+
+void                launcher_annotator_set_annotations  (LauncherAnnotator   *annotator,
+                                                         LauncherAnnotations *annotations);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_ANNOTATOR_H__ */
@@ -0,0 +1,397 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "launcher-benchmark-view.h"
+
+static void launcher_benchmark_view_class_init  (LauncherBenchmarkViewClass *klass);
+static void launcher_benchmark_view_init        (LauncherBenchmarkView      *benchmark_view);
+static void launcher_benchmark_view_finalize    (LauncherBenchmarkView      *benchmark_view);
+
+static void add_column                          (LauncherBenchmarkView      *benchmark_view,
+                                                 const gchar                *title,
+                                                 gint                        column);
+static void add_row                             (LauncherBenchmarkView      *benchmark_view,
+                                                 const gchar                *name,
+                                                 LauncherBenchmarkMetric     metric,
+                                                 const gchar                *unit,
+                                                 gdouble                     scale);
+static void add_startup_rows                    (LauncherBenchmarkView      *benchmark_view,
+                                                 const gchar                *name,
+                                                 LauncherBenchmarkMetric     metric,
+                                                 const gchar                *unit,
+                                                 gdouble                     scale);
+static void add_stats_row                       (LauncherBenchmarkView      *benchmark_view,
+                                                 const gchar                *name,
+                                                 LauncherBenchmarkStats     *stats,
+                                                 const gchar                *unit,
+                                                 gdouble                     scale);
+static void progress_action                     (LauncherBenchmarkView      *benchmark_view);
+static void regression_action                   (LauncherBenchmarkView      *benchmark_view);
+static void disconnect_benchmark                (LauncherBenchmarkView      *benchmark_view);
+
+#define LAUNCHER_BENCHMARK_VIEW_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_BENCHMARK_VIEW_TYPE, LauncherBenchmarkViewPrivate))
+
+typedef struct _LauncherBenchmarkViewPrivate LauncherBenchmarkViewPrivate;
+
+struct _LauncherBenchmarkViewPrivate
+{
+  LauncherBenchmark *benchmark;
+  GtkWidget         *status_label;
+  GtkWidget         *regression_label;
+  GtkWidget         *tree;
+  GtkListStore      *store;
+  gulong             progress_id;
+  gulong             regression_id;
+  gboolean           finished;
+};
+
+enum
+{
+  METRIC = 0,
+  MIN,
+  MEDIAN,
+  MEAN,
+  STDDEV,
+  P95,
+  COLUMNS
+};
+
+G_DEFINE_TYPE (LauncherBenchmarkView, launcher_benchmark_view, GTK_TYPE_BOX)
+
+static void
+launcher_benchmark_view_class_init (LauncherBenchmarkViewClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_benchmark_view_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherBenchmarkViewPrivate));
+}
+
+static void
+launcher_benchmark_view_init (LauncherBenchmarkView *benchmark_view)
+{
+  LauncherBenchmarkViewPrivate *priv;
+  GtkWidget *scrolled_window;
+
+  priv = LAUNCHER_BENCHMARK_VIEW_GET_PRIVATE (benchmark_view);
+  priv->benchmark = NULL;
+  priv->progress_id = 0;
+  priv->regression_id = 0;
+  priv->finished = FALSE;
+
+  gtk_orientable_set_orientation (GTK_ORIENTABLE (benchmark_view), GTK_ORIENTATION_VERTICAL);
+  
+  priv->status_label = gtk_label_new (NULL);
+  gtk_misc_set_alignment (GTK_MISC (priv->status_label), 0, .5);
+  gtk_misc_set_padding (GTK_MISC (priv->status_label), 4, 2);
+  gtk_box_pack_start (GTK_BOX (benchmark_view), priv->status_label, FALSE, FALSE, 0);
+
+  priv->regression_label = gtk_label_new (NULL);
+  gtk_misc_set_alignment (GTK_MISC (priv->regression_label), 0, .5);
+  gtk_misc_set_padding (GTK_MISC (priv->regression_label), 4, 2);
+  gtk_widget_set_no_show_all (priv->regression_label, TRUE);
+  gtk_box_pack_start (GTK_BOX (benchmark_view), priv->regression_label, FALSE, FALSE, 0);
+  
+  priv->store = gtk_list_store_new (COLUMNS, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, 
+                                    G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING);
+  priv->tree = gtk_tree_view_new_with_model (GTK_TREE_MODEL (priv->store));
+  
+  add_column (benchmark_view, "Metric", METRIC);
+  add_column (benchmark_view, "Min", MIN);
+  add_column (benchmark_view, "Median", MEDIAN);
+  add_column (benchmark_view, "Mean", MEAN);
+  add_column (benchmark_view, "Std Dev", STDDEV);
+  add_column (benchmark_view, "P95", P95);
+
+  scrolled_window = gtk_scrolled_window_new (NULL, NULL);
+  gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolled_window),
+                                  GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_container_add (GTK_CONTAINER (scrolled_window), priv->tree);
+  gtk_box_pack_start (GTK_BOX (benchmark_view), scrolled_window, TRUE, TRUE, 0);
+}
+
+static void
+launcher_benchmark_view_finalize (LauncherBenchmarkView *benchmark_view)
+{
+  LauncherBenchmarkViewPrivate *priv;
+  priv = LAUNCHER_BENCHMARK_VIEW_GET_PRIVATE (benchmark_view);
+  disconnect_benchmark (benchmark_view);
+  g_object_unref (priv->store);
+  G_OBJECT_CLASS (launcher_benchmark_view_parent_class)->finalize (G_OBJECT (benchmark_view));
+}
+
+GtkWidget*
+launcher_benchmark_view_new (void)
+{
+  return g_object_new (launcher_benchmark_view_get_type (), NULL);
+}
+
+static void
+add_column (LauncherBenchmarkView *benchmark_view,
+            const gchar           *title,
+            gint                   column)
+{
+  LauncherBenchmarkViewPrivate *priv;
+  GtkCellRenderer *renderer;
+  GtkTreeViewColumn *tree_column;
+  
+  priv = LAUNCHER_BENCHMARK_VIEW_GET_PRIVATE (benchmark_view);
+  
+  renderer = gtk_cell_renderer_text_new ();
+  if (column != METRIC)
+    g_object_set (renderer, "xalign", 1.0, NULL);
+
+  tree_column = gtk_tree_view_column_new_with_attributes (title, renderer, "text", column, NULL);
+  gtk_tree_view_column_set_expand (tree_column, column == METRIC);
+  gtk_tree_view_append_column (GTK_TREE_VIEW (priv->tree), tree_column);
+}
+
+void
+launcher_benchmark_view_set_benchmark (LauncherBenchmarkView *benchmark_view,
+                                       LauncherBenchmark     *benchmark)
+{
+  LauncherBenchmarkViewPrivate *priv;
+  priv = LAUNCHER_BENCHMARK_VIEW_GET_PRIVATE (benchmark_view);
+  
+  disconnect_benchmark (benchmark_view);
+
+  priv->benchmark = g_object_ref (benchmark);
+  priv->progress_id = g_signal_connect_swapped (G_OBJECT (benchmark), "progress",
+                                                G_CALLBACK (progress_action), benchmark_view);
+  priv->regression_id = g_signal_connect_swapped (G_OBJECT (benchmark), "regression",
+                                                  G_CALLBACK (regression_action), benchmark_view);
+  
+  gtk_widget_hide (priv->regression_label);
+  priv->finished = FALSE;
+  gtk_list_store_clear (priv->store);
+  progress_action (benchmark_view);
+}
+
+static void
+disconnect_benchmark (LauncherBenchmarkView *benchmark_view)
+{
+  LauncherBenchmarkViewPrivate *priv;
+  priv = LAUNCHER_BENCHMARK_VIEW_GET_PRIVATE (benchmark_view);
+  
+  if (priv->benchmark == NULL)
+    return;
+
+  g_signal_handler_disconnect (priv->benchmark, priv->progress_id);
+  g_signal_handler_disconnect (priv->benchmark, priv->regression_id);
+  g_object_unref (priv->benchmark);
+  priv->benchmark = NULL;
+}
+
+static void
+progress_action (LauncherBenchmarkView *benchmark_view)
+{
+  LauncherBenchmarkViewPrivate *priv;
+  LauncherConfig *config;
+  gchar *text;
+  
+  priv = LAUNCHER_BENCHMARK_VIEW_GET_PRIVATE (benchmark_view);
+  
+  if (priv->finished)
+    return;
+  
+  config = launcher_benchmark_get_config (priv->benchmark);
+  text = g_strdup_printf (launcher_benchmark_get_mode (priv->benchmark) == LAUNCHER_BENCHMARK_STARTUP ? 
+                          "Benchmarking the startup of %s: run %d of %d" : "Benchmarking %s: run %d of %d", 
+                          launcher_config_get_executable (config),
+                          launcher_benchmark_get_completed (priv->benchmark),
+                          launcher_benchmark_get_total (priv->benchmark));
+  gtk_label_set_text (GTK_LABEL (priv->status_label), text);
+  g_free (text);
+}
+
+static void
+regression_action (LauncherBenchmarkView *benchmark_view)
+{
+  LauncherBenchmarkViewPrivate *priv;
+  const LauncherHistoryRegression *regression;
+  gchar *text;
+  
+  priv = LAUNCHER_BENCHMARK_VIEW_GET_PRIVATE (benchmark_view);
+
+  regression = launcher_benchmark_get_regression (priv->benchmark);
+  if (regression == NULL || !regression->detected)
+    return;
+
+  text = g_strdup_printf ("Wall time is %.0f%% slower than the previous benchmarks (p = %.4f)", 
+                          (regression->slowdown - 1) * 100, regression->p_value);
+  gtk_label_set_text (GTK_LABEL (priv->regression_label), text);
+  gtk_widget_show (priv->regression_label);
+  g_free (text);
+}
+
+void
+launcher_benchmark_view_show_results (LauncherBenchmarkView *benchmark_view,
+                                      const GError          *error)
+{
+  LauncherBenchmarkViewPrivate *priv;
+  LauncherConfig *config;
+  gchar *text;
+  
+  priv = LAUNCHER_BENCHMARK_VIEW_GET_PRIVATE (benchmark_view);
+  priv->finished = TRUE;
+  
+  config = launcher_benchmark_get_config (priv->benchmark);
+  
+  if (error != NULL)
+    {
+      text = g_strdup_printf ("Benchmark of %s failed: %s", 
+                              launcher_config_get_executable (config), error->message);
+      gtk_label_set_text (GTK_LABEL (priv->status_label), text);
+      g_free (text);
+      return;
+    }
+  
+  if (launcher_benchmark_get_mode (priv->benchmark) == LAUNCHER_BENCHMARK_STARTUP)
+    {
+      text = g_strdup_printf ("%s: %d cold and %d warm starts, %d failed", 
+                              launcher_config_get_executable (config),
+                              (launcher_benchmark_get_n_samples (priv->benchmark) + 1) / 2,
+                              launcher_benchmark_get_n_samples (priv->benchmark) / 2,
+                              launcher_benchmark_get_n_failures (priv->benchmark));
+      gtk_label_set_text (GTK_LABEL (priv->status_label), text);
+      g_free (text);
+      
+      gtk_list_store_clear (priv->store);
+      add_startup_rows (benchmark_view, "First Output", LAUNCHER_BENCHMARK_FIRST_OUTPUT, "ms", 1000);
+      add_startup_rows (benchmark_view, "Exit", LAUNCHER_BENCHMARK_WALL_TIME, "ms", 1000);
+      add_startup_rows (benchmark_view, "Dynamic Loader", LAUNCHER_BENCHMARK_LINKER_TIME, "M cycles", 1000000);
+      add_startup_rows (benchmark_view, "System Time", LAUNCHER_BENCHMARK_SYSTEM_TIME, "ms", 1000);
+      return;
+    }
+  
+  text = g_strdup_printf ("%s: %d runs, %d warmups, %d failed", 
+                          launcher_config_get_executable (config),
+                          launcher_benchmark_get_n_samples (priv->benchmark),
+                          launcher_benchmark_get_total (priv->benchmark) - 
+                          launcher_benchmark_get_n_samples (priv->benchmark),
+                          launcher_benchmark_get_n_failures (priv->benchmark));
+  gtk_label_set_text (GTK_LABEL (priv->status_label), text);
+  g_free (text);
+
+  gtk_list_store_clear (priv->store);
+  add_row (benchmark_view, "Wall Time", LAUNCHER_BENCHMARK_WALL_TIME, "ms", 1000);
+  add_row (benchmark_view, "User Time", LAUNCHER_BENCHMARK_USER_TIME, "ms", 1000);
+  add_row (benchmark_view, "System Time", LAUNCHER_BENCHMARK_SYSTEM_TIME, "ms", 1000);
+  add_row (benchmark_view, "Max RSS", LAUNCHER_BENCHMARK_MAX_RSS, "KiB", 1);
+  
+  if (launcher_benchmark_get_n_samples (priv->benchmark) > 0)
+    {
+      const LauncherCounterValues *counters;
+      counters = &launcher_benchmark_get_sample (priv->benchmark, 0)->counters;
+      
+      if (launcher_counter_values_has (counters, LAUNCHER_COUNTER_CYCLES))
+        add_row (benchmark_view, "Cycles", LAUNCHER_BENCHMARK_CYCLES, "M", 1000000);
+      if (launcher_counter_values_has (counters, LAUNCHER_COUNTER_INSTRUCTIONS))
+        add_row (benchmark_view, "Instructions", LAUNCHER_BENCHMARK_INSTRUCTIONS, "M", 1000000);
+      if (launcher_counter_values_ratio (counters, LAUNCHER_COUNTER_INSTRUCTIONS, 
+                                         LAUNCHER_COUNTER_CYCLES) >= 0)
+        add_row (benchmark_view, "IPC", LAUNCHER_BENCHMARK_IPC, "", 1);
+      if (launcher_counter_values_ratio (counters, LAUNCHER_COUNTER_BRANCH_MISSES, 
+                                         LAUNCHER_COUNTER_BRANCHES) >= 0)
+        add_row (benchmark_view, "Branch Misses", LAUNCHER_BENCHMARK_BRANCH_MISS_RATE, "%", 0.01);
+      if (launcher_counter_values_ratio (counters, LAUNCHER_COUNTER_LLC_MISSES, 
+                                         LAUNCHER_COUNTER_LLC_REFERENCES) >= 0)
+        add_row (benchmark_view, "LLC Misses", LAUNCHER_BENCHMARK_LLC_MISS_RATE, "%", 0.01);
+    }
+}
+
+static void
+add_row (LauncherBenchmarkView   *benchmark_view,
+         const gchar             *name,
+         LauncherBenchmarkMetric  metric,
+         const gchar             *unit,
+         gdouble                  scale)
+{
+  LauncherBenchmarkViewPrivate *priv;
+  LauncherBenchmarkStats stats;
+  priv = LAUNCHER_BENCHMARK_VIEW_GET_PRIVATE (benchmark_view);
+  launcher_benchmark_get_stats (priv->benchmark, metric, &stats);
+  add_stats_row (benchmark_view, name, &stats, unit, scale);
+}
+
+/*
+ * Puts the cold and the warm starts of a metric next to each other.
+ */
+static void
+add_startup_rows (LauncherBenchmarkView   *benchmark_view,
+                  const gchar             *name,
+                  LauncherBenchmarkMetric  metric,
+                  const gchar             *unit,
+                  gdouble                  scale)
+{
+  LauncherBenchmarkViewPrivate *priv;
+  LauncherBenchmarkStats stats;
+  gchar *row_name;
+  
+  priv = LAUNCHER_BENCHMARK_VIEW_GET_PRIVATE (benchmark_view);
+  
+  launcher_benchmark_get_startup_stats (priv->benchmark, metric, TRUE, &stats);
+  row_name = g_strconcat (name, " (cold)", NULL);
+  add_stats_row (benchmark_view, row_name, &stats, unit, scale);
+  g_free (row_name);
+
+  launcher_benchmark_get_startup_stats (priv->benchmark, metric, FALSE, &stats);
+  row_name = g_strconcat (name, " (warm)", NULL);
+  add_stats_row (benchmark_view, row_name, &stats, unit, scale);
+  g_free (row_name);
+}
+
+static void
+add_stats_row (LauncherBenchmarkView  *benchmark_view,
+               const gchar            *name,
+               LauncherBenchmarkStats *stats,
+               const gchar            *unit,
+               gdouble                 scale)
+{
+  LauncherBenchmarkViewPrivate *priv;
+  GtkTreeIter iter;
+  gchar *min;
+  gchar *median;
+  gchar *mean;
+  gchar *stddev;
+  gchar *p95;
+  
+  priv = LAUNCHER_BENCHMARK_VIEW_GET_PRIVATE (benchmark_view);
+  
+  min = g_strdup_printf ("%.3f %s", stats->min / scale, unit);
+  median = g_strdup_printf ("%.3f %s", stats->median / scale, unit);
+  mean = g_strdup_printf ("%.3f %s", stats->mean / scale, unit);
+  stddev = g_strdup_printf ("%.3f %s", stats->stddev / scale, unit);
+  p95 = g_strdup_printf ("%.3f %s", stats->p95 / scale, unit);
+  
+  gtk_list_store_append (priv->store, &iter);
+  gtk_list_store_set (priv->store, &iter,
+                      METRIC, name,
+                      MIN, min,
+                      MEDIAN, median,
+                      MEAN, mean,
+                      STDDEV, stddev,
+                      P95, p95,
+                      -1);
+  
+  g_free (min);
+  g_free (median);
+  g_free (mean);
+  g_free (stddev);
+  g_free (p95);
+}
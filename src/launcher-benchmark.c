@@ -0,0 +1,828 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "launcher-benchmark.h"
+
+static void launcher_benchmark_class_init  (LauncherBenchmarkClass *klass);
+static void launcher_benchmark_init        (LauncherBenchmark      *benchmark);
+static void launcher_benchmark_finalize    (LauncherBenchmark      *benchmark);
+
+static void run_thread                     (GTask                  *task,
+                                            LauncherBenchmark      *benchmark,
+                                            gpointer                task_data,
+                                            GCancellable           *cancellable);
+static gboolean run_once                   (LauncherBenchmark      *benchmark,
+                                            LauncherBenchmarkSample *sample,
+                                            GError                **error);
+static gboolean run_startup_once           (LauncherBenchmark      *benchmark,
+                                            LauncherBenchmarkSample *sample,
+                                            gchar                 **envp,
+                                            const gchar            *debug_path,
+                                            GError                **error);
+static gchar** resolve_files               (const gchar            *program,
+                                            gchar                 **envp);
+static void evict_files                    (gchar                 **files);
+static gint64 read_linker_time             (const gchar            *debug_path,
+                                            GPid                    pid);
+static void child_setup                    (gpointer                data);
+static gboolean progress_action            (LauncherBenchmark      *benchmark);
+static void compute_stats                  (LauncherBenchmark      *benchmark,
+                                            LauncherBenchmarkMetric metric,
+                                            gint                    cold,
+                                            LauncherBenchmarkStats *stats);
+static gdouble get_value                   (const LauncherBenchmarkSample *sample,
+                                            LauncherBenchmarkMetric  metric);
+static gint compare_values                 (const gdouble          *a,
+                                            const gdouble          *b);
+
+#define LAUNCHER_BENCHMARK_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_BENCHMARK_TYPE, LauncherBenchmarkPrivate))
+
+typedef struct _LauncherBenchmarkPrivate LauncherBenchmarkPrivate;
+
+struct _LauncherBenchmarkPrivate
+{
+  LauncherConfig *config;
+  LauncherBenchmarkMode mode;
+  gchar         **argv;
+  gint            runs;
+  gint            warmups;
+  gint            completed;
+  GArray         *samples;
+  LauncherResources *resources;
+  gchar         **environment;
+  LauncherHistoryRegression *regression;
+};
+
+typedef struct
+{
+  LauncherCounters  *counters;
+  LauncherResources *resources;
+} ChildSetup;
+
+enum
+{
+  PROGRESS,
+  REGRESSION,
+  LAST_SIGNAL
+};
+
+static guint launcher_benchmark_signals[LAST_SIGNAL] = { 0 };
+
+G_DEFINE_TYPE (LauncherBenchmark, launcher_benchmark, G_TYPE_OBJECT)
+
+static void 
+launcher_benchmark_class_init (LauncherBenchmarkClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  launcher_benchmark_signals[PROGRESS] =
+    g_signal_new ("progress", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherBenchmarkClass, progress),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  launcher_benchmark_signals[REGRESSION] =
+    g_signal_new ("regression", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherBenchmarkClass, regression),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_benchmark_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherBenchmarkPrivate));
+}
+
+static void
+launcher_benchmark_init (LauncherBenchmark *benchmark)
+{
+  LauncherBenchmarkPrivate *priv;
+  priv = LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark);
+  priv->config = NULL;
+  priv->mode = LAUNCHER_BENCHMARK_RUN;
+  priv->argv = NULL;
+  priv->runs = 0;
+  priv->warmups = 0;
+  priv->completed = 0;
+  priv->samples = g_array_new (FALSE, TRUE, sizeof (LauncherBenchmarkSample));
+  priv->resources = NULL;
+  priv->environment = NULL;
+  priv->regression = NULL;
+}
+
+static void
+launcher_benchmark_finalize (LauncherBenchmark *benchmark)
+{
+  LauncherBenchmarkPrivate *priv;
+  priv = LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark);
+  if (priv->config)
+    g_object_unref (priv->config);
+  g_strfreev (priv->argv);
+  g_strfreev (priv->environment);
+  g_array_free (priv->samples, TRUE);
+  if (priv->resources)
+    g_object_unref (priv->resources);
+  g_free (priv->regression);
+  G_OBJECT_CLASS (launcher_benchmark_parent_class)->finalize (G_OBJECT (benchmark));
+}
+
+LauncherBenchmark*
+launcher_benchmark_new (LauncherConfig  *config,
+                        gchar          **argv)
+{
+  LauncherBenchmarkPrivate *priv;
+  LauncherBenchmark *benchmark;
+
+  benchmark = LAUNCHER_BENCHMARK (g_object_new (launcher_benchmark_get_type (), NULL));
+  priv = LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark);
+  priv->config = g_object_ref (config);
+  priv->argv = g_strdupv (argv);
+  priv->runs = MAX (1, launcher_config_get_benchmark_runs (config));
+  priv->warmups = MAX (0, launcher_config_get_benchmark_warmups (config));
+
+  return benchmark;
+}
+
+/*
+ * Measures the startup of the program instead of the whole run. Every run 
+ * is a pair, first with the program and its libraries evicted from the 
+ * page cache and then again with them resident.
+ */
+LauncherBenchmark*
+launcher_benchmark_new_startup (LauncherConfig  *config,
+                                gchar          **argv)
+{
+  LauncherBenchmark *benchmark;
+  benchmark = launcher_benchmark_new (config, argv);
+  LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark)->mode = LAUNCHER_BENCHMARK_STARTUP;
+  return benchmark;
+}
+
+/*
+ * The affinity, priorities and limits applied to every run.
+ */
+void
+launcher_benchmark_set_resources (LauncherBenchmark *benchmark,
+                                  LauncherResources *resources)
+{
+  LauncherBenchmarkPrivate *priv;
+  priv = LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark);
+  if (priv->resources)
+    g_object_unref (priv->resources);
+  priv->resources = g_object_ref (resources);
+}
+
+/*
+ * The complete environment of every run, the one of the editor when NULL.
+ */
+void
+launcher_benchmark_set_environment (LauncherBenchmark  *benchmark,
+                                    gchar             **environment)
+{
+  LauncherBenchmarkPrivate *priv;
+  priv = LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark);
+  g_strfreev (priv->environment);
+  priv->environment = g_strdupv (environment);
+}
+
+void
+launcher_benchmark_run_async (LauncherBenchmark   *benchmark,
+                              GCancellable        *cancellable,
+                              GAsyncReadyCallback  callback,
+                              gpointer             user_data)
+{
+  GTask *task;
+  task = g_task_new (benchmark, cancellable, callback, user_data);
+  g_task_run_in_thread (task, (GTaskThreadFunc) run_thread);
+  g_object_unref (task);
+}
+
+gboolean
+launcher_benchmark_run_finish (LauncherBenchmark  *benchmark,
+                               GAsyncResult       *result,
+                               GError            **error)
+{
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/*
+ * The runs happen on a worker thread, one after the other, so that they do
+ * not compete with each other and the editor never waits on a child.
+ */
+static void
+run_thread (GTask             *task,
+            LauncherBenchmark *benchmark,
+            gpointer           task_data,
+            GCancellable      *cancellable)
+{
+  LauncherBenchmarkPrivate *priv;
+  GError *error = NULL;
+  gchar **files = NULL;
+  gchar **envp = NULL;
+  gchar *debug_folder = NULL;
+  gchar *debug_path = NULL;
+  gint total;
+  gint i;
+
+  priv = LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark);
+  
+  total = launcher_benchmark_get_total (benchmark);
+  
+  if (priv->mode == LAUNCHER_BENCHMARK_STARTUP)
+    {
+      debug_folder = g_dir_make_tmp ("launcher-startup-XXXXXX", &error);
+      if (debug_folder == NULL)
+        {
+          g_task_return_error (task, error);
+          return;
+        }
+      debug_path = g_build_filename (debug_folder, "ld", NULL);
+      envp = priv->environment != NULL ? g_strdupv (priv->environment) : g_get_environ ();
+      files = resolve_files (priv->argv[0], envp);
+      envp = g_environ_setenv (envp, "LD_DEBUG", "statistics", TRUE);
+      envp = g_environ_setenv (envp, "LD_DEBUG_OUTPUT", debug_path, TRUE);
+    }
+  
+  for (i = 0; i < total; i++)
+    {
+      LauncherBenchmarkSample sample;
+      gboolean success;
+      
+      if (g_task_return_error_if_cancelled (task))
+        break;
+      
+      if (priv->mode == LAUNCHER_BENCHMARK_STARTUP)
+        {
+          gboolean cold = i >= priv->warmups && (i - priv->warmups) % 2 == 0;
+          if (cold)
+            evict_files (files);
+          success = run_startup_once (benchmark, &sample, envp, debug_path, &error);
+          sample.cold = cold;
+        }
+      else
+        {
+          success = run_once (benchmark, &sample, &error);
+        }
+      
+      if (!success)
+        {
+          g_task_return_error (task, error);
+          break;
+        }
+      
+      if (i >= priv->warmups)
+        g_array_append_val (priv->samples, sample);
+      
+      g_atomic_int_inc (&priv->completed);
+      g_main_context_invoke_full (NULL, G_PRIORITY_DEFAULT, 
+                                  (GSourceFunc) progress_action,
+                                  g_object_ref (benchmark), g_object_unref);
+    }
+
+  if (i == total)
+    g_task_return_boolean (task, TRUE);
+  
+  if (debug_folder != NULL)
+    g_rmdir (debug_folder);
+  g_free (debug_folder);
+  g_free (debug_path);
+  g_strfreev (envp);
+  g_strfreev (files);
+}
+
+static gboolean
+run_once (LauncherBenchmark        *benchmark,
+          LauncherBenchmarkSample  *sample,
+          GError                  **error)
+{
+  LauncherBenchmarkPrivate *priv;
+  LauncherCounters *counters = NULL;
+  ChildSetup setup;
+  struct rusage usage;
+  gint64 start;
+  GPid pid;
+  gint status;
+  
+  priv = LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark);
+  
+  if (launcher_config_get_counters (priv->config))
+    counters = launcher_counters_new ();
+
+  setup.counters = counters;
+  setup.resources = priv->resources;
+
+  start = g_get_monotonic_time ();
+
+  if (!g_spawn_async (NULL, priv->argv, priv->environment, 
+                      G_SPAWN_DO_NOT_REAP_CHILD | G_SPAWN_SEARCH_PATH | G_SPAWN_SEARCH_PATH_FROM_ENVP | 
+                      G_SPAWN_STDOUT_TO_DEV_NULL | G_SPAWN_STDERR_TO_DEV_NULL,
+                      child_setup, &setup, &pid, error))
+    {
+      if (counters != NULL)
+        g_object_unref (counters);
+      return FALSE;
+    }
+  
+  if (counters != NULL)
+    launcher_counters_receive (counters);
+  
+  while (wait4 (pid, &status, 0, &usage) < 0)
+    {
+      if (errno != EINTR)
+        {
+          g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                       "Not able to wait for %s: %s", priv->argv[0], g_strerror (errno));
+          g_spawn_close_pid (pid);
+          if (counters != NULL)
+            g_object_unref (counters);
+          return FALSE;
+        }
+    }
+  
+  sample->wall_time = g_get_monotonic_time () - start;
+  sample->user_time = (gint64) usage.ru_utime.tv_sec * G_USEC_PER_SEC + usage.ru_utime.tv_usec;
+  sample->system_time = (gint64) usage.ru_stime.tv_sec * G_USEC_PER_SEC + usage.ru_stime.tv_usec;
+  sample->max_rss = usage.ru_maxrss;
+  sample->status = status;
+  sample->first_output = -1;
+  sample->linker_time = -1;
+  sample->cold = FALSE;
+  
+  memset (&sample->counters, 0, sizeof (LauncherCounterValues));
+  if (counters != NULL)
+    {
+      launcher_counters_read (counters, &sample->counters);
+      g_object_unref (counters);
+    }
+
+  g_spawn_close_pid (pid);
+  return TRUE;
+}
+
+/*
+ * The output is read, not thrown away, to see when the first byte arrives. 
+ * The dynamic loader writes its statistics to a file of its own so that 
+ * they do not mix with the output of the program.
+ */
+static gboolean
+run_startup_once (LauncherBenchmark        *benchmark,
+                  LauncherBenchmarkSample  *sample,
+                  gchar                   **envp,
+                  const gchar              *debug_path,
+                  GError                  **error)
+{
+  LauncherBenchmarkPrivate *priv;
+  ChildSetup setup;
+  struct pollfd fds[2];
+  struct rusage usage;
+  gint64 start;
+  GPid pid;
+  gint status;
+  gint open_fds;
+  gint i;
+  
+  priv = LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark);
+  
+  setup.counters = NULL;
+  setup.resources = priv->resources;
+  
+  start = g_get_monotonic_time ();
+
+  if (!g_spawn_async_with_pipes (NULL, priv->argv, envp, 
+                                 G_SPAWN_DO_NOT_REAP_CHILD | G_SPAWN_SEARCH_PATH | 
+                                 G_SPAWN_SEARCH_PATH_FROM_ENVP, 
+                                 child_setup, &setup, &pid, NULL, 
+                                 &fds[0].fd, &fds[1].fd, error))
+    return FALSE;
+  
+  sample->first_output = -1;
+  fds[0].events = fds[1].events = POLLIN;
+  open_fds = 2;
+  
+  while (open_fds > 0)
+    {
+      if (poll (fds, 2, -1) < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          break;
+        }
+
+      for (i = 0; i < 2; i++)
+        {
+          gchar buffer[4096];
+          gssize size;
+          
+          if (fds[i].fd < 0 || fds[i].revents == 0)
+            continue;
+
+          size = read (fds[i].fd, buffer, sizeof (buffer));
+          if (size > 0 && sample->first_output < 0)
+            sample->first_output = g_get_monotonic_time () - start;
+          
+          if (size == 0 || (size < 0 && errno != EINTR && errno != EAGAIN))
+            {
+              close (fds[i].fd);
+              fds[i].fd = -1;
+              open_fds--;
+            }
+        }
+    }
+  
+  for (i = 0; i < 2; i++)
+    if (fds[i].fd >= 0)
+      close (fds[i].fd);
+
+  while (wait4 (pid, &status, 0, &usage) < 0)
+    {
+      if (errno != EINTR)
+        {
+          g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                       "Not able to wait for %s: %s", priv->argv[0], g_strerror (errno));
+          g_spawn_close_pid (pid);
+          return FALSE;
+        }
+    }
+
+  sample->wall_time = g_get_monotonic_time () - start;
+  sample->user_time = (gint64) usage.ru_utime.tv_sec * G_USEC_PER_SEC + usage.ru_utime.tv_usec;
+  sample->system_time = (gint64) usage.ru_stime.tv_sec * G_USEC_PER_SEC + usage.ru_stime.tv_usec;
+  sample->max_rss = usage.ru_maxrss;
+  sample->status = status;
+  sample->linker_time = read_linker_time (debug_path, pid);
+  memset (&sample->counters, 0, sizeof (LauncherCounterValues));
+
+  g_spawn_close_pid (pid);
+  return TRUE;
+}
+
+/*
+ * The program and the libraries ldd resolves for it, which are the files 
+ * a cold start has to read from disk.
+ */
+static gchar**
+resolve_files (const gchar  *program,
+               gchar       **envp)
+{
+  GPtrArray *files;
+  gchar *path;
+  gchar *ldd_argv[3];
+  gchar *output = NULL;
+  
+  files = g_ptr_array_new ();
+  
+  path = g_find_program_in_path (program);
+  if (path == NULL)
+    {
+      g_ptr_array_add (files, NULL);
+      return (gchar**) g_ptr_array_free (files, FALSE);
+    }
+  
+  g_ptr_array_add (files, path);
+  
+  ldd_argv[0] = "ldd";
+  ldd_argv[1] = path;
+  ldd_argv[2] = NULL;
+  
+  if (g_spawn_sync (NULL, ldd_argv, envp, 
+                    G_SPAWN_SEARCH_PATH | G_SPAWN_STDERR_TO_DEV_NULL, 
+                    NULL, NULL, &output, NULL, NULL, NULL))
+    {
+      gchar **lines;
+      gchar **line;
+      
+      /* libc.so.6 => /lib64/libc.so.6 (0x...) or /lib64/ld-linux-x86-64.so.2 (0x...) */
+      lines = g_strsplit (output, "\n", -1);
+      for (line = lines; *line != NULL; line++)
+        {
+          gchar *file;
+          gchar *end;
+          
+          file = strstr (*line, "=> ");
+          file = file != NULL ? file + 3 : g_strstrip (*line);
+          if (*file != '/')
+            continue;
+          
+          end = strstr (file, " (");
+          g_ptr_array_add (files, end != NULL ? g_strndup (file, end - file) : g_strdup (file));
+        }
+      g_strfreev (lines);
+      g_free (output);
+    }
+  
+  g_ptr_array_add (files, NULL);
+  return (gchar**) g_ptr_array_free (files, FALSE);
+}
+
+/*
+ * Only clean pages that no other process maps can be dropped, so a 
+ * library like libc stays resident and the cold numbers are a lower bound.
+ */
+static void
+evict_files (gchar **files)
+{
+  for (; files != NULL && *files != NULL; files++)
+    {
+      gint fd;
+      fd = open (*files, O_RDONLY | O_CLOEXEC);
+      if (fd < 0)
+        continue;
+      posix_fadvise (fd, 0, 0, POSIX_FADV_DONTNEED);
+      close (fd);
+    }
+}
+
+/*
+ * Returns the cycles the dynamic loader spent before main, or -1 when the 
+ * statistics are missing, as with a static executable.
+ */
+static gint64
+read_linker_time (const gchar *debug_path,
+                  GPid         pid)
+{
+  gchar *path;
+  gchar *contents;
+  gint64 cycles = -1;
+  
+  path = g_strdup_printf ("%s.%d", debug_path, pid);
+  
+  if (g_file_get_contents (path, &contents, NULL, NULL))
+    {
+      gchar *line;
+      line = strstr (contents, "total startup time in dynamic loader:");
+      if (line != NULL)
+        cycles = g_ascii_strtoll (line + strlen ("total startup time in dynamic loader:"), 
+                                  NULL, 10);
+      g_free (contents);
+    }
+  
+  g_unlink (path);
+  g_free (path);
+  
+  return cycles;
+}
+
+/*
+ * Runs in the child before exec, the setup lives on the stack of the 
+ * spawning thread which waits for the fork.
+ */
+static void
+child_setup (gpointer data)
+{
+  ChildSetup *setup = data;
+  if (setup->resources != NULL)
+    launcher_resources_child_setup (setup->resources);
+  if (setup->counters != NULL)
+    launcher_counters_child_setup (setup->counters);
+}
+
+static gboolean
+progress_action (LauncherBenchmark *benchmark)
+{
+  g_signal_emit_by_name ((gpointer) benchmark, "progress");
+  return G_SOURCE_REMOVE;
+}
+
+LauncherConfig*
+launcher_benchmark_get_config (LauncherBenchmark *benchmark)
+{
+  return LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark)->config;
+}
+
+LauncherBenchmarkMode
+launcher_benchmark_get_mode (LauncherBenchmark *benchmark)
+{
+  return LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark)->mode;
+}
+
+guint
+launcher_benchmark_get_completed (LauncherBenchmark *benchmark)
+{
+  return g_atomic_int_get (&LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark)->completed);
+}
+
+guint
+launcher_benchmark_get_total (LauncherBenchmark *benchmark)
+{
+  LauncherBenchmarkPrivate *priv;
+  priv = LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark);
+  if (priv->mode == LAUNCHER_BENCHMARK_STARTUP)
+    return priv->warmups + priv->runs * 2;
+  return priv->warmups + priv->runs;
+}
+
+guint
+launcher_benchmark_get_n_samples (LauncherBenchmark *benchmark)
+{
+  return LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark)->samples->len;
+}
+
+const LauncherBenchmarkSample*
+launcher_benchmark_get_sample (LauncherBenchmark *benchmark,
+                               guint              index)
+{
+  LauncherBenchmarkPrivate *priv;
+  priv = LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark);
+  return &g_array_index (priv->samples, LauncherBenchmarkSample, index);
+}
+
+guint
+launcher_benchmark_get_n_failures (LauncherBenchmark *benchmark)
+{
+  LauncherBenchmarkPrivate *priv;
+  guint failures = 0;
+  guint i;
+  
+  priv = LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark);
+  
+  for (i = 0; i < priv->samples->len; i++)
+    {
+      LauncherBenchmarkSample *sample;
+      sample = &g_array_index (priv->samples, LauncherBenchmarkSample, i);
+      if (!WIFEXITED (sample->status) || WEXITSTATUS (sample->status) != 0)
+        failures++;
+    }
+  
+  return failures;
+}
+
+void
+launcher_benchmark_get_stats (LauncherBenchmark       *benchmark,
+                              LauncherBenchmarkMetric  metric,
+                              LauncherBenchmarkStats  *stats)
+{
+  compute_stats (benchmark, metric, -1, stats);
+}
+
+/*
+ * The stats of only the cold or only the warm runs of a startup benchmark.
+ */
+void
+launcher_benchmark_get_startup_stats (LauncherBenchmark       *benchmark,
+                                      LauncherBenchmarkMetric  metric,
+                                      gboolean                 cold,
+                                      LauncherBenchmarkStats  *stats)
+{
+  compute_stats (benchmark, metric, cold ? 1 : 0, stats);
+}
+
+/*
+ * Runs without a value for the metric, like a program that printed nothing, 
+ * are left out. A cold filter of -1 takes every run.
+ */
+static void
+compute_stats (LauncherBenchmark       *benchmark,
+               LauncherBenchmarkMetric  metric,
+               gint                     cold,
+               LauncherBenchmarkStats  *stats)
+{
+  LauncherBenchmarkPrivate *priv;
+  gdouble *values;
+  gdouble sum = 0;
+  gdouble squares = 0;
+  gdouble position;
+  guint lower;
+  guint n;
+  guint i;
+  
+  priv = LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark);
+  
+  memset (stats, 0, sizeof (LauncherBenchmarkStats));
+
+  values = g_new (gdouble, priv->samples->len);
+  n = 0;
+  for (i = 0; i < priv->samples->len; i++)
+    {
+      LauncherBenchmarkSample *sample;
+      gdouble value;
+      
+      sample = &g_array_index (priv->samples, LauncherBenchmarkSample, i);
+      if (cold >= 0 && sample->cold != cold)
+        continue;
+      
+      value = get_value (sample, metric);
+      if (value < 0)
+        continue;
+      
+      values[n++] = value;
+      sum += value;
+    }
+  
+  if (n == 0)
+    {
+      g_free (values);
+      return;
+    }
+
+  qsort (values, n, sizeof (gdouble), (GCompareFunc) compare_values);
+  
+  stats->min = values[0];
+  stats->mean = sum / n;
+  stats->median = n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+  
+  for (i = 0; i < n; i++)
+    squares += (values[i] - stats->mean) * (values[i] - stats->mean);
+  stats->stddev = n > 1 ? sqrt (squares / (n - 1)) : 0;
+
+  position = 0.95 * (n - 1);
+  lower = (guint) position;
+  if (lower + 1 < n)
+    stats->p95 = values[lower] + (position - lower) * (values[lower + 1] - values[lower]);
+  else
+    stats->p95 = values[lower];
+  
+  g_free (values);
+}
+
+const LauncherHistoryRegression*
+launcher_benchmark_get_regression (LauncherBenchmark *benchmark)
+{
+  return LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark)->regression;
+}
+
+void
+launcher_benchmark_set_regression (LauncherBenchmark               *benchmark,
+                                   const LauncherHistoryRegression *regression)
+{
+  LauncherBenchmarkPrivate *priv;
+  priv = LAUNCHER_BENCHMARK_GET_PRIVATE (benchmark);
+  g_free (priv->regression);
+  priv->regression = g_memdup (regression, sizeof (LauncherHistoryRegression));
+  g_signal_emit_by_name ((gpointer) benchmark, "regression");
+}
+
+static gdouble
+get_value (const LauncherBenchmarkSample *sample,
+           LauncherBenchmarkMetric        metric)
+{
+  switch (metric)
+    {
+    case LAUNCHER_BENCHMARK_WALL_TIME:
+      return sample->wall_time;
+    case LAUNCHER_BENCHMARK_USER_TIME:
+      return sample->user_time;
+    case LAUNCHER_BENCHMARK_SYSTEM_TIME:
+      return sample->system_time;
+    case LAUNCHER_BENCHMARK_MAX_RSS:
+      return sample->max_rss;
+    case LAUNCHER_BENCHMARK_CYCLES:
+      return sample->counters.values[LAUNCHER_COUNTER_CYCLES];
+    case LAUNCHER_BENCHMARK_INSTRUCTIONS:
+      return sample->counters.values[LAUNCHER_COUNTER_INSTRUCTIONS];
+    case LAUNCHER_BENCHMARK_IPC:
+      return MAX (launcher_counter_values_ratio (&sample->counters, LAUNCHER_COUNTER_INSTRUCTIONS, 
+                                                 LAUNCHER_COUNTER_CYCLES), 0);
+    case LAUNCHER_BENCHMARK_BRANCH_MISS_RATE:
+      return MAX (launcher_counter_values_ratio (&sample->counters, LAUNCHER_COUNTER_BRANCH_MISSES, 
+                                                 LAUNCHER_COUNTER_BRANCHES), 0);
+    case LAUNCHER_BENCHMARK_LLC_MISS_RATE:
+      return MAX (launcher_counter_values_ratio (&sample->counters, LAUNCHER_COUNTER_LLC_MISSES, 
+                                                 LAUNCHER_COUNTER_LLC_REFERENCES), 0);
+    case LAUNCHER_BENCHMARK_FIRST_OUTPUT:
+      return sample->first_output;
+    case LAUNCHER_BENCHMARK_LINKER_TIME:
+      return sample->linker_time;
+    }
+  return 0;
+}
+
+static gint
+compare_values (const gdouble *a,
+                const gdouble *b)
+{
+  if (*a < *b)
+    return -1;
+  if (*a > *b)
+    return 1;
+  return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_BENCHMARK_H__
+#define	__LAUNCHER_BENCHMARK_H__
+
+#include <gio/gio.h>
+#include "launcher-config.h"
+#include "launcher-history.h"
+#include "launcher-counters.h"
+#include "launcher-resources.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_BENCHMARK_TYPE            (launcher_benchmark_get_type ())
+#define LAUNCHER_BENCHMARK(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_BENCHMARK_TYPE, LauncherBenchmark))
+#define LAUNCHER_BENCHMARK_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_BENCHMARK_TYPE, LauncherBenchmarkClass))
+#define IS_LAUNCHER_BENCHMARK(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_BENCHMARK_TYPE))
+#define IS_LAUNCHER_BENCHMARK_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_BENCHMARK_TYPE))
+
+typedef struct _LauncherBenchmark LauncherBenchmark;
+typedef struct _LauncherBenchmarkClass LauncherBenchmarkClass;
+
+typedef enum
+{
+  LAUNCHER_BENCHMARK_RUN,
+  LAUNCHER_BENCHMARK_STARTUP
+} LauncherBenchmarkMode;
+
+typedef struct
+{
+  gint64   wall_time;
+  gint64   user_time;
+  gint64   system_time;
+  glong    max_rss;
+  gint     status;
+  gint64   first_output;
+  gint64   linker_time;
+  gboolean cold;
+  LauncherCounterValues counters;
+} LauncherBenchmarkSample;
+
+typedef enum
+{
+  LAUNCHER_BENCHMARK_WALL_TIME,
+  LAUNCHER_BENCHMARK_USER_TIME,
+  LAUNCHER_BENCHMARK_SYSTEM_TIME,
+  LAUNCHER_BENCHMARK_MAX_RSS,
+  LAUNCHER_BENCHMARK_CYCLES,
+  LAUNCHER_BENCHMARK_INSTRUCTIONS,
+  LAUNCHER_BENCHMARK_IPC,
+  LAUNCHER_BENCHMARK_BRANCH_MISS_RATE,
+  LAUNCHER_BENCHMARK_LLC_MISS_RATE,
+  LAUNCHER_BENCHMARK_FIRST_OUTPUT,
+  LAUNCHER_BENCHMARK_LINKER_TIME
+} LauncherBenchmarkMetric;
+
+typedef struct
+{
+  gdouble min;
+  gdouble median;
+  gdouble mean;
+  gdouble stddev;
+  gdouble p95;
+} LauncherBenchmarkStats;
+
+struct _LauncherBenchmark
+{
+  GObject parent_instance;
+};
+
+struct _LauncherBenchmarkClass
+{
+  GObjectClass parent_class;
+
+  void (*progress) (LauncherBenchmark *benchmark);
+  void (*regression) (LauncherBenchmark *benchmark);
+};
+
+GType launcher_benchmark_get_type (void) G_GNUC_CONST;
+
+LauncherBenchmark*             launcher_benchmark_new            (LauncherConfig          *config,
+                                                                  gchar                  **argv);
+LauncherBenchmark*             launcher_benchmark_new_startup    (LauncherConfig          *config,
+                                                                  gchar                  **argv);
+
+void                           launcher_benchmark_run_async      (LauncherBenchmark       *benchmark,
+                                                                  GCancellable            *cancellable,
+                                                                  GAsyncReadyCallback      callback,
+                                                                  gpointer                 user_data);
+gboolean                       launcher_benchmark_run_finish     (LauncherBenchmark       *benchmark,
+                                                                  GAsyncResult            *result,
+                                                                  GError                 **error);
+
+void                           launcher_benchmark_set_resources  (LauncherBenchmark       *benchmark,
+                                                                  LauncherResources       *resources);
+void                           launcher_benchmark_set_environment (LauncherBenchmark      *benchmark,
+                                                                   gchar                 **environment);
+
+LauncherConfig*                launcher_benchmark_get_config     (LauncherBenchmark       *benchmark);
+LauncherBenchmarkMode          launcher_benchmark_get_mode       (LauncherBenchmark       *benchmark);
+guint                          launcher_benchmark_get_completed  (LauncherBenchmark       *benchmark);
+guint                          launcher_benchmark_get_total      (LauncherBenchmark       *benchmark);
+guint                          launcher_benchmark_get_n_samples  (LauncherBenchmark       *benchmark);
+const LauncherBenchmarkSample* launcher_benchmark_get_sample     (LauncherBenchmark       *benchmark,
+                                                                  guint                    index);
+guint                          launcher_benchmark_get_n_failures (LauncherBenchmark       *benchmark);
+void                           launcher_benchmark_get_stats      (LauncherBenchmark       *benchmark,
+                                                                  LauncherBenchmarkMetric  metric,
+                                                                  LauncherBenchmarkStats  *stats);
+void                           launcher_benchmark_get_startup_stats (LauncherBenchmark    *benchmark,
+                                                                  LauncherBenchmarkMetric  metric,
+                                                                  gboolean                 cold,
+                                                                  LauncherBenchmarkStats  *stats);
+
+const LauncherHistoryRegression* launcher_benchmark_get_regression (LauncherBenchmark *benchmark);
+void                           launcher_benchmark_set_regression (LauncherBenchmark       *benchmark,
+                                                                  const LauncherHistoryRegression *regression);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_BENCHMARK_H__ */
@@ -0,0 +1,538 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include <sys/stat.h>
+#include "launcher-build.h"
+
+/*
+ * Tracks whether the executable is older than the sources of the project, 
+ * so that the build command only runs when there is something to build.
+ *
+ * The project folder is walked once in a thread to find the newest source 
+ * file and every directory gets a file monitor. From then on a changed 
+ * source only costs a stat of that one file, and deciding whether to build 
+ * costs a stat of the executable instead of the stat of the whole tree a 
+ * no-op make does. Deleted and moved sources can not be compared by time, 
+ * they simply mark the build as dirty until the next build finishes.
+ *
+ * Files and folders matching the ignore patterns, checked against both the 
+ * name and the path relative to the project folder, are never looked at. 
+ * Every change to a source emits "changed" so watch mode can rerun.
+ */
+
+static void launcher_build_class_init  (LauncherBuildClass *klass);
+static void launcher_build_init        (LauncherBuild      *build);
+static void launcher_build_finalize    (LauncherBuild      *build);
+
+typedef struct
+{
+  gchar     *folder_path;
+  gchar    **ignore_patterns;
+} ScanData;
+
+typedef struct
+{
+  GPtrArray *directories;
+  gint64     newest_mtime;
+} Scan;
+
+static void scan_thread                (GTask              *task,
+                                        gpointer            source,
+                                        ScanData           *data,
+                                        GCancellable       *cancellable);
+static void scanned_action             (GObject            *source,
+                                        GAsyncResult       *result,
+                                        LauncherBuild      *build);
+static void monitor_directory          (LauncherBuild      *build,
+                                        const gchar        *path);
+static void changed_action             (GFileMonitor       *monitor,
+                                        GFile              *file,
+                                        GFile              *other_file,
+                                        GFileMonitorEvent   event,
+                                        LauncherBuild      *build);
+static gboolean is_source              (const gchar        *name);
+static void source_changed             (LauncherBuild      *build);
+static gboolean is_ignored             (gchar             **ignore_patterns,
+                                        const gchar        *folder_path,
+                                        const gchar        *path,
+                                        const gchar        *name);
+static gint64 get_mtime                (const gchar        *path);
+static void scan_free                  (Scan               *scan);
+static void scan_data_free             (ScanData           *data);
+
+#define LAUNCHER_BUILD_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_BUILD_TYPE, LauncherBuildPrivate))
+
+typedef struct _LauncherBuildPrivate LauncherBuildPrivate;
+
+struct _LauncherBuildPrivate
+{
+  gchar        *folder_path;
+  gchar       **ignore_patterns;
+  GHashTable   *monitors;
+  GCancellable *cancellable;
+  gboolean      scanned;
+  gint64        newest_mtime;
+  gboolean      dirty;
+  guint         serial;
+  gint64        change_time;
+};
+
+enum
+{
+  CHANGED,
+  LAST_SIGNAL
+};
+
+static guint launcher_build_signals[LAST_SIGNAL] = { 0 };
+
+static const gchar *source_suffixes[] = {
+  ".c", ".h", ".cc", ".cpp", ".cxx", ".hh", ".hpp", ".hxx", ".inl", ".ipp", 
+  ".y", ".l", ".s", ".S", ".asm", ".f", ".f90", ".rs", ".go", ".java", ".vala",
+  ".am", ".ac", ".in", ".mk", ".cmake", ".pc", ".sh", NULL
+};
+
+static const gchar *source_names[] = {
+  "Makefile", "makefile", "GNUmakefile", "CMakeLists.txt", "meson.build", 
+  "Cargo.toml", "build.ninja", NULL
+};
+
+G_DEFINE_TYPE (LauncherBuild, launcher_build, G_TYPE_OBJECT)
+
+static void
+launcher_build_class_init (LauncherBuildClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  launcher_build_signals[CHANGED] =
+    g_signal_new ("changed", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherBuildClass, changed),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_build_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherBuildPrivate));
+}
+
+static void
+launcher_build_init (LauncherBuild *build)
+{
+  LauncherBuildPrivate *priv;
+  priv = LAUNCHER_BUILD_GET_PRIVATE (build);
+  priv->folder_path = NULL;
+  priv->ignore_patterns = NULL;
+  priv->monitors = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, 
+                                          (GDestroyNotify) g_object_unref);
+  priv->cancellable = g_cancellable_new ();
+  priv->scanned = FALSE;
+  priv->newest_mtime = 0;
+  priv->dirty = FALSE;
+  priv->serial = 0;
+  priv->change_time = 0;
+}
+
+static void
+launcher_build_finalize (LauncherBuild *build)
+{
+  LauncherBuildPrivate *priv;
+  GHashTableIter iter;
+  gpointer monitor;
+  
+  priv = LAUNCHER_BUILD_GET_PRIVATE (build);
+  
+  g_cancellable_cancel (priv->cancellable);
+  g_object_unref (priv->cancellable);
+  
+  g_hash_table_iter_init (&iter, priv->monitors);
+  while (g_hash_table_iter_next (&iter, NULL, &monitor))
+    {
+      g_signal_handlers_disconnect_by_func (monitor, changed_action, build);
+      g_file_monitor_cancel (monitor);
+    }
+  g_hash_table_destroy (priv->monitors);
+  g_free (priv->folder_path);
+  g_strfreev (priv->ignore_patterns);
+
+  G_OBJECT_CLASS (launcher_build_parent_class)->finalize (G_OBJECT (build));
+}
+
+/*
+ * The ignore patterns are separated by semicolons or spaces, for example 
+ * "build;*.log;doc/*".
+ */
+LauncherBuild*
+launcher_build_new (const gchar *folder_path,
+                    const gchar *ignore_patterns)
+{
+  LauncherBuildPrivate *priv;
+  LauncherBuild *build;
+  ScanData *data;
+  GTask *task;
+
+  build = LAUNCHER_BUILD (g_object_new (launcher_build_get_type (), NULL));
+  priv = LAUNCHER_BUILD_GET_PRIVATE (build);
+  
+  priv->folder_path = g_strdup (folder_path);
+  priv->ignore_patterns = g_strsplit_set (ignore_patterns != NULL ? ignore_patterns : "", 
+                                          "; ", -1);
+
+  data = g_slice_new (ScanData);
+  data->folder_path = g_strdup (folder_path);
+  data->ignore_patterns = g_strdupv (priv->ignore_patterns);
+
+  /* the scan does not keep the build alive, finalize cancels it */
+  task = g_task_new (NULL, priv->cancellable, (GAsyncReadyCallback) scanned_action, build);
+  g_task_set_task_data (task, data, (GDestroyNotify) scan_data_free);
+  g_task_run_in_thread (task, (GTaskThreadFunc) scan_thread);
+  g_object_unref (task);
+
+  return build;
+}
+
+/*
+ * Until the first scan is done nothing is known and the build has to run.
+ */
+gboolean
+launcher_build_is_stale (LauncherBuild *build,
+                         const gchar   *executable)
+{
+  LauncherBuildPrivate *priv;
+  gint64 mtime;
+  
+  priv = LAUNCHER_BUILD_GET_PRIVATE (build);
+  
+  if (!priv->scanned || priv->dirty)
+    return TRUE;
+  
+  mtime = get_mtime (executable);
+  return mtime < 0 || priv->newest_mtime > mtime;
+}
+
+/*
+ * A source deleted while the build runs must still count, so finishing only 
+ * clears the dirty flag when nothing happened since the build began.
+ */
+guint
+launcher_build_begin (LauncherBuild *build)
+{
+  return LAUNCHER_BUILD_GET_PRIVATE (build)->serial;
+}
+
+void
+launcher_build_finish (LauncherBuild *build,
+                       guint          serial)
+{
+  LauncherBuildPrivate *priv;
+  priv = LAUNCHER_BUILD_GET_PRIVATE (build);
+  if (priv->serial == serial)
+    priv->dirty = FALSE;
+}
+
+/*
+ * The monotonic time of the most recent change to a source.
+ */
+gint64
+launcher_build_get_change_time (LauncherBuild *build)
+{
+  return LAUNCHER_BUILD_GET_PRIVATE (build)->change_time;
+}
+
+static void
+scan_thread (GTask         *task,
+             gpointer       source,
+             ScanData      *data,
+             GCancellable  *cancellable)
+{
+  Scan *scan;
+  GQueue queue = G_QUEUE_INIT;
+  gchar *path;
+  
+  scan = g_slice_new (Scan);
+  scan->directories = g_ptr_array_new_with_free_func (g_free);
+  scan->newest_mtime = 0;
+  
+  g_queue_push_tail (&queue, g_strdup (data->folder_path));
+  
+  while ((path = g_queue_pop_head (&queue)) != NULL)
+    {
+      const gchar *name;
+      GDir *dir;
+      
+      if (g_cancellable_is_cancelled (cancellable))
+        {
+          g_free (path);
+          continue;
+        }
+      
+      dir = g_dir_open (path, 0, NULL);
+      if (dir == NULL)
+        {
+          g_free (path);
+          continue;
+        }
+      
+      while ((name = g_dir_read_name (dir)) != NULL)
+        {
+          gchar *child;
+          
+          child = g_build_filename (path, name, NULL);
+          
+          if (is_ignored (data->ignore_patterns, data->folder_path, child, name))
+            {
+              g_free (child);
+              continue;
+            }
+          
+          if (g_file_test (child, G_FILE_TEST_IS_DIR) && 
+              !g_file_test (child, G_FILE_TEST_IS_SYMLINK))
+            {
+              g_queue_push_tail (&queue, child);
+              continue;
+            }
+          
+          if (is_source (name))
+            scan->newest_mtime = MAX (scan->newest_mtime, get_mtime (child));
+
+          g_free (child);
+        }
+      
+      g_dir_close (dir);
+      g_ptr_array_add (scan->directories, path);
+    }
+  
+  if (g_cancellable_is_cancelled (cancellable))
+    {
+      scan_free (scan);
+      g_task_return_error_if_cancelled (task);
+      return;
+    }
+  
+  g_task_return_pointer (task, scan, (GDestroyNotify) scan_free);
+}
+
+/*
+ * A cancelled task never returns the scan, so the build is still alive 
+ * whenever there is one.
+ */
+static void
+scanned_action (GObject       *source,
+                GAsyncResult  *result,
+                LauncherBuild *build)
+{
+  LauncherBuildPrivate *priv;
+  Scan *scan;
+  guint i;
+  
+  scan = g_task_propagate_pointer (G_TASK (result), NULL);
+  if (scan == NULL)
+    return;
+  
+  priv = LAUNCHER_BUILD_GET_PRIVATE (build);
+  
+  for (i = 0; i < scan->directories->len; i++)
+    monitor_directory (build, g_ptr_array_index (scan->directories, i));
+  
+  priv->newest_mtime = MAX (priv->newest_mtime, scan->newest_mtime);
+  priv->scanned = TRUE;
+  
+  scan_free (scan);
+}
+
+static void
+monitor_directory (LauncherBuild *build,
+                   const gchar   *path)
+{
+  LauncherBuildPrivate *priv;
+  GFileMonitor *monitor;
+  GFile *file;
+  
+  priv = LAUNCHER_BUILD_GET_PRIVATE (build);
+  
+  if (g_hash_table_contains (priv->monitors, path))
+    return;
+  
+  file = g_file_new_for_path (path);
+  monitor = g_file_monitor_directory (file, G_FILE_MONITOR_NONE, NULL, NULL);
+  g_object_unref (file);
+  
+  if (monitor == NULL)
+    return;
+  
+  g_signal_connect (G_OBJECT (monitor), "changed",
+                    G_CALLBACK (changed_action), build);
+  g_hash_table_insert (priv->monitors, g_strdup (path), monitor);
+}
+
+static void
+changed_action (GFileMonitor      *monitor,
+                GFile             *file,
+                GFile             *other_file,
+                GFileMonitorEvent  event,
+                LauncherBuild     *build)
+{
+  LauncherBuildPrivate *priv;
+  gchar *path;
+  gchar *name;
+  
+  priv = LAUNCHER_BUILD_GET_PRIVATE (build);
+  
+  path = g_file_get_path (file);
+  name = g_file_get_basename (file);
+  
+  if (path == NULL || is_ignored (priv->ignore_patterns, priv->folder_path, path, name))
+    {
+      g_free (path);
+      g_free (name);
+      return;
+    }
+  
+  switch (event)
+    {
+    case G_FILE_MONITOR_EVENT_CREATED:
+      if (g_file_test (path, G_FILE_TEST_IS_DIR))
+        {
+          /* whatever was moved in with it has not been seen yet */
+          monitor_directory (build, path);
+          priv->dirty = TRUE;
+          priv->serial++;
+          source_changed (build);
+          break;
+        }
+      /* fall through */
+    case G_FILE_MONITOR_EVENT_CHANGED:
+    case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+    case G_FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED:
+      if (is_source (name))
+        {
+          priv->newest_mtime = MAX (priv->newest_mtime, get_mtime (path));
+          source_changed (build);
+        }
+      break;
+    case G_FILE_MONITOR_EVENT_DELETED:
+    case G_FILE_MONITOR_EVENT_MOVED:
+      if (is_source (name) || g_hash_table_remove (priv->monitors, path))
+        {
+          priv->dirty = TRUE;
+          priv->serial++;
+          source_changed (build);
+        }
+      break;
+    default:
+      break;
+    }
+  
+  g_free (path);
+  g_free (name);
+}
+
+static void
+source_changed (LauncherBuild *build)
+{
+  LauncherBuildPrivate *priv;
+  priv = LAUNCHER_BUILD_GET_PRIVATE (build);
+  priv->change_time = g_get_monotonic_time ();
+  g_signal_emit_by_name ((gpointer) build, "changed");
+}
+
+static gboolean
+is_source (const gchar *name)
+{
+  const gchar *suffix;
+  gint i;
+  
+  for (i = 0; source_names[i] != NULL; i++)
+    if (strcmp (name, source_names[i]) == 0)
+      return TRUE;
+  
+  suffix = strrchr (name, '.');
+  if (suffix == NULL)
+    return FALSE;
+  
+  for (i = 0; source_suffixes[i] != NULL; i++)
+    if (strcmp (suffix, source_suffixes[i]) == 0)
+      return TRUE;
+  
+  return FALSE;
+}
+
+/*
+ * Hidden files and folders are version control data and editor backups 
+ * and are always ignored.
+ */
+static gboolean
+is_ignored (gchar       **ignore_patterns,
+            const gchar  *folder_path,
+            const gchar  *path,
+            const gchar  *name)
+{
+  const gchar *relative_path;
+  gsize length;
+  gint i;
+  
+  if (name == NULL || name[0] == '.')
+    return TRUE;
+  
+  length = strlen (folder_path);
+  relative_path = path;
+  if (strncmp (path, folder_path, length) == 0 && path[length] == G_DIR_SEPARATOR)
+    relative_path = path + length + 1;
+  
+  for (i = 0; ignore_patterns[i] != NULL; i++)
+    {
+      if (*ignore_patterns[i] == '\0')
+        continue;
+      if (g_pattern_match_simple (ignore_patterns[i], name) ||
+          g_pattern_match_simple (ignore_patterns[i], relative_path))
+        return TRUE;
+    }
+  
+  return FALSE;
+}
+
+/*
+ * Nanoseconds matter, a generated header written in the same second as 
+ * the link would otherwise look newer than the executable forever.
+ */
+static gint64
+get_mtime (const gchar *path)
+{
+  struct stat st;
+  
+  if (stat (path, &st) != 0)
+    return -1;
+  
+  return (gint64) st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+static void
+scan_free (Scan *scan)
+{
+  g_ptr_array_free (scan->directories, TRUE);
+  g_slice_free (Scan, scan);
+}
+
+static void
+scan_data_free (ScanData *data)
+{
+  g_free (data->folder_path);
+  g_strfreev (data->ignore_patterns);
+  g_slice_free (ScanData, data);
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_BUILD_H__
+#define	__LAUNCHER_BUILD_H__
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_BUILD_TYPE            (launcher_build_get_type ())
+#define LAUNCHER_BUILD(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_BUILD_TYPE, LauncherBuild))
+#define LAUNCHER_BUILD_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_BUILD_TYPE, LauncherBuildClass))
+#define IS_LAUNCHER_BUILD(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_BUILD_TYPE))
+#define IS_LAUNCHER_BUILD_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_BUILD_TYPE))
+
+typedef struct _LauncherBuild LauncherBuild;
+typedef struct _LauncherBuildClass LauncherBuildClass;
+
+struct _LauncherBuild
+{
+  GObject parent_instance;
+};
+
+struct _LauncherBuildClass
+{
+  GObjectClass parent_class;
+
+  void (*changed) (LauncherBuild *build);
+};
+
+GType launcher_build_get_type (void) G_GNUC_CONST;
+
+LauncherBuild*  launcher_build_new       (const gchar   *folder_path,
+                                          const gchar   *ignore_patterns);
+
+gboolean        launcher_build_is_stale  (LauncherBuild *build,
+                                          const gchar   *executable);
+guint           launcher_build_begin     (LauncherBuild *build);
+void            launcher_build_finish    (LauncherBuild *build,
+                                          guint          serial);
+gint64          launcher_build_get_change_time (LauncherBuild *build);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_BUILD_H__ */
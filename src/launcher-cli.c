@@ -0,0 +1,792 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <glib-unix.h>
+#include "launcher-core.h"
+#include "launcher-crash.h"
+#include "launcher-hang.h"
+
+/*
+ * Runs a launcher.conf without the editor, so that a build machine can 
+ * launch and measure a program exactly the way the plugin does. The 
+ * launcher.conf lives in the project config folder, which is also where 
+ * the profiles and the cores of crashed runs are written.
+ *
+ *   codeslayer-launcher run|benchmark|startup|sweep LAUNCHER.CONF
+ */
+
+#define PROFILES "profiles"
+#define CRASHES "crashes"
+#define TERMINATE_TIMEOUT 3000
+
+typedef enum
+{
+  COMMAND_RUN,
+  COMMAND_BENCHMARK,
+  COMMAND_STARTUP,
+  COMMAND_SWEEP
+} Command;
+
+typedef struct
+{
+  GMainLoop            *loop;
+  LauncherConfig       *config;
+  Command               command;
+  gchar                *profiles_folder;
+  gchar                *crashes_folder;
+  GCancellable         *cancellable;
+  LauncherProcess      *process;
+  LauncherOutputBuffer *buffer;
+  guint64               printed_lines;
+  gboolean              building;
+  gboolean              collecting;
+  gint                  status;
+} Cli;
+
+static gboolean parse_command     (const gchar           *name,
+                                   Command               *command);
+static LauncherConfig* load_config (const gchar          *file_path,
+                                   const gchar           *profile,
+                                   const gchar           *project_folder,
+                                   GError               **error);
+static void start_command         (Cli                   *cli);
+static void start_build           (Cli                   *cli);
+static void start_process         (Cli                   *cli);
+static void watch_process         (Cli                   *cli,
+                                   LauncherProcess       *process,
+                                   GCallback              finished);
+static void build_finished_action (Cli                   *cli,
+                                   LauncherProcess       *process);
+static void process_finished_action (Cli                 *cli,
+                                   LauncherProcess       *process);
+static void process_gone_action   (Cli                   *cli,
+                                   GObject               *process);
+static void crash_collected_action (GObject              *source,
+                                   GAsyncResult          *result,
+                                   Cli                   *cli);
+static void process_hung_action   (Cli                   *cli,
+                                   LauncherProcess       *process);
+static void hang_sampled_action   (GObject               *source,
+                                   GAsyncResult          *result,
+                                   LauncherProcess       *process);
+static void print_lines           (Cli                   *cli);
+static gint get_exit_code         (LauncherProcess       *process);
+static void start_benchmark       (Cli                   *cli,
+                                   LauncherBenchmarkMode  mode);
+static void benchmark_finished_action (LauncherBenchmark *benchmark,
+                                   GAsyncResult          *result,
+                                   Cli                   *cli);
+static void print_stats           (const gchar           *name,
+                                   LauncherBenchmarkStats *stats,
+                                   const gchar           *unit,
+                                   gdouble                scale);
+static void print_startup_stats   (LauncherBenchmark     *benchmark,
+                                   const gchar           *name,
+                                   LauncherBenchmarkMetric metric,
+                                   const gchar           *unit,
+                                   gdouble                scale);
+static void start_sweep           (Cli                   *cli);
+static void sweep_finished_action (LauncherSweep         *sweep,
+                                   GAsyncResult          *result,
+                                   Cli                   *cli);
+static gchar* quote_csv           (const gchar           *value);
+static gboolean interrupt_action  (Cli                   *cli);
+static void fail                  (Cli                   *cli,
+                                   GError                *error);
+
+static gchar *profile = NULL;
+static gchar *project_folder = NULL;
+static gchar *active_file = NULL;
+static gboolean build = FALSE;
+static gint runs = 0;
+static gint warmups = -1;
+
+static GOptionEntry entries[] = 
+{
+  { "profile", 'p', 0, G_OPTION_ARG_STRING, &profile, 
+    "The profile to launch instead of the main one", "NAME" },
+  { "project-folder", 'd', 0, G_OPTION_ARG_FILENAME, &project_folder, 
+    "The folder of the project, the current folder when not given", "FOLDER" },
+  { "file", 'f', 0, G_OPTION_ARG_FILENAME, &active_file, 
+    "The file that ${ACTIVE_FILE} expands to", "FILE" },
+  { "build", 'b', 0, G_OPTION_ARG_NONE, &build, 
+    "Run the build command first and only launch when it succeeds", NULL },
+  { "runs", 'r', 0, G_OPTION_ARG_INT, &runs, 
+    "The number of benchmark runs instead of the configured one", "N" },
+  { "warmups", 'w', 0, G_OPTION_ARG_INT, &warmups, 
+    "The number of benchmark warmups instead of the configured one", "N" },
+  { NULL }
+};
+
+int
+main (int   argc,
+      char *argv[])
+{
+  GOptionContext *context;
+  Cli cli;
+  gchar *config_folder;
+  GError *error = NULL;
+  
+  context = g_option_context_new ("run|benchmark|startup|sweep LAUNCHER.CONF");
+  g_option_context_set_summary (context, "Launches the program of a launcher.conf "
+                                         "the way the launcher plugin does.");
+  g_option_context_add_main_entries (context, entries, NULL);
+  
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      g_error_free (error);
+      g_option_context_free (context);
+      return 2;
+    }
+  
+  memset (&cli, 0, sizeof (Cli));
+  
+  if (argc != 3 || !parse_command (argv[1], &cli.command))
+    {
+      gchar *help = g_option_context_get_help (context, TRUE, NULL);
+      g_printerr ("%s", help);
+      g_free (help);
+      g_option_context_free (context);
+      return 2;
+    }
+  
+  g_option_context_free (context);
+  
+  if (project_folder == NULL)
+    project_folder = g_get_current_dir ();
+  
+  cli.config = load_config (argv[2], profile, project_folder, &error);
+  if (cli.config == NULL)
+    {
+      g_printerr ("%s\n", error->message);
+      g_error_free (error);
+      return 2;
+    }
+  
+  if (runs > 0)
+    launcher_config_set_benchmark_runs (cli.config, runs);
+  if (warmups >= 0)
+    launcher_config_set_benchmark_warmups (cli.config, warmups);
+  
+  config_folder = g_path_get_dirname (argv[2]);
+  cli.profiles_folder = g_build_filename (config_folder, PROFILES, NULL);
+  cli.crashes_folder = g_build_filename (config_folder, CRASHES, NULL);
+  g_free (config_folder);
+  
+  cli.loop = g_main_loop_new (NULL, FALSE);
+  cli.cancellable = g_cancellable_new ();
+  
+  g_unix_signal_add (SIGINT, (GSourceFunc) interrupt_action, &cli);
+  g_unix_signal_add (SIGTERM, (GSourceFunc) interrupt_action, &cli);
+  
+  if (build && launcher_config_get_build_command (cli.config) != NULL &&
+      *launcher_config_get_build_command (cli.config) != '\0')
+    start_build (&cli);
+  else
+    start_command (&cli);
+  
+  g_main_loop_run (cli.loop);
+  
+  g_main_loop_unref (cli.loop);
+  g_object_unref (cli.cancellable);
+  g_object_unref (cli.config);
+  g_free (cli.profiles_folder);
+  g_free (cli.crashes_folder);
+  g_free (project_folder);
+  g_free (profile);
+  g_free (active_file);
+  
+  return cli.status;
+}
+
+static gboolean
+parse_command (const gchar *name,
+               Command     *command)
+{
+  if (g_strcmp0 (name, "run") == 0)
+    *command = COMMAND_RUN;
+  else if (g_strcmp0 (name, "benchmark") == 0)
+    *command = COMMAND_BENCHMARK;
+  else if (g_strcmp0 (name, "startup") == 0)
+    *command = COMMAND_STARTUP;
+  else if (g_strcmp0 (name, "sweep") == 0)
+    *command = COMMAND_SWEEP;
+  else
+    return FALSE;
+  return TRUE;
+}
+
+/*
+ * The path of the launcher.conf tells projects apart, the way the plugin 
+ * uses its project.
+ */
+static LauncherConfig*
+load_config (const gchar  *file_path,
+             const gchar  *profile,
+             const gchar  *project_folder,
+             GError      **error)
+{
+  LauncherConfig *config;
+  GKeyFile *key_file;
+  gchar *project_name;
+  
+  key_file = g_key_file_new ();
+  if (!g_key_file_load_from_file (key_file, file_path, G_KEY_FILE_NONE, error))
+    {
+      g_key_file_free (key_file);
+      return NULL;
+    }
+  
+  project_name = g_path_get_basename (project_folder);
+  config = launcher_core_load_config (key_file, profile, (gpointer) file_path, 
+                                      project_name, project_folder);
+  g_free (project_name);
+  g_key_file_free (key_file);
+  
+  if (profile != NULL && g_strcmp0 (launcher_config_get_name (config), profile) != 0)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND, 
+                   "There is no profile %s in %s", profile, file_path);
+      g_object_unref (config);
+      return NULL;
+    }
+  
+  if (launcher_config_get_executable (config) == NULL ||
+      *launcher_config_get_executable (config) == '\0')
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, 
+                   "There is no executable in %s", file_path);
+      g_object_unref (config);
+      return NULL;
+    }
+  
+  return config;
+}
+
+static void
+start_command (Cli *cli)
+{
+  const gchar *parameters;
+  
+  parameters = launcher_config_get_parameters (cli->config);
+  
+  switch (cli->command)
+    {
+    case COMMAND_RUN:
+      if (launcher_sweep_has_placeholders (parameters))
+        start_sweep (cli);
+      else
+        start_process (cli);
+      break;
+    case COMMAND_BENCHMARK:
+      start_benchmark (cli, LAUNCHER_BENCHMARK_RUN);
+      break;
+    case COMMAND_STARTUP:
+      start_benchmark (cli, LAUNCHER_BENCHMARK_STARTUP);
+      break;
+    case COMMAND_SWEEP:
+      start_sweep (cli);
+      break;
+    }
+}
+
+static void
+start_build (Cli *cli)
+{
+  LauncherProcess *process;
+  GError *error = NULL;
+  
+  process = launcher_core_spawn_build (cli->config, active_file, &error);
+  if (process == NULL)
+    {
+      fail (cli, error);
+      return;
+    }
+  
+  cli->building = TRUE;
+  watch_process (cli, process, G_CALLBACK (build_finished_action));
+}
+
+static void
+start_process (Cli *cli)
+{
+  LauncherProcess *process;
+  GError *error = NULL;
+  
+  process = launcher_core_spawn_process (cli->config, active_file, 
+                                         cli->profiles_folder, &error);
+  if (process == NULL)
+    {
+      fail (cli, error);
+      return;
+    }
+  
+  watch_process (cli, process, G_CALLBACK (process_finished_action));
+  g_signal_connect_swapped (G_OBJECT (process), "hung",
+                            G_CALLBACK (process_hung_action), cli);
+}
+
+/*
+ * The process stays alive until both of its pipes are closed, so the 
+ * output is only complete once the last reference is gone, which can be 
+ * well after the program exited. The buffer is kept for that last look.
+ */
+static void
+watch_process (Cli             *cli,
+               LauncherProcess *process,
+               GCallback        finished)
+{
+  cli->process = process;
+  cli->buffer = g_object_ref (launcher_process_get_output (process));
+  cli->printed_lines = 0;
+  
+  g_signal_connect_swapped (G_OBJECT (cli->buffer), "changed",
+                            G_CALLBACK (print_lines), cli);
+  g_signal_connect_swapped (G_OBJECT (process), "finished", finished, cli);
+  g_object_weak_ref (G_OBJECT (process), (GWeakNotify) process_gone_action, cli);
+}
+
+static void
+build_finished_action (Cli             *cli,
+                       LauncherProcess *process)
+{
+  cli->status = get_exit_code (process);
+  if (cli->status != 0)
+    g_printerr ("The build failed: %s\n", launcher_config_get_build_command (cli->config));
+  g_object_unref (process);
+}
+
+/*
+ * A crash keeps the loop running until its backtrace has been printed.
+ */
+static void
+process_finished_action (Cli             *cli,
+                         LauncherProcess *process)
+{
+  cli->status = get_exit_code (process);
+  
+  if (launcher_process_get_state (process) == LAUNCHER_PROCESS_SIGNALED &&
+      launcher_process_get_core_dumped (process))
+    {
+      cli->collecting = TRUE;
+      launcher_crash_collect_async (launcher_process_get_pid (process), 
+                                    launcher_process_get_exit_status (process),
+                                    launcher_process_get_program (process),
+                                    launcher_process_get_working_directory (process),
+                                    cli->crashes_folder, cli->cancellable, 
+                                    (GAsyncReadyCallback) crash_collected_action, cli);
+    }
+  
+  g_object_unref (process);
+}
+
+static void
+crash_collected_action (GObject      *source,
+                        GAsyncResult *result,
+                        Cli          *cli)
+{
+  LauncherCrash *crash;
+  GError *error = NULL;
+  
+  cli->collecting = FALSE;
+  
+  crash = launcher_crash_collect_finish (result, &error);
+  if (crash != NULL)
+    {
+      g_printerr ("%s crashed, the core is %s\n%s", 
+                  launcher_crash_get_program (crash),
+                  launcher_crash_get_core_path (crash),
+                  launcher_crash_get_backtrace (crash));
+      g_object_unref (crash);
+    }
+  else
+    {
+      if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        g_printerr ("No backtrace of the crash: %s\n", error->message);
+      g_error_free (error);
+    }
+  
+  if (cli->process == NULL)
+    g_main_loop_quit (cli->loop);
+}
+
+/*
+ * The stacks go to stderr before the run is terminated, the sampling keeps 
+ * a reference so the loop waits for it.
+ */
+static void
+process_hung_action (Cli             *cli,
+                     LauncherProcess *process)
+{
+  gchar *reason;
+  reason = launcher_process_get_hang_reason (process);
+  launcher_hang_sample_async (launcher_process_get_pid (process), reason, 
+                              cli->cancellable, 
+                              (GAsyncReadyCallback) hang_sampled_action, 
+                              g_object_ref (process));
+  g_free (reason);
+}
+
+static void
+hang_sampled_action (GObject         *source,
+                     GAsyncResult    *result,
+                     LauncherProcess *process)
+{
+  LauncherHang *hang;
+  GError *error = NULL;
+  
+  hang = launcher_hang_sample_finish (result, &error);
+  if (hang != NULL)
+    {
+      gchar *stacks;
+      stacks = launcher_hang_format (hang);
+      g_printerr ("%s hung, %s\n%s", 
+                  launcher_config_get_executable (launcher_process_get_config (process)),
+                  launcher_hang_get_reason (hang), stacks);
+      g_free (stacks);
+      g_object_unref (hang);
+    }
+  else
+    {
+      if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        g_printerr ("No stacks of the hung run: %s\n", error->message);
+      g_error_free (error);
+    }
+  
+  launcher_process_terminate (process, TERMINATE_TIMEOUT);
+  g_object_unref (process);
+}
+
+/*
+ * Starts the launch once a successful build has written all its output.
+ */
+static void
+process_gone_action (Cli     *cli,
+                     GObject *process)
+{
+  print_lines (cli);
+  
+  g_signal_handlers_disconnect_by_func (cli->buffer, print_lines, cli);
+  g_object_unref (cli->buffer);
+  cli->buffer = NULL;
+  
+  cli->process = NULL;
+  
+  if (cli->building && cli->status == 0 && !g_cancellable_is_cancelled (cli->cancellable))
+    {
+      cli->building = FALSE;
+      start_command (cli);
+      return;
+    }
+  
+  if (!cli->collecting)
+    g_main_loop_quit (cli->loop);
+}
+
+/*
+ * Lines the ring dropped before they were printed are lost, which only 
+ * happens when the terminal is much slower than the program.
+ */
+static void
+print_lines (Cli *cli)
+{
+  guint64 dropped_lines;
+  guint64 total_lines;
+  guint64 line;
+  
+  dropped_lines = launcher_output_buffer_get_dropped_lines (cli->buffer);
+  total_lines = dropped_lines + launcher_output_buffer_get_n_lines (cli->buffer);
+  
+  for (line = MAX (cli->printed_lines, dropped_lines); line < total_lines; line++)
+    {
+      const gchar *text;
+      gsize length;
+      gboolean is_stderr;
+      FILE *stream;
+      
+      text = launcher_output_buffer_get_line (cli->buffer, line - dropped_lines, 
+                                              &length, &is_stderr);
+      stream = is_stderr ? stderr : stdout;
+      fwrite (text, 1, length, stream);
+      fputc ('\n', stream);
+    }
+  
+  cli->printed_lines = total_lines;
+  fflush (stdout);
+}
+
+/*
+ * Follows the shell in reporting a killed program as 128 plus the signal.
+ */
+static gint
+get_exit_code (LauncherProcess *process)
+{
+  switch (launcher_process_get_state (process))
+    {
+    case LAUNCHER_PROCESS_EXITED:
+      return launcher_process_get_exit_status (process);
+    case LAUNCHER_PROCESS_SIGNALED:
+      return 128 + launcher_process_get_exit_status (process);
+    default:
+      return 1;
+    }
+}
+
+static void
+start_benchmark (Cli                   *cli,
+                 LauncherBenchmarkMode  mode)
+{
+  LauncherBenchmark *benchmark;
+  GError *error = NULL;
+  
+  benchmark = launcher_core_create_benchmark (cli->config, mode, active_file, &error);
+  if (benchmark == NULL)
+    {
+      fail (cli, error);
+      return;
+    }
+  
+  launcher_benchmark_run_async (benchmark, cli->cancellable, 
+                                (GAsyncReadyCallback) benchmark_finished_action, cli);
+}
+
+static void
+benchmark_finished_action (LauncherBenchmark *benchmark,
+                           GAsyncResult      *result,
+                           Cli               *cli)
+{
+  const gchar *executable;
+  GError *error = NULL;
+  
+  executable = launcher_config_get_executable (cli->config);
+  
+  if (!launcher_benchmark_run_finish (benchmark, result, &error))
+    {
+      g_object_unref (benchmark);
+      fail (cli, error);
+      return;
+    }
+  
+  if (launcher_benchmark_get_mode (benchmark) == LAUNCHER_BENCHMARK_STARTUP)
+    {
+      g_print ("%s: %d cold and %d warm starts, %d failed\n\n", executable,
+               (launcher_benchmark_get_n_samples (benchmark) + 1) / 2,
+               launcher_benchmark_get_n_samples (benchmark) / 2,
+               launcher_benchmark_get_n_failures (benchmark));
+      print_stats (NULL, NULL, NULL, 0);
+      print_startup_stats (benchmark, "First Output", LAUNCHER_BENCHMARK_FIRST_OUTPUT, "ms", 1000);
+      print_startup_stats (benchmark, "Exit", LAUNCHER_BENCHMARK_WALL_TIME, "ms", 1000);
+      print_startup_stats (benchmark, "Dynamic Loader", LAUNCHER_BENCHMARK_LINKER_TIME, "M cycles", 1000000);
+      print_startup_stats (benchmark, "System Time", LAUNCHER_BENCHMARK_SYSTEM_TIME, "ms", 1000);
+    }
+  else
+    {
+      LauncherBenchmarkStats stats;
+      
+      g_print ("%s: %d runs, %d warmups, %d failed\n\n", executable,
+               launcher_benchmark_get_n_samples (benchmark),
+               launcher_benchmark_get_total (benchmark) - 
+               launcher_benchmark_get_n_samples (benchmark),
+               launcher_benchmark_get_n_failures (benchmark));
+      print_stats (NULL, NULL, NULL, 0);
+      launcher_benchmark_get_stats (benchmark, LAUNCHER_BENCHMARK_WALL_TIME, &stats);
+      print_stats ("Wall Time", &stats, "ms", 1000);
+      launcher_benchmark_get_stats (benchmark, LAUNCHER_BENCHMARK_USER_TIME, &stats);
+      print_stats ("User Time", &stats, "ms", 1000);
+      launcher_benchmark_get_stats (benchmark, LAUNCHER_BENCHMARK_SYSTEM_TIME, &stats);
+      print_stats ("System Time", &stats, "ms", 1000);
+      launcher_benchmark_get_stats (benchmark, LAUNCHER_BENCHMARK_MAX_RSS, &stats);
+      print_stats ("Max RSS", &stats, "KiB", 1);
+    }
+  
+  if (launcher_benchmark_get_n_failures (benchmark) > 0)
+    cli->status = 1;
+  
+  g_object_unref (benchmark);
+  g_main_loop_quit (cli->loop);
+}
+
+/*
+ * Prints the header when there are no stats.
+ */
+static void
+print_stats (const gchar            *name,
+             LauncherBenchmarkStats *stats,
+             const gchar            *unit,
+             gdouble                 scale)
+{
+  gchar *label;
+  
+  if (stats == NULL)
+    {
+      g_print ("%-24s %14s %14s %14s %14s %14s\n", 
+               "", "Min", "Median", "Mean", "Stddev", "P95");
+      return;
+    }
+  
+  label = g_strdup_printf ("%s (%s)", name, unit);
+  g_print ("%-24s %14.3f %14.3f %14.3f %14.3f %14.3f\n", label, 
+           stats->min / scale, stats->median / scale, stats->mean / scale,
+           stats->stddev / scale, stats->p95 / scale);
+  g_free (label);
+}
+
+static void
+print_startup_stats (LauncherBenchmark       *benchmark,
+                     const gchar             *name,
+                     LauncherBenchmarkMetric  metric,
+                     const gchar             *unit,
+                     gdouble                  scale)
+{
+  LauncherBenchmarkStats stats;
+  gchar *row_name;
+  
+  launcher_benchmark_get_startup_stats (benchmark, metric, TRUE, &stats);
+  row_name = g_strconcat (name, " cold", NULL);
+  print_stats (row_name, &stats, unit, scale);
+  g_free (row_name);
+
+  launcher_benchmark_get_startup_stats (benchmark, metric, FALSE, &stats);
+  row_name = g_strconcat (name, " warm", NULL);
+  print_stats (row_name, &stats, unit, scale);
+  g_free (row_name);
+}
+
+static void
+start_sweep (Cli *cli)
+{
+  LauncherSweep *sweep;
+  GError *error = NULL;
+  
+  sweep = launcher_core_create_sweep (cli->config, active_file, &error);
+  if (sweep == NULL)
+    {
+      fail (cli, error);
+      return;
+    }
+  
+  launcher_sweep_run_async (sweep, cli->cancellable, 
+                            (GAsyncReadyCallback) sweep_finished_action, cli);
+}
+
+/*
+ * The results are written as the CSV the sweep view exports, in the order 
+ * the runs finished. A cancelled sweep still prints the runs it got through.
+ */
+static void
+sweep_finished_action (LauncherSweep *sweep,
+                       GAsyncResult  *result,
+                       Cli           *cli)
+{
+  GError *error = NULL;
+  guint i;
+  
+  launcher_sweep_run_finish (sweep, result, &error);
+  
+  g_print ("parameters,status,wall_time_us,user_time_us,system_time_us,max_rss_kib,cpus\n");
+  
+  for (i = 0; i < launcher_sweep_get_n_results (sweep); i++)
+    {
+      const LauncherSweepResult *sweep_result;
+      gchar *quoted;
+      gchar *status;
+      gchar *cpus;
+      
+      sweep_result = launcher_sweep_get_result (sweep, i);
+      
+      quoted = quote_csv (sweep_result->parameters);
+      if (WIFEXITED (sweep_result->status))
+        status = g_strdup_printf ("%d", WEXITSTATUS (sweep_result->status));
+      else
+        status = g_strdup_printf ("signal %d", WTERMSIG (sweep_result->status));
+      if (sweep_result->n_cpus > 1)
+        cpus = g_strdup_printf ("%d-%d", sweep_result->first_cpu, 
+                                sweep_result->first_cpu + sweep_result->n_cpus - 1);
+      else
+        cpus = g_strdup_printf ("%d", sweep_result->first_cpu);
+      
+      g_print ("%s,%s,%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT ",%ld,%s\n", 
+               quoted, status, sweep_result->wall_time, sweep_result->user_time, 
+               sweep_result->system_time, sweep_result->max_rss, cpus);
+      
+      if (sweep_result->status != 0)
+        cli->status = 1;
+      
+      g_free (quoted);
+      g_free (status);
+      g_free (cpus);
+    }
+  
+  g_object_unref (sweep);
+  
+  if (error != NULL)
+    fail (cli, error);
+  else
+    g_main_loop_quit (cli->loop);
+}
+
+static gchar*
+quote_csv (const gchar *value)
+{
+  GString *string;
+  const gchar *pointer;
+  
+  if (strpbrk (value, ",\"\n") == NULL)
+    return g_strdup (value);
+
+  string = g_string_new ("\"");
+  for (pointer = value; *pointer != '\0'; pointer++)
+    {
+      if (*pointer == '"')
+        g_string_append_c (string, '"');
+      g_string_append_c (string, *pointer);
+    }
+  g_string_append_c (string, '"');
+  
+  return g_string_free (string, FALSE);
+}
+
+/*
+ * An interrupt stops the program the way the output pane does, 
+ * benchmarks and sweeps stop after the run in progress.
+ */
+static gboolean
+interrupt_action (Cli *cli)
+{
+  g_cancellable_cancel (cli->cancellable);
+  if (cli->process != NULL)
+    launcher_process_terminate (cli->process, TERMINATE_TIMEOUT);
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+fail (Cli    *cli,
+      GError *error)
+{
+  g_printerr ("%s\n", error->message);
+  g_error_free (error);
+  if (cli->status == 0)
+    cli->status = 1;
+  g_main_loop_quit (cli->loop);
+}
@@ -0,0 +1,363 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include "launcher-command.h"
+
+/*
+ * The command is what a config runs, compiled once from its text fields: 
+ * the parameters are split into words the way the shell would and every 
+ * word, like the executable, the build command, the build folder and every 
+ * value of the environment block, becomes a template. A launch then only 
+ * expands the templates, nothing is parsed again.
+ *
+ * The environment block has one setting per line:
+ *
+ *   NAME=value     sets the variable
+ *   NAME^=value    puts the value in front of a list like PATH
+ *   NAME+=value    puts the value at the end of a list like PATH
+ *   -NAME          removes the variable
+ *
+ * Empty lines and lines starting with # are skipped.
+ */
+
+typedef enum
+{
+  SETTING_SET,
+  SETTING_PREPEND,
+  SETTING_APPEND,
+  SETTING_UNSET
+} SettingType;
+
+typedef struct
+{
+  SettingType       type;
+  gchar            *name;
+  LauncherTemplate *value;
+} Setting;
+
+struct _LauncherCommand
+{
+  LauncherTemplate *executable;
+  GPtrArray        *arguments;
+  GArray           *settings;
+  LauncherTemplate *build_command;
+  LauncherTemplate *build_folder;
+};
+
+static gboolean parse_environment  (LauncherCommand  *command,
+                                    const gchar      *environment,
+                                    GError          **error);
+static gboolean parse_setting      (const gchar      *line,
+                                    Setting          *setting,
+                                    GError          **error);
+static gboolean valid_name         (const gchar      *name);
+static void setting_clear          (Setting          *setting);
+
+LauncherCommand*
+launcher_command_compile (const gchar  *executable,
+                          const gchar  *parameters,
+                          const gchar  *environment,
+                          const gchar  *build_command,
+                          const gchar  *build_folder,
+                          GError      **error)
+{
+  LauncherCommand *command;
+  gchar **words = NULL;
+  gint n_words = 0;
+  gint i;
+  
+  if (parameters != NULL && *parameters != '\0')
+    {
+      if (!g_shell_parse_argv (parameters, &n_words, &words, error))
+        return NULL;
+    }
+  
+  command = g_slice_new0 (LauncherCommand);
+  command->executable = launcher_template_compile (executable);
+  command->arguments = g_ptr_array_new_with_free_func ((GDestroyNotify) launcher_template_free);
+  for (i = 0; i < n_words; i++)
+    g_ptr_array_add (command->arguments, launcher_template_compile (words[i]));
+  g_strfreev (words);
+  
+  command->settings = g_array_new (FALSE, FALSE, sizeof (Setting));
+  g_array_set_clear_func (command->settings, (GDestroyNotify) setting_clear);
+  
+  if (build_command != NULL && *build_command != '\0')
+    command->build_command = launcher_template_compile (build_command);
+  if (build_folder != NULL && *build_folder != '\0')
+    command->build_folder = launcher_template_compile (build_folder);
+  
+  if (!parse_environment (command, environment, error))
+    {
+      launcher_command_free (command);
+      return NULL;
+    }
+  
+  return command;
+}
+
+void
+launcher_command_free (LauncherCommand *command)
+{
+  if (command == NULL)
+    return;
+  launcher_template_free (command->executable);
+  g_ptr_array_unref (command->arguments);
+  g_array_free (command->settings, TRUE);
+  launcher_template_free (command->build_command);
+  launcher_template_free (command->build_folder);
+  g_slice_free (LauncherCommand, command);
+}
+
+gboolean
+launcher_command_uses_variable (LauncherCommand  *command,
+                                LauncherVariable  variable)
+{
+  guint i;
+  
+  if (launcher_template_uses_variable (command->executable, variable))
+    return TRUE;
+  
+  for (i = 0; i < command->arguments->len; i++)
+    if (launcher_template_uses_variable (g_ptr_array_index (command->arguments, i), variable))
+      return TRUE;
+  
+  for (i = 0; i < command->settings->len; i++)
+    {
+      Setting *setting = &g_array_index (command->settings, Setting, i);
+      if (setting->value != NULL && 
+          launcher_template_uses_variable (setting->value, variable))
+        return TRUE;
+    }
+  
+  return FALSE;
+}
+
+/*
+ * Returns NULL when the config has no build folder of its own. The folder 
+ * can not refer to itself, so ${build_folder} in it expands to nothing.
+ */
+gchar*
+launcher_command_expand_build_folder (LauncherCommand  *command,
+                                      gchar           **variables)
+{
+  gchar **envp;
+  gchar *build_folder;
+  
+  if (command->build_folder == NULL)
+    return NULL;
+  
+  envp = g_get_environ ();
+  build_folder = launcher_template_expand (command->build_folder, variables, envp);
+  g_strfreev (envp);
+  
+  return build_folder;
+}
+
+/*
+ * The settings are applied in order on top of the environment of the editor 
+ * and a value sees the variables set before it, so "PATH^=${HOME}/bin" and 
+ * "LD_LIBRARY_PATH=${LD_LIBRARY_PATH}" work the way they would in a shell.
+ */
+gchar**
+launcher_command_expand_envp (LauncherCommand  *command,
+                              gchar           **variables)
+{
+  gchar **envp;
+  guint i;
+  
+  envp = g_get_environ ();
+  
+  for (i = 0; i < command->settings->len; i++)
+    {
+      Setting *setting = &g_array_index (command->settings, Setting, i);
+      const gchar *current;
+      gchar *value;
+      
+      if (setting->type == SETTING_UNSET)
+        {
+          envp = g_environ_unsetenv (envp, setting->name);
+          continue;
+        }
+      
+      value = launcher_template_expand (setting->value, variables, envp);
+      current = g_environ_getenv (envp, setting->name);
+      
+      if (current != NULL && *current != '\0' && *value != '\0')
+        {
+          gchar *joined = NULL;
+          if (setting->type == SETTING_PREPEND)
+            joined = g_strconcat (value, ":", current, NULL);
+          else if (setting->type == SETTING_APPEND)
+            joined = g_strconcat (current, ":", value, NULL);
+          if (joined != NULL)
+            {
+              g_free (value);
+              value = joined;
+            }
+        }
+      
+      envp = g_environ_setenv (envp, setting->name, value, TRUE);
+      g_free (value);
+    }
+  
+  return envp;
+}
+
+/*
+ * The envp is the one the program gets, names that are not editor 
+ * variables are looked up in it.
+ */
+gchar**
+launcher_command_expand_argv (LauncherCommand  *command,
+                              gchar           **variables,
+                              gchar           **envp)
+{
+  gchar **argv;
+  guint i;
+  
+  argv = g_new0 (gchar*, command->arguments->len + 2);
+  argv[0] = launcher_template_expand (command->executable, variables, envp);
+  for (i = 0; i < command->arguments->len; i++)
+    argv[i + 1] = launcher_template_expand (g_ptr_array_index (command->arguments, i), 
+                                            variables, envp);
+  
+  return argv;
+}
+
+gchar*
+launcher_command_expand_build_command (LauncherCommand  *command,
+                                       gchar           **variables,
+                                       gchar           **envp)
+{
+  if (command->build_command == NULL)
+    return NULL;
+  return launcher_template_expand (command->build_command, variables, envp);
+}
+
+static gboolean
+parse_environment (LauncherCommand  *command,
+                   const gchar      *environment,
+                   GError          **error)
+{
+  gchar **lines;
+  gchar **line;
+  
+  if (environment == NULL)
+    return TRUE;
+  
+  lines = g_strsplit (environment, "\n", -1);
+  
+  for (line = lines; *line != NULL; line++)
+    {
+      Setting setting;
+      
+      g_strstrip (*line);
+      if (**line == '\0' || **line == '#')
+        continue;
+      
+      if (!parse_setting (*line, &setting, error))
+        {
+          g_strfreev (lines);
+          return FALSE;
+        }
+      
+      g_array_append_val (command->settings, setting);
+    }
+  
+  g_strfreev (lines);
+  return TRUE;
+}
+
+static gboolean
+parse_setting (const gchar  *line,
+               Setting      *setting,
+               GError      **error)
+{
+  const gchar *equals = NULL;
+  const gchar *name_end;
+  
+  setting->value = NULL;
+  
+  if (*line == '-')
+    {
+      setting->type = SETTING_UNSET;
+      setting->name = g_strstrip (g_strdup (line + 1));
+    }
+  else
+    {
+      equals = strchr (line, '=');
+      if (equals == NULL)
+        {
+          g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                       "The environment setting \"%s\" is not NAME=value.", line);
+          return FALSE;
+        }
+      
+      name_end = equals;
+      setting->type = SETTING_SET;
+      if (equals > line && equals[-1] == '^')
+        {
+          setting->type = SETTING_PREPEND;
+          name_end--;
+        }
+      else if (equals > line && equals[-1] == '+')
+        {
+          setting->type = SETTING_APPEND;
+          name_end--;
+        }
+      
+      setting->name = g_strstrip (g_strndup (line, name_end - line));
+    }
+  
+  if (!valid_name (setting->name))
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                   "The environment setting \"%s\" does not start with a variable name.", line);
+      g_free (setting->name);
+      return FALSE;
+    }
+  
+  if (setting->type != SETTING_UNSET)
+    setting->value = launcher_template_compile (equals + 1);
+  
+  return TRUE;
+}
+
+static gboolean
+valid_name (const gchar *name)
+{
+  const gchar *c;
+  
+  if (*name == '\0' || g_ascii_isdigit (*name))
+    return FALSE;
+  
+  for (c = name; *c != '\0'; c++)
+    if (!g_ascii_isalnum (*c) && *c != '_')
+      return FALSE;
+  
+  return TRUE;
+}
+
+static void
+setting_clear (Setting *setting)
+{
+  g_free (setting->name);
+  launcher_template_free (setting->value);
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_COMMAND_H__
+#define	__LAUNCHER_COMMAND_H__
+
+#include <gio/gio.h>
+#include "launcher-template.h"
+
+G_BEGIN_DECLS
+
+typedef struct _LauncherCommand LauncherCommand;
+
+LauncherCommand*  launcher_command_compile              (const gchar      *executable,
+                                                         const gchar      *parameters,
+                                                         const gchar      *environment,
+                                                         const gchar      *build_command,
+                                                         const gchar      *build_folder,
+                                                         GError          **error);
+void              launcher_command_free                 (LauncherCommand  *command);
+
+gboolean          launcher_command_uses_variable        (LauncherCommand  *command,
+                                                         LauncherVariable  variable);
+gchar*            launcher_command_expand_build_folder  (LauncherCommand  *command,
+                                                         gchar           **variables);
+gchar**           launcher_command_expand_envp          (LauncherCommand  *command,
+                                                         gchar           **variables);
+gchar**           launcher_command_expand_argv          (LauncherCommand  *command,
+                                                         gchar           **variables,
+                                                         gchar           **envp);
+gchar*            launcher_command_expand_build_command (LauncherCommand  *command,
+                                                         gchar           **variables,
+                                                         gchar           **envp);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_COMMAND_H__ */
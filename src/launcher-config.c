@@ -21,6 +21,7 @@
 static void launcher_config_class_init  (LauncherConfigClass *klass);
 static void launcher_config_init        (LauncherConfig      *config);
 static void launcher_config_finalize    (LauncherConfig      *config);
+static void clear_command               (LauncherConfig      *config);
 
 #define LAUNCHER_CONFIG_GET_PRIVATE(obj) \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_CONFIG_TYPE, LauncherConfigPrivate))
@@ -29,19 +30,68 @@ typedef struct _LauncherConfigPrivate LauncherConfigPrivate;
 
 struct _LauncherConfigPrivate
 {
-  CodeSlayerProject *project;
+  gpointer           project;
+  gchar             *project_name;
+  gchar             *project_folder;
+  gchar             *name;
   gchar             *executable;
   gchar             *parameters;
+  gchar             *build_command;
   gboolean           terminal;
+  gint               benchmark_runs;
+  gint               benchmark_warmups;
+  LauncherProfiler   profiler;
+  gboolean           counters;
+  gint               launch_order;
+  gint               launch_delay;
+  gboolean           watch;
+  gchar             *watch_ignore;
+  gint               watch_debounce;
+  gboolean           standby;
+  gboolean           prefetch;
+  gchar             *cpu_affinity;
+  gint               nice;
+  gchar             *io_priority;
+  gchar             *resource_limits;
+  gchar             *cgroup_limits;
+  gchar             *environment;
+  gchar             *build_folder;
+  gint               max_instances;
+  gint               timeout;
+  gint               idle_timeout;
+  LauncherCommand   *command;
 };
 
 enum
 {
   PROP_0,
   PROP_PROJECT_KEY,
+  PROP_NAME,
   PROP_EXECUTABLE,
   PROP_PARAMETERS,
-  PROP_TERMINAL
+  PROP_BUILD_COMMAND,
+  PROP_TERMINAL,
+  PROP_BENCHMARK_RUNS,
+  PROP_BENCHMARK_WARMUPS,
+  PROP_PROFILER,
+  PROP_COUNTERS,
+  PROP_LAUNCH_ORDER,
+  PROP_LAUNCH_DELAY,
+  PROP_WATCH,
+  PROP_WATCH_IGNORE,
+  PROP_WATCH_DEBOUNCE,
+  PROP_STANDBY,
+  PROP_PREFETCH,
+  PROP_CPU_AFFINITY,
+  PROP_NICE,
+  PROP_IO_PRIORITY,
+  PROP_RESOURCE_LIMITS,
+  PROP_CGROUP_LIMITS,
+  PROP_ENVIRONMENT,
+  PROP_BUILD_FOLDER,
+  PROP_MAX_INSTANCES,
+  PROP_TIMEOUT,
+  PROP_IDLE_TIMEOUT
 };
 
 G_DEFINE_TYPE (LauncherConfig, launcher_config, G_TYPE_OBJECT)
@@ -60,9 +110,35 @@ launcher_config_init (LauncherConfig *config)
   LauncherConfigPrivate *priv;
   priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
   priv->project = NULL;
+  priv->project_name = NULL;
+  priv->project_folder = NULL;
+  priv->name = NULL;
   priv->executable = NULL;
   priv->parameters = NULL;
+  priv->build_command = NULL;
   priv->terminal = FALSE;
+  priv->benchmark_runs = 10;
+  priv->benchmark_warmups = 1;
+  priv->profiler = LAUNCHER_PROFILER_NONE;
+  priv->counters = FALSE;
+  priv->launch_order = 0;
+  priv->launch_delay = 0;
+  priv->watch = FALSE;
+  priv->watch_ignore = NULL;
+  priv->watch_debounce = 200;
+  priv->standby = FALSE;
+  priv->prefetch = FALSE;
+  priv->cpu_affinity = NULL;
+  priv->nice = 0;
+  priv->io_priority = NULL;
+  priv->resource_limits = NULL;
+  priv->cgroup_limits = NULL;
+  priv->environment = NULL;
+  priv->build_folder = NULL;
+  priv->max_instances = 0;
+  priv->timeout = 0;
+  priv->idle_timeout = 0;
+  priv->command = NULL;
 }
 
 static void
@@ -70,6 +146,9 @@ launcher_config_finalize (LauncherConfig *config)
 {
   LauncherConfigPrivate *priv;
   priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  g_free (priv->project_name);
+  g_free (priv->project_folder);
+  g_free (priv->name);
   if (priv->executable)
     {
       g_free (priv->executable);
@@ -80,6 +159,23 @@ launcher_config_finalize (LauncherConfig *config)
       g_free (priv->parameters);
       priv->parameters = NULL;
     }
+  if (priv->build_command)
+    {
+      g_free (priv->build_command);
+      priv->build_command = NULL;
+    }
+  if (priv->watch_ignore)
+    {
+      g_free (priv->watch_ignore);
+      priv->watch_ignore = NULL;
+    }
+  g_free (priv->cpu_affinity);
+  g_free (priv->io_priority);
+  g_free (priv->resource_limits);
+  g_free (priv->cgroup_limits);
+  g_free (priv->environment);
+  g_free (priv->build_folder);
+  launcher_command_free (priv->command);
   G_OBJECT_CLASS (launcher_config_parent_class)->finalize (G_OBJECT (config));
 }
 
@@ -89,7 +185,12 @@ launcher_config_new (void)
   return LAUNCHER_CONFIG (g_object_new (launcher_config_get_type (), NULL));
 }
 
-CodeSlayerProject*  
+/*
+ * The project is only compared, the plugin keeps its CodeSlayerProject 
+ * here and the command line driver the path of the launcher.conf. What 
+ * the launch needs to know about the project is its name and folder.
+ */
+gpointer
 launcher_config_get_project (LauncherConfig    *config)
 {
   LauncherConfigPrivate *priv;
@@ -97,15 +198,52 @@ launcher_config_get_project (LauncherConfig    *config)
   return priv->project;
 }
 
+const gchar*
+launcher_config_get_project_name (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->project_name;
+}
+
+const gchar*
+launcher_config_get_project_folder (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->project_folder;
+}
+
 void
 launcher_config_set_project (LauncherConfig    *config,
-                             CodeSlayerProject *project)
+                             gpointer           project,
+                             const gchar       *project_name,
+                             const gchar       *project_folder)
 {
   LauncherConfigPrivate *priv;
   priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
   priv->project = project;
+  g_free (priv->project_name);
+  priv->project_name = g_strdup (project_name);
+  g_free (priv->project_folder);
+  priv->project_folder = g_strdup (project_folder);
 }                             
 
+/*
+ * The name of the profile, NULL for the main profile of the project.
+ */
+const gchar*
+launcher_config_get_name (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->name;
+}
+
+void
+launcher_config_set_name (LauncherConfig *config,
+                          const gchar    *name)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  g_free (priv->name);
+  priv->name = name != NULL && *name != '\0' ? g_strdup (name) : NULL;
+}
+
 const gchar*
 launcher_config_get_executable (LauncherConfig *config)
 {
@@ -124,6 +262,7 @@ launcher_config_set_executable (LauncherConfig *config,
       priv->executable = NULL;
     }
   priv->executable = g_strdup (executable);
+  clear_command (config);
 }
 
 const gchar*
@@ -144,6 +283,28 @@ launcher_config_set_parameters (LauncherConfig *config,
       priv->parameters = NULL;
     }
   priv->parameters = g_strdup (parameters);
+  clear_command (config);
+}
+
+const gchar*
+launcher_config_get_build_command (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->build_command;
+}
+
+void
+launcher_config_set_build_command (LauncherConfig *config,
+                                   const gchar    *build_command)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  if (priv->build_command)
+    {
+      g_free (priv->build_command);
+      priv->build_command = NULL;
+    }
+  priv->build_command = g_strdup (build_command);
+  clear_command (config);
 }
 
 const gboolean
@@ -160,3 +321,403 @@ launcher_config_set_terminal (LauncherConfig *config,
   priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
   priv->terminal = terminal;
 }
+
+gint
+launcher_config_get_benchmark_runs (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->benchmark_runs;
+}
+
+void
+launcher_config_set_benchmark_runs (LauncherConfig *config,
+                                    gint            benchmark_runs)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  priv->benchmark_runs = benchmark_runs;
+}
+
+gint
+launcher_config_get_benchmark_warmups (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->benchmark_warmups;
+}
+
+void
+launcher_config_set_benchmark_warmups (LauncherConfig *config,
+                                       gint            benchmark_warmups)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  priv->benchmark_warmups = benchmark_warmups;
+}
+
+LauncherProfiler
+launcher_config_get_profiler (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->profiler;
+}
+
+void
+launcher_config_set_profiler (LauncherConfig   *config,
+                              LauncherProfiler  profiler)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  priv->profiler = profiler;
+}
+
+gboolean
+launcher_config_get_counters (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->counters;
+}
+
+void
+launcher_config_set_counters (LauncherConfig *config,
+                              gboolean        counters)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  priv->counters = counters;
+}
+
+gint
+launcher_config_get_launch_order (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->launch_order;
+}
+
+void
+launcher_config_set_launch_order (LauncherConfig *config,
+                                  gint            launch_order)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  priv->launch_order = launch_order;
+}
+
+/*
+ * The number of milliseconds to wait after this project is launched 
+ * before the next project of the same group is launched.
+ */
+gint
+launcher_config_get_launch_delay (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->launch_delay;
+}
+
+void
+launcher_config_set_launch_delay (LauncherConfig *config,
+                                  gint            launch_delay)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  priv->launch_delay = launch_delay;
+}
+
+gboolean
+launcher_config_get_watch (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->watch;
+}
+
+void
+launcher_config_set_watch (LauncherConfig *config,
+                           gboolean        watch)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  priv->watch = watch;
+}
+
+const gchar*
+launcher_config_get_watch_ignore (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->watch_ignore;
+}
+
+void
+launcher_config_set_watch_ignore (LauncherConfig *config,
+                                  const gchar    *watch_ignore)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  if (priv->watch_ignore)
+    {
+      g_free (priv->watch_ignore);
+      priv->watch_ignore = NULL;
+    }
+  priv->watch_ignore = g_strdup (watch_ignore);
+}
+
+/*
+ * The milliseconds without changes before watch mode restarts.
+ */
+gint
+launcher_config_get_watch_debounce (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->watch_debounce;
+}
+
+void
+launcher_config_set_watch_debounce (LauncherConfig *config,
+                                    gint            watch_debounce)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  priv->watch_debounce = watch_debounce;
+}
+
+/*
+ * Whether a stand-by child is kept parked for the next launch.
+ */
+gboolean
+launcher_config_get_standby (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->standby;
+}
+
+void
+launcher_config_set_standby (LauncherConfig *config,
+                             gboolean        standby)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  priv->standby = standby;
+}
+
+/*
+ * Whether the executable and its libraries are read ahead after a build.
+ */
+gboolean
+launcher_config_get_prefetch (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->prefetch;
+}
+
+void
+launcher_config_set_prefetch (LauncherConfig *config,
+                              gboolean        prefetch)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  priv->prefetch = prefetch;
+}
+
+/*
+ * The cpus the program may run on, as a list like 0-3,6.
+ */
+const gchar*
+launcher_config_get_cpu_affinity (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->cpu_affinity;
+}
+
+void
+launcher_config_set_cpu_affinity (LauncherConfig *config,
+                                  const gchar    *cpu_affinity)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  g_free (priv->cpu_affinity);
+  priv->cpu_affinity = g_strdup (cpu_affinity);
+}
+
+gint
+launcher_config_get_nice (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->nice;
+}
+
+void
+launcher_config_set_nice (LauncherConfig *config,
+                          gint            nice)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  priv->nice = nice;
+}
+
+/*
+ * The ionice class and level, like best-effort:7 or idle.
+ */
+const gchar*
+launcher_config_get_io_priority (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->io_priority;
+}
+
+void
+launcher_config_set_io_priority (LauncherConfig *config,
+                                 const gchar    *io_priority)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  g_free (priv->io_priority);
+  priv->io_priority = g_strdup (io_priority);
+}
+
+/*
+ * The rlimits, like as=4G nofile=1024 core=0.
+ */
+const gchar*
+launcher_config_get_resource_limits (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->resource_limits;
+}
+
+void
+launcher_config_set_resource_limits (LauncherConfig *config,
+                                     const gchar    *resource_limits)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  g_free (priv->resource_limits);
+  priv->resource_limits = g_strdup (resource_limits);
+}
+
+/*
+ * The limits of a transient cgroup, like memory=2G cpu=150%.
+ */
+const gchar*
+launcher_config_get_cgroup_limits (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->cgroup_limits;
+}
+
+void
+launcher_config_set_cgroup_limits (LauncherConfig *config,
+                                   const gchar    *cgroup_limits)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  g_free (priv->cgroup_limits);
+  priv->cgroup_limits = g_strdup (cgroup_limits);
+}
+
+/*
+ * Lines of NAME=value, NAME^=value, NAME+=value or -NAME that are applied 
+ * to the environment of the program.
+ */
+const gchar*
+launcher_config_get_environment (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->environment;
+}
+
+void
+launcher_config_set_environment (LauncherConfig *config,
+                                 const gchar    *environment)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  g_free (priv->environment);
+  priv->environment = g_strdup (environment);
+  clear_command (config);
+}
+
+/*
+ * Where the build command runs, the project folder when it is not set.
+ */
+const gchar*
+launcher_config_get_build_folder (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->build_folder;
+}
+
+void
+launcher_config_set_build_folder (LauncherConfig *config,
+                                  const gchar    *build_folder)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  g_free (priv->build_folder);
+  priv->build_folder = g_strdup (build_folder);
+  clear_command (config);
+}
+
+/*
+ * The number of runs of this config allowed at the same time, 0 when 
+ * only the global limit of the job queue applies.
+ */
+gint
+launcher_config_get_max_instances (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->max_instances;
+}
+
+void
+launcher_config_set_max_instances (LauncherConfig *config,
+                                   gint            max_instances)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  priv->max_instances = max_instances;
+}
+
+/*
+ * The seconds a run may take before it is sampled and terminated, 0 when 
+ * it may run forever.
+ */
+gint
+launcher_config_get_timeout (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->timeout;
+}
+
+void
+launcher_config_set_timeout (LauncherConfig *config,
+                             gint            timeout)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  priv->timeout = timeout;
+}
+
+/*
+ * The seconds a run may go without writing any output before it is 
+ * sampled and terminated, 0 when it may be silent forever.
+ */
+gint
+launcher_config_get_idle_timeout (LauncherConfig *config)
+{
+  return LAUNCHER_CONFIG_GET_PRIVATE (config)->idle_timeout;
+}
+
+void
+launcher_config_set_idle_timeout (LauncherConfig *config,
+                                  gint            idle_timeout)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  priv->idle_timeout = idle_timeout;
+}
+
+/*
+ * The fields compiled into templates. The command is kept until one of 
+ * the fields it was compiled from changes, so a launch never parses them.
+ */
+LauncherCommand*
+launcher_config_get_command (LauncherConfig  *config,
+                             GError         **error)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  
+  if (priv->command == NULL)
+    priv->command = launcher_command_compile (priv->executable, priv->parameters, 
+                                              priv->environment, priv->build_command, 
+                                              priv->build_folder, error);
+  
+  return priv->command;
+}
+
+static void
+clear_command (LauncherConfig *config)
+{
+  LauncherConfigPrivate *priv;
+  priv = LAUNCHER_CONFIG_GET_PRIVATE (config);
+  launcher_command_free (priv->command);
+  priv->command = NULL;
+}
@@ -19,8 +19,8 @@
 #ifndef __LAUNCHER_CONFIG_H__
 #define	__LAUNCHER_CONFIG_H__
 
-#include <gtk/gtk.h>
-#include <codeslayer/codeslayer.h>
+#include <gio/gio.h>
+#include "launcher-command.h"
 
 G_BEGIN_DECLS
 
@@ -30,6 +30,16 @@ G_BEGIN_DECLS
 #define IS_LAUNCHER_CONFIG(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_CONFIG_TYPE))
 #define IS_LAUNCHER_CONFIG_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_CONFIG_TYPE))
 
+typedef enum
+{
+  LAUNCHER_PROFILER_NONE,
+  LAUNCHER_PROFILER_PERF,
+  LAUNCHER_PROFILER_CALLGRIND,
+  LAUNCHER_PROFILER_MASSIF,
+  LAUNCHER_PROFILER_HEAPTRACK,
+  LAUNCHER_PROFILER_MALLOC
+} LauncherProfiler;
+
 typedef struct _LauncherConfig LauncherConfig;
 typedef struct _LauncherConfigClass LauncherConfigClass;
 
@@ -47,18 +57,100 @@ GType launcher_config_get_type (void) G_GNUC_CONST;
 
 LauncherConfig*     launcher_config_new                       (void);
 
-CodeSlayerProject*  launcher_config_get_project      (LauncherConfig    *config);
+gpointer            launcher_config_get_project        (LauncherConfig    *config);
+const gchar*        launcher_config_get_project_name   (LauncherConfig    *config);
+const gchar*        launcher_config_get_project_folder (LauncherConfig    *config);
 void                launcher_config_set_project      (LauncherConfig    *config,
-                                                      CodeSlayerProject *project);
+                                                      gpointer           project,
+                                                      const gchar       *project_name,
+                                                      const gchar       *project_folder);
+const gchar*        launcher_config_get_name         (LauncherConfig    *config);
+void                launcher_config_set_name         (LauncherConfig    *config,
+                                                      const gchar       *name);
 const gchar*        launcher_config_get_executable   (LauncherConfig    *config);
 void                launcher_config_set_executable   (LauncherConfig    *config,
                                                       const gchar       *executable);
 const gchar*        launcher_config_get_parameters   (LauncherConfig    *config);
 void                launcher_config_set_parameters   (LauncherConfig    *config,
                                                       const gchar       *parameters);
+const gchar*        launcher_config_get_build_command (LauncherConfig   *config);
+void                launcher_config_set_build_command (LauncherConfig   *config,
+                                                       const gchar      *build_command);
 const gboolean      launcher_config_get_terminal     (LauncherConfig    *config);
 void                launcher_config_set_terminal     (LauncherConfig    *config,
                                                       gboolean           terminal);
+gint                launcher_config_get_benchmark_runs    (LauncherConfig *config);
+void                launcher_config_set_benchmark_runs    (LauncherConfig *config,
+                                                           gint            benchmark_runs);
+gint                launcher_config_get_benchmark_warmups (LauncherConfig *config);
+void                launcher_config_set_benchmark_warmups (LauncherConfig *config,
+                                                           gint            benchmark_warmups);
+
+LauncherProfiler    launcher_config_get_profiler          (LauncherConfig *config);
+void                launcher_config_set_profiler          (LauncherConfig *config,
+                                                           LauncherProfiler profiler);
+
+gboolean            launcher_config_get_counters          (LauncherConfig *config);
+void                launcher_config_set_counters          (LauncherConfig *config,
+                                                           gboolean        counters);
+
+gint                launcher_config_get_launch_order      (LauncherConfig *config);
+void                launcher_config_set_launch_order      (LauncherConfig *config,
+                                                           gint            launch_order);
+gint                launcher_config_get_launch_delay      (LauncherConfig *config);
+void                launcher_config_set_launch_delay      (LauncherConfig *config,
+                                                           gint            launch_delay);
+
+gboolean            launcher_config_get_watch             (LauncherConfig *config);
+void                launcher_config_set_watch             (LauncherConfig *config,
+                                                           gboolean        watch);
+const gchar*        launcher_config_get_watch_ignore      (LauncherConfig *config);
+void                launcher_config_set_watch_ignore      (LauncherConfig *config,
+                                                           const gchar    *watch_ignore);
+gint                launcher_config_get_watch_debounce    (LauncherConfig *config);
+void                launcher_config_set_watch_debounce    (LauncherConfig *config,
+                                                           gint            watch_debounce);
+
+gboolean            launcher_config_get_standby           (LauncherConfig *config);
+void                launcher_config_set_standby           (LauncherConfig *config,
+                                                           gboolean        standby);
+gboolean            launcher_config_get_prefetch          (LauncherConfig *config);
+void                launcher_config_set_prefetch          (LauncherConfig *config,
+                                                           gboolean        prefetch);
+
+const gchar*        launcher_config_get_cpu_affinity      (LauncherConfig *config);
+void                launcher_config_set_cpu_affinity      (LauncherConfig *config,
+                                                           const gchar    *cpu_affinity);
+gint                launcher_config_get_nice              (LauncherConfig *config);
+void                launcher_config_set_nice              (LauncherConfig *config,
+                                                           gint            nice);
+const gchar*        launcher_config_get_io_priority       (LauncherConfig *config);
+void                launcher_config_set_io_priority       (LauncherConfig *config,
+                                                           const gchar    *io_priority);
+const gchar*        launcher_config_get_resource_limits   (LauncherConfig *config);
+void                launcher_config_set_resource_limits   (LauncherConfig *config,
+                                                           const gchar    *resource_limits);
+const gchar*        launcher_config_get_cgroup_limits     (LauncherConfig *config);
+void                launcher_config_set_cgroup_limits     (LauncherConfig *config,
+                                                           const gchar    *cgroup_limits);
+
+const gchar*        launcher_config_get_environment       (LauncherConfig *config);
+void                launcher_config_set_environment       (LauncherConfig *config,
+                                                           const gchar    *environment);
+const gchar*        launcher_config_get_build_folder      (LauncherConfig *config);
+void                launcher_config_set_build_folder      (LauncherConfig *config,
+                                                           const gchar    *build_folder);
+gint                launcher_config_get_max_instances     (LauncherConfig *config);
+void                launcher_config_set_max_instances     (LauncherConfig *config,
+                                                           gint            max_instances);
+gint                launcher_config_get_timeout           (LauncherConfig *config);
+void                launcher_config_set_timeout           (LauncherConfig *config,
+                                                           gint            timeout);
+gint                launcher_config_get_idle_timeout      (LauncherConfig *config);
+void                launcher_config_set_idle_timeout      (LauncherConfig *config,
+                                                           gint            idle_timeout);
+LauncherCommand*    launcher_config_get_command           (LauncherConfig *config,
+                                                           GError        **error);
 
 G_END_DECLS
 
@@ -0,0 +1,707 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <errno.h>
+#include "launcher-core.h"
+#include "launcher-profiler.h"
+#include "launcher-template.h"
+
+/*
+ * The launch logic that does not need the editor: reading and writing 
+ * the profiles of a launcher.conf and turning a config into the argv, 
+ * environment and resources of a process, a build, a benchmark or a 
+ * sweep. The plugin and the command line driver share all of it, so a 
+ * program measured on a build machine is launched exactly the way the 
+ * editor launches it.
+ *
+ * Where the editor has a notion the core does not, the active file and 
+ * the folder profiles are written to, the caller passes it in.
+ */
+
+#define EXECUTABLE "executable"
+#define PARAMETERS "parameters"
+#define BUILD_COMMAND "build_command"
+#define TERMINAL "terminal"
+#define BENCHMARK_RUNS "benchmark_runs"
+#define BENCHMARK_WARMUPS "benchmark_warmups"
+#define PROFILER "profiler"
+#define COUNTERS "counters"
+#define LAUNCH_ORDER "launch_order"
+#define LAUNCH_DELAY "launch_delay"
+#define WATCH "watch"
+#define WATCH_IGNORE "watch_ignore"
+#define WATCH_DEBOUNCE "watch_debounce"
+#define STANDBY "standby"
+#define PREFETCH "prefetch"
+#define CPU_AFFINITY "cpu_affinity"
+#define NICE "nice"
+#define IO_PRIORITY "io_priority"
+#define RESOURCE_LIMITS "resource_limits"
+#define CGROUP_LIMITS "cgroup_limits"
+#define ENVIRONMENT "environment"
+#define BUILD_FOLDER "build_folder"
+#define MAX_INSTANCES "max_instances"
+#define TIMEOUT "timeout"
+#define IDLE_TIMEOUT "idle_timeout"
+
+typedef struct
+{
+  const gchar *program;
+  const gchar *execute_option;
+} Terminal;
+
+/*
+ * Every one of these runs the words after the option as the argv of the 
+ * program, without a shell in between.
+ */
+static const Terminal terminals[] = 
+{
+  { "x-terminal-emulator", "-e" },
+  { "gnome-terminal", "--" },
+  { "konsole", "-e" },
+  { "xfce4-terminal", "-x" },
+  { "xterm", "-e" }
+};
+
+static gchar** parse_argv                  (const gchar   *executable,
+                                            const gchar   *parameters,
+                                            GError       **error);
+static gchar** create_profiler_argv        (LauncherConfig  *config,
+                                            gchar          **argv,
+                                            gchar          **envp,
+                                            const gchar     *profiles_folder,
+                                            gchar          **profile_path,
+                                            GError         **error);
+
+/*
+ * The group in launcher.conf that holds the profile, the main profile 
+ * keeps the [main] group it always had.
+ */
+gchar*
+launcher_core_profile_section (const gchar *name)
+{
+  if (name == NULL || *name == '\0')
+    return g_strdup (LAUNCHER_PROFILE_MAIN);
+  return g_strconcat (LAUNCHER_PROFILE_PREFIX, name, NULL);
+}
+
+/*
+ * Loads the named profile, or the main one when there is no profile by 
+ * that name. The project is whatever the caller tells its projects apart 
+ * by, the core only compares it.
+ */
+LauncherConfig*
+launcher_core_load_config (GKeyFile    *key_file, 
+                           const gchar *name,
+                           gpointer     project,
+                           const gchar *project_name,
+                           const gchar *project_folder)
+{
+  LauncherConfig *config;
+  gchar *section;
+  gchar *executable;
+  gchar *parameters;
+  gchar *build_command;
+  gchar *watch_ignore;
+  gchar *cpu_affinity;
+  gchar *io_priority;
+  gchar *resource_limits;
+  gchar *cgroup_limits;
+  gchar *environment;
+  gchar *build_folder;
+  gboolean terminal;
+  gchar *profiler;
+
+  section = launcher_core_profile_section (name);
+  if (!g_key_file_has_group (key_file, section))
+    {
+      g_free (section);
+      section = launcher_core_profile_section (NULL);
+      name = NULL;
+    }
+  
+  executable = g_key_file_get_string (key_file, section, EXECUTABLE, NULL);
+  parameters = g_key_file_get_string (key_file, section, PARAMETERS, NULL);
+  build_command = g_key_file_get_string (key_file, section, BUILD_COMMAND, NULL);
+  watch_ignore = g_key_file_get_string (key_file, section, WATCH_IGNORE, NULL);
+  cpu_affinity = g_key_file_get_string (key_file, section, CPU_AFFINITY, NULL);
+  io_priority = g_key_file_get_string (key_file, section, IO_PRIORITY, NULL);
+  resource_limits = g_key_file_get_string (key_file, section, RESOURCE_LIMITS, NULL);
+  cgroup_limits = g_key_file_get_string (key_file, section, CGROUP_LIMITS, NULL);
+  environment = g_key_file_get_string (key_file, section, ENVIRONMENT, NULL);
+  build_folder = g_key_file_get_string (key_file, section, BUILD_FOLDER, NULL);
+  terminal = g_key_file_get_boolean (key_file, section, TERMINAL, NULL);
+  profiler = g_key_file_get_string (key_file, section, PROFILER, NULL);
+  
+  config = launcher_config_new ();
+  launcher_config_set_project (config, project, project_name, project_folder);
+  launcher_config_set_name (config, name);
+  launcher_config_set_executable (config, executable);
+  launcher_config_set_parameters (config, parameters);
+  launcher_config_set_build_command (config, build_command);
+  launcher_config_set_terminal (config, terminal);
+  launcher_config_set_profiler (config, launcher_profiler_from_string (profiler));
+  launcher_config_set_counters (config, g_key_file_get_boolean (key_file, section, COUNTERS, NULL));
+  launcher_config_set_launch_order (config, g_key_file_get_integer (key_file, section, LAUNCH_ORDER, NULL));
+  launcher_config_set_launch_delay (config, g_key_file_get_integer (key_file, section, LAUNCH_DELAY, NULL));
+  launcher_config_set_watch (config, g_key_file_get_boolean (key_file, section, WATCH, NULL));
+  launcher_config_set_watch_ignore (config, watch_ignore);
+  launcher_config_set_standby (config, g_key_file_get_boolean (key_file, section, STANDBY, NULL));
+  launcher_config_set_prefetch (config, g_key_file_get_boolean (key_file, section, PREFETCH, NULL));
+  launcher_config_set_cpu_affinity (config, cpu_affinity);
+  launcher_config_set_nice (config, g_key_file_get_integer (key_file, section, NICE, NULL));
+  launcher_config_set_io_priority (config, io_priority);
+  launcher_config_set_resource_limits (config, resource_limits);
+  launcher_config_set_cgroup_limits (config, cgroup_limits);
+  launcher_config_set_environment (config, environment);
+  launcher_config_set_build_folder (config, build_folder);
+  launcher_config_set_max_instances (config, g_key_file_get_integer (key_file, section, MAX_INSTANCES, NULL));
+  launcher_config_set_timeout (config, g_key_file_get_integer (key_file, section, TIMEOUT, NULL));
+  launcher_config_set_idle_timeout (config, g_key_file_get_integer (key_file, section, IDLE_TIMEOUT, NULL));
+  
+  if (g_key_file_has_key (key_file, section, WATCH_DEBOUNCE, NULL))
+    launcher_config_set_watch_debounce (config, 
+                                        g_key_file_get_integer (key_file, section, WATCH_DEBOUNCE, NULL));
+  
+  if (g_key_file_has_key (key_file, section, BENCHMARK_RUNS, NULL))
+    launcher_config_set_benchmark_runs (config, 
+                                        g_key_file_get_integer (key_file, section, BENCHMARK_RUNS, NULL));
+  if (g_key_file_has_key (key_file, section, BENCHMARK_WARMUPS, NULL))
+    launcher_config_set_benchmark_warmups (config, 
+                                           g_key_file_get_integer (key_file, section, BENCHMARK_WARMUPS, NULL));
+  
+  /* parsed here so the first launch only expands, a bad setting is 
+     reported when the program is launched */
+  launcher_config_get_command (config, NULL);
+  
+  g_free (executable);
+  g_free (parameters);
+  g_free (build_command);
+  g_free (watch_ignore);
+  g_free (cpu_affinity);
+  g_free (io_priority);
+  g_free (resource_limits);
+  g_free (cgroup_limits);
+  g_free (environment);
+  g_free (build_folder);
+  g_free (profiler);
+  g_free (section);
+  
+  return config;
+}
+
+/*
+ * Writes the config into the group of its profile, the other profiles in 
+ * the key file are left alone.
+ */
+void
+launcher_core_save_config (GKeyFile       *key_file,
+                           LauncherConfig *config)
+{
+  gchar *section;
+  
+  section = launcher_core_profile_section (launcher_config_get_name (config));
+
+  g_key_file_set_string (key_file, section, EXECUTABLE, launcher_config_get_executable (config));
+  g_key_file_set_string (key_file, section, PARAMETERS, launcher_config_get_parameters (config));
+  if (launcher_config_get_build_command (config) != NULL)
+    g_key_file_set_string (key_file, section, BUILD_COMMAND, launcher_config_get_build_command (config));
+  g_key_file_set_boolean (key_file, section, TERMINAL, launcher_config_get_terminal (config));
+  g_key_file_set_integer (key_file, section, BENCHMARK_RUNS, 
+                          launcher_config_get_benchmark_runs (config));
+  g_key_file_set_integer (key_file, section, BENCHMARK_WARMUPS, 
+                          launcher_config_get_benchmark_warmups (config));
+  g_key_file_set_string (key_file, section, PROFILER, 
+                         launcher_profiler_to_string (launcher_config_get_profiler (config)));
+  g_key_file_set_boolean (key_file, section, COUNTERS, launcher_config_get_counters (config));
+  g_key_file_set_integer (key_file, section, LAUNCH_ORDER, launcher_config_get_launch_order (config));
+  g_key_file_set_integer (key_file, section, LAUNCH_DELAY, launcher_config_get_launch_delay (config));
+  g_key_file_set_boolean (key_file, section, WATCH, launcher_config_get_watch (config));
+  if (launcher_config_get_watch_ignore (config) != NULL)
+    g_key_file_set_string (key_file, section, WATCH_IGNORE, launcher_config_get_watch_ignore (config));
+  g_key_file_set_integer (key_file, section, WATCH_DEBOUNCE, launcher_config_get_watch_debounce (config));
+  g_key_file_set_boolean (key_file, section, STANDBY, launcher_config_get_standby (config));
+  g_key_file_set_boolean (key_file, section, PREFETCH, launcher_config_get_prefetch (config));
+  g_key_file_set_integer (key_file, section, NICE, launcher_config_get_nice (config));
+  g_key_file_set_integer (key_file, section, MAX_INSTANCES, launcher_config_get_max_instances (config));
+  g_key_file_set_integer (key_file, section, TIMEOUT, launcher_config_get_timeout (config));
+  g_key_file_set_integer (key_file, section, IDLE_TIMEOUT, launcher_config_get_idle_timeout (config));
+  if (launcher_config_get_cpu_affinity (config) != NULL)
+    g_key_file_set_string (key_file, section, CPU_AFFINITY, launcher_config_get_cpu_affinity (config));
+  if (launcher_config_get_io_priority (config) != NULL)
+    g_key_file_set_string (key_file, section, IO_PRIORITY, launcher_config_get_io_priority (config));
+  if (launcher_config_get_resource_limits (config) != NULL)
+    g_key_file_set_string (key_file, section, RESOURCE_LIMITS, launcher_config_get_resource_limits (config));
+  if (launcher_config_get_cgroup_limits (config) != NULL)
+    g_key_file_set_string (key_file, section, CGROUP_LIMITS, launcher_config_get_cgroup_limits (config));
+  if (launcher_config_get_environment (config) != NULL)
+    g_key_file_set_string (key_file, section, ENVIRONMENT, launcher_config_get_environment (config));
+  if (launcher_config_get_build_folder (config) != NULL)
+    g_key_file_set_string (key_file, section, BUILD_FOLDER, launcher_config_get_build_folder (config));
+  
+  g_free (section);
+}
+
+/*
+ * Fills in the values of the variables for a launch and returns the 
+ * command they are used with. A relative build folder is taken from the 
+ * project folder.
+ */
+LauncherCommand*
+launcher_core_create_variables (LauncherConfig  *config,
+                                const gchar     *active_file,
+                                gchar          **variables,
+                                GError         **error)
+{
+  LauncherCommand *command;
+  const gchar *folder_path;
+  gchar *build_folder;
+  
+  command = launcher_config_get_command (config, error);
+  if (command == NULL)
+    return NULL;
+  
+  folder_path = launcher_config_get_project_folder (config);
+  
+  variables[LAUNCHER_VARIABLE_PROJECT_FOLDER] = g_strdup (folder_path);
+  variables[LAUNCHER_VARIABLE_PROJECT_NAME] = g_strdup (launcher_config_get_project_name (config));
+  variables[LAUNCHER_VARIABLE_ACTIVE_FILE] = g_strdup (active_file);
+  variables[LAUNCHER_VARIABLE_BUILD_FOLDER] = NULL;
+  
+  build_folder = launcher_command_expand_build_folder (command, variables);
+  if (build_folder == NULL || *build_folder == '\0')
+    {
+      g_free (build_folder);
+      build_folder = g_strdup (folder_path);
+    }
+  else if (!g_path_is_absolute (build_folder))
+    {
+      gchar *relative = build_folder;
+      build_folder = g_build_filename (folder_path, relative, NULL);
+      g_free (relative);
+    }
+  variables[LAUNCHER_VARIABLE_BUILD_FOLDER] = build_folder;
+  
+  return command;
+}
+
+void
+launcher_core_free_variables (gchar **variables)
+{
+  gint i;
+  for (i = 0; i < LAUNCHER_VARIABLE_COUNT; i++)
+    g_free (variables[i]);
+}
+
+gchar**
+launcher_core_create_argv (LauncherConfig   *config,
+                           const gchar      *active_file,
+                           gchar          ***envp,
+                           GError          **error)
+{
+  LauncherCommand *command;
+  gchar *variables[LAUNCHER_VARIABLE_COUNT];
+  gchar **argv;
+  
+  command = launcher_core_create_variables (config, active_file, variables, error);
+  if (command == NULL)
+    return NULL;
+  
+  *envp = launcher_command_expand_envp (command, variables);
+  argv = launcher_command_expand_argv (command, variables, *envp);
+  launcher_core_free_variables (variables);
+  
+  return argv;
+}
+
+/*
+ * Cgroup limits put the program in a systemd scope, which is why the argv 
+ * may change. Returns NULL when a setting is not valid.
+ */
+LauncherResources*
+launcher_core_create_resources (LauncherConfig   *config,
+                                gchar          ***argv,
+                                GError          **error)
+{
+  LauncherResources *resources;
+  resources = launcher_resources_new (config, error);
+  if (resources != NULL)
+    *argv = launcher_resources_wrap_argv (resources, *argv);
+  return resources;
+}
+
+/*
+ * Returns the spawned process, the profiles folder is only used when the 
+ * config runs the program under a profiler.
+ */
+LauncherProcess*
+launcher_core_spawn_process (LauncherConfig  *config,
+                             const gchar     *active_file,
+                             const gchar     *profiles_folder,
+                             GError         **error)
+{
+  LauncherProcess *process;
+  LauncherResources *resources = NULL;
+  gchar **argv;
+  gchar **envp = NULL;
+  gchar *profile_path = NULL;
+  gchar *program = NULL;
+
+  argv = launcher_core_create_argv (config, active_file, &envp, error);
+  if (argv != NULL)
+    program = g_strdup (argv[0]);
+  if (argv != NULL && launcher_config_get_profiler (config) != LAUNCHER_PROFILER_NONE)
+    argv = create_profiler_argv (config, argv, envp, profiles_folder, &profile_path, error);
+  if (argv != NULL)
+    resources = launcher_core_create_resources (config, &argv, error);
+
+  if (resources == NULL)
+    {
+      g_strfreev (argv);
+      g_strfreev (envp);
+      g_free (profile_path);
+      g_free (program);
+      return NULL;
+    }
+  
+  process = launcher_process_new (config);
+  launcher_process_set_profile (process, launcher_config_get_profiler (config), profile_path);
+  launcher_process_set_resources (process, resources);
+  launcher_process_set_environment (process, envp);
+  launcher_process_set_program (process, program);
+  /* under a profiler the core would be the profiler's, env execs the program */
+  launcher_process_set_core_dumps (process, launcher_config_get_profiler (config) == LAUNCHER_PROFILER_NONE || 
+                                            launcher_config_get_profiler (config) == LAUNCHER_PROFILER_MALLOC);
+  launcher_process_set_watchdog (process, TRUE);
+  g_object_unref (resources);
+  g_strfreev (envp);
+  g_free (profile_path);
+  g_free (program);
+  
+  if (!launcher_process_spawn (process, argv, error))
+    {
+      g_object_unref (process);
+      g_strfreev (argv);
+      return NULL;
+    }
+  
+  g_strfreev (argv);
+  return process;
+}
+
+/*
+ * The argv goes to the terminal as separate words, so nothing is quoted 
+ * or split again on the way, and the terminal gets the environment of the 
+ * program. The terminal is not waited for, GSubprocess reaps it.
+ */
+gboolean
+launcher_core_spawn_terminal (LauncherConfig  *config,
+                              const gchar     *active_file,
+                              GError         **error)
+{
+  GSubprocessLauncher *launcher;
+  GSubprocess *subprocess;
+  GPtrArray *terminal_argv;
+  gchar *program = NULL;
+  gchar **argv;
+  gchar **arg;
+  gchar **envp = NULL;
+  guint i;
+  
+  for (i = 0; i < G_N_ELEMENTS (terminals) && program == NULL; i++)
+    program = g_find_program_in_path (terminals[i].program);
+  
+  if (program == NULL)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND, 
+                   "There is no terminal emulator to run %s in", 
+                   launcher_config_get_executable (config));
+      return FALSE;
+    }
+  
+  argv = launcher_core_create_argv (config, active_file, &envp, error);
+  if (argv == NULL)
+    {
+      g_free (program);
+      return FALSE;
+    }
+  
+  terminal_argv = g_ptr_array_new ();
+  g_ptr_array_add (terminal_argv, program);
+  g_ptr_array_add (terminal_argv, (gpointer) terminals[i - 1].execute_option);
+  for (arg = argv; *arg != NULL; arg++)
+    g_ptr_array_add (terminal_argv, *arg);
+  g_ptr_array_add (terminal_argv, NULL);
+  
+  launcher = g_subprocess_launcher_new (G_SUBPROCESS_FLAGS_NONE);
+  g_subprocess_launcher_set_environ (launcher, envp);
+  subprocess = g_subprocess_launcher_spawnv (launcher, 
+                                             (const gchar * const *) terminal_argv->pdata, 
+                                             error);
+  g_object_unref (launcher);
+  
+  g_ptr_array_free (terminal_argv, TRUE);
+  g_free (program);
+  g_strfreev (argv);
+  g_strfreev (envp);
+  
+  if (subprocess == NULL)
+    return FALSE;
+  
+  g_object_unref (subprocess);
+  return TRUE;
+}
+
+/*
+ * The build command runs through the shell in the build folder, with the 
+ * environment of the program it builds.
+ */
+LauncherProcess*
+launcher_core_spawn_build (LauncherConfig  *config,
+                           const gchar     *active_file,
+                           GError         **error)
+{
+  LauncherConfig *build_config;
+  LauncherProcess *process;
+  LauncherCommand *command;
+  gchar *variables[LAUNCHER_VARIABLE_COUNT];
+  gchar **envp;
+  gchar *build_command;
+  gchar *argv[4];
+  
+  command = launcher_core_create_variables (config, active_file, variables, error);
+  if (command == NULL)
+    return NULL;
+  
+  envp = launcher_command_expand_envp (command, variables);
+  build_command = launcher_command_expand_build_command (command, variables, envp);
+  
+  build_config = launcher_config_new ();
+  launcher_config_set_project (build_config, launcher_config_get_project (config),
+                               launcher_config_get_project_name (config),
+                               launcher_config_get_project_folder (config));
+  launcher_config_set_executable (build_config, build_command);
+  
+  argv[0] = "/bin/sh";
+  argv[1] = "-c";
+  argv[2] = build_command;
+  argv[3] = NULL;
+  
+  process = launcher_process_new (build_config);
+  launcher_process_set_working_directory (process, variables[LAUNCHER_VARIABLE_BUILD_FOLDER]);
+  launcher_process_set_environment (process, envp);
+  g_object_unref (build_config);
+  launcher_core_free_variables (variables);
+  g_strfreev (envp);
+  
+  if (!launcher_process_spawn (process, argv, error))
+    {
+      g_object_unref (process);
+      process = NULL;
+    }
+  
+  g_free (build_command);
+  return process;
+}
+
+LauncherBenchmark*
+launcher_core_create_benchmark (LauncherConfig         *config,
+                                LauncherBenchmarkMode   mode,
+                                const gchar            *active_file,
+                                GError                **error)
+{
+  LauncherBenchmark *benchmark;
+  LauncherResources *resources;
+  gchar **argv;
+  gchar **envp = NULL;
+  
+  if (launcher_sweep_has_placeholders (launcher_config_get_parameters (config)))
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, 
+                   "Benchmarks do not expand sweep parameters, use Run instead.");
+      return NULL;
+    }
+  
+  argv = launcher_core_create_argv (config, active_file, &envp, error);
+  if (argv == NULL)
+    return NULL;
+  
+  /* a systemd scope around the program would be what the startup measures */
+  if (mode == LAUNCHER_BENCHMARK_STARTUP)
+    resources = launcher_resources_new (config, error);
+  else
+    resources = launcher_core_create_resources (config, &argv, error);
+  
+  if (resources != NULL && mode == LAUNCHER_BENCHMARK_STARTUP && 
+      launcher_resources_has_cgroup (resources))
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, 
+                   "Startup benchmarks can not apply cgroup limits, the systemd scope "
+                   "would be measured along with the program. Clear the cgroup limits "
+                   "or run a normal benchmark.");
+      g_object_unref (resources);
+      resources = NULL;
+    }
+  
+  if (resources == NULL)
+    {
+      g_strfreev (argv);
+      g_strfreev (envp);
+      return NULL;
+    }
+  
+  if (mode == LAUNCHER_BENCHMARK_STARTUP)
+    benchmark = launcher_benchmark_new_startup (config, argv);
+  else
+    benchmark = launcher_benchmark_new (config, argv);
+  launcher_benchmark_set_resources (benchmark, resources);
+  launcher_benchmark_set_environment (benchmark, envp);
+  g_object_unref (resources);
+  g_strfreev (argv);
+  g_strfreev (envp);
+  
+  return benchmark;
+}
+
+/*
+ * Every combination of the placeholder values becomes its own run, the 
+ * parameters are expanded before they are parsed so that a value can 
+ * hold more than one argument. The ${} variables are expanded last, in 
+ * every word of the parsed runs.
+ */
+LauncherSweep*
+launcher_core_create_sweep (LauncherConfig  *config,
+                            const gchar     *active_file,
+                            GError         **error)
+{
+  LauncherSweep *sweep;
+  LauncherCommand *command;
+  LauncherResources *resources;
+  const gchar *executable;
+  gchar *variables[LAUNCHER_VARIABLE_COUNT];
+  gchar **envp;
+  gchar **expansions;
+  gchar **expansion;
+  
+  resources = launcher_resources_new (config, error);
+  if (resources == NULL)
+    return NULL;
+  
+  command = launcher_core_create_variables (config, active_file, variables, error);
+  if (command == NULL)
+    {
+      g_object_unref (resources);
+      return NULL;
+    }
+  
+  envp = launcher_command_expand_envp (command, variables);
+  executable = launcher_config_get_executable (config);
+  expansions = launcher_sweep_expand (launcher_config_get_parameters (config));
+  sweep = launcher_sweep_new (config);
+  launcher_sweep_set_environment (sweep, envp);
+  launcher_sweep_set_resources (sweep, resources);
+
+  for (expansion = expansions; *expansion != NULL; expansion++)
+    {
+      gchar **argv;
+      gchar **arg;
+      
+      argv = parse_argv (executable, *expansion, error);
+      if (argv == NULL)
+        {
+          g_object_unref (sweep);
+          sweep = NULL;
+          break;
+        }
+      
+      for (arg = argv; *arg != NULL; arg++)
+        {
+          gchar *expanded = launcher_template_expand_text (*arg, variables, envp);
+          g_free (*arg);
+          *arg = expanded;
+        }
+
+      argv = launcher_resources_wrap_argv (resources, argv);
+      launcher_sweep_add_run (sweep, *expansion, argv);
+      g_strfreev (argv);
+    }
+  
+  g_object_unref (resources);
+  g_strfreev (expansions);
+  g_strfreev (envp);
+  launcher_core_free_variables (variables);
+  
+  return sweep;
+}
+
+static gchar**
+parse_argv (const gchar  *executable,
+            const gchar  *parameters,
+            GError      **error)
+{
+  gchar **arguments = NULL;
+  gchar **argv;
+  gint argc = 0;
+  gint i;
+
+  if (parameters != NULL && *parameters != '\0')
+    {
+      if (!g_shell_parse_argv (parameters, &argc, &arguments, error))
+        return NULL;
+    }
+
+  argv = g_new0 (gchar*, argc + 2);
+  argv[0] = g_strdup (executable);
+  for (i = 0; i < argc; i++)
+    argv[i + 1] = g_strdup (arguments[i]);
+
+  g_strfreev (arguments);
+  return argv;
+}
+
+/*
+ * The profile is written into the profiles folder so that it can be 
+ * opened later with the tool's own viewer.
+ */
+static gchar**
+create_profiler_argv (LauncherConfig  *config,
+                      gchar          **argv,
+                      gchar          **envp,
+                      const gchar     *profiles_folder,
+                      gchar          **profile_path,
+                      GError         **error)
+{
+  LauncherProfiler profiler;
+  gchar **profiler_argv;
+  
+  profiler = launcher_config_get_profiler (config);
+  
+  if (g_mkdir_with_parents (profiles_folder, 0755) != 0)
+    {
+      g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno), 
+                   "Unable to create the profiles folder %s", profiles_folder);
+      g_strfreev (argv);
+      return NULL;
+    }
+  
+  *profile_path = launcher_profiler_create_output_path (profiler, profiles_folder);
+  profiler_argv = launcher_profiler_wrap_argv (profiler, argv, envp, *profile_path);
+  
+  g_strfreev (argv);
+  return profiler_argv;
+}
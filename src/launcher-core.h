@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_CORE_H__
+#define	__LAUNCHER_CORE_H__
+
+#include <gio/gio.h>
+#include "launcher-config.h"
+#include "launcher-command.h"
+#include "launcher-resources.h"
+#include "launcher-process.h"
+#include "launcher-benchmark.h"
+#include "launcher-sweep.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_PROFILE_MAIN "main"
+#define LAUNCHER_PROFILE_PREFIX "profile "
+
+gchar*              launcher_core_profile_section       (const gchar            *name);
+LauncherConfig*     launcher_core_load_config           (GKeyFile               *key_file,
+                                                         const gchar            *name,
+                                                         gpointer                project,
+                                                         const gchar            *project_name,
+                                                         const gchar            *project_folder);
+void                launcher_core_save_config           (GKeyFile               *key_file,
+                                                         LauncherConfig         *config);
+
+LauncherCommand*    launcher_core_create_variables      (LauncherConfig         *config,
+                                                         const gchar            *active_file,
+                                                         gchar                 **variables,
+                                                         GError                **error);
+void                launcher_core_free_variables        (gchar                 **variables);
+gchar**             launcher_core_create_argv           (LauncherConfig         *config,
+                                                         const gchar            *active_file,
+                                                         gchar                ***envp,
+                                                         GError                **error);
+LauncherResources*  launcher_core_create_resources      (LauncherConfig         *config,
+                                                         gchar                ***argv,
+                                                         GError                **error);
+
+LauncherProcess*    launcher_core_spawn_process         (LauncherConfig         *config,
+                                                         const gchar            *active_file,
+                                                         const gchar            *profiles_folder,
+                                                         GError                **error);
+gboolean            launcher_core_spawn_terminal        (LauncherConfig         *config,
+                                                         const gchar            *active_file,
+                                                         GError                **error);
+LauncherProcess*    launcher_core_spawn_build           (LauncherConfig         *config,
+                                                         const gchar            *active_file,
+                                                         GError                **error);
+LauncherBenchmark*  launcher_core_create_benchmark      (LauncherConfig         *config,
+                                                         LauncherBenchmarkMode   mode,
+                                                         const gchar            *active_file,
+                                                         GError                **error);
+LauncherSweep*      launcher_core_create_sweep          (LauncherConfig         *config,
+                                                         const gchar            *active_file,
+                                                         GError                **error);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_CORE_H__ */
@@ -0,0 +1,410 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "launcher-counters.h"
+
+/*
+ * The counters are opened by the child itself, between fork and exec, with
+ * enable_on_exec set so that only the program is counted and inherit set so 
+ * that the processes it starts are counted too. The descriptors are handed 
+ * back to the parent over a socket pair, which can read the totals after 
+ * the child has been reaped.
+ *
+ * Hardware events are often not available, in a virtual machine for example, 
+ * or restricted by perf_event_paranoid, so every event is opened on its own 
+ * and whatever could be opened is used. Because the events are not grouped 
+ * the kernel may multiplex them, so the values are scaled by the time each 
+ * one was actually running.
+ */
+
+static void launcher_counters_class_init  (LauncherCountersClass *klass);
+static void launcher_counters_init        (LauncherCounters      *counters);
+static void launcher_counters_finalize    (LauncherCounters      *counters);
+
+static void set_attr                      (struct perf_event_attr *attr,
+                                           guint32                 type,
+                                           guint64                 config);
+static gint open_event                    (struct perf_event_attr *attr);
+
+#define LAUNCHER_COUNTERS_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_COUNTERS_TYPE, LauncherCountersPrivate))
+
+typedef struct _LauncherCountersPrivate LauncherCountersPrivate;
+
+struct _LauncherCountersPrivate
+{
+  struct perf_event_attr attrs[LAUNCHER_COUNTER_LAST];
+  gint                   fds[LAUNCHER_COUNTER_LAST];
+  gint                   sockets[2];
+};
+
+typedef struct
+{
+  guint64 value;
+  guint64 time_enabled;
+  guint64 time_running;
+} ReadFormat;
+
+#define CACHE_CONFIG(cache, op, result) \
+  ((cache) | ((op) << 8) | ((result) << 16))
+
+G_DEFINE_TYPE (LauncherCounters, launcher_counters, G_TYPE_OBJECT)
+
+static void
+launcher_counters_class_init (LauncherCountersClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_counters_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherCountersPrivate));
+}
+
+static void
+launcher_counters_init (LauncherCounters *counters)
+{
+  LauncherCountersPrivate *priv;
+  gint i;
+  
+  priv = LAUNCHER_COUNTERS_GET_PRIVATE (counters);
+  
+  for (i = 0; i < LAUNCHER_COUNTER_LAST; i++)
+    priv->fds[i] = -1;
+  
+  set_attr (&priv->attrs[LAUNCHER_COUNTER_CYCLES], 
+            PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+  set_attr (&priv->attrs[LAUNCHER_COUNTER_INSTRUCTIONS], 
+            PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+  set_attr (&priv->attrs[LAUNCHER_COUNTER_BRANCHES], 
+            PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS);
+  set_attr (&priv->attrs[LAUNCHER_COUNTER_BRANCH_MISSES], 
+            PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+  set_attr (&priv->attrs[LAUNCHER_COUNTER_L1D_LOADS], PERF_TYPE_HW_CACHE, 
+            CACHE_CONFIG (PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, 
+                          PERF_COUNT_HW_CACHE_RESULT_ACCESS));
+  set_attr (&priv->attrs[LAUNCHER_COUNTER_L1D_MISSES], PERF_TYPE_HW_CACHE, 
+            CACHE_CONFIG (PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, 
+                          PERF_COUNT_HW_CACHE_RESULT_MISS));
+  set_attr (&priv->attrs[LAUNCHER_COUNTER_LLC_REFERENCES], 
+            PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES);
+  set_attr (&priv->attrs[LAUNCHER_COUNTER_LLC_MISSES], 
+            PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+  set_attr (&priv->attrs[LAUNCHER_COUNTER_CONTEXT_SWITCHES], 
+            PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES);
+  set_attr (&priv->attrs[LAUNCHER_COUNTER_PAGE_FAULTS], 
+            PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+  set_attr (&priv->attrs[LAUNCHER_COUNTER_TASK_CLOCK], 
+            PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK);
+  
+  if (socketpair (AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, priv->sockets) != 0)
+    {
+      priv->sockets[0] = -1;
+      priv->sockets[1] = -1;
+    }
+}
+
+static void
+launcher_counters_finalize (LauncherCounters *counters)
+{
+  LauncherCountersPrivate *priv;
+  gint i;
+  
+  priv = LAUNCHER_COUNTERS_GET_PRIVATE (counters);
+  
+  for (i = 0; i < LAUNCHER_COUNTER_LAST; i++)
+    {
+      if (priv->fds[i] >= 0)
+        close (priv->fds[i]);
+    }
+  
+  for (i = 0; i < 2; i++)
+    {
+      if (priv->sockets[i] >= 0)
+        close (priv->sockets[i]);
+    }
+
+  G_OBJECT_CLASS (launcher_counters_parent_class)->finalize (G_OBJECT (counters));
+}
+
+LauncherCounters*
+launcher_counters_new (void)
+{
+  return LAUNCHER_COUNTERS (g_object_new (launcher_counters_get_type (), NULL));
+}
+
+/*
+ * Hardware events only count user space so that they work for unprivileged 
+ * users, the software events try to include the kernel first since that is 
+ * where context switches happen.
+ */
+static void
+set_attr (struct perf_event_attr *attr,
+          guint32                 type,
+          guint64                 config)
+{
+  memset (attr, 0, sizeof (struct perf_event_attr));
+  attr->size = sizeof (struct perf_event_attr);
+  attr->type = type;
+  attr->config = config;
+  attr->read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  attr->disabled = 1;
+  attr->enable_on_exec = 1;
+  attr->inherit = 1;
+  attr->exclude_hv = 1;
+  attr->exclude_kernel = type != PERF_TYPE_SOFTWARE;
+}
+
+/*
+ * Runs in the child after fork, so only system calls are made here.
+ */
+void
+launcher_counters_child_setup (gpointer counters)
+{
+  LauncherCountersPrivate *priv;
+  struct msghdr message;
+  struct cmsghdr *header;
+  struct iovec iov;
+  union
+  {
+    struct cmsghdr header;
+    gchar          buffer[CMSG_SPACE (sizeof (gint) * LAUNCHER_COUNTER_LAST)];
+  } control;
+  gint fds[LAUNCHER_COUNTER_LAST];
+  guint32 mask = 0;
+  gint n = 0;
+  gint i;
+  
+  priv = LAUNCHER_COUNTERS_GET_PRIVATE (counters);
+  
+  if (priv->sockets[1] < 0)
+    return;
+  
+  for (i = 0; i < LAUNCHER_COUNTER_LAST; i++)
+    {
+      gint fd;
+      fd = open_event (&priv->attrs[i]);
+      if (fd >= 0)
+        {
+          fds[n++] = fd;
+          mask |= 1 << i;
+        }
+    }
+  
+  memset (&message, 0, sizeof (message));
+  iov.iov_base = &mask;
+  iov.iov_len = sizeof (mask);
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  
+  if (n > 0)
+    {
+      message.msg_control = control.buffer;
+      message.msg_controllen = CMSG_SPACE (sizeof (gint) * n);
+      header = CMSG_FIRSTHDR (&message);
+      header->cmsg_level = SOL_SOCKET;
+      header->cmsg_type = SCM_RIGHTS;
+      header->cmsg_len = CMSG_LEN (sizeof (gint) * n);
+      memcpy (CMSG_DATA (header), fds, sizeof (gint) * n);
+    }
+  
+  sendmsg (priv->sockets[1], &message, MSG_NOSIGNAL);
+  
+  for (i = 0; i < n; i++)
+    close (fds[i]);
+}
+
+static gint
+open_event (struct perf_event_attr *attr)
+{
+  gint fd;
+  
+  fd = syscall (__NR_perf_event_open, attr, 0, -1, -1, 0);
+  if (fd < 0 && (errno == EACCES || errno == EPERM) && !attr->exclude_kernel)
+    {
+      attr->exclude_kernel = 1;
+      fd = syscall (__NR_perf_event_open, attr, 0, -1, -1, 0);
+    }
+  
+  return fd;
+}
+
+/*
+ * Called once the child has been spawned. The spawn only returns after the 
+ * exec, so the descriptors have already been sent by then.
+ */
+void
+launcher_counters_receive (LauncherCounters *counters)
+{
+  LauncherCountersPrivate *priv;
+  struct msghdr message;
+  struct cmsghdr *header;
+  struct iovec iov;
+  union
+  {
+    struct cmsghdr header;
+    gchar          buffer[CMSG_SPACE (sizeof (gint) * LAUNCHER_COUNTER_LAST)];
+  } control;
+  guint32 mask = 0;
+  
+  priv = LAUNCHER_COUNTERS_GET_PRIVATE (counters);
+  
+  if (priv->sockets[1] < 0)
+    return;
+
+  close (priv->sockets[1]);
+  priv->sockets[1] = -1;
+
+  memset (&message, 0, sizeof (message));
+  iov.iov_base = &mask;
+  iov.iov_len = sizeof (mask);
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control.buffer;
+  message.msg_controllen = sizeof (control.buffer);
+  
+  if (recvmsg (priv->sockets[0], &message, MSG_DONTWAIT | MSG_CMSG_CLOEXEC) == sizeof (mask))
+    {
+      for (header = CMSG_FIRSTHDR (&message); header != NULL; 
+           header = CMSG_NXTHDR (&message, header))
+        {
+          gint *fds;
+          gint n;
+          gint i;
+          gint j = 0;
+          
+          if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS)
+            continue;
+          
+          fds = (gint *) CMSG_DATA (header);
+          n = (header->cmsg_len - CMSG_LEN (0)) / sizeof (gint);
+          
+          for (i = 0; i < LAUNCHER_COUNTER_LAST && j < n; i++)
+            {
+              if (mask & (1 << i))
+                priv->fds[i] = fds[j++];
+            }
+        }
+    }
+  
+  close (priv->sockets[0]);
+  priv->sockets[0] = -1;
+}
+
+void
+launcher_counters_read (LauncherCounters      *counters,
+                        LauncherCounterValues *values)
+{
+  LauncherCountersPrivate *priv;
+  gint i;
+  
+  priv = LAUNCHER_COUNTERS_GET_PRIVATE (counters);
+  
+  memset (values, 0, sizeof (LauncherCounterValues));
+  
+  for (i = 0; i < LAUNCHER_COUNTER_LAST; i++)
+    {
+      ReadFormat data;
+      
+      if (priv->fds[i] < 0 || 
+          read (priv->fds[i], &data, sizeof (data)) != sizeof (data) ||
+          data.time_running == 0)
+        continue;
+      
+      if (data.time_running < data.time_enabled)
+        values->values[i] = (guint64) ((gdouble) data.value * data.time_enabled / data.time_running);
+      else
+        values->values[i] = data.value;
+      
+      values->mask |= 1 << i;
+    }
+}
+
+gboolean
+launcher_counter_values_has (const LauncherCounterValues *values,
+                             LauncherCounter              counter)
+{
+  return (values->mask & (1 << counter)) != 0;
+}
+
+gdouble
+launcher_counter_values_ratio (const LauncherCounterValues *values,
+                               LauncherCounter              numerator,
+                               LauncherCounter              denominator)
+{
+  if (!launcher_counter_values_has (values, numerator) || 
+      !launcher_counter_values_has (values, denominator) || 
+      values->values[denominator] == 0)
+    return -1;
+  
+  return (gdouble) values->values[numerator] / values->values[denominator];
+}
+
+gchar*
+launcher_counter_values_format (const LauncherCounterValues *values)
+{
+  GString *string;
+  gdouble ratio;
+  
+  if (values->mask == 0)
+    return NULL;
+  
+  string = g_string_new (NULL);
+  
+  ratio = launcher_counter_values_ratio (values, LAUNCHER_COUNTER_INSTRUCTIONS, 
+                                         LAUNCHER_COUNTER_CYCLES);
+  if (ratio >= 0)
+    g_string_append_printf (string, ", IPC %.2f", ratio);
+  
+  ratio = launcher_counter_values_ratio (values, LAUNCHER_COUNTER_BRANCH_MISSES, 
+                                         LAUNCHER_COUNTER_BRANCHES);
+  if (ratio >= 0)
+    g_string_append_printf (string, ", %.2f%% branch misses", ratio * 100);
+  
+  ratio = launcher_counter_values_ratio (values, LAUNCHER_COUNTER_L1D_MISSES, 
+                                         LAUNCHER_COUNTER_L1D_LOADS);
+  if (ratio >= 0)
+    g_string_append_printf (string, ", %.2f%% L1D misses", ratio * 100);
+  
+  ratio = launcher_counter_values_ratio (values, LAUNCHER_COUNTER_LLC_MISSES, 
+                                         LAUNCHER_COUNTER_LLC_REFERENCES);
+  if (ratio >= 0)
+    g_string_append_printf (string, ", %.2f%% LLC misses", ratio * 100);
+  
+  if (launcher_counter_values_has (values, LAUNCHER_COUNTER_CONTEXT_SWITCHES))
+    g_string_append_printf (string, ", %" G_GUINT64_FORMAT " context switches", 
+                            values->values[LAUNCHER_COUNTER_CONTEXT_SWITCHES]);
+  
+  if (launcher_counter_values_has (values, LAUNCHER_COUNTER_PAGE_FAULTS))
+    g_string_append_printf (string, ", %" G_GUINT64_FORMAT " page faults", 
+                            values->values[LAUNCHER_COUNTER_PAGE_FAULTS]);
+  
+  if (string->len == 0)
+    {
+      g_string_free (string, TRUE);
+      return NULL;
+    }
+
+  /* drop the leading separator */
+  g_string_erase (string, 0, 2);
+  return g_string_free (string, FALSE);
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_COUNTERS_H__
+#define	__LAUNCHER_COUNTERS_H__
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_COUNTERS_TYPE            (launcher_counters_get_type ())
+#define LAUNCHER_COUNTERS(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_COUNTERS_TYPE, LauncherCounters))
+#define LAUNCHER_COUNTERS_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_COUNTERS_TYPE, LauncherCountersClass))
+#define IS_LAUNCHER_COUNTERS(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_COUNTERS_TYPE))
+#define IS_LAUNCHER_COUNTERS_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_COUNTERS_TYPE))
+
+typedef struct _LauncherCounters LauncherCounters;
+typedef struct _LauncherCountersClass LauncherCountersClass;
+
+/* the order is part of the history file format, only add to the end */
+typedef enum
+{
+  LAUNCHER_COUNTER_CYCLES,
+  LAUNCHER_COUNTER_INSTRUCTIONS,
+  LAUNCHER_COUNTER_BRANCHES,
+  LAUNCHER_COUNTER_BRANCH_MISSES,
+  LAUNCHER_COUNTER_L1D_LOADS,
+  LAUNCHER_COUNTER_L1D_MISSES,
+  LAUNCHER_COUNTER_LLC_REFERENCES,
+  LAUNCHER_COUNTER_LLC_MISSES,
+  LAUNCHER_COUNTER_CONTEXT_SWITCHES,
+  LAUNCHER_COUNTER_PAGE_FAULTS,
+  LAUNCHER_COUNTER_TASK_CLOCK,
+  LAUNCHER_COUNTER_LAST
+} LauncherCounter;
+
+/* mask has a bit set for each counter that could be read */
+typedef struct
+{
+  guint32 mask;
+  guint64 values[LAUNCHER_COUNTER_LAST];
+} LauncherCounterValues;
+
+struct _LauncherCounters
+{
+  GObject parent_instance;
+};
+
+struct _LauncherCountersClass
+{
+  GObjectClass parent_class;
+};
+
+GType launcher_counters_get_type (void) G_GNUC_CONST;
+
+LauncherCounters*  launcher_counters_new          (void);
+
+void               launcher_counters_child_setup  (gpointer                     counters);
+void               launcher_counters_receive      (LauncherCounters            *counters);
+void               launcher_counters_read         (LauncherCounters            *counters,
+                                                   LauncherCounterValues       *values);
+
+gboolean           launcher_counter_values_has    (const LauncherCounterValues *values,
+                                                   LauncherCounter              counter);
+gdouble            launcher_counter_values_ratio  (const LauncherCounterValues *values,
+                                                   LauncherCounter              numerator,
+                                                   LauncherCounter              denominator);
+gchar*             launcher_counter_values_format (const LauncherCounterValues *values);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_COUNTERS_H__ */
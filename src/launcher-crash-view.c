@@ -0,0 +1,409 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "launcher-crash-view.h"
+
+/*
+ * One row per crash with the threads of its backtrace below it and the 
+ * frames below each thread. A run the watchdog caught gets a row as well, 
+ * with its sampled stacks below it, the most frequent first. Activating a frame that has a source location 
+ * emits "frame-activated" so that the engine can open the file, the view 
+ * itself knows nothing about the editor.
+ */
+
+static void launcher_crash_view_class_init  (LauncherCrashViewClass *klass);
+static void launcher_crash_view_init        (LauncherCrashView      *crash_view);
+static void launcher_crash_view_finalize    (LauncherCrashView      *crash_view);
+
+static void add_column                      (LauncherCrashView      *crash_view,
+                                             const gchar            *title,
+                                             gint                    column);
+static void row_activated_action            (LauncherCrashView      *crash_view,
+                                             GtkTreePath            *path,
+                                             GtkTreeViewColumn      *column);
+static void selection_changed_action        (LauncherCrashView      *crash_view);
+static void prepend_crash                   (LauncherCrashView      *crash_view,
+                                             const gchar            *title,
+                                             const gchar            *description,
+                                             const gchar            *status,
+                                             GtkTreeIter            *iter);
+static void append_frame                    (LauncherCrashView      *crash_view,
+                                             GtkTreeIter            *parent,
+                                             const LauncherCrashFrame *frame,
+                                             const gchar            *status);
+
+#define LAUNCHER_CRASH_VIEW_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_CRASH_VIEW_TYPE, LauncherCrashViewPrivate))
+
+typedef struct _LauncherCrashViewPrivate LauncherCrashViewPrivate;
+
+struct _LauncherCrashViewPrivate
+{
+  GtkWidget    *status_label;
+  GtkWidget    *tree;
+  GtkTreeStore *store;
+};
+
+enum
+{
+  FRAME_ACTIVATED,
+  LAST_SIGNAL
+};
+
+static guint launcher_crash_view_signals[LAST_SIGNAL] = { 0 };
+
+enum
+{
+  NAME = 0,
+  FUNCTION,
+  LOCATION,
+  FILE_PATH,
+  LINE,
+  STATUS,
+  COLUMNS
+};
+
+G_DEFINE_TYPE (LauncherCrashView, launcher_crash_view, GTK_TYPE_BOX)
+
+static void
+launcher_crash_view_class_init (LauncherCrashViewClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  launcher_crash_view_signals[FRAME_ACTIVATED] =
+    g_signal_new ("frame-activated", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherCrashViewClass, frame_activated),
+                  NULL, NULL, 
+                  g_cclosure_marshal_generic, G_TYPE_NONE, 2, G_TYPE_STRING, G_TYPE_INT);
+
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_crash_view_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherCrashViewPrivate));
+}
+
+static void
+launcher_crash_view_init (LauncherCrashView *crash_view)
+{
+  LauncherCrashViewPrivate *priv;
+  GtkTreeSelection *selection;
+  GtkWidget *scrolled_window;
+
+  priv = LAUNCHER_CRASH_VIEW_GET_PRIVATE (crash_view);
+
+  gtk_orientable_set_orientation (GTK_ORIENTABLE (crash_view), GTK_ORIENTATION_VERTICAL);
+  
+  priv->status_label = gtk_label_new (NULL);
+  gtk_misc_set_alignment (GTK_MISC (priv->status_label), 0, .5);
+  gtk_misc_set_padding (GTK_MISC (priv->status_label), 4, 2);
+  gtk_label_set_selectable (GTK_LABEL (priv->status_label), TRUE);
+  gtk_box_pack_start (GTK_BOX (crash_view), priv->status_label, FALSE, FALSE, 0);
+  
+  priv->store = gtk_tree_store_new (COLUMNS, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, 
+                                    G_TYPE_STRING, G_TYPE_INT, G_TYPE_STRING);
+  priv->tree = gtk_tree_view_new_with_model (GTK_TREE_MODEL (priv->store));
+  gtk_tree_view_set_activate_on_single_click (GTK_TREE_VIEW (priv->tree), TRUE);
+  
+  add_column (crash_view, "Crash", NAME);
+  add_column (crash_view, "Function", FUNCTION);
+  add_column (crash_view, "Location", LOCATION);
+  
+  g_signal_connect_swapped (G_OBJECT (priv->tree), "row-activated",
+                            G_CALLBACK (row_activated_action), crash_view);
+  
+  selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (priv->tree));
+  g_signal_connect_swapped (G_OBJECT (selection), "changed",
+                            G_CALLBACK (selection_changed_action), crash_view);
+
+  scrolled_window = gtk_scrolled_window_new (NULL, NULL);
+  gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolled_window),
+                                  GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_container_add (GTK_CONTAINER (scrolled_window), priv->tree);
+  gtk_box_pack_start (GTK_BOX (crash_view), scrolled_window, TRUE, TRUE, 0);
+  
+  selection_changed_action (crash_view);
+}
+
+static void
+launcher_crash_view_finalize (LauncherCrashView *crash_view)
+{
+  LauncherCrashViewPrivate *priv;
+  priv = LAUNCHER_CRASH_VIEW_GET_PRIVATE (crash_view);
+  g_object_unref (priv->store);
+  G_OBJECT_CLASS (launcher_crash_view_parent_class)->finalize (G_OBJECT (crash_view));
+}
+
+GtkWidget*
+launcher_crash_view_new (void)
+{
+  return g_object_new (launcher_crash_view_get_type (), NULL);
+}
+
+static void
+add_column (LauncherCrashView *crash_view,
+            const gchar       *title,
+            gint               column)
+{
+  LauncherCrashViewPrivate *priv;
+  GtkCellRenderer *renderer;
+  GtkTreeViewColumn *tree_column;
+  
+  priv = LAUNCHER_CRASH_VIEW_GET_PRIVATE (crash_view);
+  
+  renderer = gtk_cell_renderer_text_new ();
+  tree_column = gtk_tree_view_column_new ();
+  gtk_tree_view_column_set_title (tree_column, title);
+  gtk_tree_view_column_pack_start (tree_column, renderer, TRUE);
+  gtk_tree_view_column_add_attribute (tree_column, renderer, "text", column);
+  gtk_tree_view_column_set_expand (tree_column, column == LOCATION);
+  gtk_tree_view_append_column (GTK_TREE_VIEW (priv->tree), tree_column);
+}
+
+/*
+ * The thread that crashed is the first one the debugger lists, so it is 
+ * the one shown expanded.
+ */
+void
+launcher_crash_view_add (LauncherCrashView *crash_view,
+                         const gchar       *title,
+                         LauncherCrash     *crash)
+{
+  LauncherCrashViewPrivate *priv;
+  GtkTreeIter crash_iter;
+  GtkTreeIter thread_iter;
+  GtkTreePath *path;
+  gchar *description;
+  gchar *status;
+  gint thread = 0;
+  guint i;
+
+  priv = LAUNCHER_CRASH_VIEW_GET_PRIVATE (crash_view);
+  
+  description = g_strdup_printf ("%s (signal %d)", 
+                                 g_strsignal (launcher_crash_get_signal (crash)),
+                                 launcher_crash_get_signal (crash));
+  status = g_strdup_printf ("%s crashed, the core is %s", 
+                            launcher_crash_get_program (crash),
+                            launcher_crash_get_core_path (crash));
+  prepend_crash (crash_view, title, description, status, &crash_iter);
+  g_free (description);
+  
+  for (i = 0; i < launcher_crash_get_n_frames (crash); i++)
+    {
+      const LauncherCrashFrame *frame;
+      
+      frame = launcher_crash_get_frame (crash, i);
+      
+      if (frame->thread != thread)
+        {
+          gchar *name;
+          thread = frame->thread;
+          name = g_strdup_printf ("Thread %d", thread);
+          gtk_tree_store_append (priv->store, &thread_iter, &crash_iter);
+          gtk_tree_store_set (priv->store, &thread_iter, 
+                              NAME, name, 
+                              LINE, 0,
+                              STATUS, status, 
+                              -1);
+          g_free (name);
+        }
+      
+      append_frame (crash_view, &thread_iter, frame, status);
+    }
+  
+  g_free (status);
+  
+  if (thread == 0)
+    return;
+  
+  path = gtk_tree_model_get_path (GTK_TREE_MODEL (priv->store), &crash_iter);
+  gtk_tree_path_down (path);
+  gtk_tree_view_expand_to_path (GTK_TREE_VIEW (priv->tree), path);
+  gtk_tree_path_free (path);
+}
+
+/*
+ * The stacks are already in order, the most frequent one is expanded.
+ */
+void
+launcher_crash_view_add_hang (LauncherCrashView *crash_view,
+                              const gchar       *title,
+                              LauncherHang      *hang)
+{
+  LauncherCrashViewPrivate *priv;
+  GtkTreeIter hang_iter;
+  GtkTreePath *path;
+  gchar *description;
+  gchar *status;
+  guint i;
+  guint j;
+
+  priv = LAUNCHER_CRASH_VIEW_GET_PRIVATE (crash_view);
+  
+  description = g_strdup_printf ("Hung, %s", launcher_hang_get_reason (hang));
+  status = g_strdup_printf ("Process %d was sampled %u times before it was terminated", 
+                            launcher_hang_get_pid (hang), 
+                            launcher_hang_get_n_samples (hang));
+  prepend_crash (crash_view, title, description, status, &hang_iter);
+  g_free (description);
+  
+  for (i = 0; i < launcher_hang_get_n_stacks (hang); i++)
+    {
+      const LauncherHangStack *stack;
+      const LauncherCrashFrame *top;
+      GtkTreeIter stack_iter;
+      gchar *name;
+      
+      stack = launcher_hang_get_stack (hang, i);
+      top = g_ptr_array_index (stack->frames, 0);
+      
+      name = g_strdup_printf ("%u of %u", stack->count, launcher_hang_get_n_samples (hang));
+      gtk_tree_store_append (priv->store, &stack_iter, &hang_iter);
+      gtk_tree_store_set (priv->store, &stack_iter, 
+                          NAME, name, 
+                          FUNCTION, top->function,
+                          LINE, 0,
+                          STATUS, status, 
+                          -1);
+      g_free (name);
+      
+      for (j = 0; j < stack->frames->len; j++)
+        append_frame (crash_view, &stack_iter, g_ptr_array_index (stack->frames, j), status);
+    }
+  
+  g_free (status);
+  
+  if (launcher_hang_get_n_stacks (hang) == 0)
+    return;
+  
+  path = gtk_tree_model_get_path (GTK_TREE_MODEL (priv->store), &hang_iter);
+  gtk_tree_path_down (path);
+  gtk_tree_view_expand_to_path (GTK_TREE_VIEW (priv->tree), path);
+  gtk_tree_path_free (path);
+}
+
+/*
+ * A crash whose core or backtrace could not be had is still listed, with 
+ * the reason in place of the frames.
+ */
+void
+launcher_crash_view_add_failure (LauncherCrashView *crash_view,
+                                 const gchar       *title,
+                                 const gchar       *message)
+{
+  GtkTreeIter iter;
+  prepend_crash (crash_view, title, NULL, message, &iter);
+}
+
+static void
+prepend_crash (LauncherCrashView *crash_view,
+               const gchar       *title,
+               const gchar       *description,
+               const gchar       *status,
+               GtkTreeIter       *iter)
+{
+  LauncherCrashViewPrivate *priv;
+  GtkTreeSelection *selection;
+  
+  priv = LAUNCHER_CRASH_VIEW_GET_PRIVATE (crash_view);
+  
+  gtk_tree_store_prepend (priv->store, iter, NULL);
+  gtk_tree_store_set (priv->store, iter, 
+                      NAME, title, 
+                      FUNCTION, description, 
+                      LINE, 0,
+                      STATUS, status, 
+                      -1);
+  
+  selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (priv->tree));
+  gtk_tree_selection_select_iter (selection, iter);
+}
+
+static void
+append_frame (LauncherCrashView        *crash_view,
+              GtkTreeIter              *parent,
+              const LauncherCrashFrame *frame,
+              const gchar              *status)
+{
+  LauncherCrashViewPrivate *priv;
+  GtkTreeIter iter;
+  gchar *name;
+  gchar *location = NULL;
+  
+  priv = LAUNCHER_CRASH_VIEW_GET_PRIVATE (crash_view);
+  
+  name = g_strdup_printf ("#%d", frame->level);
+  if (frame->file_path != NULL)
+    location = g_strdup_printf ("%s:%d", frame->file_path, frame->line);
+  
+  gtk_tree_store_append (priv->store, &iter, parent);
+  gtk_tree_store_set (priv->store, &iter, 
+                      NAME, name, 
+                      FUNCTION, frame->function, 
+                      LOCATION, location, 
+                      FILE_PATH, frame->file_path, 
+                      LINE, frame->line, 
+                      STATUS, status, 
+                      -1);
+  g_free (name);
+  g_free (location);
+}
+
+static void
+row_activated_action (LauncherCrashView *crash_view,
+                      GtkTreePath       *path,
+                      GtkTreeViewColumn *column)
+{
+  LauncherCrashViewPrivate *priv;
+  GtkTreeIter iter;
+  gchar *file_path;
+  gint line;
+  
+  priv = LAUNCHER_CRASH_VIEW_GET_PRIVATE (crash_view);
+  
+  if (!gtk_tree_model_get_iter (GTK_TREE_MODEL (priv->store), &iter, path))
+    return;
+  
+  gtk_tree_model_get (GTK_TREE_MODEL (priv->store), &iter, 
+                      FILE_PATH, &file_path, LINE, &line, -1);
+  
+  if (file_path != NULL && line > 0)
+    g_signal_emit_by_name ((gpointer) crash_view, "frame-activated", file_path, line);
+  
+  g_free (file_path);
+}
+
+static void
+selection_changed_action (LauncherCrashView *crash_view)
+{
+  LauncherCrashViewPrivate *priv;
+  GtkTreeSelection *selection;
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  gchar *status = NULL;
+
+  priv = LAUNCHER_CRASH_VIEW_GET_PRIVATE (crash_view);
+  
+  selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (priv->tree));
+  if (gtk_tree_selection_get_selected (selection, &model, &iter))
+    gtk_tree_model_get (model, &iter, STATUS, &status, -1);
+  
+  gtk_label_set_text (GTK_LABEL (priv->status_label), 
+                      status != NULL ? status : "No crashes");
+  g_free (status);
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_CRASH_VIEW_H__
+#define	__LAUNCHER_CRASH_VIEW_H__
+
+#include <gtk/gtk.h>
+#include "launcher-crash.h"
+#include "launcher-hang.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_CRASH_VIEW_TYPE            (launcher_crash_view_get_type ())
+#define LAUNCHER_CRASH_VIEW(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_CRASH_VIEW_TYPE, LauncherCrashView))
+#define LAUNCHER_CRASH_VIEW_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_CRASH_VIEW_TYPE, LauncherCrashViewClass))
+#define IS_LAUNCHER_CRASH_VIEW(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_CRASH_VIEW_TYPE))
+#define IS_LAUNCHER_CRASH_VIEW_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_CRASH_VIEW_TYPE))
+
+typedef struct _LauncherCrashView LauncherCrashView;
+typedef struct _LauncherCrashViewClass LauncherCrashViewClass;
+
+struct _LauncherCrashView
+{
+  GtkBox parent_instance;
+};
+
+struct _LauncherCrashViewClass
+{
+  GtkBoxClass parent_class;
+  
+  void (*frame_activated) (LauncherCrashView *crash_view,
+                           const gchar       *file_path,
+                           gint               line);
+};
+
+GType launcher_crash_view_get_type (void) G_GNUC_CONST;
+     
+GtkWidget*  launcher_crash_view_new          (void);
+
+void        launcher_crash_view_add          (LauncherCrashView *crash_view,
+                                              const gchar       *title,
+                                              LauncherCrash     *crash);
+void        launcher_crash_view_add_hang     (LauncherCrashView *crash_view,
+                                              const gchar       *title,
+                                              LauncherHang      *hang);
+void        launcher_crash_view_add_failure  (LauncherCrashView *crash_view,
+                                              const gchar       *title,
+                                              const gchar       *message);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_CRASH_VIEW_H__ */
@@ -0,0 +1,734 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <glib/gstdio.h>
+#include "launcher-crash.h"
+
+/*
+ * Finds the core a crashed program left behind, moves it into the crash 
+ * folder of the project and asks gdb, or eu-stack when there is no gdb, for 
+ * the backtrace of every thread. Cores can be gigabytes and the debugger 
+ * takes its time loading the symbols, so everything happens on a worker 
+ * thread. Where the kernel puts the core depends on kernel.core_pattern, a 
+ * file pattern is looked up directly and systemd-coredump is asked through 
+ * coredumpctl, any other core handler is not supported.
+ */
+
+static void launcher_crash_class_init  (LauncherCrashClass *klass);
+static void launcher_crash_init        (LauncherCrash      *crash);
+static void launcher_crash_finalize    (LauncherCrash      *crash);
+
+static void collect_thread             (GTask              *task,
+                                        LauncherCrash      *crash,
+                                        gpointer            task_data,
+                                        GCancellable       *cancellable);
+static gboolean take_core              (LauncherCrash      *crash,
+                                        GCancellable       *cancellable,
+                                        GError            **error);
+static gboolean dump_coredumpctl       (LauncherCrash      *crash,
+                                        GCancellable       *cancellable,
+                                        GError            **error);
+static gchar* find_core_file           (LauncherCrash      *crash,
+                                        const gchar        *pattern);
+static gchar* expand_core_pattern      (LauncherCrash      *crash,
+                                        const gchar        *pattern);
+static void prune_cores                (const gchar        *crash_folder);
+static gboolean run_debugger           (LauncherCrash      *crash,
+                                        GCancellable       *cancellable,
+                                        GError            **error);
+static void frame_free                 (LauncherCrashFrame *frame);
+
+#define LAUNCHER_CRASH_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_CRASH_TYPE, LauncherCrashPrivate))
+
+typedef struct _LauncherCrashPrivate LauncherCrashPrivate;
+
+struct _LauncherCrashPrivate
+{
+  GPid       pid;
+  gint       signal;
+  gchar     *program;
+  gchar     *working_directory;
+  gchar     *crash_folder;
+  gchar     *core_path;
+  gchar     *backtrace;
+  GPtrArray *frames;
+};
+
+#define CORE_PATTERN "/proc/sys/kernel/core_pattern"
+#define CORE_USES_PID "/proc/sys/kernel/core_uses_pid"
+
+/* the task name the kernel puts in %e is cut at 15 characters */
+#define COMM_LENGTH 15
+
+/* systemd-coredump writes the core after the parent has seen the exit */
+#define COREDUMPCTL_ATTEMPTS 20
+#define COREDUMPCTL_INTERVAL 500000
+
+#define MAX_CORES 5
+
+G_DEFINE_TYPE (LauncherCrash, launcher_crash, G_TYPE_OBJECT)
+
+static void
+launcher_crash_class_init (LauncherCrashClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_crash_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherCrashPrivate));
+}
+
+static void
+launcher_crash_init (LauncherCrash *crash)
+{
+  LauncherCrashPrivate *priv;
+  priv = LAUNCHER_CRASH_GET_PRIVATE (crash);
+  priv->pid = 0;
+  priv->signal = 0;
+  priv->program = NULL;
+  priv->working_directory = NULL;
+  priv->crash_folder = NULL;
+  priv->core_path = NULL;
+  priv->backtrace = NULL;
+  priv->frames = NULL;
+}
+
+static void
+launcher_crash_finalize (LauncherCrash *crash)
+{
+  LauncherCrashPrivate *priv;
+  priv = LAUNCHER_CRASH_GET_PRIVATE (crash);
+  g_free (priv->program);
+  g_free (priv->working_directory);
+  g_free (priv->crash_folder);
+  g_free (priv->core_path);
+  g_free (priv->backtrace);
+  if (priv->frames != NULL)
+    g_ptr_array_unref (priv->frames);
+  G_OBJECT_CLASS (launcher_crash_parent_class)->finalize (G_OBJECT (crash));
+}
+
+/*
+ * The program is the first word of the command, it is looked up in the 
+ * working directory or on the path the way the shell would have. Without 
+ * a working directory the child ran in the one of the editor.
+ */
+void
+launcher_crash_collect_async (GPid                 pid,
+                              gint                 signal,
+                              const gchar         *program,
+                              const gchar         *working_directory,
+                              const gchar         *crash_folder,
+                              GCancellable        *cancellable,
+                              GAsyncReadyCallback  callback,
+                              gpointer             user_data)
+{
+  LauncherCrashPrivate *priv;
+  LauncherCrash *crash;
+  GTask *task;
+
+  crash = LAUNCHER_CRASH (g_object_new (launcher_crash_get_type (), NULL));
+  priv = LAUNCHER_CRASH_GET_PRIVATE (crash);
+  priv->pid = pid;
+  priv->signal = signal;
+  priv->crash_folder = g_strdup (crash_folder);
+  
+  if (working_directory != NULL)
+    priv->working_directory = g_strdup (working_directory);
+  else
+    priv->working_directory = g_get_current_dir ();
+  
+  if (program == NULL)
+    priv->program = NULL;
+  else if (g_path_is_absolute (program))
+    priv->program = g_strdup (program);
+  else if (strchr (program, G_DIR_SEPARATOR) != NULL)
+    priv->program = g_build_filename (priv->working_directory, program, NULL);
+  else
+    priv->program = g_find_program_in_path (program);
+
+  task = g_task_new (crash, cancellable, callback, user_data);
+  g_task_run_in_thread (task, (GTaskThreadFunc) collect_thread);
+  g_object_unref (task);
+  g_object_unref (crash);
+}
+
+LauncherCrash*
+launcher_crash_collect_finish (GAsyncResult  *result,
+                               GError       **error)
+{
+  if (!g_task_propagate_boolean (G_TASK (result), error))
+    return NULL;
+  return g_object_ref (g_task_get_source_object (G_TASK (result)));
+}
+
+GPid
+launcher_crash_get_pid (LauncherCrash *crash)
+{
+  return LAUNCHER_CRASH_GET_PRIVATE (crash)->pid;
+}
+
+gint
+launcher_crash_get_signal (LauncherCrash *crash)
+{
+  return LAUNCHER_CRASH_GET_PRIVATE (crash)->signal;
+}
+
+const gchar*
+launcher_crash_get_program (LauncherCrash *crash)
+{
+  return LAUNCHER_CRASH_GET_PRIVATE (crash)->program;
+}
+
+const gchar*
+launcher_crash_get_core_path (LauncherCrash *crash)
+{
+  return LAUNCHER_CRASH_GET_PRIVATE (crash)->core_path;
+}
+
+/*
+ * The debugger output as it was printed, the frames are parsed from it.
+ */
+const gchar*
+launcher_crash_get_backtrace (LauncherCrash *crash)
+{
+  return LAUNCHER_CRASH_GET_PRIVATE (crash)->backtrace;
+}
+
+guint
+launcher_crash_get_n_frames (LauncherCrash *crash)
+{
+  return LAUNCHER_CRASH_GET_PRIVATE (crash)->frames->len;
+}
+
+const LauncherCrashFrame*
+launcher_crash_get_frame (LauncherCrash *crash,
+                          guint          index)
+{
+  return g_ptr_array_index (LAUNCHER_CRASH_GET_PRIVATE (crash)->frames, index);
+}
+
+static void
+collect_thread (GTask         *task,
+                LauncherCrash *crash,
+                gpointer       task_data,
+                GCancellable  *cancellable)
+{
+  LauncherCrashPrivate *priv;
+  GError *error = NULL;
+  
+  priv = LAUNCHER_CRASH_GET_PRIVATE (crash);
+  
+  if (priv->program == NULL)
+    {
+      g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+                               "Not able to find the program of process %d", priv->pid);
+      return;
+    }
+  
+  if (g_mkdir_with_parents (priv->crash_folder, 0755) != 0)
+    {
+      g_task_return_new_error (task, G_IO_ERROR, g_io_error_from_errno (errno),
+                               "Not able to create %s", priv->crash_folder);
+      return;
+    }
+  
+  if (!take_core (crash, cancellable, &error) || 
+      !run_debugger (crash, cancellable, &error))
+    {
+      g_task_return_error (task, error);
+      return;
+    }
+  
+  prune_cores (priv->crash_folder);
+  priv->frames = launcher_crash_parse_frames (priv->backtrace);
+  g_task_return_boolean (task, TRUE);
+}
+
+/*
+ * Leaves the core in the crash folder under a name that tells which 
+ * program it came from.
+ */
+static gboolean
+take_core (LauncherCrash  *crash,
+           GCancellable   *cancellable,
+           GError        **error)
+{
+  LauncherCrashPrivate *priv;
+  gchar *pattern;
+  gchar *file_path;
+  gchar *name;
+  gchar *program_name;
+  GFile *source;
+  GFile *destination;
+  gboolean result;
+  
+  priv = LAUNCHER_CRASH_GET_PRIVATE (crash);
+  
+  if (!g_file_get_contents (CORE_PATTERN, &pattern, NULL, error))
+    return FALSE;
+  g_strchomp (pattern);
+  
+  program_name = g_path_get_basename (priv->program);
+  name = g_strdup_printf ("core.%s.%d", program_name, priv->pid);
+  priv->core_path = g_build_filename (priv->crash_folder, name, NULL);
+  g_free (program_name);
+  g_free (name);
+  
+  if (*pattern == '|')
+    {
+      if (strstr (pattern, "systemd-coredump") != NULL)
+        {
+          g_free (pattern);
+          return dump_coredumpctl (crash, cancellable, error);
+        }
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                   "Cores are handed to %s", pattern + 1);
+      g_free (pattern);
+      return FALSE;
+    }
+  
+  file_path = find_core_file (crash, pattern);
+  g_free (pattern);
+  
+  if (file_path == NULL)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+                   "Process %d did not leave a core in %s", 
+                   priv->pid, priv->working_directory);
+      return FALSE;
+    }
+  
+  /* across file systems this is a copy, which is why it is not done inline */
+  source = g_file_new_for_path (file_path);
+  destination = g_file_new_for_path (priv->core_path);
+  result = g_file_move (source, destination, G_FILE_COPY_OVERWRITE, 
+                        cancellable, NULL, NULL, error);
+  g_object_unref (source);
+  g_object_unref (destination);
+  g_free (file_path);
+  
+  return result;
+}
+
+static gboolean
+dump_coredumpctl (LauncherCrash  *crash,
+                  GCancellable   *cancellable,
+                  GError        **error)
+{
+  LauncherCrashPrivate *priv;
+  gchar *pid;
+  gint attempt;
+  
+  priv = LAUNCHER_CRASH_GET_PRIVATE (crash);
+  pid = g_strdup_printf ("%d", priv->pid);
+  
+  for (attempt = 0; attempt < COREDUMPCTL_ATTEMPTS; attempt++)
+    {
+      GSubprocess *subprocess;
+      
+      if (attempt > 0)
+        g_usleep (COREDUMPCTL_INTERVAL);
+      
+      if (g_cancellable_set_error_if_cancelled (cancellable, error))
+        {
+          g_free (pid);
+          return FALSE;
+        }
+      
+      subprocess = g_subprocess_new (G_SUBPROCESS_FLAGS_STDOUT_SILENCE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, 
+                                     error, "coredumpctl", "--no-pager", "--quiet",
+                                     "--output", priv->core_path, "dump", pid, NULL);
+      if (subprocess == NULL)
+        {
+          g_free (pid);
+          return FALSE;
+        }
+      
+      if (!g_subprocess_wait (subprocess, cancellable, error))
+        {
+          g_object_unref (subprocess);
+          g_free (pid);
+          return FALSE;
+        }
+      
+      if (g_subprocess_get_successful (subprocess) && 
+          g_file_test (priv->core_path, G_FILE_TEST_EXISTS))
+        {
+          g_object_unref (subprocess);
+          g_free (pid);
+          return TRUE;
+        }
+      
+      g_object_unref (subprocess);
+    }
+  
+  g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+               "systemd-coredump has no core of process %s", pid);
+  g_free (pid);
+  return FALSE;
+}
+
+/*
+ * Specifiers that cannot be known here, like the time of the crash, become 
+ * wildcards and the newest match is taken.
+ */
+static gchar*
+find_core_file (LauncherCrash *crash,
+                const gchar   *pattern)
+{
+  LauncherCrashPrivate *priv;
+  gchar *expanded;
+  gchar *file_path;
+  gchar *folder_path;
+  gchar *name;
+  GPatternSpec *spec;
+  GDir *dir;
+  const gchar *entry;
+  gint64 newest = 0;
+  
+  priv = LAUNCHER_CRASH_GET_PRIVATE (crash);
+  
+  expanded = expand_core_pattern (crash, pattern);
+  if (g_path_is_absolute (expanded))
+    file_path = expanded;
+  else
+    {
+      file_path = g_build_filename (priv->working_directory, expanded, NULL);
+      g_free (expanded);
+    }
+  
+  if (strchr (file_path, '*') == NULL)
+    {
+      if (g_file_test (file_path, G_FILE_TEST_IS_REGULAR))
+        return file_path;
+      g_free (file_path);
+      return NULL;
+    }
+  
+  folder_path = g_path_get_dirname (file_path);
+  name = g_path_get_basename (file_path);
+  g_free (file_path);
+  file_path = NULL;
+  
+  dir = g_dir_open (folder_path, 0, NULL);
+  if (dir == NULL)
+    {
+      g_free (folder_path);
+      g_free (name);
+      return NULL;
+    }
+  
+  spec = g_pattern_spec_new (name);
+  while ((entry = g_dir_read_name (dir)) != NULL)
+    {
+      GStatBuf buf;
+      gchar *entry_path;
+      
+      if (!g_pattern_match_string (spec, entry))
+        continue;
+      
+      entry_path = g_build_filename (folder_path, entry, NULL);
+      if (g_stat (entry_path, &buf) == 0 && S_ISREG (buf.st_mode) && buf.st_mtime >= newest)
+        {
+          newest = buf.st_mtime;
+          g_free (file_path);
+          file_path = entry_path;
+        }
+      else
+        {
+          g_free (entry_path);
+        }
+    }
+  
+  g_pattern_spec_free (spec);
+  g_dir_close (dir);
+  g_free (folder_path);
+  g_free (name);
+  
+  return file_path;
+}
+
+static gchar*
+expand_core_pattern (LauncherCrash *crash,
+                     const gchar   *pattern)
+{
+  LauncherCrashPrivate *priv;
+  GString *string;
+  gboolean has_pid = FALSE;
+  gchar *uses_pid;
+  const gchar *c;
+  
+  priv = LAUNCHER_CRASH_GET_PRIVATE (crash);
+  string = g_string_new (NULL);
+  
+  for (c = pattern; *c != '\0'; c++)
+    {
+      if (*c != '%')
+        {
+          g_string_append_c (string, *c);
+          continue;
+        }
+      
+      c++;
+      switch (*c)
+        {
+        case '\0':
+          c--;
+          break;
+        case '%':
+          g_string_append_c (string, '%');
+          break;
+        case 'p':
+        case 'P':
+          g_string_append_printf (string, "%d", priv->pid);
+          has_pid = TRUE;
+          break;
+        case 's':
+          g_string_append_printf (string, "%d", priv->signal);
+          break;
+        case 'u':
+          g_string_append_printf (string, "%d", (gint) getuid ());
+          break;
+        case 'g':
+          g_string_append_printf (string, "%d", (gint) getgid ());
+          break;
+        case 'h':
+          g_string_append (string, g_get_host_name ());
+          break;
+        case 'e':
+          {
+            gchar *name;
+            name = g_path_get_basename (priv->program);
+            g_string_append_len (string, name, MIN (strlen (name), COMM_LENGTH));
+            g_free (name);
+          }
+          break;
+        default:
+          g_string_append_c (string, '*');
+          break;
+        }
+    }
+  
+  if (!has_pid && 
+      g_file_get_contents (CORE_USES_PID, &uses_pid, NULL, NULL))
+    {
+      if (atoi (uses_pid) != 0)
+        g_string_append_printf (string, ".%d", priv->pid);
+      g_free (uses_pid);
+    }
+  
+  return g_string_free (string, FALSE);
+}
+
+/*
+ * Cores are big, only the newest few of a project are kept.
+ */
+static void
+prune_cores (const gchar *crash_folder)
+{
+  GDir *dir;
+  GPtrArray *cores;
+  const gchar *entry;
+  guint i;
+  
+  dir = g_dir_open (crash_folder, 0, NULL);
+  if (dir == NULL)
+    return;
+  
+  cores = g_ptr_array_new_with_free_func (g_free);
+  while ((entry = g_dir_read_name (dir)) != NULL)
+    {
+      if (g_str_has_prefix (entry, "core."))
+        g_ptr_array_add (cores, g_build_filename (crash_folder, entry, NULL));
+    }
+  g_dir_close (dir);
+  
+  while (cores->len > MAX_CORES)
+    {
+      guint oldest = 0;
+      time_t oldest_time = 0;
+      
+      for (i = 0; i < cores->len; i++)
+        {
+          GStatBuf buf;
+          if (g_stat (g_ptr_array_index (cores, i), &buf) != 0)
+            continue;
+          if (oldest_time == 0 || buf.st_mtime < oldest_time)
+            {
+              oldest = i;
+              oldest_time = buf.st_mtime;
+            }
+        }
+      
+      g_unlink (g_ptr_array_index (cores, oldest));
+      g_ptr_array_remove_index_fast (cores, oldest);
+    }
+  
+  g_ptr_array_free (cores, TRUE);
+}
+
+/*
+ * Absolute file names let the frames be opened no matter where the 
+ * program was compiled.
+ */
+static gboolean
+run_debugger (LauncherCrash  *crash,
+              GCancellable   *cancellable,
+              GError        **error)
+{
+  LauncherCrashPrivate *priv;
+  GSubprocess *subprocess;
+  GError *spawn_error = NULL;
+  gchar *core_option;
+  gchar *program_option;
+  gboolean result;
+  
+  priv = LAUNCHER_CRASH_GET_PRIVATE (crash);
+  
+  subprocess = g_subprocess_new (G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, 
+                                 &spawn_error, "gdb", "-batch", "-nx", 
+                                 "-ex", "set filename-display absolute",
+                                 "-ex", "thread apply all bt",
+                                 priv->program, priv->core_path, NULL);
+  
+  if (subprocess == NULL && g_error_matches (spawn_error, G_SPAWN_ERROR, G_SPAWN_ERROR_NOENT))
+    {
+      g_clear_error (&spawn_error);
+      core_option = g_strconcat ("--core=", priv->core_path, NULL);
+      program_option = g_strconcat ("--executable=", priv->program, NULL);
+      subprocess = g_subprocess_new (G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, 
+                                     &spawn_error, "eu-stack", "-s", "-m", 
+                                     core_option, program_option, NULL);
+      g_free (core_option);
+      g_free (program_option);
+    }
+  
+  if (subprocess == NULL)
+    {
+      g_propagate_error (error, spawn_error);
+      return FALSE;
+    }
+  
+  result = g_subprocess_communicate_utf8 (subprocess, NULL, cancellable, 
+                                          &priv->backtrace, NULL, error);
+  g_object_unref (subprocess);
+  
+  if (result && (priv->backtrace == NULL || *priv->backtrace == '\0'))
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                   "The debugger printed no backtrace for %s", priv->core_path);
+      return FALSE;
+    }
+  
+  return result;
+}
+
+/*
+ * Returns the frames of a gdb or eu-stack backtrace in the order they were 
+ * printed. gdb puts the location at the end of the frame line, "#1  0x... 
+ * in main (argc=1, argv=...) at /src/main.c:12", while eu-stack puts it on 
+ * the line after the frame. A new thread starts at "Thread " for gdb and 
+ * "TID " for eu-stack.
+ */
+GPtrArray*
+launcher_crash_parse_frames (const gchar *backtrace)
+{
+  GPtrArray *frames;
+  LauncherCrashFrame *frame = NULL;
+  GRegex *frame_regex;
+  GRegex *location_regex;
+  GRegex *source_regex;
+  gchar **lines;
+  gchar **line;
+  gint thread = 0;
+  
+  frames = g_ptr_array_new_with_free_func ((GDestroyNotify) frame_free);
+  
+  frame_regex = g_regex_new ("^#(\\d+)\\s+(?:0x[0-9a-fA-F]+\\s+(?:in\\s+)?)?([^\\s(]+)", 0, 0, NULL);
+  location_regex = g_regex_new (" at (\\S+):(\\d+)\\s*$", 0, 0, NULL);
+  source_regex = g_regex_new ("^\\s+(/\\S+):(\\d+)(?::\\d+)?\\s*$", 0, 0, NULL);
+  
+  lines = g_strsplit (backtrace, "\n", -1);
+  for (line = lines; *line != NULL; line++)
+    {
+      GMatchInfo *match_info;
+      
+      if (g_str_has_prefix (*line, "Thread ") || g_str_has_prefix (*line, "TID "))
+        {
+          thread++;
+          frame = NULL;
+          continue;
+        }
+      
+      if (g_regex_match (frame_regex, *line, 0, &match_info))
+        {
+          gchar *level;
+          level = g_match_info_fetch (match_info, 1);
+          frame = g_new0 (LauncherCrashFrame, 1);
+          frame->thread = MAX (thread, 1);
+          frame->level = atoi (level);
+          frame->function = g_match_info_fetch (match_info, 2);
+          g_ptr_array_add (frames, frame);
+          g_free (level);
+          g_match_info_free (match_info);
+          
+          if (g_regex_match (location_regex, *line, 0, &match_info))
+            {
+              gchar *number;
+              number = g_match_info_fetch (match_info, 2);
+              frame->file_path = g_match_info_fetch (match_info, 1);
+              frame->line = atoi (number);
+              g_free (number);
+            }
+          g_match_info_free (match_info);
+          continue;
+        }
+      g_match_info_free (match_info);
+      
+      if (frame != NULL && frame->file_path == NULL &&
+          g_regex_match (source_regex, *line, 0, &match_info))
+        {
+          gchar *number;
+          number = g_match_info_fetch (match_info, 2);
+          frame->file_path = g_match_info_fetch (match_info, 1);
+          frame->line = atoi (number);
+          g_free (number);
+        }
+      g_match_info_free (match_info);
+    }
+  
+  g_strfreev (lines);
+  g_regex_unref (frame_regex);
+  g_regex_unref (location_regex);
+  g_regex_unref (source_regex);
+  
+  return frames;
+}
+
+static void
+frame_free (LauncherCrashFrame *frame)
+{
+  g_free (frame->function);
+  g_free (frame->file_path);
+  g_free (frame);
+}
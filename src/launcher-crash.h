@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_CRASH_H__
+#define	__LAUNCHER_CRASH_H__
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_CRASH_TYPE            (launcher_crash_get_type ())
+#define LAUNCHER_CRASH(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_CRASH_TYPE, LauncherCrash))
+#define LAUNCHER_CRASH_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_CRASH_TYPE, LauncherCrashClass))
+#define IS_LAUNCHER_CRASH(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_CRASH_TYPE))
+#define IS_LAUNCHER_CRASH_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_CRASH_TYPE))
+
+typedef struct _LauncherCrash LauncherCrash;
+typedef struct _LauncherCrashClass LauncherCrashClass;
+
+typedef struct
+{
+  gint   thread;
+  gint   level;
+  gchar *function;
+  gchar *file_path;
+  gint   line;
+} LauncherCrashFrame;
+
+struct _LauncherCrash
+{
+  GObject parent_instance;
+};
+
+struct _LauncherCrashClass
+{
+  GObjectClass parent_class;
+};
+
+GType launcher_crash_get_type (void) G_GNUC_CONST;
+
+void                      launcher_crash_collect_async   (GPid                  pid,
+                                                          gint                  signal,
+                                                          const gchar          *program,
+                                                          const gchar          *working_directory,
+                                                          const gchar          *crash_folder,
+                                                          GCancellable         *cancellable,
+                                                          GAsyncReadyCallback   callback,
+                                                          gpointer              user_data);
+LauncherCrash*            launcher_crash_collect_finish  (GAsyncResult         *result,
+                                                          GError              **error);
+
+GPid                      launcher_crash_get_pid         (LauncherCrash        *crash);
+gint                      launcher_crash_get_signal      (LauncherCrash        *crash);
+const gchar*              launcher_crash_get_program     (LauncherCrash        *crash);
+const gchar*              launcher_crash_get_core_path   (LauncherCrash        *crash);
+const gchar*              launcher_crash_get_backtrace   (LauncherCrash        *crash);
+guint                     launcher_crash_get_n_frames    (LauncherCrash        *crash);
+const LauncherCrashFrame* launcher_crash_get_frame       (LauncherCrash        *crash,
+                                                          guint                 index);
+
+GPtrArray*                launcher_crash_parse_frames    (const gchar          *backtrace);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_CRASH_H__ */
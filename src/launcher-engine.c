@@ -16,16 +16,118 @@
  * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
  */
 
+#include <sys/wait.h>
 #include <codeslayer/codeslayer-utils.h>
 #include "launcher-engine.h"
 #include "launcher-project-properties.h"
 #include "launcher-config.h"
+#include "launcher-core.h"
+#include "launcher-process.h"
+#include "launcher-output.h"
+#include "launcher-benchmark.h"
+#include "launcher-benchmark-view.h"
+#include "launcher-sweep.h"
+#include "launcher-sweep-view.h"
+#include "launcher-history.h"
+#include "launcher-profiler.h"
+#include "launcher-reports.h"
+#include "launcher-annotations.h"
+#include "launcher-annotator.h"
+#include "launcher-group.h"
+#include "launcher-probe.h"
+#include "launcher-build.h"
+#include "launcher-watch.h"
+#include "launcher-prefetch.h"
+#include "launcher-resources.h"
+#include "launcher-profile-index.h"
+#include "launcher-profile-picker.h"
+#include "launcher-scheduler.h"
+#include "launcher-jobs-view.h"
+#include "launcher-monitor.h"
+#include "launcher-monitor-view.h"
+#include "launcher-crash.h"
+#include "launcher-crash-view.h"
+#include "launcher-hang.h"
 
-#define MAIN "main"
-#define EXECUTABLE "executable"
-#define PARAMETERS "parameters"
-#define TERMINAL "terminal"
 #define LAUNCHER_CONF "launcher.conf"
+#define LAUNCHER_GROUPS "launcher.groups"
+#define LAUNCHER_HISTORY "launcher.history"
+#define PROFILES "profiles"
+#define CRASHES "crashes"
+#define TERMINATE_TIMEOUT 3000
+
+typedef struct
+{
+  LauncherEngine *engine;
+  GList          *configs;
+  GCancellable   *cancellable;
+} LaunchGroup;
+
+typedef struct
+{
+  LauncherEngine  *engine;
+  LauncherProcess *process;
+} ProfileReport;
+
+typedef struct
+{
+  LauncherEngine *engine;
+  gchar          *title;
+} CrashReport;
+
+typedef struct
+{
+  LauncherEngine  *engine;
+  LauncherProcess *process;
+  gchar           *title;
+} HangReport;
+
+typedef enum
+{
+  MEMBER_PENDING,
+  MEMBER_STARTING,
+  MEMBER_READY,
+  MEMBER_FAILED
+} MemberState;
+
+typedef struct _GroupRun GroupRun;
+
+typedef struct
+{
+  GroupRun    *run;
+  guint        index;
+  MemberState  state;
+  gint64       start_time;
+  gint64       ready_time;
+  gchar       *error;
+  LauncherJob *job;
+  gulong       cancelled_id;
+} MemberRun;
+
+typedef struct
+{
+  LauncherConfig *config;
+  LauncherBuild  *build;
+  guint           serial;
+  MemberRun      *member_run;
+} BuildRun;
+
+typedef struct
+{
+  gint64 cold_total;
+  guint  cold_runs;
+} LaunchLatency;
+
+struct _GroupRun
+{
+  LauncherEngine *engine;
+  LauncherGroup  *group;
+  GCancellable   *cancellable;
+  gint64          start_time;
+  MemberRun      *members;
+  gboolean        failed;
+  gboolean        starting;
+};
 
 static void launcher_engine_class_init            (LauncherEngineClass *klass);
 static void launcher_engine_init                  (LauncherEngine      *engine);
@@ -34,8 +136,58 @@ static void launcher_engine_finalize              (LauncherEngine      *engine);
 static void run_action                            (LauncherEngine      *engine);
 static void project_run_action                    (LauncherEngine      *engine, 
                                                    GList               *selections);
+static void benchmark_action                      (LauncherEngine      *engine);
+static void project_benchmark_action              (LauncherEngine      *engine, 
+                                                   GList               *selections);
+static void benchmark_startup_action              (LauncherEngine      *engine);
+static void project_benchmark_startup_action      (LauncherEngine      *engine, 
+                                                   GList               *selections);
+static void benchmark_executable                  (LauncherEngine      *engine, 
+                                                   CodeSlayerProject   *project,
+                                                   LauncherBenchmarkMode mode);
+static gboolean benchmark_job                     (LauncherEngine      *engine, 
+                                                   LauncherJob         *job);
+static gboolean sweep_job                         (LauncherEngine      *engine, 
+                                                   LauncherJob         *job);
+static void sweep_finished_action                 (LauncherSweep       *sweep,
+                                                   GAsyncResult        *result,
+                                                   LauncherEngine      *engine);
+static void benchmark_finished_action             (LauncherBenchmark   *benchmark,
+                                                   GAsyncResult        *result,
+                                                   LauncherEngine      *engine);
+static LauncherHistory* get_history              (LauncherEngine      *engine, 
+                                                   CodeSlayerProject   *project);
+static void record_process                        (LauncherEngine      *engine,
+                                                   LauncherProcess     *process);
+static void record_benchmark                      (LauncherEngine      *engine,
+                                                   LauncherBenchmark   *benchmark);
+static void process_recorded_action               (LauncherHistory     *history,
+                                                   GAsyncResult        *result,
+                                                   LauncherProcess     *process);
+static void benchmark_recorded_action             (LauncherHistory     *history,
+                                                   GAsyncResult        *result,
+                                                   LauncherBenchmark   *benchmark);
+static CodeSlayerProject* get_active_project      (LauncherEngine      *engine);
+static LauncherConfig* get_launch_config          (LauncherEngine      *engine, 
+                                                   CodeSlayerProject   *project);
 static LauncherConfig* get_config_by_project      (LauncherEngine      *engine, 
                                                    CodeSlayerProject   *project);
+static void index_project                         (LauncherEngine      *engine,
+                                                   CodeSlayerProject   *project);
+static void index_open_projects                   (LauncherEngine      *engine);
+static void launch_profile_action                 (LauncherEngine      *engine);
+static LauncherConfig* select_profile             (LauncherEngine      *engine,
+                                                   CodeSlayerProject   *project,
+                                                   const gchar         *name);
+static void watch_config_folder                   (LauncherEngine      *engine,
+                                                   CodeSlayerProject   *project,
+                                                   const gchar         *folder_path);
+static void config_folder_changed_action          (GFileMonitor        *monitor,
+                                                   GFile               *file,
+                                                   GFile               *other_file,
+                                                   GFileMonitorEvent    event_type,
+                                                   LauncherEngine      *engine);
+static void destroy_monitor                       (GFileMonitor        *monitor);
 static void project_properties_opened_action      (LauncherEngine      *engine,
                                                    CodeSlayerProject   *project);
 static void project_properties_saved_action       (LauncherEngine      *engine,
@@ -45,6 +197,99 @@ static void save_config_action                    (LauncherEngine      *engine,
 static CodeSlayerProject* get_selections_project  (GList               *selections);
 static void launch_executable                     (LauncherEngine      *engine, 
                                                    CodeSlayerProject   *project);
+static void launch_config                         (LauncherEngine      *engine, 
+                                                   LauncherConfig      *config);
+static void start_config                          (LauncherEngine      *engine, 
+                                                   LauncherConfig      *config);
+static gboolean start_job                         (LauncherJob         *job,
+                                                   LauncherEngine      *engine);
+static gboolean run_job                           (LauncherEngine      *engine, 
+                                                   LauncherJob         *job);
+static void bind_job                              (LauncherProcess     *process,
+                                                   LauncherJob         *job);
+static void cancel_process_action                 (LauncherProcess     *process);
+static LauncherBuild* get_build                   (LauncherEngine      *engine, 
+                                                   LauncherConfig      *config);
+static LauncherBuild* get_stale_build             (LauncherEngine      *engine, 
+                                                   LauncherConfig      *config);
+static gboolean build_config                      (LauncherEngine      *engine, 
+                                                   LauncherConfig      *config,
+                                                   LauncherBuild       *build,
+                                                   MemberRun           *member_run);
+static void build_finished_action                 (LauncherEngine      *engine,
+                                                   LauncherProcess     *process);
+static void build_run_free                        (BuildRun            *run);
+static void update_watch                          (LauncherEngine      *engine,
+                                                   LauncherConfig      *config);
+static void watch_restart_action                  (LauncherWatch       *watch,
+                                                   LauncherEngine      *engine);
+static void prepare_standby                       (LauncherEngine      *engine,
+                                                   LauncherConfig      *config);
+static LauncherProcess* release_standby           (LauncherEngine      *engine,
+                                                   LauncherConfig      *config);
+static void destroy_standby                       (LauncherProcess     *process);
+static void record_launch                         (LauncherEngine      *engine,
+                                                   LauncherProcess     *process);
+static gint compare_launch_order                  (LauncherConfig      *config1,
+                                                   LauncherConfig      *config2);
+static void launch_group                          (LaunchGroup         *group);
+static gboolean launch_group_action               (LaunchGroup         *group);
+static void destroy_launch_group                  (LaunchGroup         *group);
+static LauncherProcess* launch_process            (LauncherEngine      *engine, 
+                                                   LauncherConfig      *config);
+static LauncherProcess* spawn_process             (LauncherEngine      *engine, 
+                                                   LauncherConfig      *config);
+static void launch_groups_menu_action             (LauncherEngine      *engine);
+static void project_launch_group_action           (LauncherEngine      *engine, 
+                                                   GList               *selections);
+static void launch_project_group                  (LauncherEngine      *engine, 
+                                                   CodeSlayerProject   *project);
+static LauncherGroup* select_group                (GList               *groups);
+static void start_group_members                   (GroupRun            *run);
+static void start_group_member                    (GroupRun            *run,
+                                                   MemberRun           *member_run);
+static void submit_group_member                   (MemberRun           *member_run,
+                                                   LauncherConfig      *config);
+static gboolean start_member_job                  (LauncherJob         *job,
+                                                   MemberRun           *member_run);
+static void member_cancelled_action               (MemberRun           *member_run);
+static void release_member_job                    (MemberRun           *member_run);
+static void fail_group_member                     (MemberRun           *member_run,
+                                                   const gchar         *error);
+static void continue_group_run                    (GroupRun            *run);
+static void member_ready_action                   (LauncherProcess     *process,
+                                                   GAsyncResult        *result,
+                                                   MemberRun           *member_run);
+static void report_group_run                      (GroupRun            *run);
+static void group_run_free                        (GroupRun            *run);
+static const gchar* get_active_file               (LauncherEngine      *engine);
+static gchar* get_profiles_folder                 (LauncherEngine      *engine,
+                                                   LauncherConfig      *config);
+static void report_profile                        (LauncherEngine      *engine,
+                                                   LauncherProcess     *process);
+static void profile_summarized_action             (GObject             *source,
+                                                   GAsyncResult        *result,
+                                                   ProfileReport       *report);
+static void report_crash                          (LauncherEngine      *engine,
+                                                   LauncherProcess     *process);
+static void crash_collected_action                (GObject             *source,
+                                                   GAsyncResult        *result,
+                                                   CrashReport         *report);
+static void process_hung_action                   (LauncherEngine      *engine,
+                                                   LauncherProcess     *process);
+static void hang_sampled_action                   (GObject             *source,
+                                                   GAsyncResult        *result,
+                                                   HangReport          *report);
+static void frame_activated_action                (LauncherEngine      *engine,
+                                                   const gchar         *file_path,
+                                                   gint                 line);
+static void profile_annotations_action            (GObject             *source,
+                                                   GAsyncResult        *result,
+                                                   LauncherEngine      *engine);
+static void clear_annotations_action              (LauncherEngine      *engine);
+static void process_finished_action               (LauncherEngine      *engine,
+                                                   LauncherProcess     *process);
+static void show_error                            (const gchar         *message);
 
 #define LAUNCHER_ENGINE_GET_PRIVATE(obj) \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_ENGINE_TYPE, LauncherEnginePrivate))
@@ -57,7 +302,30 @@ struct _LauncherEnginePrivate
   GtkWidget  *menu;
   GtkWidget  *project_properties;
   GtkWidget  *projects_menu;
-  GList      *configs;
+  GtkWidget  *output;
+  GtkWidget  *benchmark_view;
+  GtkWidget  *sweep_view;
+  GtkWidget  *jobs_view;
+  GtkWidget  *monitor_view;
+  GtkWidget  *crash_view;
+  GtkWidget  *reports;
+  GHashTable *configs;
+  GHashTable *monitors;
+  GHashTable *histories;
+  GHashTable *builds;
+  GHashTable *watches;
+  GHashTable *standbys;
+  GHashTable *latencies;
+  GHashTable *mapped_files;
+  GHashTable *active_profiles;
+  LauncherProfileIndex *profile_index;
+  LauncherScheduler *scheduler;
+  LauncherMonitor   *process_monitor;
+  GList      *processes;
+  LauncherBenchmark *benchmark;
+  LauncherSweep     *sweep;
+  GCancellable      *cancellable;
+  LauncherAnnotator *annotator;
   gulong      properties_opened_id;
   gulong      properties_saved_id;
 };
@@ -77,7 +345,29 @@ launcher_engine_init (LauncherEngine *engine)
 {
   LauncherEnginePrivate *priv;
   priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);  
-  priv->configs = NULL;
+  priv->configs = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, 
+                                         (GDestroyNotify) g_object_unref);
+  priv->monitors = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, 
+                                          (GDestroyNotify) destroy_monitor);
+  priv->histories = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, 
+                                           (GDestroyNotify) g_object_unref);
+  priv->builds = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, 
+                                        (GDestroyNotify) g_object_unref);
+  priv->watches = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, 
+                                         (GDestroyNotify) g_object_unref);
+  priv->standbys = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, 
+                                          (GDestroyNotify) destroy_standby);
+  priv->latencies = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+  priv->mapped_files = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, 
+                                              (GDestroyNotify) g_strfreev);
+  priv->active_profiles = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+  priv->profile_index = launcher_profile_index_new ();
+  priv->scheduler = launcher_scheduler_new ();
+  priv->process_monitor = launcher_monitor_new ();
+  priv->processes = NULL;
+  priv->benchmark = NULL;
+  priv->sweep = NULL;
+  priv->cancellable = g_cancellable_new ();
 }
 
 static void
@@ -85,13 +375,48 @@ launcher_engine_finalize (LauncherEngine *engine)
 {
   LauncherEnginePrivate *priv;
   priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);  
-  if (priv->configs != NULL)
+  g_hash_table_destroy (priv->monitors);
+  g_hash_table_destroy (priv->configs);
+  g_hash_table_destroy (priv->histories);
+  g_hash_table_destroy (priv->watches);
+  g_hash_table_destroy (priv->standbys);
+  g_hash_table_destroy (priv->latencies);
+  g_hash_table_destroy (priv->mapped_files);
+  g_hash_table_destroy (priv->builds);
+  g_hash_table_destroy (priv->active_profiles);
+  g_object_unref (priv->profile_index);
+  
+  g_cancellable_cancel (priv->cancellable);
+  g_object_unref (priv->cancellable);
+  if (priv->benchmark != NULL)
+    g_object_unref (priv->benchmark);
+  if (priv->sweep != NULL)
+    g_object_unref (priv->sweep);
+  g_object_unref (priv->annotator);
+  
+  if (priv->processes != NULL)
     {
-      g_list_foreach (priv->configs, (GFunc) g_object_unref, NULL);
-      g_list_free (priv->configs);
-      priv->configs = NULL;    
+      GList *list = priv->processes;
+      while (list != NULL)
+        {
+          LauncherJob *job;
+          g_signal_handlers_disconnect_by_func (list->data, process_finished_action, engine);
+          g_signal_handlers_disconnect_by_func (list->data, build_finished_action, engine);
+          
+          /* programs keep running when the plugin goes away */
+          job = g_object_get_data (G_OBJECT (list->data), "launcher-job");
+          if (job != NULL)
+            g_signal_handlers_disconnect_by_func (launcher_job_get_cancellable (job), 
+                                                  cancel_process_action, list->data);
+          list = g_list_next (list);
+        }
+      g_list_free_full (priv->processes, g_object_unref);
+      priv->processes = NULL;
     }
   
+  g_object_unref (priv->scheduler);
+  g_object_unref (priv->process_monitor);
+  
   g_signal_handler_disconnect (priv->codeslayer, priv->properties_opened_id);
   g_signal_handler_disconnect (priv->codeslayer, priv->properties_saved_id);
 
@@ -102,7 +427,14 @@ LauncherEngine*
 launcher_engine_new (CodeSlayer *codeslayer,
                      GtkWidget  *menu, 
                      GtkWidget  *project_properties,
-                     GtkWidget  *projects_menu)
+                     GtkWidget  *projects_menu,
+                     GtkWidget  *output,
+                     GtkWidget  *benchmark_view,
+                     GtkWidget  *sweep_view,
+                     GtkWidget  *jobs_view,
+                     GtkWidget  *monitor_view,
+                     GtkWidget  *crash_view,
+                     GtkWidget  *reports)
 {
   LauncherEnginePrivate *priv;
   LauncherEngine *engine;
@@ -114,6 +446,17 @@ launcher_engine_new (CodeSlayer *codeslayer,
   priv->menu = menu;
   priv->project_properties = project_properties;
   priv->projects_menu = projects_menu;
+  priv->output = output;
+  priv->benchmark_view = benchmark_view;
+  priv->sweep_view = sweep_view;
+  priv->jobs_view = jobs_view;
+  priv->monitor_view = monitor_view;
+  priv->crash_view = crash_view;
+  priv->reports = reports;
+  priv->annotator = launcher_annotator_new (codeslayer);
+  
+  launcher_jobs_view_set_scheduler (LAUNCHER_JOBS_VIEW (jobs_view), priv->scheduler);
+  launcher_monitor_view_set_monitor (LAUNCHER_MONITOR_VIEW (monitor_view), priv->process_monitor);
   
   g_signal_connect_swapped (G_OBJECT (menu), "run",
                             G_CALLBACK (run_action), engine);
@@ -121,6 +464,33 @@ launcher_engine_new (CodeSlayer *codeslayer,
   g_signal_connect_swapped (G_OBJECT (projects_menu), "run",
                             G_CALLBACK (project_run_action), engine);
 
+  g_signal_connect_swapped (G_OBJECT (menu), "launch-profile",
+                            G_CALLBACK (launch_profile_action), engine);
+
+  g_signal_connect_swapped (G_OBJECT (menu), "benchmark",
+                            G_CALLBACK (benchmark_action), engine);
+
+  g_signal_connect_swapped (G_OBJECT (projects_menu), "benchmark",
+                            G_CALLBACK (project_benchmark_action), engine);
+
+  g_signal_connect_swapped (G_OBJECT (menu), "benchmark-startup",
+                            G_CALLBACK (benchmark_startup_action), engine);
+
+  g_signal_connect_swapped (G_OBJECT (projects_menu), "benchmark-startup",
+                            G_CALLBACK (project_benchmark_startup_action), engine);
+
+  g_signal_connect_swapped (G_OBJECT (menu), "launch-group",
+                            G_CALLBACK (launch_groups_menu_action), engine);
+
+  g_signal_connect_swapped (G_OBJECT (projects_menu), "launch-group",
+                            G_CALLBACK (project_launch_group_action), engine);
+
+  g_signal_connect_swapped (G_OBJECT (menu), "clear-annotations",
+                            G_CALLBACK (clear_annotations_action), engine);
+
+  g_signal_connect_swapped (G_OBJECT (crash_view), "frame-activated",
+                            G_CALLBACK (frame_activated_action), engine);
+
   priv->properties_opened_id =  g_signal_connect_swapped (G_OBJECT (codeslayer), "project-properties-opened",
                                                           G_CALLBACK (project_properties_opened_action), engine);
 
@@ -139,45 +509,106 @@ get_config_by_project (LauncherEngine    *engine,
 {
   LauncherEnginePrivate *priv;
   LauncherConfig *config;
-  GKeyFile *key_file;
   gchar *folder_path;
   gchar *file_path;
-  gchar *executable;
-  gchar *parameters;
-  gboolean terminal;
   
   priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  config = g_hash_table_lookup (priv->configs, project);
+  if (config != NULL)
+    return config;
 
   folder_path = codeslayer_get_project_config_folder_path (priv->codeslayer, project);
   file_path = g_build_filename (folder_path, LAUNCHER_CONF, NULL);
   
-  if (!codeslayer_utils_file_exists (file_path))
+  watch_config_folder (engine, project, folder_path);
+  
+  if (codeslayer_utils_file_exists (file_path))
     {
-      g_free (folder_path);
-      g_free (file_path);
-      return NULL;
+      GKeyFile *key_file;
+      key_file = codeslayer_utils_get_key_file (file_path);
+      config = launcher_core_load_config (key_file, 
+                                          g_hash_table_lookup (priv->active_profiles, project), 
+                                          project, codeslayer_project_get_name (project),
+                                          codeslayer_project_get_folder_path (project));
+      launcher_profile_index_update (priv->profile_index, project, key_file);
+      g_key_file_free (key_file);
+      g_hash_table_insert (priv->configs, project, config);
     }
 
-  key_file = codeslayer_utils_get_key_file (file_path);
-  executable = g_key_file_get_string (key_file, MAIN, EXECUTABLE, NULL);
-  parameters = g_key_file_get_string (key_file, MAIN, PARAMETERS, NULL);
-  terminal = g_key_file_get_boolean (key_file, MAIN, TERMINAL, NULL);
-  
-  config = launcher_config_new ();
-  launcher_config_set_project (config, project);
-  launcher_config_set_executable (config, executable);
-  launcher_config_set_parameters (config, parameters);
-  launcher_config_set_terminal (config, terminal);
-  
   g_free (folder_path);
   g_free (file_path);
-  g_free (executable);
-  g_free (parameters);
-  g_key_file_free (key_file);
   
   return config;
 }
 
+static void
+watch_config_folder (LauncherEngine    *engine,
+                     CodeSlayerProject *project,
+                     const gchar       *folder_path)
+{
+  LauncherEnginePrivate *priv;
+  GFileMonitor *monitor;
+  GFile *folder;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+
+  if (g_hash_table_lookup (priv->monitors, project) != NULL)
+    return;
+  
+  folder = g_file_new_for_path (folder_path);
+  monitor = g_file_monitor_directory (folder, G_FILE_MONITOR_NONE, NULL, NULL);
+  g_object_unref (folder);
+  
+  if (monitor == NULL)
+    return;
+
+  g_object_set_data (G_OBJECT (monitor), "project", project);
+  g_signal_connect (G_OBJECT (monitor), "changed",
+                    G_CALLBACK (config_folder_changed_action), engine);
+  g_hash_table_insert (priv->monitors, project, monitor);
+}
+
+/*
+ * The watch, build and stand-by child were made from the old launcher.conf, 
+ * so they go along with the cached config.
+ */
+static void
+config_folder_changed_action (GFileMonitor      *monitor,
+                              GFile             *file,
+                              GFile             *other_file,
+                              GFileMonitorEvent  event_type,
+                              LauncherEngine    *engine)
+{
+  LauncherEnginePrivate *priv;
+  CodeSlayerProject *project;
+  gchar *basename;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  if (event_type == G_FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED)
+    return;
+
+  basename = g_file_get_basename (file);
+  if (g_strcmp0 (basename, LAUNCHER_CONF) == 0)
+    {
+      project = g_object_get_data (G_OBJECT (monitor), "project");
+      g_hash_table_remove (priv->configs, project);
+      g_hash_table_remove (priv->watches, project);
+      g_hash_table_remove (priv->builds, project);
+      g_hash_table_remove (priv->standbys, project);
+      index_project (engine, project);
+    }
+  g_free (basename);
+}
+
+static void
+destroy_monitor (GFileMonitor *monitor)
+{
+  g_file_monitor_cancel (monitor);
+  g_object_unref (monitor);
+}
+
 static void
 project_properties_opened_action (LauncherEngine    *engine,
                                   CodeSlayerProject *project)
@@ -190,8 +621,6 @@ project_properties_opened_action (LauncherEngine    *engine,
   config = get_config_by_project (engine, project);
   launcher_project_properties_opened (LAUNCHER_PROJECT_PROPERTIES (priv->project_properties),
                                       config, project);
-  if (config != NULL)
-    g_object_unref (config);                                       
 }
 
 static void
@@ -206,8 +635,6 @@ project_properties_saved_action (LauncherEngine    *engine,
   config = get_config_by_project (engine, project);
   launcher_project_properties_saved (LAUNCHER_PROJECT_PROPERTIES (priv->project_properties),
                                      config, project);
-  if (config != NULL)
-    g_object_unref (config);                                       
 }
 
 static void
@@ -218,9 +645,6 @@ save_config_action (LauncherEngine *engine,
   CodeSlayerProject *project;
   gchar *folder_path;
   gchar *file_path;
-  const gchar *executable;
-  const gchar *parameters;
-  gboolean terminal;
   GKeyFile *key_file;
  
   priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
@@ -229,106 +653,1982 @@ save_config_action (LauncherEngine *engine,
   folder_path = codeslayer_get_project_config_folder_path (priv->codeslayer, project);
   file_path = codeslayer_utils_get_file_path (folder_path, LAUNCHER_CONF);
   key_file = codeslayer_utils_get_key_file (file_path);
-
-  executable = launcher_config_get_executable (config);
-  parameters = launcher_config_get_parameters (config);
-  terminal = launcher_config_get_terminal (config);
-  g_key_file_set_string (key_file, MAIN, EXECUTABLE, executable);
-  g_key_file_set_string (key_file, MAIN, PARAMETERS, parameters);
-  g_key_file_set_boolean (key_file, MAIN, TERMINAL, terminal);
-
+  launcher_core_save_config (key_file, config);
   codeslayer_utils_save_key_file (key_file, file_path);  
+  launcher_profile_index_update (priv->profile_index, project, key_file);
   g_key_file_free (key_file);
   g_free (folder_path);
   g_free (file_path); 
+
+  /* a profile saved under a new name becomes the active one */
+  g_hash_table_replace (priv->configs, project, g_object_ref (config));
+  if (launcher_config_get_name (config) != NULL)
+    g_hash_table_replace (priv->active_profiles, project, 
+                          g_strdup (launcher_config_get_name (config)));
+  else
+    g_hash_table_remove (priv->active_profiles, project);
+  
+  /* the ignore patterns are fixed when the monitors are set up */
+  g_hash_table_remove (priv->watches, project);
+  g_hash_table_remove (priv->builds, project);
+  g_hash_table_remove (priv->standbys, project);
+  
+  /* start watching the sources now so the next run can skip the build */
+  if (launcher_config_get_build_command (config) != NULL && 
+      *launcher_config_get_build_command (config) != '\0')
+    get_build (engine, config);
+  
+  update_watch (engine, config);
+  prepare_standby (engine, config);
 }
 
 static void
 run_action (LauncherEngine *engine)
+{
+  CodeSlayerProject *project;
+  project = get_active_project (engine);
+  if (project != NULL)
+    launch_executable (engine, project);
+}
+
+/*
+ * Picks one of the profiles of the open projects and launches it, the 
+ * profile stays the active one of its project for the next run.
+ */
+static void
+launch_profile_action (LauncherEngine *engine)
 {
   LauncherEnginePrivate *priv;
   CodeSlayerProject *project;
+  LauncherConfig *config;
+  gchar *name;
+  
   priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
-  project = codeslayer_get_active_editor_project (priv->codeslayer);
   
-  if (project == NULL)
+  index_open_projects (engine);
+  
+  if (!launcher_profile_picker_run (priv->profile_index, &project, &name))
+    return;
+  
+  config = select_profile (engine, project, name);
+  g_free (name);
+  
+  if (config != NULL)
+    launch_config (engine, config);
+}
+
+/*
+ * Only the projects that were never read are read here, the others are 
+ * kept up to date as their launcher.conf changes.
+ */
+static void
+index_open_projects (LauncherEngine *engine)
+{
+  LauncherEnginePrivate *priv;
+  GList *editors;
+  GList *list;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  editors = codeslayer_get_all_editors (priv->codeslayer);
+  for (list = editors; list != NULL; list = g_list_next (list))
     {
-      GtkWidget *dialog;
-      dialog =  gtk_message_dialog_new (NULL, 
-                                        GTK_DIALOG_MODAL,
-                                        GTK_MESSAGE_ERROR, GTK_BUTTONS_OK,
-                                        "There are no open editors. Not able to determine what program to run.");
-      gtk_dialog_run (GTK_DIALOG (dialog));
-      gtk_widget_destroy (dialog);
-      return;
+      CodeSlayerProject *project;
+      const gchar *file_path;
+      
+      file_path = codeslayer_editor_get_file_path (list->data);
+      if (file_path == NULL)
+        continue;
+      
+      project = codeslayer_get_project_by_file_path (priv->codeslayer, file_path);
+      if (project != NULL && 
+          !launcher_profile_index_has_project (priv->profile_index, project))
+        index_project (engine, project);
     }
+  g_list_free (editors);
+}
+
+static void
+index_project (LauncherEngine    *engine,
+               CodeSlayerProject *project)
+{
+  LauncherEnginePrivate *priv;
+  GKeyFile *key_file = NULL;
+  gchar *folder_path;
+  gchar *file_path;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  folder_path = codeslayer_get_project_config_folder_path (priv->codeslayer, project);
+  file_path = g_build_filename (folder_path, LAUNCHER_CONF, NULL);
+  
+  watch_config_folder (engine, project, folder_path);
+  
+  if (codeslayer_utils_file_exists (file_path))
+    key_file = codeslayer_utils_get_key_file (file_path);
+  
+  launcher_profile_index_update (priv->profile_index, project, key_file);
+  
+  if (key_file != NULL)
+    g_key_file_free (key_file);
+  g_free (folder_path);
+  g_free (file_path);
+}
+
+/*
+ * Makes the named profile the active one of the project. The watch, build 
+ * and stand-by child belong to the profile they were made for, so they 
+ * are dropped along with the old config.
+ */
+static LauncherConfig*
+select_profile (LauncherEngine    *engine,
+                CodeSlayerProject *project,
+                const gchar       *name)
+{
+  LauncherEnginePrivate *priv;
+  LauncherConfig *config;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  config = g_hash_table_lookup (priv->configs, project);
+  if (config != NULL && g_strcmp0 (launcher_config_get_name (config), name) == 0)
+    return config;
   
-  launch_executable (engine, project);
+  if (name != NULL)
+    g_hash_table_replace (priv->active_profiles, project, g_strdup (name));
+  else
+    g_hash_table_remove (priv->active_profiles, project);
+  
+  g_hash_table_remove (priv->configs, project);
+  g_hash_table_remove (priv->watches, project);
+  g_hash_table_remove (priv->builds, project);
+  g_hash_table_remove (priv->standbys, project);
+  
+  return get_launch_config (engine, project);
 }
 
+/*
+ * Every selected project is launched, in launch order, so that a stack of 
+ * cooperating programs can be brought up together. A project with a launch 
+ * delay holds back the ones after it without blocking the main loop.
+ */
 static void
 project_run_action (LauncherEngine *engine, 
                     GList          *selections)
 {
+  LauncherEnginePrivate *priv;
+  LaunchGroup *group;
+  GList *configs = NULL;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  while (selections != NULL)
+    {
+      CodeSlayerProjectsSelection *selection = selections->data;
+      CodeSlayerProject *project;
+      LauncherConfig *config;
+      
+      project = codeslayer_projects_selection_get_project (CODESLAYER_PROJECTS_SELECTION (selection));
+      config = get_launch_config (engine, project);
+      if (config != NULL)
+        configs = g_list_prepend (configs, g_object_ref (config));
+      
+      selections = g_list_next (selections);
+    }
+  
+  if (configs == NULL)
+    return;
+  
+  configs = g_list_sort (g_list_reverse (configs), (GCompareFunc) compare_launch_order);
+  
+  group = g_slice_new (LaunchGroup);
+  group->engine = engine;
+  group->configs = configs;
+  group->cancellable = g_object_ref (priv->cancellable);
+  
+  launch_group (group);
+}
+
+static LauncherBuild*
+get_build (LauncherEngine *engine, 
+           LauncherConfig *config)
+{
+  LauncherEnginePrivate *priv;
   CodeSlayerProject *project;
-  project = get_selections_project (selections);
-  launch_executable (engine, project);
+  LauncherBuild *build;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  project = launcher_config_get_project (config);
+  
+  build = g_hash_table_lookup (priv->builds, project);
+  if (build == NULL)
+    {
+      build = launcher_build_new (codeslayer_project_get_folder_path (project), 
+                                  launcher_config_get_watch_ignore (config));
+      g_hash_table_insert (priv->builds, project, build);
+    }
+  
+  return build;
 }
 
-static void
-launch_executable (LauncherEngine    *engine, 
-                   CodeSlayerProject *project)
+/*
+ * Returns the build of the config when it has a build command and a 
+ * source changed since the executable was last linked, otherwise NULL.
+ */
+static LauncherBuild*
+get_stale_build (LauncherEngine *engine, 
+                 LauncherConfig *config)
 {
-  GAppInfo *appinfo;
-  LauncherConfig *config;
-  const gchar *executable;
-  const gchar *parameters;
+  const gchar *build_command;
+  LauncherBuild *build;
+  
+  build_command = launcher_config_get_build_command (config);
+  if (build_command == NULL || *build_command == '\0')
+    return NULL;
+  
+  build = get_build (engine, config);
+  if (!launcher_build_is_stale (build, launcher_config_get_executable (config)))
+    return NULL;
+  
+  return build;
+}
 
-  config = get_config_by_project (engine, project);
+/*
+ * The build runs through the shell in the build folder and its output 
+ * goes to the output pane like any other process, but it is not recorded 
+ * in the history. A group member is handed back to its group once the 
+ * build is done rather than started on its own.
+ */
+static gboolean
+build_config (LauncherEngine *engine, 
+              LauncherConfig *config,
+              LauncherBuild  *build,
+              MemberRun      *member_run)
+{
+  LauncherEnginePrivate *priv;
+  LauncherProcess *process;
+  BuildRun *run;
+  GError *error = NULL;
   
-  if (config == NULL)
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  process = launcher_core_spawn_build (config, get_active_file (engine), &error);
+  if (process == NULL)
     {
-      GtkWidget *dialog;
-      gchar *msg;
-      const gchar *project_name;
-      
-      project_name = codeslayer_project_get_name (project);
-      
-      msg = g_strconcat ("There is no launch config for project ", 
-                         project_name, ".", NULL);      
-      dialog =  gtk_message_dialog_new (NULL, 
-                                        GTK_DIALOG_MODAL,
-                                        GTK_MESSAGE_ERROR, GTK_BUTTONS_OK,
-                                        msg, 
-                                        NULL);
-      gtk_dialog_run (GTK_DIALOG (dialog));
-      gtk_widget_destroy (dialog);
-      g_free (msg);
-      return;
+      show_error (error->message);
+      g_error_free (error);
+      return FALSE;
     }
   
-  executable = launcher_config_get_executable (config);
-  parameters = launcher_config_get_parameters (config);
+  run = g_slice_new (BuildRun);
+  run->config = g_object_ref (config);
+  run->build = g_object_ref (build);
+  run->serial = launcher_build_begin (build);
+  run->member_run = member_run;
+  g_object_set_data_full (G_OBJECT (process), "launcher-build-run", 
+                          run, (GDestroyNotify) build_run_free);
+  
+  g_signal_connect_swapped (G_OBJECT (process), "finished",
+                            G_CALLBACK (build_finished_action), engine);
+  priv->processes = g_list_append (priv->processes, process);
+  
+  launcher_output_set_process (LAUNCHER_OUTPUT (priv->output), process);
+  codeslayer_show_bottom_pane (priv->codeslayer, priv->output);
+  
+  return TRUE;
+}
 
-  if (launcher_config_get_terminal (config))
+static void
+build_finished_action (LauncherEngine  *engine,
+                       LauncherProcess *process)
+{
+  LauncherEnginePrivate *priv;
+  BuildRun *run;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  run = g_object_get_data (G_OBJECT (process), "launcher-build-run");
+  
+  /* a failed build leaves its output and status in the output pane */
+  if (launcher_process_get_state (process) == LAUNCHER_PROCESS_EXITED &&
+      launcher_process_get_exit_status (process) == 0)
     {
-      gchar *command;              
-      command = g_strconcat (executable, " ", parameters, NULL);
-      appinfo = g_app_info_create_from_commandline (command, NULL,
-                                                    G_APP_INFO_CREATE_NEEDS_TERMINAL, NULL);
-      g_free (command);
+      launcher_build_finish (run->build, run->serial);
+      if (launcher_config_get_prefetch (run->config))
+        launcher_prefetch (launcher_config_get_executable (run->config), 
+                           g_hash_table_lookup (priv->mapped_files, 
+                                                launcher_config_get_project (run->config)));
+      if (run->member_run != NULL)
+        submit_group_member (run->member_run, run->config);
+      else
+        start_config (engine, run->config);
     }
-  else
+  else if (run->member_run != NULL)
+    {
+      fail_group_member (run->member_run, "The build failed");
+    }
+  
+  run->member_run = NULL;
+  
+  priv->processes = g_list_remove (priv->processes, process);
+  g_object_unref (process);
+}
+
+/*
+ * A member still waiting on the build here was dropped along with the 
+ * engine before the build finished.
+ */
+static void
+build_run_free (BuildRun *run)
+{
+  if (run->member_run != NULL)
+    fail_group_member (run->member_run, "The build did not finish");
+  g_object_unref (run->config);
+  g_object_unref (run->build);
+  g_slice_free (BuildRun, run);
+}
+
+/*
+ * Watch mode shares the directory monitors of the build, so turning it on 
+ * costs nothing more than the debounce timer. Terminal runs are left alone 
+ * since there is no process to stop.
+ */
+static void
+update_watch (LauncherEngine *engine,
+              LauncherConfig *config)
+{
+  LauncherEnginePrivate *priv;
+  CodeSlayerProject *project;
+  LauncherWatch *watch;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  project = launcher_config_get_project (config);
+  
+  if (!launcher_config_get_watch (config) || launcher_config_get_terminal (config))
     {
-      gchar *command;              
-      command = g_strconcat (executable, " ", parameters, NULL);
-      appinfo = g_app_info_create_from_commandline (executable, NULL,
-                                                    G_APP_INFO_CREATE_NONE, NULL);
-      g_free (command);
+      g_hash_table_remove (priv->watches, project);
+      return;
     }
+  
+  if (g_hash_table_lookup (priv->watches, project) != NULL)
+    return;
+  
+  watch = launcher_watch_new (get_build (engine, config), 
+                              launcher_config_get_watch_debounce (config));
+  g_object_set_data (G_OBJECT (watch), "project", project);
+  g_signal_connect (G_OBJECT (watch), "restart",
+                    G_CALLBACK (watch_restart_action), engine);
+  g_hash_table_insert (priv->watches, project, watch);
+}
+
+static void
+watch_restart_action (LauncherWatch  *watch,
+                      LauncherEngine *engine)
+{
+  CodeSlayerProject *project;
+  LauncherConfig *config;
+  
+  project = g_object_get_data (G_OBJECT (watch), "project");
+  config = get_config_by_project (engine, project);
+  if (config != NULL)
+    launch_config (engine, config);
+}
 
-  g_app_info_launch (appinfo, NULL, NULL, NULL);
-  g_object_unref (appinfo);
+static gint
+compare_launch_order (LauncherConfig *config1,
+                      LauncherConfig *config2)
+{
+  return launcher_config_get_launch_order (config1) - 
+         launcher_config_get_launch_order (config2);
+}
+
+/*
+ * Launches the configs in order until one has a delay, the rest of the 
+ * group is picked up again by a timeout once the delay has passed.
+ */
+static void
+launch_group (LaunchGroup *group)
+{
+  while (group->configs != NULL)
+    {
+      LauncherConfig *config = group->configs->data;
+      gint launch_delay;
+      
+      group->configs = g_list_delete_link (group->configs, group->configs);
+      launch_config (group->engine, config);
+      launch_delay = launcher_config_get_launch_delay (config);
+      g_object_unref (config);
+      
+      if (launch_delay > 0 && group->configs != NULL)
+        {
+          g_timeout_add (launch_delay, (GSourceFunc) launch_group_action, group);
+          return;
+        }
+    }
+  
+  destroy_launch_group (group);
+}
+
+/*
+ * The cancellable is cancelled when the engine is finalized, after that 
+ * the group must not touch the engine.
+ */
+static gboolean
+launch_group_action (LaunchGroup *group)
+{
+  if (g_cancellable_is_cancelled (group->cancellable))
+    destroy_launch_group (group);
+  else
+    launch_group (group);
+  return G_SOURCE_REMOVE;
+}
+
+static void
+destroy_launch_group (LaunchGroup *group)
+{
+  g_list_free_full (group->configs, g_object_unref);
+  g_object_unref (group->cancellable);
+  g_slice_free (LaunchGroup, group);
+}
+
+static void
+launch_executable (LauncherEngine    *engine, 
+                   CodeSlayerProject *project)
+{
+  LauncherConfig *config;
+  config = get_launch_config (engine, project);
+  if (config != NULL)
+    launch_config (engine, config);
+}
+
+/*
+ * With a build command the executable is rebuilt first, but only when 
+ * a source changed since it was last linked. Watch mode starts with the 
+ * first run, the stand-by child is parked once the run is launched.
+ */
+static void
+launch_config (LauncherEngine *engine, 
+               LauncherConfig *config)
+{
+  LauncherBuild *build;
+  
+  update_watch (engine, config);
+  
+  build = get_stale_build (engine, config);
+  if (build != NULL)
+    build_config (engine, config, build, NULL);
+  else
+    start_config (engine, config);
+}
+
+/*
+ * Runs and sweeps go through the job queue, a terminal is not something 
+ * the queue can tell has finished so it is opened right away.
+ */
+static void
+start_config (LauncherEngine *engine, 
+              LauncherConfig *config)
+{
+  LauncherEnginePrivate *priv;
+  const gchar *parameters;
+  GError *error = NULL;
+
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  parameters = launcher_config_get_parameters (config);
+
+  if (!launcher_config_get_terminal (config))
+    {
+      LauncherJob *job;
+      job = launcher_scheduler_submit (priv->scheduler, config, 
+                                       launcher_sweep_has_placeholders (parameters) ? 
+                                       LAUNCHER_JOB_SWEEP : LAUNCHER_JOB_RUN,
+                                       (LauncherJobFunc) start_job, engine);
+      if (launcher_job_get_state (job) == LAUNCHER_JOB_QUEUED)
+        codeslayer_show_bottom_pane (priv->codeslayer, priv->jobs_view);
+      return;
+    }
+  
+  if (!launcher_core_spawn_terminal (config, get_active_file (engine), &error))
+    {
+      show_error (error->message);
+      g_error_free (error);
+    }
+}
+
+static gboolean
+start_job (LauncherJob    *job,
+           LauncherEngine *engine)
+{
+  switch (launcher_job_get_kind (job))
+    {
+    case LAUNCHER_JOB_RUN:
+      return run_job (engine, job);
+    case LAUNCHER_JOB_SWEEP:
+      return sweep_job (engine, job);
+    case LAUNCHER_JOB_BENCHMARK:
+    case LAUNCHER_JOB_STARTUP:
+      return benchmark_job (engine, job);
+    }
+  return FALSE;
+}
+
+/*
+ * The job stays with the process until it finishes, cancelling the job 
+ * terminates the process.
+ */
+static gboolean
+run_job (LauncherEngine *engine, 
+         LauncherJob    *job)
+{
+  LauncherProcess *process;
+  
+  process = launch_process (engine, launcher_job_get_config (job));
+  if (process == NULL)
+    return FALSE;
+  
+  bind_job (process, job);
+  return TRUE;
+}
+
+static void
+bind_job (LauncherProcess *process,
+          LauncherJob     *job)
+{
+  g_object_set_data_full (G_OBJECT (process), "launcher-job", 
+                          g_object_ref (job), g_object_unref);
+  g_signal_connect_object (G_OBJECT (launcher_job_get_cancellable (job)), "cancelled",
+                           G_CALLBACK (cancel_process_action), process, G_CONNECT_SWAPPED);
+}
+
+static void
+cancel_process_action (LauncherProcess *process)
+{
+  launcher_process_terminate (process, TERMINATE_TIMEOUT);
+}
+
+/*
+ * Returns the spawned process, which is owned by the engine until it 
+ * finishes, or NULL when the launch failed and the error was shown.
+ */
+static LauncherProcess*
+launch_process (LauncherEngine *engine, 
+                LauncherConfig *config)
+{
+  LauncherEnginePrivate *priv;
+  LauncherProcess *process;
+  LauncherWatch *watch;
+
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  process = release_standby (engine, config);
+  if (process == NULL)
+    process = spawn_process (engine, config);
+  if (process == NULL)
+    return NULL;
+  
+  g_signal_connect_swapped (G_OBJECT (process), "finished",
+                            G_CALLBACK (process_finished_action), engine);
+  g_signal_connect_swapped (G_OBJECT (process), "hung",
+                            G_CALLBACK (process_hung_action), engine);
+  priv->processes = g_list_append (priv->processes, process);
+  launcher_monitor_add_process (priv->process_monitor, process);
+  
+  watch = g_hash_table_lookup (priv->watches, launcher_config_get_project (config));
+  if (watch != NULL)
+    {
+      gint64 change_time = launcher_watch_take_change_time (watch);
+      if (change_time > 0)
+        launcher_process_set_restart_latency (process, g_get_monotonic_time () - change_time);
+      launcher_watch_set_process (watch, process);
+    }
+  
+  launcher_output_set_process (LAUNCHER_OUTPUT (priv->output), process);
+  codeslayer_show_bottom_pane (priv->codeslayer, priv->output);
+  
+  /* park the next one while this one runs */
+  prepare_standby (engine, config);
+  
+  return process;
+}
+
+static LauncherProcess*
+spawn_process (LauncherEngine *engine, 
+               LauncherConfig *config)
+{
+  LauncherProcess *process;
+  gchar *profiles_folder;
+  GError *error = NULL;
+
+  profiles_folder = get_profiles_folder (engine, config);
+  process = launcher_core_spawn_process (config, get_active_file (engine), 
+                                         profiles_folder, &error);
+  g_free (profiles_folder);
+  
+  if (process == NULL)
+    {
+      show_error (error->message);
+      g_error_free (error);
+    }
+  
+  return process;
+}
+
+/*
+ * A stand-by child is forked with everything but the exec done, so that 
+ * the next launch only has to release it. Runs that wrap or count the 
+ * program, that need a terminal or that take the active file, which is 
+ * only known at launch, are always spawned cold.
+ */
+static void
+prepare_standby (LauncherEngine *engine,
+                 LauncherConfig *config)
+{
+  LauncherEnginePrivate *priv;
+  CodeSlayerProject *project;
+  LauncherProcess *process;
+  LauncherResources *resources;
+  LauncherCommand *command;
+  gchar **argv;
+  gchar **envp = NULL;
+  gchar *program;
+  GError *error = NULL;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  project = launcher_config_get_project (config);
+  command = launcher_config_get_command (config, NULL);
+  
+  if (command == NULL ||
+      launcher_command_uses_variable (command, LAUNCHER_VARIABLE_ACTIVE_FILE) ||
+      !launcher_config_get_standby (config) || 
+      launcher_config_get_terminal (config) ||
+      launcher_config_get_counters (config) ||
+      launcher_config_get_profiler (config) != LAUNCHER_PROFILER_NONE ||
+      launcher_sweep_has_placeholders (launcher_config_get_parameters (config)))
+    return;
+  
+  if (g_hash_table_lookup (priv->standbys, project) != NULL)
+    return;
+  
+  argv = launcher_core_create_argv (config, NULL, &envp, NULL);
+  if (argv == NULL)
+    return;
+  
+  program = g_strdup (argv[0]);
+  
+  /* a bad setting is reported when the program is launched */
+  resources = launcher_core_create_resources (config, &argv, NULL);
+  if (resources == NULL)
+    {
+      g_strfreev (argv);
+      g_strfreev (envp);
+      g_free (program);
+      return;
+    }
+  
+  process = launcher_process_new (config);
+  launcher_process_set_resources (process, resources);
+  launcher_process_set_environment (process, envp);
+  launcher_process_set_program (process, program);
+  launcher_process_set_core_dumps (process, TRUE);
+  launcher_process_set_watchdog (process, TRUE);
+  g_object_unref (resources);
+  g_strfreev (envp);
+  g_free (program);
+  if (launcher_process_prespawn (process, argv, &error))
+    {
+      g_hash_table_insert (priv->standbys, project, process);
+    }
+  else
+    {
+      g_warning ("Not able to prepare a stand-by process: %s", error->message);
+      g_error_free (error);
+      g_object_unref (process);
+    }
+  
+  g_strfreev (argv);
+}
+
+/*
+ * Returns the stand-by child of the project once it is running the program, 
+ * or NULL when there is none, it went away in the meantime or it was 
+ * parked for another config of the project.
+ */
+static LauncherProcess*
+release_standby (LauncherEngine *engine,
+                 LauncherConfig *config)
+{
+  LauncherEnginePrivate *priv;
+  CodeSlayerProject *project;
+  LauncherProcess *process;
+  LaunchLatency *latency;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  project = launcher_config_get_project (config);
+  
+  process = g_hash_table_lookup (priv->standbys, project);
+  if (process == NULL)
+    return NULL;
+  
+  g_hash_table_steal (priv->standbys, project);
+  
+  if (launcher_process_get_config (process) != config || 
+      !launcher_process_release (process))
+    {
+      destroy_standby (process);
+      return NULL;
+    }
+  
+  latency = g_hash_table_lookup (priv->latencies, project);
+  if (latency != NULL && latency->cold_runs > 0)
+    launcher_process_set_cold_latency (process, latency->cold_total / latency->cold_runs);
+  
+  return process;
+}
+
+static void
+destroy_standby (LauncherProcess *process)
+{
+  launcher_process_discard (process);
+  g_object_unref (process);
+}
+
+/*
+ * Keeps the cold launch latency as the baseline for warm runs and the files 
+ * the program mapped for the next prefetch.
+ */
+static void
+record_launch (LauncherEngine  *engine,
+               LauncherProcess *process)
+{
+  LauncherEnginePrivate *priv;
+  CodeSlayerProject *project;
+  gchar **mapped_files;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  project = launcher_config_get_project (launcher_process_get_config (process));
+  
+  if (launcher_process_get_launch_latency (process) >= 0 && 
+      !launcher_process_get_warm (process) &&
+      launcher_process_get_profiler (process) == LAUNCHER_PROFILER_NONE)
+    {
+      LaunchLatency *latency;
+      latency = g_hash_table_lookup (priv->latencies, project);
+      if (latency == NULL)
+        {
+          latency = g_new0 (LaunchLatency, 1);
+          g_hash_table_insert (priv->latencies, project, latency);
+        }
+      latency->cold_total += launcher_process_get_launch_latency (process);
+      latency->cold_runs++;
+    }
+  
+  mapped_files = launcher_process_get_mapped_files (process);
+  if (mapped_files != NULL)
+    g_hash_table_replace (priv->mapped_files, project, g_strdupv (mapped_files));
+}
+
+static void
+launch_groups_menu_action (LauncherEngine *engine)
+{
+  CodeSlayerProject *project;
+  project = get_active_project (engine);
+  if (project != NULL)
+    launch_project_group (engine, project);
+}
+
+static void
+project_launch_group_action (LauncherEngine *engine, 
+                             GList          *selections)
+{
+  CodeSlayerProject *project;
+  project = get_selections_project (selections);
+  launch_project_group (engine, project);
+}
+
+/*
+ * Starts every member whose dependencies are ready right away, the others 
+ * follow as soon as the probes of their dependencies pass.
+ */
+static void
+launch_project_group (LauncherEngine    *engine, 
+                      CodeSlayerProject *project)
+{
+  LauncherEnginePrivate *priv;
+  LauncherGroup *group;
+  GroupRun *run;
+  GList *groups;
+  gchar *folder_path;
+  gchar *file_path;
+  GError *error = NULL;
+  guint i;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  folder_path = codeslayer_get_project_config_folder_path (priv->codeslayer, project);
+  file_path = codeslayer_utils_get_file_path (folder_path, LAUNCHER_GROUPS);
+  groups = launcher_group_load (file_path, codeslayer_project_get_folder_path (project), &error);
+  g_free (folder_path);
+  g_free (file_path);
+  
+  if (error != NULL)
+    {
+      show_error (error->message);
+      g_error_free (error);
+      return;
+    }
+  
+  if (groups == NULL)
+    {
+      gchar *msg;
+      msg = g_strconcat ("There are no launch groups for project ", 
+                         codeslayer_project_get_name (project), ".", NULL);      
+      show_error (msg);
+      g_free (msg);
+      return;
+    }
+  
+  group = select_group (groups);
+  if (group != NULL)
+    {
+      run = g_slice_new0 (GroupRun);
+      run->engine = engine;
+      run->group = g_object_ref (group);
+      run->cancellable = g_object_ref (priv->cancellable);
+      run->start_time = g_get_monotonic_time ();
+      run->members = g_new0 (MemberRun, launcher_group_get_n_members (group));
+      
+      for (i = 0; i < launcher_group_get_n_members (group); i++)
+        {
+          run->members[i].run = run;
+          run->members[i].index = i;
+          run->members[i].state = MEMBER_PENDING;
+        }
+      
+      start_group_members (run);
+    }
+  
+  g_list_free_full (groups, g_object_unref);
+}
+
+static LauncherGroup*
+select_group (GList *groups)
+{
+  LauncherGroup *group = NULL;
+  GtkWidget *dialog;
+  GtkWidget *content_area;
+  GtkWidget *combo_box;
+  GList *list;
+  
+  if (groups->next == NULL)
+    return groups->data;
+  
+  dialog = gtk_dialog_new_with_buttons ("Launch Group", NULL, GTK_DIALOG_MODAL,
+                                        GTK_STOCK_CANCEL, GTK_RESPONSE_CANCEL,
+                                        GTK_STOCK_EXECUTE, GTK_RESPONSE_OK,
+                                        NULL);
+  gtk_dialog_set_default_response (GTK_DIALOG (dialog), GTK_RESPONSE_OK);
+  
+  combo_box = gtk_combo_box_text_new ();
+  for (list = groups; list != NULL; list = g_list_next (list))
+    gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (combo_box), 
+                                    launcher_group_get_name (list->data));
+  gtk_combo_box_set_active (GTK_COMBO_BOX (combo_box), 0);
+  
+  content_area = gtk_dialog_get_content_area (GTK_DIALOG (dialog));
+  gtk_container_set_border_width (GTK_CONTAINER (content_area), 8);
+  gtk_box_pack_start (GTK_BOX (content_area), combo_box, FALSE, FALSE, 0);
+  gtk_widget_show_all (content_area);
+  
+  if (gtk_dialog_run (GTK_DIALOG (dialog)) == GTK_RESPONSE_OK)
+    group = g_list_nth_data (groups, gtk_combo_box_get_active (GTK_COMBO_BOX (combo_box)));
+  
+  gtk_widget_destroy (dialog);
+  return group;
+}
+
+static void
+start_group_members (GroupRun *run)
+{
+  guint n_members;
+  guint n_starting = 0;
+  guint i;
+  
+  n_members = launcher_group_get_n_members (run->group);
+  run->starting = TRUE;
+
+  for (i = 0; i < n_members && !run->failed; i++)
+    {
+      const LauncherGroupMember *member;
+      gboolean ready = TRUE;
+      gchar **depend;
+      
+      if (run->members[i].state != MEMBER_PENDING)
+        continue;
+      
+      member = launcher_group_get_member (run->group, i);
+      for (depend = member->depends; *depend != NULL && ready; depend++)
+        {
+          gint index = launcher_group_find_member (run->group, *depend);
+          ready = run->members[index].state == MEMBER_READY;
+        }
+      
+      if (ready)
+        start_group_member (run, &run->members[i]);
+    }
+  
+  run->starting = FALSE;
+  
+  for (i = 0; i < n_members; i++)
+    if (run->members[i].state == MEMBER_STARTING)
+      n_starting++;
+  
+  /* nothing is left to wait for once a member failed or all are ready */
+  if (n_starting == 0)
+    {
+      report_group_run (run);
+      group_run_free (run);
+    }
+}
+
+/*
+ * Members are built when stale and go through the job queue like any 
+ * other run, the probe only starts once the job has its process.
+ */
+static void
+start_group_member (GroupRun  *run,
+                    MemberRun *member_run)
+{
+  LauncherEnginePrivate *priv;
+  const LauncherGroupMember *member;
+  CodeSlayerProject *project;
+  LauncherConfig *config = NULL;
+  LauncherBuild *build;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (run->engine);
+  member = launcher_group_get_member (run->group, member_run->index);
+  
+  member_run->start_time = g_get_monotonic_time ();
+  member_run->state = MEMBER_STARTING;
+  
+  project = codeslayer_get_project_by_file_path (priv->codeslayer, member->project_path);
+  if (project == NULL)
+    {
+      gchar *error;
+      error = g_strdup_printf ("%s is not an open project", member->project_path);
+      fail_group_member (member_run, error);
+      g_free (error);
+      return;
+    }
+  
+  config = get_config_by_project (run->engine, project);
+  if (config == NULL)
+    {
+      gchar *error;
+      error = g_strdup_printf ("There is no launch config for project %s", 
+                               codeslayer_project_get_name (project));
+      fail_group_member (member_run, error);
+      g_free (error);
+      return;
+    }
+  
+  if (launcher_config_get_terminal (config))
+    {
+      fail_group_member (member_run, "Members can not be run in a terminal");
+      return;
+    }
+  
+  build = get_stale_build (run->engine, config);
+  if (build == NULL)
+    submit_group_member (member_run, config);
+  else if (!build_config (run->engine, config, build, member_run))
+    fail_group_member (member_run, "The build could not be started");
+}
+
+static void
+submit_group_member (MemberRun      *member_run,
+                     LauncherConfig *config)
+{
+  LauncherEnginePrivate *priv;
+  LauncherJob *job;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (member_run->run->engine);
+  
+  job = launcher_scheduler_submit (priv->scheduler, config, LAUNCHER_JOB_RUN,
+                                   (LauncherJobFunc) start_member_job, member_run);
+  
+  /* a queued job that is cancelled never starts, the member fails instead */
+  if (launcher_job_get_state (job) == LAUNCHER_JOB_QUEUED)
+    {
+      member_run->job = g_object_ref (job);
+      member_run->cancelled_id = g_signal_connect_swapped (G_OBJECT (launcher_job_get_cancellable (job)), 
+                                                           "cancelled", 
+                                                           G_CALLBACK (member_cancelled_action), 
+                                                           member_run);
+      codeslayer_show_bottom_pane (priv->codeslayer, priv->jobs_view);
+    }
+}
+
+static gboolean
+start_member_job (LauncherJob *job,
+                  MemberRun   *member_run)
+{
+  GroupRun *run = member_run->run;
+  const LauncherGroupMember *member;
+  LauncherProcess *process;
+  
+  release_member_job (member_run);
+  
+  process = launch_process (run->engine, launcher_job_get_config (job));
+  if (process == NULL)
+    {
+      fail_group_member (member_run, "The process could not be launched");
+      return FALSE;
+    }
+  
+  bind_job (process, job);
+  
+  member = launcher_group_get_member (run->group, member_run->index);
+  member_run->start_time = g_get_monotonic_time ();
+  launcher_probe_wait_async (process, member->probe, member->probe_target, member->timeout, 
+                             run->cancellable, (GAsyncReadyCallback) member_ready_action, 
+                             member_run);
+  return TRUE;
+}
+
+static void
+member_cancelled_action (MemberRun *member_run)
+{
+  release_member_job (member_run);
+  fail_group_member (member_run, "The job was cancelled");
+}
+
+static void
+release_member_job (MemberRun *member_run)
+{
+  if (member_run->job == NULL)
+    return;
+  
+  g_signal_handler_disconnect (launcher_job_get_cancellable (member_run->job), 
+                               member_run->cancelled_id);
+  g_object_unref (member_run->job);
+  member_run->job = NULL;
+  member_run->cancelled_id = 0;
+}
+
+static void
+fail_group_member (MemberRun   *member_run,
+                   const gchar *error)
+{
+  member_run->state = MEMBER_FAILED;
+  member_run->error = g_strdup (error);
+  member_run->run->failed = TRUE;
+  continue_group_run (member_run->run);
+}
+
+static void
+member_ready_action (LauncherProcess *process,
+                     GAsyncResult    *result,
+                     MemberRun       *member_run)
+{
+  LauncherEnginePrivate *priv;
+  GroupRun *run = member_run->run;
+  GError *error = NULL;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (run->engine);
+  
+  if (launcher_probe_wait_finish (process, result, &error))
+    {
+      LauncherJob *job;
+      
+      /* a ready member may serve forever, its slot goes to the next one */
+      job = g_object_get_data (G_OBJECT (process), "launcher-job");
+      if (job != NULL)
+        launcher_scheduler_finish (priv->scheduler, job);
+      
+      member_run->state = MEMBER_READY;
+      member_run->ready_time = g_get_monotonic_time ();
+      continue_group_run (run);
+    }
+  else
+    {
+      fail_group_member (member_run, error->message);
+      g_error_free (error);
+    }
+}
+
+/*
+ * A member that fails while start_group_members is still going through 
+ * the group is picked up by that loop. Once the engine is gone the run 
+ * just waits for the other members to let go.
+ */
+static void
+continue_group_run (GroupRun *run)
+{
+  if (run->starting)
+    return;
+  
+  if (g_cancellable_is_cancelled (run->cancellable))
+    {
+      guint i;
+      for (i = 0; i < launcher_group_get_n_members (run->group); i++)
+        if (run->members[i].state == MEMBER_STARTING)
+          return;
+      group_run_free (run);
+      return;
+    }
+  
+  start_group_members (run);
+}
+
+/*
+ * Times are measured from the moment the group was launched, the ready 
+ * column is how long the member took after it was started.
+ */
+static void
+report_group_run (GroupRun *run)
+{
+  LauncherEnginePrivate *priv;
+  GString *text;
+  gchar *title;
+  gint64 end_time = run->start_time;
+  guint i;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (run->engine);
+  
+  text = g_string_new (NULL);
+  g_string_append_printf (text, "%-24s %12s %12s %12s\n", "Member", "Started", "Ready In", "Ready At");
+  
+  for (i = 0; i < launcher_group_get_n_members (run->group); i++)
+    {
+      const LauncherGroupMember *member;
+      MemberRun *member_run = &run->members[i];
+      
+      member = launcher_group_get_member (run->group, i);
+      
+      switch (member_run->state)
+        {
+        case MEMBER_READY:
+          g_string_append_printf (text, "%-24s %10.3f s %10.3f s %10.3f s\n", member->name, 
+                                  (member_run->start_time - run->start_time) / (gdouble) G_USEC_PER_SEC,
+                                  (member_run->ready_time - member_run->start_time) / (gdouble) G_USEC_PER_SEC,
+                                  (member_run->ready_time - run->start_time) / (gdouble) G_USEC_PER_SEC);
+          end_time = MAX (end_time, member_run->ready_time);
+          break;
+        case MEMBER_FAILED:
+          g_string_append_printf (text, "%-24s %10.3f s   failed: %s\n", member->name, 
+                                  (member_run->start_time - run->start_time) / (gdouble) G_USEC_PER_SEC,
+                                  member_run->error);
+          break;
+        default:
+          g_string_append_printf (text, "%-24s  not started\n", member->name);
+          break;
+        }
+    }
+  
+  if (run->failed)
+    title = g_strdup_printf ("%s failed", launcher_group_get_name (run->group));
+  else
+    title = g_strdup_printf ("%s ready in %.2f s", launcher_group_get_name (run->group), 
+                             (end_time - run->start_time) / (gdouble) G_USEC_PER_SEC);
+  
+  launcher_reports_add (LAUNCHER_REPORTS (priv->reports), title, text->str);
+  codeslayer_show_bottom_pane (priv->codeslayer, priv->reports);
+  
+  g_string_free (text, TRUE);
+  g_free (title);
+}
+
+static void
+group_run_free (GroupRun *run)
+{
+  guint i;
+  for (i = 0; i < launcher_group_get_n_members (run->group); i++)
+    g_free (run->members[i].error);
+  g_free (run->members);
+  g_object_unref (run->group);
+  g_object_unref (run->cancellable);
+  g_slice_free (GroupRun, run);
+}
+
+static const gchar*
+get_active_file (LauncherEngine *engine)
+{
+  LauncherEnginePrivate *priv;
+  CodeSlayerEditor *editor;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  editor = codeslayer_get_active_editor (priv->codeslayer);
+  if (editor == NULL)
+    return NULL;
+  
+  return codeslayer_editor_get_file_path (editor);
+}
+
+/*
+ * The profiles are written into the project config folder so that they 
+ * can be opened later with the tool's own viewer.
+ */
+static gchar*
+get_profiles_folder (LauncherEngine *engine,
+                     LauncherConfig *config)
+{
+  LauncherEnginePrivate *priv;
+  gchar *config_folder_path;
+  gchar *folder_path;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  config_folder_path = codeslayer_get_project_config_folder_path (priv->codeslayer, 
+                                                                  launcher_config_get_project (config));
+  folder_path = g_build_filename (config_folder_path, PROFILES, NULL);
+  g_free (config_folder_path);
+  
+  return folder_path;
+}
+
+static void
+process_finished_action (LauncherEngine  *engine,
+                         LauncherProcess *process)
+{
+  LauncherEnginePrivate *priv;
+  LauncherJob *job;
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  /* a profiled run is too slow to be compared with the history */
+  if (launcher_process_get_profiler (process) != LAUNCHER_PROFILER_NONE)
+    report_profile (engine, process);
+  else
+    record_process (engine, process);
+  
+  if (launcher_process_get_state (process) == LAUNCHER_PROCESS_SIGNALED &&
+      launcher_process_get_core_dumped (process))
+    report_crash (engine, process);
+  
+  record_launch (engine, process);
+  
+  job = g_object_get_data (G_OBJECT (process), "launcher-job");
+  if (job != NULL)
+    launcher_scheduler_finish (priv->scheduler, job);
+  
+  priv->processes = g_list_remove (priv->processes, process);
+  g_object_unref (process);
+}
+
+static void
+report_profile (LauncherEngine  *engine,
+                LauncherProcess *process)
+{
+  LauncherEnginePrivate *priv;
+  ProfileReport *report;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  report = g_new (ProfileReport, 1);
+  report->engine = engine;
+  report->process = g_object_ref (process);
+  
+  launcher_profiler_summarize_async (launcher_process_get_profiler (process),
+                                     launcher_process_get_profile_path (process),
+                                     priv->cancellable, 
+                                     (GAsyncReadyCallback) profile_summarized_action, 
+                                     report);
+
+  switch (launcher_process_get_profiler (process))
+    {
+    case LAUNCHER_PROFILER_CALLGRIND:
+    case LAUNCHER_PROFILER_PERF:
+      launcher_annotations_load_async (launcher_process_get_profiler (process),
+                                       launcher_process_get_profile_path (process),
+                                       priv->cancellable, 
+                                       (GAsyncReadyCallback) profile_annotations_action, 
+                                       engine);
+      break;
+    default:
+      break;
+    }
+}
+
+static void
+profile_summarized_action (GObject       *source,
+                           GAsyncResult  *result,
+                           ProfileReport *report)
+{
+  LauncherEnginePrivate *priv;
+  LauncherProcess *process;
+  LauncherConfig *config;
+  GDateTime *date_time;
+  gchar *time;
+  gchar *title;
+  gchar *text;
+  gchar *summary;
+  GError *error = NULL;
+  
+  process = report->process;
+  summary = launcher_profiler_summarize_finish (result, &error);
+  
+  if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+      g_error_free (error);
+      g_object_unref (process);
+      g_free (report);
+      return;
+    }
+
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (report->engine);
+  config = launcher_process_get_config (process);
+  
+  date_time = g_date_time_new_from_unix_local (launcher_process_get_start_time (process) / G_USEC_PER_SEC);
+  time = g_date_time_format (date_time, "%H:%M:%S");
+  title = g_strdup_printf ("%s %s %s", 
+                           codeslayer_project_get_name (launcher_config_get_project (config)),
+                           launcher_profiler_to_string (launcher_process_get_profiler (process)), 
+                           time);
+  
+  if (summary != NULL)
+    text = g_strdup_printf ("%s\n\n%s", launcher_process_get_profile_path (process), summary);
+  else
+    text = g_strdup_printf ("%s\n\n%s", launcher_process_get_profile_path (process), error->message);
+  
+  launcher_reports_add (LAUNCHER_REPORTS (priv->reports), title, text);
+  codeslayer_show_bottom_pane (priv->codeslayer, priv->reports);
+  
+  if (error != NULL)
+    g_error_free (error);
+  g_date_time_unref (date_time);
+  g_free (time);
+  g_free (title);
+  g_free (text);
+  g_free (summary);
+  g_object_unref (process);
+  g_free (report);
+}
+
+/*
+ * The core goes into the crash folder of the project next to the profiles, 
+ * the backtrace is shown once the debugger is done with it.
+ */
+static void
+report_crash (LauncherEngine  *engine,
+              LauncherProcess *process)
+{
+  LauncherEnginePrivate *priv;
+  LauncherConfig *config;
+  CrashReport *report;
+  GDateTime *date_time;
+  gchar *config_folder_path;
+  gchar *crash_folder;
+  gchar *time;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  config = launcher_process_get_config (process);
+  
+  date_time = g_date_time_new_from_unix_local (launcher_process_get_start_time (process) / G_USEC_PER_SEC);
+  time = g_date_time_format (date_time, "%H:%M:%S");
+  
+  report = g_new (CrashReport, 1);
+  report->engine = engine;
+  report->title = g_strdup_printf ("%s %s", launcher_config_get_project_name (config), time);
+  
+  config_folder_path = codeslayer_get_project_config_folder_path (priv->codeslayer, 
+                                                                  launcher_config_get_project (config));
+  crash_folder = g_build_filename (config_folder_path, CRASHES, NULL);
+  
+  launcher_crash_collect_async (launcher_process_get_pid (process), 
+                                launcher_process_get_exit_status (process),
+                                launcher_process_get_program (process),
+                                launcher_process_get_working_directory (process),
+                                crash_folder, priv->cancellable, 
+                                (GAsyncReadyCallback) crash_collected_action, 
+                                report);
+  
+  g_date_time_unref (date_time);
+  g_free (config_folder_path);
+  g_free (crash_folder);
+  g_free (time);
+}
+
+static void
+crash_collected_action (GObject       *source,
+                        GAsyncResult  *result,
+                        CrashReport   *report)
+{
+  LauncherEnginePrivate *priv;
+  LauncherCrash *crash;
+  GError *error = NULL;
+  
+  crash = launcher_crash_collect_finish (result, &error);
+  
+  if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+      g_error_free (error);
+      g_free (report->title);
+      g_free (report);
+      return;
+    }
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (report->engine);
+  
+  if (crash != NULL)
+    {
+      launcher_crash_view_add (LAUNCHER_CRASH_VIEW (priv->crash_view), report->title, crash);
+      g_object_unref (crash);
+    }
+  else
+    {
+      launcher_crash_view_add_failure (LAUNCHER_CRASH_VIEW (priv->crash_view), 
+                                       report->title, error->message);
+      g_error_free (error);
+    }
+  
+  codeslayer_show_bottom_pane (priv->codeslayer, priv->crash_view);
+  
+  g_free (report->title);
+  g_free (report);
+}
+
+/*
+ * The stacks are sampled while the run is still stuck and only then is it 
+ * terminated, the sampling holds a reference so the process outlives it.
+ */
+static void
+process_hung_action (LauncherEngine  *engine,
+                     LauncherProcess *process)
+{
+  LauncherEnginePrivate *priv;
+  HangReport *report;
+  GDateTime *date_time;
+  gchar *time;
+  gchar *reason;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  date_time = g_date_time_new_now_local ();
+  time = g_date_time_format (date_time, "%H:%M:%S");
+  reason = launcher_process_get_hang_reason (process);
+  
+  report = g_new (HangReport, 1);
+  report->engine = engine;
+  report->process = g_object_ref (process);
+  report->title = g_strdup_printf ("%s %s", 
+                                   launcher_config_get_project_name (launcher_process_get_config (process)), 
+                                   time);
+  
+  launcher_hang_sample_async (launcher_process_get_pid (process), reason, 
+                              priv->cancellable, 
+                              (GAsyncReadyCallback) hang_sampled_action, 
+                              report);
+  
+  g_date_time_unref (date_time);
+  g_free (time);
+  g_free (reason);
+}
+
+static void
+hang_sampled_action (GObject      *source,
+                     GAsyncResult *result,
+                     HangReport   *report)
+{
+  LauncherEnginePrivate *priv;
+  LauncherHang *hang;
+  GError *error = NULL;
+  
+  hang = launcher_hang_sample_finish (result, &error);
+  
+  if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+      g_error_free (error);
+      g_object_unref (report->process);
+      g_free (report->title);
+      g_free (report);
+      return;
+    }
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (report->engine);
+  
+  if (hang != NULL)
+    {
+      launcher_crash_view_add_hang (LAUNCHER_CRASH_VIEW (priv->crash_view), report->title, hang);
+      g_object_unref (hang);
+    }
+  else
+    {
+      launcher_crash_view_add_failure (LAUNCHER_CRASH_VIEW (priv->crash_view), 
+                                       report->title, error->message);
+      g_error_free (error);
+    }
+  
+  codeslayer_show_bottom_pane (priv->codeslayer, priv->crash_view);
+  launcher_process_terminate (report->process, TERMINATE_TIMEOUT);
+  
+  g_object_unref (report->process);
+  g_free (report->title);
+  g_free (report);
+}
+
+/*
+ * Frames in system libraries point at sources that are rarely installed.
+ */
+static void
+frame_activated_action (LauncherEngine *engine,
+                        const gchar    *file_path,
+                        gint            line)
+{
+  LauncherEnginePrivate *priv;
+  CodeSlayerDocument *document;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  if (!g_file_test (file_path, G_FILE_TEST_IS_REGULAR))
+    {
+      gchar *message;
+      message = g_strdup_printf ("The source %s is not available", file_path);
+      show_error (message);
+      g_free (message);
+      return;
+    }
+  
+  document = codeslayer_document_new ();
+  codeslayer_document_set_file_path (document, file_path);
+  codeslayer_document_set_line_number (document, line);
+  codeslayer_document_set_project (document, 
+                                   codeslayer_get_project_by_file_path (priv->codeslayer, file_path));
+  codeslayer_select_editor (priv->codeslayer, document);
+  g_object_unref (document);
+}
+
+static void
+profile_annotations_action (GObject        *source,
+                            GAsyncResult   *result,
+                            LauncherEngine *engine)
+{
+  LauncherEnginePrivate *priv;
+  LauncherAnnotations *annotations;
+  GError *error = NULL;
+  
+  annotations = launcher_annotations_load_finish (result, &error);
+  if (annotations == NULL)
+    {
+      if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        g_warning ("Unable to annotate the profile: %s", error->message);
+      g_error_free (error);
+      return;
+    }
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  launcher_annotator_set_annotations (priv->annotator, annotations);
+  g_object_unref (annotations);
+}
+
+static void
+clear_annotations_action (LauncherEngine *engine)
+{
+  LauncherEnginePrivate *priv;
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  launcher_annotator_set_annotations (priv->annotator, NULL);
+}
+
+static void
+benchmark_action (LauncherEngine *engine)
+{
+  CodeSlayerProject *project;
+  project = get_active_project (engine);
+  if (project != NULL)
+    benchmark_executable (engine, project, LAUNCHER_BENCHMARK_RUN);
+}
+
+static void
+project_benchmark_action (LauncherEngine *engine, 
+                          GList          *selections)
+{
+  CodeSlayerProject *project;
+  project = get_selections_project (selections);
+  benchmark_executable (engine, project, LAUNCHER_BENCHMARK_RUN);
+}
+
+static void
+benchmark_startup_action (LauncherEngine *engine)
+{
+  CodeSlayerProject *project;
+  project = get_active_project (engine);
+  if (project != NULL)
+    benchmark_executable (engine, project, LAUNCHER_BENCHMARK_STARTUP);
+}
+
+static void
+project_benchmark_startup_action (LauncherEngine *engine, 
+                                  GList          *selections)
+{
+  CodeSlayerProject *project;
+  project = get_selections_project (selections);
+  benchmark_executable (engine, project, LAUNCHER_BENCHMARK_STARTUP);
+}
+
+/*
+ * Benchmarks are queued as exclusive jobs, one starts when the sweep or 
+ * benchmark before it has finished and nothing else starts until it is 
+ * done. Runs that are already going are left alone.
+ */
+static void
+benchmark_executable (LauncherEngine        *engine, 
+                      CodeSlayerProject     *project,
+                      LauncherBenchmarkMode  mode)
+{
+  LauncherEnginePrivate *priv;
+  LauncherConfig *config;
+  LauncherJob *job;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  config = get_launch_config (engine, project);
+  if (config == NULL)
+    return;
+  
+  if (launcher_sweep_has_placeholders (launcher_config_get_parameters (config)))
+    {
+      show_error ("Benchmarks do not expand sweep parameters, use Run instead.");
+      return;
+    }
+  
+  job = launcher_scheduler_submit (priv->scheduler, config, 
+                                   mode == LAUNCHER_BENCHMARK_STARTUP ? 
+                                   LAUNCHER_JOB_STARTUP : LAUNCHER_JOB_BENCHMARK,
+                                   (LauncherJobFunc) start_job, engine);
+  if (launcher_job_get_state (job) == LAUNCHER_JOB_QUEUED)
+    codeslayer_show_bottom_pane (priv->codeslayer, priv->jobs_view);
+}
+
+static gboolean
+benchmark_job (LauncherEngine *engine, 
+               LauncherJob    *job)
+{
+  LauncherEnginePrivate *priv;
+  LauncherBenchmarkMode mode;
+  GError *error = NULL;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  if (launcher_job_get_kind (job) == LAUNCHER_JOB_STARTUP)
+    mode = LAUNCHER_BENCHMARK_STARTUP;
+  else
+    mode = LAUNCHER_BENCHMARK_RUN;
+  
+  priv->benchmark = launcher_core_create_benchmark (launcher_job_get_config (job), mode, 
+                                                    get_active_file (engine), &error);
+  if (priv->benchmark == NULL)
+    {
+      show_error (error->message);
+      g_error_free (error);
+      return FALSE;
+    }
+  
+  g_object_set_data_full (G_OBJECT (priv->benchmark), "launcher-job", 
+                          g_object_ref (job), g_object_unref);
+
+  launcher_benchmark_view_set_benchmark (LAUNCHER_BENCHMARK_VIEW (priv->benchmark_view), 
+                                         priv->benchmark);
+  codeslayer_show_bottom_pane (priv->codeslayer, priv->benchmark_view);
+
+  launcher_benchmark_run_async (priv->benchmark, launcher_job_get_cancellable (job), 
+                                (GAsyncReadyCallback) benchmark_finished_action, engine);
+  return TRUE;
+}
+
+static gboolean
+sweep_job (LauncherEngine *engine, 
+           LauncherJob    *job)
+{
+  LauncherEnginePrivate *priv;
+  GError *error = NULL;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  priv->sweep = launcher_core_create_sweep (launcher_job_get_config (job), 
+                                            get_active_file (engine), &error);
+  if (priv->sweep == NULL)
+    {
+      show_error (error->message);
+      g_error_free (error);
+      return FALSE;
+    }
+  
+  g_object_set_data_full (G_OBJECT (priv->sweep), "launcher-job", 
+                          g_object_ref (job), g_object_unref);
+  launcher_sweep_view_set_sweep (LAUNCHER_SWEEP_VIEW (priv->sweep_view), priv->sweep);
+  codeslayer_show_bottom_pane (priv->codeslayer, priv->sweep_view);
+
+  launcher_sweep_run_async (priv->sweep, launcher_job_get_cancellable (job), 
+                            (GAsyncReadyCallback) sweep_finished_action, engine);
+  return TRUE;
+}
+
+/*
+ * A job that is already finished was dropped by the scheduler of an 
+ * engine that is gone. A sweep cancelled from the job queue still shows 
+ * the runs it got through.
+ */
+static void
+sweep_finished_action (LauncherSweep  *sweep,
+                       GAsyncResult   *result,
+                       LauncherEngine *engine)
+{
+  LauncherEnginePrivate *priv;
+  LauncherJob *job;
+  GError *error = NULL;
+  
+  job = g_object_get_data (G_OBJECT (sweep), "launcher-job");
+  
+  launcher_sweep_run_finish (sweep, result, &error);
+  
+  if (launcher_job_get_state (job) == LAUNCHER_JOB_FINISHED)
+    {
+      if (error != NULL)
+        g_error_free (error);
+      return;
+    }
+
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  launcher_sweep_view_show_results (LAUNCHER_SWEEP_VIEW (priv->sweep_view), error);
+  
+  /* finishing the job can start the next sweep */
+  priv->sweep = NULL;
+  launcher_scheduler_finish (priv->scheduler, job);
+  g_object_unref (sweep);
+  
+  if (error != NULL)
+    g_error_free (error);
+}
+
+static void
+benchmark_finished_action (LauncherBenchmark *benchmark,
+                           GAsyncResult      *result,
+                           LauncherEngine    *engine)
+{
+  LauncherEnginePrivate *priv;
+  LauncherJob *job;
+  GError *error = NULL;
+  
+  job = g_object_get_data (G_OBJECT (benchmark), "launcher-job");
+  
+  launcher_benchmark_run_finish (benchmark, result, &error);
+  
+  if (launcher_job_get_state (job) == LAUNCHER_JOB_FINISHED)
+    {
+      if (error != NULL)
+        g_error_free (error);
+      return;
+    }
+
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  launcher_benchmark_view_show_results (LAUNCHER_BENCHMARK_VIEW (priv->benchmark_view), error);
+  
+  /* startup runs would skew the wall time history of whole runs */
+  if (error == NULL && launcher_benchmark_get_mode (benchmark) == LAUNCHER_BENCHMARK_RUN)
+    record_benchmark (engine, benchmark);
+  
+  priv->benchmark = NULL;
+  launcher_scheduler_finish (priv->scheduler, job);
+  g_object_unref (benchmark);
+  
+  if (error != NULL)
+    g_error_free (error);
+}
+
+static LauncherHistory*
+get_history (LauncherEngine    *engine, 
+             CodeSlayerProject *project)
+{
+  LauncherEnginePrivate *priv;
+  LauncherHistory *history;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  history = g_hash_table_lookup (priv->histories, project);
+  if (history == NULL)
+    {
+      gchar *folder_path;
+      gchar *file_path;
+      folder_path = codeslayer_get_project_config_folder_path (priv->codeslayer, project);
+      file_path = g_build_filename (folder_path, LAUNCHER_HISTORY, NULL);
+      history = launcher_history_new (file_path);
+      g_hash_table_insert (priv->histories, project, history);
+      g_free (folder_path);
+      g_free (file_path);
+    }
+  
+  return history;
+}
+
+static void
+record_process (LauncherEngine  *engine,
+                LauncherProcess *process)
+{
+  LauncherEnginePrivate *priv;
+  LauncherHistoryRecord record = { 0 };
+  LauncherConfig *config;
+  LauncherHistory *history;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  switch (launcher_process_get_state (process))
+    {
+    case LAUNCHER_PROCESS_EXITED:
+      record.exit_status = launcher_process_get_exit_status (process);
+      break;
+    case LAUNCHER_PROCESS_SIGNALED:
+      record.exit_status = -launcher_process_get_exit_status (process);
+      break;
+    default:
+      return;
+    }
+  
+  config = launcher_process_get_config (process);
+  record.timestamp = launcher_process_get_start_time (process);
+  record.wall_time = launcher_process_get_run_time (process);
+  record.cpu_time = launcher_process_get_cpu_time (process);
+  record.max_rss = launcher_process_get_max_rss (process);
+  record.config_hash = launcher_history_get_config_hash (launcher_config_get_executable (config),
+                                                         launcher_config_get_parameters (config));
+  if (launcher_process_get_counters (process) != NULL)
+    launcher_history_set_counters (&record, launcher_process_get_counters (process));
+  
+  history = get_history (engine, launcher_config_get_project (config));
+  launcher_history_append_async (history, &record, 1, launcher_config_get_executable (config), 
+                                 priv->cancellable, 
+                                 (GAsyncReadyCallback) process_recorded_action, 
+                                 g_object_ref (process));
+}
+
+static void
+record_benchmark (LauncherEngine    *engine,
+                  LauncherBenchmark *benchmark)
+{
+  LauncherEnginePrivate *priv;
+  LauncherHistoryRecord *records;
+  LauncherConfig *config;
+  LauncherHistory *history;
+  guint32 config_hash;
+  gint64 timestamp;
+  guint n_samples;
+  guint i;
+  
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  
+  n_samples = launcher_benchmark_get_n_samples (benchmark);
+  if (n_samples == 0)
+    return;
+
+  config = launcher_benchmark_get_config (benchmark);
+  config_hash = launcher_history_get_config_hash (launcher_config_get_executable (config),
+                                                  launcher_config_get_parameters (config));
+  timestamp = g_get_real_time ();
+  
+  records = g_new0 (LauncherHistoryRecord, n_samples);
+  for (i = 0; i < n_samples; i++)
+    {
+      const LauncherBenchmarkSample *sample;
+      sample = launcher_benchmark_get_sample (benchmark, i);
+      records[i].timestamp = timestamp;
+      records[i].wall_time = sample->wall_time;
+      records[i].cpu_time = sample->user_time + sample->system_time;
+      records[i].max_rss = sample->max_rss;
+      records[i].config_hash = config_hash;
+      records[i].flags = LAUNCHER_HISTORY_BENCHMARK;
+      launcher_history_set_counters (&records[i], &sample->counters);
+      if (WIFEXITED (sample->status))
+        records[i].exit_status = WEXITSTATUS (sample->status);
+      else
+        records[i].exit_status = -WTERMSIG (sample->status);
+    }
+  
+  history = get_history (engine, launcher_config_get_project (config));
+  launcher_history_append_async (history, records, n_samples, 
+                                 launcher_config_get_executable (config), 
+                                 priv->cancellable, 
+                                 (GAsyncReadyCallback) benchmark_recorded_action, 
+                                 g_object_ref (benchmark));
+  g_free (records);
+}
+
+static void
+process_recorded_action (LauncherHistory *history,
+                         GAsyncResult    *result,
+                         LauncherProcess *process)
+{
+  LauncherHistoryRegression regression;
+  
+  if (launcher_history_append_finish (history, result, &regression, NULL) && 
+      regression.detected)
+    launcher_process_set_regression (process, &regression);
+
+  g_object_unref (process);
+}
+
+static void
+benchmark_recorded_action (LauncherHistory   *history,
+                           GAsyncResult      *result,
+                           LauncherBenchmark *benchmark)
+{
+  LauncherHistoryRegression regression;
+  
+  if (launcher_history_append_finish (history, result, &regression, NULL) && 
+      regression.detected)
+    launcher_benchmark_set_regression (benchmark, &regression);
+
+  g_object_unref (benchmark);
+}
+
+GList*
+launcher_engine_get_processes (LauncherEngine *engine)
+{
+  return LAUNCHER_ENGINE_GET_PRIVATE (engine)->processes;
+}
+
+static CodeSlayerProject*
+get_active_project (LauncherEngine *engine)
+{
+  LauncherEnginePrivate *priv;
+  CodeSlayerProject *project;
+  priv = LAUNCHER_ENGINE_GET_PRIVATE (engine);
+  project = codeslayer_get_active_editor_project (priv->codeslayer);
+  
+  if (project == NULL)
+    show_error ("There are no open editors. Not able to determine what program to run.");
+
+  return project;
+}
+
+static LauncherConfig*
+get_launch_config (LauncherEngine    *engine, 
+                   CodeSlayerProject *project)
+{
+  LauncherConfig *config;
+
+  config = get_config_by_project (engine, project);
+  
+  if (config == NULL)
+    {
+      gchar *msg;
+      msg = g_strconcat ("There is no launch config for project ", 
+                         codeslayer_project_get_name (project), ".", NULL);      
+      show_error (msg);
+      g_free (msg);
+    }
+  
+  return config;
+}
+
+static void
+show_error (const gchar *message)
+{
+  GtkWidget *dialog;
+  dialog =  gtk_message_dialog_new (NULL, 
+                                    GTK_DIALOG_MODAL,
+                                    GTK_MESSAGE_ERROR, GTK_BUTTONS_OK,
+                                    "%s", message);
+  gtk_dialog_run (GTK_DIALOG (dialog));
+  gtk_widget_destroy (dialog);
 }
 
 static CodeSlayerProject*
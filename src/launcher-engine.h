@@ -48,7 +48,16 @@ GType launcher_engine_get_type (void) G_GNUC_CONST;
 LauncherEngine*  launcher_engine_new (CodeSlayer *codeslayer,
                                   GtkWidget  *menu,
                                   GtkWidget  *project_properties,
-                                  GtkWidget  *projects_menu);
+                                  GtkWidget  *projects_menu,
+                                  GtkWidget  *output,
+                                  GtkWidget  *benchmark_view,
+                                  GtkWidget  *sweep_view,
+                                  GtkWidget  *jobs_view,
+                                  GtkWidget  *monitor_view,
+                                  GtkWidget  *crash_view,
+                                  GtkWidget  *reports);
+
+GList*           launcher_engine_get_processes (LauncherEngine *engine);
 
 G_END_DECLS
 
@@ -0,0 +1,351 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "launcher-group.h"
+
+/*
+ * Groups are read from the launcher.groups key file next to launcher.conf. 
+ * A group section lists its members and each member has its own section 
+ * named after the group and the member:
+ *
+ *   [stack]
+ *   members=backend;server;client
+ *
+ *   [stack backend]
+ *   project=../backend
+ *   probe=tcp:5432
+ *
+ *   [stack server]
+ *   project=../server
+ *   depends=backend
+ *   probe=log:Listening on port [0-9]+
+ *   timeout=30
+ *
+ * The project path is relative to the folder of the project that owns the 
+ * file and defaults to that project, the launch config of the project is 
+ * what gets run.
+ */
+
+#define MEMBERS "members"
+#define PROJECT "project"
+#define DEPENDS "depends"
+#define PROBE "probe"
+#define TIMEOUT "timeout"
+#define DEFAULT_TIMEOUT 60
+
+static void launcher_group_class_init  (LauncherGroupClass  *klass);
+static void launcher_group_init        (LauncherGroup       *group);
+static void launcher_group_finalize    (LauncherGroup       *group);
+
+static LauncherGroup* load_group       (GKeyFile            *key_file,
+                                        const gchar         *name,
+                                        const gchar         *folder_path,
+                                        GError             **error);
+static gboolean check_depends          (LauncherGroup       *group,
+                                        GError             **error);
+static gboolean visit_member           (LauncherGroup       *group,
+                                        guint                index,
+                                        guint8              *marks,
+                                        GError             **error);
+static void member_clear               (LauncherGroupMember *member);
+
+#define LAUNCHER_GROUP_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_GROUP_TYPE, LauncherGroupPrivate))
+
+typedef struct _LauncherGroupPrivate LauncherGroupPrivate;
+
+struct _LauncherGroupPrivate
+{
+  gchar  *name;
+  GArray *members;
+};
+
+G_DEFINE_TYPE (LauncherGroup, launcher_group, G_TYPE_OBJECT)
+
+static void
+launcher_group_class_init (LauncherGroupClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_group_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherGroupPrivate));
+}
+
+static void
+launcher_group_init (LauncherGroup *group)
+{
+  LauncherGroupPrivate *priv;
+  priv = LAUNCHER_GROUP_GET_PRIVATE (group);
+  priv->name = NULL;
+  priv->members = g_array_new (FALSE, TRUE, sizeof (LauncherGroupMember));
+  g_array_set_clear_func (priv->members, (GDestroyNotify) member_clear);
+}
+
+static void
+launcher_group_finalize (LauncherGroup *group)
+{
+  LauncherGroupPrivate *priv;
+  priv = LAUNCHER_GROUP_GET_PRIVATE (group);
+  g_free (priv->name);
+  g_array_free (priv->members, TRUE);
+  G_OBJECT_CLASS (launcher_group_parent_class)->finalize (G_OBJECT (group));
+}
+
+static void
+member_clear (LauncherGroupMember *member)
+{
+  g_free (member->name);
+  g_free (member->project_path);
+  g_strfreev (member->depends);
+  g_free (member->probe_target);
+}
+
+/*
+ * Returns the groups in the order of the file, or NULL with the error set 
+ * when a group is malformed. A missing file is simply no groups.
+ */
+GList*
+launcher_group_load (const gchar  *file_path,
+                     const gchar  *folder_path,
+                     GError      **error)
+{
+  GKeyFile *key_file;
+  GList *groups = NULL;
+  gchar **names;
+  gchar **name;
+  
+  if (!g_file_test (file_path, G_FILE_TEST_EXISTS))
+    return NULL;
+  
+  key_file = g_key_file_new ();
+  if (!g_key_file_load_from_file (key_file, file_path, G_KEY_FILE_NONE, error))
+    {
+      g_key_file_free (key_file);
+      return NULL;
+    }
+  
+  names = g_key_file_get_groups (key_file, NULL);
+  
+  for (name = names; *name != NULL; name++)
+    {
+      LauncherGroup *group;
+      
+      if (!g_key_file_has_key (key_file, *name, MEMBERS, NULL))
+        continue;
+      
+      group = load_group (key_file, *name, folder_path, error);
+      if (group == NULL)
+        {
+          g_list_free_full (groups, g_object_unref);
+          groups = NULL;
+          break;
+        }
+
+      groups = g_list_prepend (groups, group);
+    }
+  
+  g_strfreev (names);
+  g_key_file_free (key_file);
+  
+  return g_list_reverse (groups);
+}
+
+static LauncherGroup*
+load_group (GKeyFile     *key_file,
+            const gchar  *name,
+            const gchar  *folder_path,
+            GError      **error)
+{
+  LauncherGroupPrivate *priv;
+  LauncherGroup *group;
+  gchar **members;
+  gchar **member_name;
+  
+  group = LAUNCHER_GROUP (g_object_new (launcher_group_get_type (), NULL));
+  priv = LAUNCHER_GROUP_GET_PRIVATE (group);
+  priv->name = g_strdup (name);
+  
+  members = g_key_file_get_string_list (key_file, name, MEMBERS, NULL, NULL);
+  
+  for (member_name = members; *member_name != NULL; member_name++)
+    {
+      LauncherGroupMember member = { 0 };
+      GFile *file;
+      gchar *section;
+      gchar *project;
+      gchar *probe;
+      
+      section = g_strconcat (name, " ", *member_name, NULL);
+      project = g_key_file_get_string (key_file, section, PROJECT, NULL);
+      probe = g_key_file_get_string (key_file, section, PROBE, NULL);
+      
+      member.name = g_strdup (*member_name);
+      member.depends = g_key_file_get_string_list (key_file, section, DEPENDS, NULL, NULL);
+      if (member.depends == NULL)
+        member.depends = g_new0 (gchar*, 1);
+      
+      member.timeout = DEFAULT_TIMEOUT;
+      if (g_key_file_has_key (key_file, section, TIMEOUT, NULL))
+        member.timeout = g_key_file_get_integer (key_file, section, TIMEOUT, NULL);
+      
+      if (project == NULL || *project == '\0')
+        member.project_path = g_strdup (folder_path);
+      else if (g_path_is_absolute (project))
+        member.project_path = g_strdup (project);
+      else
+        member.project_path = g_build_filename (folder_path, project, NULL);
+      
+      /* resolve .. so the path compares equal to the project folder */
+      file = g_file_new_for_path (member.project_path);
+      g_free (member.project_path);
+      member.project_path = g_file_get_path (file);
+      g_object_unref (file);
+      
+      if (!launcher_probe_parse (probe, &member.probe, &member.probe_target, error))
+        {
+          g_prefix_error (error, "Launch group %s: ", name);
+          member_clear (&member);
+          g_free (section);
+          g_free (project);
+          g_free (probe);
+          g_strfreev (members);
+          g_object_unref (group);
+          return NULL;
+        }
+      
+      g_array_append_val (priv->members, member);
+      
+      g_free (section);
+      g_free (project);
+      g_free (probe);
+    }
+  
+  g_strfreev (members);
+  
+  if (!check_depends (group, error))
+    {
+      g_prefix_error (error, "Launch group %s: ", name);
+      g_object_unref (group);
+      return NULL;
+    }
+
+  return group;
+}
+
+/*
+ * Every dependency has to be a member of the same group and the members 
+ * must not depend on each other in a cycle, otherwise the group could 
+ * never be fully started.
+ */
+static gboolean
+check_depends (LauncherGroup  *group,
+               GError        **error)
+{
+  LauncherGroupPrivate *priv;
+  guint8 *marks;
+  gboolean result = TRUE;
+  guint i;
+  
+  priv = LAUNCHER_GROUP_GET_PRIVATE (group);
+  marks = g_new0 (guint8, priv->members->len);
+  
+  for (i = 0; i < priv->members->len && result; i++)
+    result = visit_member (group, i, marks, error);
+  
+  g_free (marks);
+  return result;
+}
+
+static gboolean
+visit_member (LauncherGroup  *group,
+              guint           index,
+              guint8         *marks,
+              GError        **error)
+{
+  LauncherGroupPrivate *priv;
+  LauncherGroupMember *member;
+  gchar **depend;
+  
+  priv = LAUNCHER_GROUP_GET_PRIVATE (group);
+  member = &g_array_index (priv->members, LauncherGroupMember, index);
+  
+  if (marks[index] == 2)
+    return TRUE;
+  
+  if (marks[index] == 1)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, 
+                   "%s depends on itself through its dependencies", member->name);
+      return FALSE;
+    }
+  
+  marks[index] = 1;
+  
+  for (depend = member->depends; *depend != NULL; depend++)
+    {
+      gint depend_index;
+      
+      depend_index = launcher_group_find_member (group, *depend);
+      if (depend_index < 0)
+        {
+          g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, 
+                       "%s depends on %s which is not a member", member->name, *depend);
+          return FALSE;
+        }
+      
+      if (!visit_member (group, depend_index, marks, error))
+        return FALSE;
+    }
+  
+  marks[index] = 2;
+  return TRUE;
+}
+
+const gchar*
+launcher_group_get_name (LauncherGroup *group)
+{
+  return LAUNCHER_GROUP_GET_PRIVATE (group)->name;
+}
+
+guint
+launcher_group_get_n_members (LauncherGroup *group)
+{
+  return LAUNCHER_GROUP_GET_PRIVATE (group)->members->len;
+}
+
+const LauncherGroupMember*
+launcher_group_get_member (LauncherGroup *group,
+                           guint          index)
+{
+  return &g_array_index (LAUNCHER_GROUP_GET_PRIVATE (group)->members, LauncherGroupMember, index);
+}
+
+gint
+launcher_group_find_member (LauncherGroup *group,
+                            const gchar   *name)
+{
+  LauncherGroupPrivate *priv;
+  guint i;
+  
+  priv = LAUNCHER_GROUP_GET_PRIVATE (group);
+  
+  for (i = 0; i < priv->members->len; i++)
+    if (g_strcmp0 (g_array_index (priv->members, LauncherGroupMember, i).name, name) == 0)
+      return i;
+  
+  return -1;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_GROUP_H__
+#define	__LAUNCHER_GROUP_H__
+
+#include <gio/gio.h>
+#include "launcher-probe.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_GROUP_TYPE            (launcher_group_get_type ())
+#define LAUNCHER_GROUP(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_GROUP_TYPE, LauncherGroup))
+#define LAUNCHER_GROUP_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_GROUP_TYPE, LauncherGroupClass))
+#define IS_LAUNCHER_GROUP(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_GROUP_TYPE))
+#define IS_LAUNCHER_GROUP_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_GROUP_TYPE))
+
+typedef struct _LauncherGroup LauncherGroup;
+typedef struct _LauncherGroupClass LauncherGroupClass;
+
+typedef struct
+{
+  gchar              *name;
+  gchar              *project_path;
+  gchar             **depends;
+  LauncherProbeType   probe;
+  gchar              *probe_target;
+  gint                timeout;
+} LauncherGroupMember;
+
+struct _LauncherGroup
+{
+  GObject parent_instance;
+};
+
+struct _LauncherGroupClass
+{
+  GObjectClass parent_class;
+};
+
+GType launcher_group_get_type (void) G_GNUC_CONST;
+
+GList*                     launcher_group_load           (const gchar   *file_path,
+                                                          const gchar   *folder_path,
+                                                          GError       **error);
+
+const gchar*               launcher_group_get_name       (LauncherGroup *group);
+guint                      launcher_group_get_n_members  (LauncherGroup *group);
+const LauncherGroupMember* launcher_group_get_member     (LauncherGroup *group,
+                                                          guint          index);
+gint                       launcher_group_find_member    (LauncherGroup *group,
+                                                          const gchar   *name);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_GROUP_H__ */
@@ -0,0 +1,393 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "launcher-hang.h"
+
+/*
+ * A poor man's profiler for a run that is stuck. The stacks of all threads 
+ * are taken a few times, eu-stack being much quicker to attach than gdb, 
+ * and identical stacks are counted together. A deadlock shows up as the 
+ * same stacks in every sample, a livelock as a handful of stacks that keep 
+ * coming back. The launcher is the parent of the run, so attaching works 
+ * with the default ptrace scope. Each attach stops the program for as long 
+ * as the tool needs, which is why all of it happens on a worker thread.
+ */
+
+static void launcher_hang_class_init  (LauncherHangClass *klass);
+static void launcher_hang_init        (LauncherHang      *hang);
+static void launcher_hang_finalize    (LauncherHang      *hang);
+
+static void sample_thread             (GTask             *task,
+                                       LauncherHang      *hang,
+                                       gpointer           task_data,
+                                       GCancellable      *cancellable);
+static gchar* take_sample             (LauncherHang      *hang,
+                                       GCancellable      *cancellable,
+                                       GError           **error);
+static void add_sample                (LauncherHang      *hang,
+                                       GHashTable        *stacks,
+                                       GPtrArray         *frames);
+static gint compare_stacks            (LauncherHangStack **stack1,
+                                       LauncherHangStack **stack2);
+static void stack_free                (LauncherHangStack *stack);
+static LauncherCrashFrame* frame_copy (LauncherCrashFrame *frame);
+static void frame_free                (LauncherCrashFrame *frame);
+
+#define LAUNCHER_HANG_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_HANG_TYPE, LauncherHangPrivate))
+
+typedef struct _LauncherHangPrivate LauncherHangPrivate;
+
+struct _LauncherHangPrivate
+{
+  GPid       pid;
+  gchar     *reason;
+  guint      n_samples;
+  GPtrArray *stacks;
+};
+
+#define SAMPLES 5
+#define SAMPLE_INTERVAL 200000
+
+G_DEFINE_TYPE (LauncherHang, launcher_hang, G_TYPE_OBJECT)
+
+static void
+launcher_hang_class_init (LauncherHangClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_hang_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherHangPrivate));
+}
+
+static void
+launcher_hang_init (LauncherHang *hang)
+{
+  LauncherHangPrivate *priv;
+  priv = LAUNCHER_HANG_GET_PRIVATE (hang);
+  priv->pid = 0;
+  priv->reason = NULL;
+  priv->n_samples = 0;
+  priv->stacks = g_ptr_array_new_with_free_func ((GDestroyNotify) stack_free);
+}
+
+static void
+launcher_hang_finalize (LauncherHang *hang)
+{
+  LauncherHangPrivate *priv;
+  priv = LAUNCHER_HANG_GET_PRIVATE (hang);
+  g_free (priv->reason);
+  g_ptr_array_free (priv->stacks, TRUE);
+  G_OBJECT_CLASS (launcher_hang_parent_class)->finalize (G_OBJECT (hang));
+}
+
+/*
+ * The process has to be kept running until this finishes, terminating it 
+ * is up to the caller.
+ */
+void
+launcher_hang_sample_async (GPid                 pid,
+                            const gchar         *reason,
+                            GCancellable        *cancellable,
+                            GAsyncReadyCallback  callback,
+                            gpointer             user_data)
+{
+  LauncherHangPrivate *priv;
+  LauncherHang *hang;
+  GTask *task;
+
+  hang = LAUNCHER_HANG (g_object_new (launcher_hang_get_type (), NULL));
+  priv = LAUNCHER_HANG_GET_PRIVATE (hang);
+  priv->pid = pid;
+  priv->reason = g_strdup (reason);
+
+  task = g_task_new (hang, cancellable, callback, user_data);
+  g_task_run_in_thread (task, (GTaskThreadFunc) sample_thread);
+  g_object_unref (task);
+  g_object_unref (hang);
+}
+
+LauncherHang*
+launcher_hang_sample_finish (GAsyncResult  *result,
+                             GError       **error)
+{
+  if (!g_task_propagate_boolean (G_TASK (result), error))
+    return NULL;
+  return g_object_ref (g_task_get_source_object (G_TASK (result)));
+}
+
+GPid
+launcher_hang_get_pid (LauncherHang *hang)
+{
+  return LAUNCHER_HANG_GET_PRIVATE (hang)->pid;
+}
+
+const gchar*
+launcher_hang_get_reason (LauncherHang *hang)
+{
+  return LAUNCHER_HANG_GET_PRIVATE (hang)->reason;
+}
+
+guint
+launcher_hang_get_n_samples (LauncherHang *hang)
+{
+  return LAUNCHER_HANG_GET_PRIVATE (hang)->n_samples;
+}
+
+/*
+ * The distinct stacks, the most frequent first. A stack that several 
+ * threads share is counted once for every thread in every sample.
+ */
+guint
+launcher_hang_get_n_stacks (LauncherHang *hang)
+{
+  return LAUNCHER_HANG_GET_PRIVATE (hang)->stacks->len;
+}
+
+const LauncherHangStack*
+launcher_hang_get_stack (LauncherHang *hang,
+                         guint         index)
+{
+  return g_ptr_array_index (LAUNCHER_HANG_GET_PRIVATE (hang)->stacks, index);
+}
+
+/*
+ * The stacks as text, for where there is no view to show them in.
+ */
+gchar*
+launcher_hang_format (LauncherHang *hang)
+{
+  LauncherHangPrivate *priv;
+  GString *string;
+  guint i;
+  guint j;
+  
+  priv = LAUNCHER_HANG_GET_PRIVATE (hang);
+  string = g_string_new (NULL);
+  
+  for (i = 0; i < priv->stacks->len; i++)
+    {
+      LauncherHangStack *stack;
+      stack = g_ptr_array_index (priv->stacks, i);
+      
+      g_string_append_printf (string, "%u in %u samples:\n", stack->count, priv->n_samples);
+      for (j = 0; j < stack->frames->len; j++)
+        {
+          LauncherCrashFrame *frame;
+          frame = g_ptr_array_index (stack->frames, j);
+          g_string_append_printf (string, "  #%-3d %s", frame->level, frame->function);
+          if (frame->file_path != NULL)
+            g_string_append_printf (string, " at %s:%d", frame->file_path, frame->line);
+          g_string_append_c (string, '\n');
+        }
+    }
+  
+  return g_string_free (string, FALSE);
+}
+
+/*
+ * A sample that fails after the first one usually means the program exited 
+ * in the meantime, so the samples taken so far are kept.
+ */
+static void
+sample_thread (GTask        *task,
+               LauncherHang *hang,
+               gpointer      task_data,
+               GCancellable *cancellable)
+{
+  LauncherHangPrivate *priv;
+  GHashTable *stacks;
+  GError *error = NULL;
+  gint i;
+  
+  priv = LAUNCHER_HANG_GET_PRIVATE (hang);
+  
+  stacks = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  
+  for (i = 0; i < SAMPLES; i++)
+    {
+      gchar *backtrace;
+      GPtrArray *frames;
+      
+      if (i > 0)
+        g_usleep (SAMPLE_INTERVAL);
+      
+      backtrace = take_sample (hang, cancellable, &error);
+      if (backtrace == NULL)
+        break;
+      
+      frames = launcher_crash_parse_frames (backtrace);
+      if (frames->len > 0)
+        {
+          add_sample (hang, stacks, frames);
+          priv->n_samples++;
+        }
+      g_ptr_array_unref (frames);
+      g_free (backtrace);
+    }
+  
+  g_hash_table_destroy (stacks);
+  
+  if (priv->n_samples == 0 || g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+      if (error == NULL)
+        g_set_error (&error, G_IO_ERROR, G_IO_ERROR_FAILED, 
+                     "No stacks could be taken of process %d", priv->pid);
+      g_task_return_error (task, error);
+      return;
+    }
+  
+  if (error != NULL)
+    g_error_free (error);
+  
+  g_ptr_array_sort (priv->stacks, (GCompareFunc) compare_stacks);
+  g_task_return_boolean (task, TRUE);
+}
+
+static gchar*
+take_sample (LauncherHang  *hang,
+             GCancellable  *cancellable,
+             GError       **error)
+{
+  LauncherHangPrivate *priv;
+  GSubprocess *subprocess;
+  GError *spawn_error = NULL;
+  gchar *pid;
+  gchar *output = NULL;
+  
+  priv = LAUNCHER_HANG_GET_PRIVATE (hang);
+  pid = g_strdup_printf ("%d", priv->pid);
+  
+  subprocess = g_subprocess_new (G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, 
+                                 &spawn_error, "eu-stack", "-s", "-p", pid, NULL);
+  
+  if (subprocess == NULL && g_error_matches (spawn_error, G_SPAWN_ERROR, G_SPAWN_ERROR_NOENT))
+    {
+      g_clear_error (&spawn_error);
+      subprocess = g_subprocess_new (G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, 
+                                     &spawn_error, "gdb", "-batch", "-nx", "-p", pid,
+                                     "-ex", "set filename-display absolute",
+                                     "-ex", "thread apply all bt", NULL);
+    }
+  
+  g_free (pid);
+  
+  if (subprocess == NULL)
+    {
+      g_propagate_error (error, spawn_error);
+      return NULL;
+    }
+  
+  if (!g_subprocess_communicate_utf8 (subprocess, NULL, cancellable, &output, NULL, error))
+    {
+      g_object_unref (subprocess);
+      return NULL;
+    }
+  
+  g_object_unref (subprocess);
+  return output;
+}
+
+/*
+ * Stacks are told apart by their functions only, the addresses inside 
+ * a function move from one sample to the next.
+ */
+static void
+add_sample (LauncherHang *hang,
+            GHashTable   *stacks,
+            GPtrArray    *frames)
+{
+  LauncherHangPrivate *priv;
+  guint start = 0;
+  guint i;
+  
+  priv = LAUNCHER_HANG_GET_PRIVATE (hang);
+  
+  for (i = 1; i <= frames->len; i++)
+    {
+      LauncherHangStack *stack;
+      GString *key;
+      guint j;
+      
+      if (i < frames->len &&
+          ((LauncherCrashFrame *) g_ptr_array_index (frames, i))->thread == 
+          ((LauncherCrashFrame *) g_ptr_array_index (frames, start))->thread)
+        continue;
+      
+      key = g_string_new (NULL);
+      for (j = start; j < i; j++)
+        {
+          g_string_append (key, ((LauncherCrashFrame *) g_ptr_array_index (frames, j))->function);
+          g_string_append_c (key, '\n');
+        }
+      
+      stack = g_hash_table_lookup (stacks, key->str);
+      if (stack == NULL)
+        {
+          stack = g_new0 (LauncherHangStack, 1);
+          stack->frames = g_ptr_array_new_with_free_func ((GDestroyNotify) frame_free);
+          for (j = start; j < i; j++)
+            g_ptr_array_add (stack->frames, frame_copy (g_ptr_array_index (frames, j)));
+          g_ptr_array_add (priv->stacks, stack);
+          g_hash_table_insert (stacks, g_string_free (key, FALSE), stack);
+        }
+      else
+        {
+          g_string_free (key, TRUE);
+        }
+      
+      stack->count++;
+      start = i;
+    }
+}
+
+static gint
+compare_stacks (LauncherHangStack **stack1,
+                LauncherHangStack **stack2)
+{
+  if ((*stack1)->count != (*stack2)->count)
+    return (*stack1)->count > (*stack2)->count ? -1 : 1;
+  return 0;
+}
+
+static void
+stack_free (LauncherHangStack *stack)
+{
+  g_ptr_array_unref (stack->frames);
+  g_free (stack);
+}
+
+static LauncherCrashFrame*
+frame_copy (LauncherCrashFrame *frame)
+{
+  LauncherCrashFrame *copy;
+  copy = g_new (LauncherCrashFrame, 1);
+  copy->thread = frame->thread;
+  copy->level = frame->level;
+  copy->function = g_strdup (frame->function);
+  copy->file_path = g_strdup (frame->file_path);
+  copy->line = frame->line;
+  return copy;
+}
+
+static void
+frame_free (LauncherCrashFrame *frame)
+{
+  g_free (frame->function);
+  g_free (frame->file_path);
+  g_free (frame);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_HANG_H__
+#define	__LAUNCHER_HANG_H__
+
+#include <gio/gio.h>
+#include "launcher-crash.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_HANG_TYPE            (launcher_hang_get_type ())
+#define LAUNCHER_HANG(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_HANG_TYPE, LauncherHang))
+#define LAUNCHER_HANG_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_HANG_TYPE, LauncherHangClass))
+#define IS_LAUNCHER_HANG(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_HANG_TYPE))
+#define IS_LAUNCHER_HANG_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_HANG_TYPE))
+
+typedef struct _LauncherHang LauncherHang;
+typedef struct _LauncherHangClass LauncherHangClass;
+
+typedef struct
+{
+  guint      count;
+  GPtrArray *frames;
+} LauncherHangStack;
+
+struct _LauncherHang
+{
+  GObject parent_instance;
+};
+
+struct _LauncherHangClass
+{
+  GObjectClass parent_class;
+};
+
+GType launcher_hang_get_type (void) G_GNUC_CONST;
+
+void                     launcher_hang_sample_async   (GPid                  pid,
+                                                       const gchar          *reason,
+                                                       GCancellable         *cancellable,
+                                                       GAsyncReadyCallback   callback,
+                                                       gpointer              user_data);
+LauncherHang*            launcher_hang_sample_finish  (GAsyncResult         *result,
+                                                       GError              **error);
+
+GPid                     launcher_hang_get_pid        (LauncherHang         *hang);
+const gchar*             launcher_hang_get_reason     (LauncherHang         *hang);
+guint                    launcher_hang_get_n_samples  (LauncherHang         *hang);
+guint                    launcher_hang_get_n_stacks   (LauncherHang         *hang);
+const LauncherHangStack* launcher_hang_get_stack      (LauncherHang         *hang,
+                                                       guint                 index);
+gchar*                   launcher_hang_format         (LauncherHang         *hang);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_HANG_H__ */
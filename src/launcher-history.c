@@ -0,0 +1,625 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <glib/gstdio.h>
+#include "launcher-history.h"
+
+G_STATIC_ASSERT (LAUNCHER_COUNTER_LAST <= LAUNCHER_HISTORY_N_COUNTERS);
+G_STATIC_ASSERT (sizeof (LauncherHistoryRecord) == 160);
+
+/*
+ * The history is an append only file of fixed size records following a 
+ * small header. Fixed records mean the file can be mapped and walked 
+ * backwards without parsing, which keeps the regression check cheap even 
+ * with a very long history.
+ */
+
+#define MAGIC "LCHHIST"
+#define VERSION 2
+#define VERSION_1_RECORD_SIZE 64
+
+#define BASELINE_SIZE 30
+#define MIN_BASELINE 8
+#define RECENT_SIZE 5
+#define MIN_RECENT 3
+#define SIGNIFICANCE 0.01
+#define MIN_SLOWDOWN 1.05
+
+static void launcher_history_class_init  (LauncherHistoryClass *klass);
+static void launcher_history_init        (LauncherHistory      *history);
+static void launcher_history_finalize    (LauncherHistory      *history);
+
+typedef struct
+{
+  gchar   magic[8];
+  guint32 version;
+  guint32 record_size;
+} Header;
+
+typedef struct
+{
+  LauncherHistoryRecord *records;
+  guint                  n_records;
+  gchar                 *executable;
+} AppendData;
+
+static void append_thread                (GTask                 *task,
+                                          LauncherHistory       *history,
+                                          AppendData            *data,
+                                          GCancellable          *cancellable);
+static void append_data_free             (AppendData            *data);
+static void get_binary_identity          (LauncherHistory       *history,
+                                          const gchar           *executable,
+                                          gint64                *mtime,
+                                          guint64               *hash);
+static gboolean write_records            (LauncherHistory       *history,
+                                          const LauncherHistoryRecord *records,
+                                          guint                  n_records,
+                                          GError               **error);
+static gboolean upgrade_records          (LauncherHistory       *history,
+                                          GError               **error);
+static gboolean write_all                (gint                   fd,
+                                          gconstpointer          data,
+                                          gsize                  length);
+static void check_regression             (LauncherHistory       *history,
+                                          const LauncherHistoryRecord *record,
+                                          guint                  n_recent,
+                                          LauncherHistoryRegression *regression);
+static gdouble mann_whitney              (const gdouble         *recent,
+                                          guint                  n_recent,
+                                          const gdouble         *baseline,
+                                          guint                  n_baseline);
+static gdouble median                    (const gdouble         *values,
+                                          guint                  n_values);
+static gint compare_values               (const gdouble         *a,
+                                          const gdouble         *b);
+
+#define LAUNCHER_HISTORY_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_HISTORY_TYPE, LauncherHistoryPrivate))
+
+typedef struct _LauncherHistoryPrivate LauncherHistoryPrivate;
+
+struct _LauncherHistoryPrivate
+{
+  gchar   *file_path;
+  GMutex   mutex;
+  gchar   *binary_path;
+  gint64   binary_mtime;
+  gint64   binary_size;
+  guint64  binary_hash;
+};
+
+G_DEFINE_TYPE (LauncherHistory, launcher_history, G_TYPE_OBJECT)
+
+static void 
+launcher_history_class_init (LauncherHistoryClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_history_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherHistoryPrivate));
+}
+
+static void
+launcher_history_init (LauncherHistory *history)
+{
+  LauncherHistoryPrivate *priv;
+  priv = LAUNCHER_HISTORY_GET_PRIVATE (history);
+  priv->file_path = NULL;
+  priv->binary_path = NULL;
+  priv->binary_mtime = 0;
+  priv->binary_size = 0;
+  priv->binary_hash = 0;
+  g_mutex_init (&priv->mutex);
+}
+
+static void
+launcher_history_finalize (LauncherHistory *history)
+{
+  LauncherHistoryPrivate *priv;
+  priv = LAUNCHER_HISTORY_GET_PRIVATE (history);
+  g_free (priv->file_path);
+  g_free (priv->binary_path);
+  g_mutex_clear (&priv->mutex);
+  G_OBJECT_CLASS (launcher_history_parent_class)->finalize (G_OBJECT (history));
+}
+
+LauncherHistory*
+launcher_history_new (const gchar *file_path)
+{
+  LauncherHistoryPrivate *priv;
+  LauncherHistory *history;
+
+  history = LAUNCHER_HISTORY (g_object_new (launcher_history_get_type (), NULL));
+  priv = LAUNCHER_HISTORY_GET_PRIVATE (history);
+  priv->file_path = g_strdup (file_path);
+
+  return history;
+}
+
+guint32
+launcher_history_get_config_hash (const gchar *executable,
+                                  const gchar *parameters)
+{
+  guint32 hash;
+  hash = g_str_hash (executable != NULL ? executable : "");
+  return hash * 31 + g_str_hash (parameters != NULL ? parameters : "");
+}
+
+void
+launcher_history_set_counters (LauncherHistoryRecord       *record,
+                               const LauncherCounterValues *values)
+{
+  gint i;
+  
+  record->counters_mask = values->mask;
+  for (i = 0; i < LAUNCHER_COUNTER_LAST; i++)
+    record->counters[i] = values->values[i];
+}
+
+void
+launcher_history_append_async (LauncherHistory             *history,
+                               const LauncherHistoryRecord *records,
+                               guint                        n_records,
+                               const gchar                 *executable,
+                               GCancellable                *cancellable,
+                               GAsyncReadyCallback          callback,
+                               gpointer                     user_data)
+{
+  AppendData *data;
+  GTask *task;
+  
+  data = g_new0 (AppendData, 1);
+  data->records = g_memdup (records, n_records * sizeof (LauncherHistoryRecord));
+  data->n_records = n_records;
+  data->executable = g_strdup (executable);
+
+  task = g_task_new (history, cancellable, callback, user_data);
+  g_task_set_task_data (task, data, (GDestroyNotify) append_data_free);
+  g_task_run_in_thread (task, (GTaskThreadFunc) append_thread);
+  g_object_unref (task);
+}
+
+gboolean
+launcher_history_append_finish (LauncherHistory            *history,
+                                GAsyncResult               *result,
+                                LauncherHistoryRegression  *regression,
+                                GError                    **error)
+{
+  LauncherHistoryRegression *value;
+  
+  value = g_task_propagate_pointer (G_TASK (result), error);
+  if (value == NULL)
+    return FALSE;
+  
+  if (regression != NULL)
+    *regression = *value;
+
+  g_free (value);
+  return TRUE;
+}
+
+static void
+append_data_free (AppendData *data)
+{
+  g_free (data->records);
+  g_free (data->executable);
+  g_free (data);
+}
+
+static void
+append_thread (GTask           *task,
+               LauncherHistory *history,
+               AppendData      *data,
+               GCancellable    *cancellable)
+{
+  LauncherHistoryPrivate *priv;
+  LauncherHistoryRegression *regression;
+  LauncherHistoryRecord *last;
+  GError *error = NULL;
+  gint64 mtime;
+  guint64 hash;
+  guint i;
+
+  priv = LAUNCHER_HISTORY_GET_PRIVATE (history);
+  
+  g_mutex_lock (&priv->mutex);
+
+  get_binary_identity (history, data->executable, &mtime, &hash);
+  for (i = 0; i < data->n_records; i++)
+    {
+      data->records[i].binary_mtime = mtime;
+      data->records[i].binary_hash = hash;
+    }
+
+  if (!write_records (history, data->records, data->n_records, &error))
+    {
+      g_mutex_unlock (&priv->mutex);
+      g_task_return_error (task, error);
+      return;
+    }
+
+  regression = g_new0 (LauncherHistoryRegression, 1);
+  last = &data->records[data->n_records - 1];
+  if (last->exit_status == 0)
+    check_regression (history, last, MAX (data->n_records, RECENT_SIZE), regression);
+
+  g_mutex_unlock (&priv->mutex);
+  
+  g_task_return_pointer (task, regression, g_free);
+}
+
+/*
+ * Hashing a large binary is not free, so the hash is only recomputed when 
+ * the executable was rebuilt since the last run.
+ */
+static void
+get_binary_identity (LauncherHistory *history,
+                     const gchar     *executable,
+                     gint64          *mtime,
+                     guint64         *hash)
+{
+  LauncherHistoryPrivate *priv;
+  GMappedFile *mapped_file;
+  GStatBuf buf;
+  gchar *path;
+  
+  priv = LAUNCHER_HISTORY_GET_PRIVATE (history);
+  
+  *mtime = 0;
+  *hash = 0;
+
+  path = g_find_program_in_path (executable);
+  if (path == NULL || g_stat (path, &buf) != 0)
+    {
+      g_free (path);
+      return;
+    }
+  
+  *mtime = buf.st_mtime;
+  
+  if (g_strcmp0 (path, priv->binary_path) == 0 && 
+      priv->binary_mtime == buf.st_mtime && priv->binary_size == buf.st_size)
+    {
+      *hash = priv->binary_hash;
+      g_free (path);
+      return;
+    }
+  
+  mapped_file = g_mapped_file_new (path, FALSE, NULL);
+  if (mapped_file != NULL)
+    {
+      const guchar *contents;
+      gsize length;
+      gsize i;
+
+      contents = (const guchar *) g_mapped_file_get_contents (mapped_file);
+      length = g_mapped_file_get_length (mapped_file);
+      
+      *hash = G_GUINT64_CONSTANT (14695981039346656037);
+      for (i = 0; i < length; i++)
+        {
+          *hash ^= contents[i];
+          *hash *= G_GUINT64_CONSTANT (1099511628211);
+        }
+      
+      g_mapped_file_unref (mapped_file);
+    }
+
+  g_free (priv->binary_path);
+  priv->binary_path = path;
+  priv->binary_mtime = buf.st_mtime;
+  priv->binary_size = buf.st_size;
+  priv->binary_hash = *hash;
+}
+
+static gboolean
+write_records (LauncherHistory              *history,
+               const LauncherHistoryRecord  *records,
+               guint                         n_records,
+               GError                      **error)
+{
+  LauncherHistoryPrivate *priv;
+  struct stat buf;
+  Header header;
+  gint fd;
+  
+  priv = LAUNCHER_HISTORY_GET_PRIVATE (history);
+  
+  fd = g_open (priv->file_path, O_RDWR | O_APPEND | O_CREAT, 0644);
+  if (fd < 0 || fstat (fd, &buf) != 0)
+    goto error;
+  
+  if (buf.st_size >= (off_t) sizeof (Header) &&
+      pread (fd, &header, sizeof (Header), 0) == sizeof (Header) &&
+      memcmp (header.magic, MAGIC, sizeof (header.magic)) == 0 &&
+      header.version == 1 && header.record_size == VERSION_1_RECORD_SIZE)
+    {
+      close (fd);
+      fd = -1;
+      if (!upgrade_records (history, error))
+        return FALSE;
+      
+      fd = g_open (priv->file_path, O_RDWR | O_APPEND | O_CREAT, 0644);
+      if (fd < 0 || fstat (fd, &buf) != 0)
+        goto error;
+    }
+
+  if (buf.st_size >= (off_t) sizeof (Header) &&
+      (pread (fd, &header, sizeof (Header), 0) != sizeof (Header) ||
+       memcmp (header.magic, MAGIC, sizeof (header.magic)) != 0 ||
+       header.version != VERSION || 
+       header.record_size != sizeof (LauncherHistoryRecord)))
+    {
+      /* an older or foreign file, start over and keep it around */
+      gchar *old_path;
+      old_path = g_strconcat (priv->file_path, ".old", NULL);
+      g_rename (priv->file_path, old_path);
+      g_free (old_path);
+      close (fd);
+      
+      fd = g_open (priv->file_path, O_RDWR | O_APPEND | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0 || fstat (fd, &buf) != 0)
+        goto error;
+    }
+
+  if (buf.st_size < (off_t) sizeof (Header))
+    {
+      memset (&header, 0, sizeof (Header));
+      memcpy (header.magic, MAGIC, sizeof (header.magic));
+      header.version = VERSION;
+      header.record_size = sizeof (LauncherHistoryRecord);
+      if (ftruncate (fd, 0) != 0 || !write_all (fd, &header, sizeof (Header)))
+        goto error;
+    }
+  else if ((buf.st_size - sizeof (Header)) % sizeof (LauncherHistoryRecord) != 0)
+    {
+      /* drop a record torn by an earlier crash */
+      off_t size;
+      size = buf.st_size - (buf.st_size - sizeof (Header)) % sizeof (LauncherHistoryRecord);
+      if (ftruncate (fd, size) != 0)
+        goto error;
+    }
+
+  if (!write_all (fd, records, n_records * sizeof (LauncherHistoryRecord)))
+    goto error;
+
+  close (fd);
+  return TRUE;
+
+error:
+  g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+               "Not able to write %s: %s", priv->file_path, g_strerror (errno));
+  if (fd >= 0)
+    close (fd);
+  return FALSE;
+}
+
+/*
+ * The first version had the same record without the counters, so the old 
+ * records are kept with an empty counters_mask.
+ */
+static gboolean
+upgrade_records (LauncherHistory  *history,
+                 GError          **error)
+{
+  LauncherHistoryPrivate *priv;
+  LauncherHistoryRecord *records;
+  Header header;
+  GByteArray *array;
+  gchar *contents;
+  gsize length;
+  gsize n_records;
+  gsize i;
+  gboolean result;
+  
+  priv = LAUNCHER_HISTORY_GET_PRIVATE (history);
+  
+  if (!g_file_get_contents (priv->file_path, &contents, &length, error))
+    return FALSE;
+  
+  n_records = (length - sizeof (Header)) / VERSION_1_RECORD_SIZE;
+  records = g_new0 (LauncherHistoryRecord, n_records);
+  for (i = 0; i < n_records; i++)
+    memcpy (&records[i], contents + sizeof (Header) + i * VERSION_1_RECORD_SIZE, 
+            VERSION_1_RECORD_SIZE);
+  
+  memset (&header, 0, sizeof (Header));
+  memcpy (header.magic, MAGIC, sizeof (header.magic));
+  header.version = VERSION;
+  header.record_size = sizeof (LauncherHistoryRecord);
+  
+  array = g_byte_array_sized_new (sizeof (Header) + n_records * sizeof (LauncherHistoryRecord));
+  g_byte_array_append (array, (const guint8 *) &header, sizeof (Header));
+  g_byte_array_append (array, (const guint8 *) records, n_records * sizeof (LauncherHistoryRecord));
+  
+  result = g_file_set_contents (priv->file_path, (const gchar *) array->data, array->len, error);
+  
+  g_byte_array_unref (array);
+  g_free (records);
+  g_free (contents);
+  return result;
+}
+
+static gboolean
+write_all (gint          fd,
+           gconstpointer data,
+           gsize         length)
+{
+  const gchar *bytes = data;
+  
+  while (length > 0)
+    {
+      gssize written;
+      written = write (fd, bytes, length);
+      if (written < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          return FALSE;
+        }
+      bytes += written;
+      length -= written;
+    }
+  
+  return TRUE;
+}
+
+/*
+ * A single slow run proves nothing, so the most recent successful runs of 
+ * the same config are compared against the runs before them with a one 
+ * sided Mann-Whitney U test, which makes no assumption about the shape of 
+ * the timing distribution.
+ */
+static void
+check_regression (LauncherHistory             *history,
+                  const LauncherHistoryRecord *record,
+                  guint                        n_recent,
+                  LauncherHistoryRegression   *regression)
+{
+  LauncherHistoryPrivate *priv;
+  const LauncherHistoryRecord *records;
+  GMappedFile *mapped_file;
+  const gchar *contents;
+  gdouble *values;
+  gsize length;
+  guint n_records;
+  guint n_values = 0;
+  guint n_baseline;
+  guint capacity;
+  gint i;
+  
+  priv = LAUNCHER_HISTORY_GET_PRIVATE (history);
+  
+  mapped_file = g_mapped_file_new (priv->file_path, FALSE, NULL);
+  if (mapped_file == NULL)
+    return;
+  
+  contents = g_mapped_file_get_contents (mapped_file);
+  length = g_mapped_file_get_length (mapped_file);
+  
+  if (length < sizeof (Header))
+    {
+      g_mapped_file_unref (mapped_file);
+      return;
+    }
+
+  records = (const LauncherHistoryRecord *) (contents + sizeof (Header));
+  n_records = (length - sizeof (Header)) / sizeof (LauncherHistoryRecord);
+  
+  capacity = n_recent + BASELINE_SIZE;
+  values = g_new (gdouble, capacity);
+  
+  for (i = (gint) n_records - 1; i >= 0 && n_values < capacity; i--)
+    {
+      if (records[i].config_hash != record->config_hash ||
+          records[i].exit_status != 0 ||
+          (records[i].flags & LAUNCHER_HISTORY_BENCHMARK) != 
+          (record->flags & LAUNCHER_HISTORY_BENCHMARK))
+        continue;
+      
+      values[n_values++] = records[i].wall_time;
+    }
+
+  g_mapped_file_unref (mapped_file);
+  
+  n_recent = MIN (n_recent, n_values);
+  n_baseline = n_values - n_recent;
+  
+  if (n_recent >= MIN_RECENT && n_baseline >= MIN_BASELINE)
+    {
+      gdouble baseline_median;
+      
+      baseline_median = median (values + n_recent, n_baseline);
+      if (baseline_median > 0)
+        regression->slowdown = median (values, n_recent) / baseline_median;
+      
+      regression->p_value = mann_whitney (values, n_recent, values + n_recent, n_baseline);
+      regression->detected = regression->p_value < SIGNIFICANCE && 
+                             regression->slowdown >= MIN_SLOWDOWN;
+    }
+  
+  g_free (values);
+}
+
+static gdouble
+mann_whitney (const gdouble *recent,
+              guint          n_recent,
+              const gdouble *baseline,
+              guint          n_baseline)
+{
+  gdouble u = 0;
+  gdouble mean;
+  gdouble sd;
+  gdouble z;
+  guint i;
+  guint j;
+  
+  for (i = 0; i < n_recent; i++)
+    {
+      for (j = 0; j < n_baseline; j++)
+        {
+          if (recent[i] > baseline[j])
+            u += 1;
+          else if (recent[i] == baseline[j])
+            u += 0.5;
+        }
+    }
+  
+  mean = n_recent * n_baseline / 2.0;
+  sd = sqrt (n_recent * n_baseline * (n_recent + n_baseline + 1) / 12.0);
+  z = (u - mean - 0.5) / sd;
+  
+  return 0.5 * erfc (z / G_SQRT2);
+}
+
+static gdouble
+median (const gdouble *values,
+        guint          n_values)
+{
+  gdouble *sorted;
+  gdouble result;
+  
+  sorted = g_memdup (values, n_values * sizeof (gdouble));
+  qsort (sorted, n_values, sizeof (gdouble), (GCompareFunc) compare_values);
+  
+  if (n_values % 2)
+    result = sorted[n_values / 2];
+  else
+    result = (sorted[n_values / 2 - 1] + sorted[n_values / 2]) / 2;
+  
+  g_free (sorted);
+  return result;
+}
+
+static gint
+compare_values (const gdouble *a,
+                const gdouble *b)
+{
+  if (*a < *b)
+    return -1;
+  if (*a > *b)
+    return 1;
+  return 0;
+}
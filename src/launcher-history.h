@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_HISTORY_H__
+#define	__LAUNCHER_HISTORY_H__
+
+#include <gio/gio.h>
+#include "launcher-counters.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_HISTORY_TYPE            (launcher_history_get_type ())
+#define LAUNCHER_HISTORY(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_HISTORY_TYPE, LauncherHistory))
+#define LAUNCHER_HISTORY_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_HISTORY_TYPE, LauncherHistoryClass))
+#define IS_LAUNCHER_HISTORY(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_HISTORY_TYPE))
+#define IS_LAUNCHER_HISTORY_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_HISTORY_TYPE))
+
+#define LAUNCHER_HISTORY_BENCHMARK (1 << 0)
+#define LAUNCHER_HISTORY_N_COUNTERS 12
+
+typedef struct _LauncherHistory LauncherHistory;
+typedef struct _LauncherHistoryClass LauncherHistoryClass;
+
+/* 
+ * Records are written to disk as is, so the layout has to stay fixed: 
+ * times are in microseconds, max_rss in kilobytes and exit_status is the 
+ * exit code or the negated signal number. The counters are indexed by 
+ * LauncherCounter and counters_mask tells which of them were collected.
+ */
+typedef struct
+{
+  gint64  timestamp;
+  gint64  wall_time;
+  gint64  cpu_time;
+  gint64  max_rss;
+  gint64  binary_mtime;
+  guint64 binary_hash;
+  guint32 config_hash;
+  gint32  exit_status;
+  guint32 flags;
+  guint32 counters_mask;
+  guint64 counters[LAUNCHER_HISTORY_N_COUNTERS];
+} LauncherHistoryRecord;
+
+typedef struct
+{
+  gboolean detected;
+  gdouble  slowdown;
+  gdouble  p_value;
+} LauncherHistoryRegression;
+
+struct _LauncherHistory
+{
+  GObject parent_instance;
+};
+
+struct _LauncherHistoryClass
+{
+  GObjectClass parent_class;
+};
+
+GType launcher_history_get_type (void) G_GNUC_CONST;
+
+LauncherHistory*  launcher_history_new              (const gchar                *file_path);
+
+guint32           launcher_history_get_config_hash  (const gchar                *executable,
+                                                     const gchar                *parameters);
+void              launcher_history_set_counters     (LauncherHistoryRecord      *record,
+                                                     const LauncherCounterValues *values);
+
+void              launcher_history_append_async     (LauncherHistory            *history,
+                                                     const LauncherHistoryRecord *records,
+                                                     guint                       n_records,
+                                                     const gchar                *executable,
+                                                     GCancellable               *cancellable,
+                                                     GAsyncReadyCallback         callback,
+                                                     gpointer                    user_data);
+gboolean          launcher_history_append_finish    (LauncherHistory            *history,
+                                                     GAsyncResult               *result,
+                                                     LauncherHistoryRegression  *regression,
+                                                     GError                    **error);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_HISTORY_H__ */
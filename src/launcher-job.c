@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "launcher-job.h"
+
+/*
+ * One launch waiting in, or started from, the queue of the scheduler. The 
+ * job only knows how to start itself, the scheduler decides when, and the 
+ * engine tells the scheduler when whatever the job started is done.
+ */
+
+static void launcher_job_class_init  (LauncherJobClass *klass);
+static void launcher_job_init        (LauncherJob      *job);
+static void launcher_job_finalize    (LauncherJob      *job);
+
+#define LAUNCHER_JOB_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_JOB_TYPE, LauncherJobPrivate))
+
+typedef struct _LauncherJobPrivate LauncherJobPrivate;
+
+struct _LauncherJobPrivate
+{
+  guint             id;
+  LauncherConfig   *config;
+  LauncherJobKind   kind;
+  LauncherJobState  state;
+  gint              priority;
+  gint64            queued_time;
+  gint64            start_time;
+  GCancellable     *cancellable;
+  LauncherJobFunc   func;
+  gpointer          data;
+};
+
+G_DEFINE_TYPE (LauncherJob, launcher_job, G_TYPE_OBJECT)
+
+static void
+launcher_job_class_init (LauncherJobClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_job_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherJobPrivate));
+}
+
+static void
+launcher_job_init (LauncherJob *job)
+{
+  LauncherJobPrivate *priv;
+  priv = LAUNCHER_JOB_GET_PRIVATE (job);
+  priv->id = 0;
+  priv->config = NULL;
+  priv->kind = LAUNCHER_JOB_RUN;
+  priv->state = LAUNCHER_JOB_QUEUED;
+  priv->priority = 0;
+  priv->queued_time = g_get_real_time ();
+  priv->start_time = 0;
+  priv->cancellable = g_cancellable_new ();
+  priv->func = NULL;
+  priv->data = NULL;
+}
+
+static void
+launcher_job_finalize (LauncherJob *job)
+{
+  LauncherJobPrivate *priv;
+  priv = LAUNCHER_JOB_GET_PRIVATE (job);
+  if (priv->config != NULL)
+    g_object_unref (priv->config);
+  g_object_unref (priv->cancellable);
+  G_OBJECT_CLASS (launcher_job_parent_class)->finalize (G_OBJECT (job));
+}
+
+LauncherJob*
+launcher_job_new (guint            id,
+                  LauncherConfig  *config,
+                  LauncherJobKind  kind,
+                  LauncherJobFunc  func,
+                  gpointer         data)
+{
+  LauncherJobPrivate *priv;
+  LauncherJob *job;
+
+  job = LAUNCHER_JOB (g_object_new (launcher_job_get_type (), NULL));
+  priv = LAUNCHER_JOB_GET_PRIVATE (job);
+  
+  priv->id = id;
+  priv->config = g_object_ref (config);
+  priv->kind = kind;
+  priv->func = func;
+  priv->data = data;
+
+  return job;
+}
+
+/*
+ * Returns FALSE when nothing was started, the job is then done at once.
+ */
+gboolean
+launcher_job_start (LauncherJob *job)
+{
+  LauncherJobPrivate *priv;
+  priv = LAUNCHER_JOB_GET_PRIVATE (job);
+  priv->state = LAUNCHER_JOB_RUNNING;
+  priv->start_time = g_get_real_time ();
+  return priv->func (job, priv->data);
+}
+
+guint
+launcher_job_get_id (LauncherJob *job)
+{
+  return LAUNCHER_JOB_GET_PRIVATE (job)->id;
+}
+
+LauncherConfig*
+launcher_job_get_config (LauncherJob *job)
+{
+  return LAUNCHER_JOB_GET_PRIVATE (job)->config;
+}
+
+LauncherJobKind
+launcher_job_get_kind (LauncherJob *job)
+{
+  return LAUNCHER_JOB_GET_PRIVATE (job)->kind;
+}
+
+/*
+ * Measurements run alone, anything else on the machine would be part of 
+ * what they measure.
+ */
+gboolean
+launcher_job_is_exclusive (LauncherJob *job)
+{
+  return LAUNCHER_JOB_GET_PRIVATE (job)->kind != LAUNCHER_JOB_RUN;
+}
+
+/*
+ * The config of a project is replaced when its file is reloaded, so jobs 
+ * are compared by project and profile name instead of by config.
+ */
+gboolean
+launcher_job_same_profile (LauncherJob *job1,
+                           LauncherJob *job2)
+{
+  LauncherConfig *config1;
+  LauncherConfig *config2;
+  
+  config1 = LAUNCHER_JOB_GET_PRIVATE (job1)->config;
+  config2 = LAUNCHER_JOB_GET_PRIVATE (job2)->config;
+  
+  return launcher_config_get_project (config1) == launcher_config_get_project (config2) &&
+         g_strcmp0 (launcher_config_get_name (config1), launcher_config_get_name (config2)) == 0;
+}
+
+LauncherJobState
+launcher_job_get_state (LauncherJob *job)
+{
+  return LAUNCHER_JOB_GET_PRIVATE (job)->state;
+}
+
+void
+launcher_job_set_state (LauncherJob      *job,
+                        LauncherJobState  state)
+{
+  LauncherJobPrivate *priv;
+  priv = LAUNCHER_JOB_GET_PRIVATE (job);
+  priv->state = state;
+}
+
+gint
+launcher_job_get_priority (LauncherJob *job)
+{
+  return LAUNCHER_JOB_GET_PRIVATE (job)->priority;
+}
+
+void
+launcher_job_set_priority (LauncherJob *job,
+                           gint         priority)
+{
+  LauncherJobPrivate *priv;
+  priv = LAUNCHER_JOB_GET_PRIVATE (job);
+  priv->priority = priority;
+}
+
+gint64
+launcher_job_get_queued_time (LauncherJob *job)
+{
+  return LAUNCHER_JOB_GET_PRIVATE (job)->queued_time;
+}
+
+gint64
+launcher_job_get_start_time (LauncherJob *job)
+{
+  return LAUNCHER_JOB_GET_PRIVATE (job)->start_time;
+}
+
+/*
+ * Cancelled when the job is cancelled while it runs, or when the scheduler 
+ * goes away. Whatever the job started has to stop when it is.
+ */
+GCancellable*
+launcher_job_get_cancellable (LauncherJob *job)
+{
+  return LAUNCHER_JOB_GET_PRIVATE (job)->cancellable;
+}
+
+const gchar*
+launcher_job_kind_to_string (LauncherJobKind kind)
+{
+  switch (kind)
+    {
+    case LAUNCHER_JOB_RUN:
+      return "Run";
+    case LAUNCHER_JOB_SWEEP:
+      return "Sweep";
+    case LAUNCHER_JOB_BENCHMARK:
+      return "Benchmark";
+    case LAUNCHER_JOB_STARTUP:
+      return "Startup Benchmark";
+    }
+  return NULL;
+}
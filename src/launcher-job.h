@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_JOB_H__
+#define	__LAUNCHER_JOB_H__
+
+#include <gio/gio.h>
+#include "launcher-config.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_JOB_TYPE            (launcher_job_get_type ())
+#define LAUNCHER_JOB(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_JOB_TYPE, LauncherJob))
+#define LAUNCHER_JOB_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_JOB_TYPE, LauncherJobClass))
+#define IS_LAUNCHER_JOB(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_JOB_TYPE))
+#define IS_LAUNCHER_JOB_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_JOB_TYPE))
+
+typedef struct _LauncherJob LauncherJob;
+typedef struct _LauncherJobClass LauncherJobClass;
+
+typedef enum
+{
+  LAUNCHER_JOB_RUN,
+  LAUNCHER_JOB_SWEEP,
+  LAUNCHER_JOB_BENCHMARK,
+  LAUNCHER_JOB_STARTUP
+} LauncherJobKind;
+
+typedef enum
+{
+  LAUNCHER_JOB_QUEUED,
+  LAUNCHER_JOB_RUNNING,
+  LAUNCHER_JOB_FINISHED
+} LauncherJobState;
+
+typedef gboolean (*LauncherJobFunc) (LauncherJob *job, 
+                                     gpointer     data);
+
+struct _LauncherJob
+{
+  GObject parent_instance;
+};
+
+struct _LauncherJobClass
+{
+  GObjectClass parent_class;
+};
+
+GType launcher_job_get_type (void) G_GNUC_CONST;
+
+LauncherJob*      launcher_job_new              (guint            id,
+                                                 LauncherConfig  *config,
+                                                 LauncherJobKind  kind,
+                                                 LauncherJobFunc  func,
+                                                 gpointer         data);
+
+gboolean          launcher_job_start            (LauncherJob     *job);
+
+guint             launcher_job_get_id           (LauncherJob     *job);
+LauncherConfig*   launcher_job_get_config       (LauncherJob     *job);
+LauncherJobKind   launcher_job_get_kind         (LauncherJob     *job);
+gboolean          launcher_job_is_exclusive     (LauncherJob     *job);
+gboolean          launcher_job_same_profile     (LauncherJob     *job1,
+                                                 LauncherJob     *job2);
+LauncherJobState  launcher_job_get_state        (LauncherJob     *job);
+void              launcher_job_set_state        (LauncherJob     *job,
+                                                 LauncherJobState state);
+gint              launcher_job_get_priority     (LauncherJob     *job);
+void              launcher_job_set_priority     (LauncherJob     *job,
+                                                 gint             priority);
+gint64            launcher_job_get_queued_time  (LauncherJob     *job);
+gint64            launcher_job_get_start_time   (LauncherJob     *job);
+GCancellable*     launcher_job_get_cancellable  (LauncherJob     *job);
+
+const gchar*      launcher_job_kind_to_string   (LauncherJobKind  kind);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_JOB_H__ */
@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "launcher-jobs-view.h"
+
+static void launcher_jobs_view_class_init  (LauncherJobsViewClass *klass);
+static void launcher_jobs_view_init        (LauncherJobsView      *jobs_view);
+static void launcher_jobs_view_finalize    (LauncherJobsView      *jobs_view);
+
+static void add_column                     (LauncherJobsView      *jobs_view,
+                                            const gchar           *title,
+                                            gint                   column);
+static GtkWidget* add_button               (LauncherJobsView      *jobs_view,
+                                            GtkWidget             *hbox,
+                                            const gchar           *label,
+                                            GCallback              callback);
+static void changed_action                 (LauncherJobsView      *jobs_view);
+static void selection_changed_action       (LauncherJobsView      *jobs_view);
+static void cancel_action                  (LauncherJobsView      *jobs_view);
+static void raise_action                   (LauncherJobsView      *jobs_view);
+static void lower_action                   (LauncherJobsView      *jobs_view);
+static void max_jobs_action                (LauncherJobsView      *jobs_view);
+static LauncherJob* get_selected_job       (LauncherJobsView      *jobs_view);
+static gchar* format_time                  (gint64                 time);
+
+#define LAUNCHER_JOBS_VIEW_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_JOBS_VIEW_TYPE, LauncherJobsViewPrivate))
+
+typedef struct _LauncherJobsViewPrivate LauncherJobsViewPrivate;
+
+struct _LauncherJobsViewPrivate
+{
+  LauncherScheduler *scheduler;
+  GtkWidget         *status_label;
+  GtkWidget         *cancel_button;
+  GtkWidget         *raise_button;
+  GtkWidget         *lower_button;
+  GtkWidget         *max_jobs_spin_button;
+  GtkWidget         *tree;
+  GtkListStore      *store;
+};
+
+enum
+{
+  ID = 0,
+  STATE,
+  KIND,
+  PROFILE,
+  PRIORITY,
+  QUEUED,
+  STARTED,
+  COLUMNS
+};
+
+G_DEFINE_TYPE (LauncherJobsView, launcher_jobs_view, GTK_TYPE_BOX)
+
+static void
+launcher_jobs_view_class_init (LauncherJobsViewClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_jobs_view_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherJobsViewPrivate));
+}
+
+static void
+launcher_jobs_view_init (LauncherJobsView *jobs_view)
+{
+  LauncherJobsViewPrivate *priv;
+  GtkTreeSelection *selection;
+  GtkWidget *hbox;
+  GtkWidget *max_jobs_label;
+  GtkWidget *scrolled_window;
+
+  priv = LAUNCHER_JOBS_VIEW_GET_PRIVATE (jobs_view);
+  priv->scheduler = NULL;
+
+  gtk_orientable_set_orientation (GTK_ORIENTABLE (jobs_view), GTK_ORIENTATION_VERTICAL);
+  
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
+  gtk_box_pack_start (GTK_BOX (jobs_view), hbox, FALSE, FALSE, 0);
+  
+  priv->status_label = gtk_label_new (NULL);
+  gtk_misc_set_alignment (GTK_MISC (priv->status_label), 0, .5);
+  gtk_misc_set_padding (GTK_MISC (priv->status_label), 4, 2);
+  gtk_box_pack_start (GTK_BOX (hbox), priv->status_label, TRUE, TRUE, 0);
+  
+  priv->cancel_button = add_button (jobs_view, hbox, "Cancel", G_CALLBACK (cancel_action));
+  priv->raise_button = add_button (jobs_view, hbox, "Raise", G_CALLBACK (raise_action));
+  priv->lower_button = add_button (jobs_view, hbox, "Lower", G_CALLBACK (lower_action));
+  
+  max_jobs_label = gtk_label_new ("Max Jobs:");
+  gtk_misc_set_padding (GTK_MISC (max_jobs_label), 4, 0);
+  gtk_box_pack_start (GTK_BOX (hbox), max_jobs_label, FALSE, FALSE, 0);
+  
+  priv->max_jobs_spin_button = gtk_spin_button_new_with_range (1, 1024, 1);
+  gtk_box_pack_start (GTK_BOX (hbox), priv->max_jobs_spin_button, FALSE, FALSE, 0);
+  g_signal_connect_swapped (G_OBJECT (priv->max_jobs_spin_button), "value-changed",
+                            G_CALLBACK (max_jobs_action), jobs_view);
+  
+  priv->store = gtk_list_store_new (COLUMNS, G_TYPE_UINT, G_TYPE_STRING, G_TYPE_STRING, 
+                                    G_TYPE_STRING, G_TYPE_INT, G_TYPE_STRING, G_TYPE_STRING);
+  priv->tree = gtk_tree_view_new_with_model (GTK_TREE_MODEL (priv->store));
+  
+  add_column (jobs_view, "Job", ID);
+  add_column (jobs_view, "State", STATE);
+  add_column (jobs_view, "Kind", KIND);
+  add_column (jobs_view, "Profile", PROFILE);
+  add_column (jobs_view, "Priority", PRIORITY);
+  add_column (jobs_view, "Queued", QUEUED);
+  add_column (jobs_view, "Started", STARTED);
+  
+  selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (priv->tree));
+  g_signal_connect_swapped (G_OBJECT (selection), "changed",
+                            G_CALLBACK (selection_changed_action), jobs_view);
+
+  scrolled_window = gtk_scrolled_window_new (NULL, NULL);
+  gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolled_window),
+                                  GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_container_add (GTK_CONTAINER (scrolled_window), priv->tree);
+  gtk_box_pack_start (GTK_BOX (jobs_view), scrolled_window, TRUE, TRUE, 0);
+  
+  selection_changed_action (jobs_view);
+}
+
+static void
+launcher_jobs_view_finalize (LauncherJobsView *jobs_view)
+{
+  LauncherJobsViewPrivate *priv;
+  priv = LAUNCHER_JOBS_VIEW_GET_PRIVATE (jobs_view);
+  if (priv->scheduler != NULL)
+    g_object_remove_weak_pointer (G_OBJECT (priv->scheduler), (gpointer *) &priv->scheduler);
+  g_object_unref (priv->store);
+  G_OBJECT_CLASS (launcher_jobs_view_parent_class)->finalize (G_OBJECT (jobs_view));
+}
+
+GtkWidget*
+launcher_jobs_view_new (void)
+{
+  return g_object_new (launcher_jobs_view_get_type (), NULL);
+}
+
+static void
+add_column (LauncherJobsView *jobs_view,
+            const gchar      *title,
+            gint              column)
+{
+  LauncherJobsViewPrivate *priv;
+  GtkCellRenderer *renderer;
+  GtkTreeViewColumn *tree_column;
+  
+  priv = LAUNCHER_JOBS_VIEW_GET_PRIVATE (jobs_view);
+  
+  renderer = gtk_cell_renderer_text_new ();
+  tree_column = gtk_tree_view_column_new ();
+  gtk_tree_view_column_set_title (tree_column, title);
+  gtk_tree_view_column_pack_start (tree_column, renderer, TRUE);
+  gtk_tree_view_column_add_attribute (tree_column, renderer, "text", column);
+  if (column == ID || column == PRIORITY)
+    g_object_set (renderer, "xalign", 1.0, NULL);
+  gtk_tree_view_column_set_expand (tree_column, column == PROFILE);
+  gtk_tree_view_append_column (GTK_TREE_VIEW (priv->tree), tree_column);
+}
+
+static GtkWidget*
+add_button (LauncherJobsView *jobs_view,
+            GtkWidget        *hbox,
+            const gchar      *label,
+            GCallback         callback)
+{
+  GtkWidget *button;
+  button = gtk_button_new_with_label (label);
+  gtk_button_set_relief (GTK_BUTTON (button), GTK_RELIEF_NONE);
+  gtk_box_pack_start (GTK_BOX (hbox), button, FALSE, FALSE, 0);
+  g_signal_connect_swapped (G_OBJECT (button), "clicked", callback, jobs_view);
+  return button;
+}
+
+/*
+ * The scheduler belongs to the engine, the view only watches it and can 
+ * outlive it.
+ */
+void
+launcher_jobs_view_set_scheduler (LauncherJobsView  *jobs_view,
+                                  LauncherScheduler *scheduler)
+{
+  LauncherJobsViewPrivate *priv;
+  priv = LAUNCHER_JOBS_VIEW_GET_PRIVATE (jobs_view);
+  
+  priv->scheduler = scheduler;
+  g_object_add_weak_pointer (G_OBJECT (scheduler), (gpointer *) &priv->scheduler);
+  g_signal_connect_object (G_OBJECT (scheduler), "changed",
+                           G_CALLBACK (changed_action), jobs_view, G_CONNECT_SWAPPED);
+  
+  gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->max_jobs_spin_button), 
+                             launcher_scheduler_get_max_jobs (scheduler));
+  changed_action (jobs_view);
+}
+
+/*
+ * The rows are rebuilt on every change, the queue is short. The selection 
+ * is kept by job id.
+ */
+static void
+changed_action (LauncherJobsView *jobs_view)
+{
+  LauncherJobsViewPrivate *priv;
+  LauncherJob *selected_job;
+  GtkTreeSelection *selection;
+  GList *jobs;
+  GList *list;
+  guint n_running = 0;
+  guint n_queued = 0;
+  gchar *text;
+  
+  priv = LAUNCHER_JOBS_VIEW_GET_PRIVATE (jobs_view);
+  
+  selected_job = get_selected_job (jobs_view);
+  selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (priv->tree));
+  
+  gtk_list_store_clear (priv->store);
+  
+  jobs = launcher_scheduler_get_jobs (priv->scheduler);
+  for (list = jobs; list != NULL; list = list->next)
+    {
+      LauncherJob *job = list->data;
+      LauncherConfig *config;
+      GtkTreeIter iter;
+      gchar *profile;
+      gchar *queued;
+      gchar *started;
+      gboolean running;
+      
+      running = launcher_job_get_state (job) == LAUNCHER_JOB_RUNNING;
+      if (running)
+        n_running++;
+      else
+        n_queued++;
+      
+      config = launcher_job_get_config (job);
+      if (launcher_config_get_name (config) != NULL)
+        profile = g_strdup_printf ("%s: %s", 
+                                   launcher_config_get_project_name (config),
+                                   launcher_config_get_name (config));
+      else
+        profile = g_strdup (launcher_config_get_project_name (config));
+      
+      queued = format_time (launcher_job_get_queued_time (job));
+      started = running ? format_time (launcher_job_get_start_time (job)) : g_strdup ("");
+      
+      gtk_list_store_append (priv->store, &iter);
+      gtk_list_store_set (priv->store, &iter,
+                          ID, launcher_job_get_id (job),
+                          STATE, running ? "Running" : "Queued",
+                          KIND, launcher_job_kind_to_string (launcher_job_get_kind (job)),
+                          PROFILE, profile,
+                          PRIORITY, launcher_job_get_priority (job),
+                          QUEUED, queued,
+                          STARTED, started,
+                          -1);
+      
+      if (job == selected_job)
+        gtk_tree_selection_select_iter (selection, &iter);
+      
+      g_free (profile);
+      g_free (queued);
+      g_free (started);
+    }
+  g_list_free (jobs);
+  
+  text = g_strdup_printf ("%d running, %d queued", n_running, n_queued);
+  gtk_label_set_text (GTK_LABEL (priv->status_label), text);
+  g_free (text);
+  
+  selection_changed_action (jobs_view);
+}
+
+static void
+selection_changed_action (LauncherJobsView *jobs_view)
+{
+  LauncherJobsViewPrivate *priv;
+  LauncherJob *job;
+  gboolean queued;
+  
+  priv = LAUNCHER_JOBS_VIEW_GET_PRIVATE (jobs_view);
+  
+  job = get_selected_job (jobs_view);
+  queued = job != NULL && launcher_job_get_state (job) == LAUNCHER_JOB_QUEUED;
+  
+  gtk_widget_set_sensitive (priv->cancel_button, job != NULL);
+  gtk_widget_set_sensitive (priv->raise_button, queued);
+  gtk_widget_set_sensitive (priv->lower_button, queued);
+}
+
+static void
+cancel_action (LauncherJobsView *jobs_view)
+{
+  LauncherJobsViewPrivate *priv;
+  LauncherJob *job;
+  
+  priv = LAUNCHER_JOBS_VIEW_GET_PRIVATE (jobs_view);
+  
+  job = get_selected_job (jobs_view);
+  if (job != NULL)
+    launcher_scheduler_cancel (priv->scheduler, job);
+}
+
+static void
+raise_action (LauncherJobsView *jobs_view)
+{
+  LauncherJobsViewPrivate *priv;
+  LauncherJob *job;
+  
+  priv = LAUNCHER_JOBS_VIEW_GET_PRIVATE (jobs_view);
+  
+  job = get_selected_job (jobs_view);
+  if (job != NULL)
+    launcher_scheduler_set_priority (priv->scheduler, job, 
+                                     launcher_job_get_priority (job) + 1);
+}
+
+static void
+lower_action (LauncherJobsView *jobs_view)
+{
+  LauncherJobsViewPrivate *priv;
+  LauncherJob *job;
+  
+  priv = LAUNCHER_JOBS_VIEW_GET_PRIVATE (jobs_view);
+  
+  job = get_selected_job (jobs_view);
+  if (job != NULL)
+    launcher_scheduler_set_priority (priv->scheduler, job, 
+                                     launcher_job_get_priority (job) - 1);
+}
+
+static void
+max_jobs_action (LauncherJobsView *jobs_view)
+{
+  LauncherJobsViewPrivate *priv;
+  gint max_jobs;
+  
+  priv = LAUNCHER_JOBS_VIEW_GET_PRIVATE (jobs_view);
+  
+  if (priv->scheduler == NULL)
+    return;
+  
+  max_jobs = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->max_jobs_spin_button));
+  if (max_jobs != launcher_scheduler_get_max_jobs (priv->scheduler))
+    launcher_scheduler_set_max_jobs (priv->scheduler, max_jobs);
+}
+
+/*
+ * The store only keeps the id, a job is gone from the scheduler as soon 
+ * as it finishes.
+ */
+static LauncherJob*
+get_selected_job (LauncherJobsView *jobs_view)
+{
+  LauncherJobsViewPrivate *priv;
+  GtkTreeSelection *selection;
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  guint id;
+  
+  priv = LAUNCHER_JOBS_VIEW_GET_PRIVATE (jobs_view);
+  
+  if (priv->scheduler == NULL)
+    return NULL;
+  
+  selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (priv->tree));
+  if (!gtk_tree_selection_get_selected (selection, &model, &iter))
+    return NULL;
+  
+  gtk_tree_model_get (model, &iter, ID, &id, -1);
+  return launcher_scheduler_lookup (priv->scheduler, id);
+}
+
+static gchar*
+format_time (gint64 time)
+{
+  GDateTime *date_time;
+  gchar *text;
+  date_time = g_date_time_new_from_unix_local (time / G_USEC_PER_SEC);
+  text = g_date_time_format (date_time, "%H:%M:%S");
+  g_date_time_unref (date_time);
+  return text;
+}
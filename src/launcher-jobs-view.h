@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_JOBS_VIEW_H__
+#define	__LAUNCHER_JOBS_VIEW_H__
+
+#include <gtk/gtk.h>
+#include "launcher-scheduler.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_JOBS_VIEW_TYPE            (launcher_jobs_view_get_type ())
+#define LAUNCHER_JOBS_VIEW(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_JOBS_VIEW_TYPE, LauncherJobsView))
+#define LAUNCHER_JOBS_VIEW_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_JOBS_VIEW_TYPE, LauncherJobsViewClass))
+#define IS_LAUNCHER_JOBS_VIEW(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_JOBS_VIEW_TYPE))
+#define IS_LAUNCHER_JOBS_VIEW_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_JOBS_VIEW_TYPE))
+
+typedef struct _LauncherJobsView LauncherJobsView;
+typedef struct _LauncherJobsViewClass LauncherJobsViewClass;
+
+struct _LauncherJobsView
+{
+  GtkBox parent_instance;
+};
+
+struct _LauncherJobsViewClass
+{
+  GtkBoxClass parent_class;
+};
+
+GType launcher_jobs_view_get_type (void) G_GNUC_CONST;
+     
+GtkWidget*  launcher_jobs_view_new            (void);
+
+void        launcher_jobs_view_set_scheduler  (LauncherJobsView  *jobs_view,
+                                               LauncherScheduler *scheduler);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_JOBS_VIEW_H__ */
@@ -0,0 +1,776 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <dlfcn.h>
+#include <elf.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <link.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * The allocation profiler the launcher preloads into a run. It interposes 
+ * malloc, calloc, realloc and free along with the aligned and array 
+ * variants, whose blocks free() gets as well, and counts the calls, the 
+ * bytes asked for and the peak of the live heap, and it takes the backtrace of one 
+ * allocation every LAUNCHER_MALLOC_SAMPLE bytes or so to find the call 
+ * sites that allocate the most. The report is written to the file in 
+ * LAUNCHER_MALLOC_OUTPUT when the program exits.
+ *
+ * This runs inside every allocation of the program, so it uses no glib and 
+ * takes no lock on the common path. Each thread counts into its own 
+ * buffer, which is added to the totals every FLUSH_BYTES of heap change or 
+ * FLUSH_CALLS calls, so the peak is exact to within FLUSH_BYTES per thread. 
+ * Only the sampled allocations take the lock of the call site table.
+ *
+ * Sizes are the usable sizes of the real allocator, the only size free() 
+ * can know without a header in front of every block.
+ */
+
+#define DEFAULT_SAMPLE_INTERVAL (512 * 1024)
+#define FLUSH_BYTES (256 * 1024)
+#define FLUSH_CALLS 4096
+#define MAX_SITES 4096
+#define MAX_DEPTH 12
+#define TOP_SITES 50
+#define BOOTSTRAP_SIZE 8192
+
+/* sample_allocation, account_allocation and the interposed function */
+#define SKIP_FRAMES 3
+
+#define TLS __thread __attribute__ ((tls_model ("initial-exec")))
+#define NOINLINE __attribute__ ((noinline))
+#define ALWAYS_INLINE inline __attribute__ ((always_inline))
+#define EXPORT __attribute__ ((visibility ("default")))
+
+typedef struct
+{
+  int64_t  live;
+  uint64_t mallocs;
+  uint64_t callocs;
+  uint64_t reallocs;
+  uint64_t aligned;
+  uint64_t frees;
+  uint64_t bytes;
+  uint64_t calls;
+  int64_t  until_sample;
+  uint32_t random;
+  int      in_hook;
+  int      registered;
+} ThreadStats;
+
+typedef struct
+{
+  uint64_t  hash;
+  int       depth;
+  void     *frames[MAX_DEPTH];
+  uint64_t  samples;
+  uint64_t  sampled_bytes;
+} Site;
+
+static void* (*real_malloc)  (size_t size);
+static void* (*real_calloc)  (size_t n, size_t size);
+static void* (*real_realloc) (void *ptr, size_t size);
+static void  (*real_free)    (void *ptr);
+static int   (*real_posix_memalign) (void **ptr, size_t alignment, size_t size);
+static void* (*real_aligned_alloc)  (size_t alignment, size_t size);
+static void* (*real_memalign)       (size_t alignment, size_t size);
+static void* (*real_valloc)         (size_t size);
+static void* (*real_pvalloc)        (size_t size);
+
+static char bootstrap[BOOTSTRAP_SIZE];
+static size_t bootstrap_used;
+static int initializing;
+
+static char output_path[4096];
+static pid_t output_pid;
+static int64_t sample_interval = DEFAULT_SAMPLE_INTERVAL;
+
+static uint64_t total_mallocs;
+static uint64_t total_callocs;
+static uint64_t total_reallocs;
+static uint64_t total_aligned;
+static uint64_t total_frees;
+static uint64_t total_bytes;
+static int64_t total_live;
+static int64_t peak_live;
+static uint64_t total_threads;
+
+static Site sites[MAX_SITES];
+static uint64_t n_sites;
+static uint64_t dropped_samples;
+static pthread_mutex_t sites_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_key_t thread_key;
+
+static TLS ThreadStats thread_stats;
+
+static void initialize (void);
+static void flush_thread (ThreadStats *stats);
+static void thread_exit_action (void *data);
+
+static void
+initialize (void)
+{
+  if (real_malloc != NULL || initializing)
+    return;
+  
+  initializing = 1;
+  real_malloc = dlsym (RTLD_NEXT, "malloc");
+  real_calloc = dlsym (RTLD_NEXT, "calloc");
+  real_realloc = dlsym (RTLD_NEXT, "realloc");
+  real_free = dlsym (RTLD_NEXT, "free");
+  real_posix_memalign = dlsym (RTLD_NEXT, "posix_memalign");
+  real_aligned_alloc = dlsym (RTLD_NEXT, "aligned_alloc");
+  real_memalign = dlsym (RTLD_NEXT, "memalign");
+  real_valloc = dlsym (RTLD_NEXT, "valloc");
+  real_pvalloc = dlsym (RTLD_NEXT, "pvalloc");
+  initializing = 0;
+  
+  pthread_key_create (&thread_key, thread_exit_action);
+}
+
+/*
+ * The launcher starts the program through env, which execs it in the 
+ * same process, so the report belongs to the first pid that loads the 
+ * library. Programs that one starts inherit the preload and see another 
+ * pid in LAUNCHER_MALLOC_PID, they are counted but write nothing.
+ */
+static void
+read_environment (void)
+{
+  const char *value;
+  char pid[32];
+  
+  value = getenv ("LAUNCHER_MALLOC_SAMPLE");
+  if (value != NULL && atoll (value) > 0)
+    sample_interval = atoll (value);
+  
+  value = getenv ("LAUNCHER_MALLOC_PID");
+  if (value != NULL && atol (value) != (long) getpid ())
+    return;
+  
+  value = getenv ("LAUNCHER_MALLOC_OUTPUT");
+  if (value == NULL || strlen (value) >= sizeof (output_path))
+    return;
+  
+  strcpy (output_path, value);
+  output_pid = getpid ();
+  
+  snprintf (pid, sizeof (pid), "%ld", (long) output_pid);
+  setenv ("LAUNCHER_MALLOC_PID", pid, 1);
+}
+
+/*
+ * backtrace() loads libgcc on its first call, which allocates, so that 
+ * is done here rather than inside the first sampled allocation.
+ */
+static void __attribute__ ((constructor))
+launcher_malloc_init (void)
+{
+  void *frames[2];
+  
+  initialize ();
+  read_environment ();
+  
+  thread_stats.in_hook = 1;
+  backtrace (frames, 2);
+  thread_stats.in_hook = 0;
+}
+
+static uint32_t
+next_random (ThreadStats *stats)
+{
+  uint32_t x = stats->random != 0 ? stats->random : 2463534242u ^ (uint32_t) (uintptr_t) stats;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  stats->random = x;
+  return x;
+}
+
+/*
+ * The distance to the next sample is drawn from [interval/2, 3*interval/2) 
+ * so that a program allocating in a fixed pattern is not always sampled 
+ * at the same place in it.
+ */
+static void
+schedule_sample (ThreadStats *stats)
+{
+  stats->until_sample += sample_interval / 2 + next_random (stats) % sample_interval;
+}
+
+static uint64_t
+hash_frames (void **frames,
+             int    depth)
+{
+  uint64_t hash = 14695981039346656037ull;
+  int i;
+  for (i = 0; i < depth; i++)
+    {
+      hash ^= (uint64_t) (uintptr_t) frames[i];
+      hash *= 1099511628211ull;
+    }
+  return hash;
+}
+
+static NOINLINE void
+sample_allocation (size_t size)
+{
+  void *frames[MAX_DEPTH + SKIP_FRAMES];
+  uint64_t hash;
+  uint64_t index;
+  uint64_t probe;
+  int depth;
+  
+  depth = backtrace (frames, MAX_DEPTH + SKIP_FRAMES) - SKIP_FRAMES;
+  if (depth <= 0)
+    return;
+  
+  hash = hash_frames (frames + SKIP_FRAMES, depth);
+  
+  pthread_mutex_lock (&sites_mutex);
+  
+  index = hash % MAX_SITES;
+  for (probe = 0; probe < MAX_SITES; probe++)
+    {
+      Site *site = &sites[(index + probe) % MAX_SITES];
+      
+      if (site->samples == 0)
+        {
+          site->hash = hash;
+          site->depth = depth;
+          memcpy (site->frames, frames + SKIP_FRAMES, depth * sizeof (void *));
+          n_sites++;
+        }
+      else if (site->hash != hash || site->depth != depth ||
+               memcmp (site->frames, frames + SKIP_FRAMES, depth * sizeof (void *)) != 0)
+        {
+          continue;
+        }
+      
+      site->samples++;
+      site->sampled_bytes += size;
+      break;
+    }
+  
+  if (probe == MAX_SITES)
+    dropped_samples++;
+  
+  pthread_mutex_unlock (&sites_mutex);
+}
+
+static void
+flush_thread (ThreadStats *stats)
+{
+  int64_t live;
+  int64_t peak;
+  
+  __atomic_add_fetch (&total_mallocs, stats->mallocs, __ATOMIC_RELAXED);
+  __atomic_add_fetch (&total_callocs, stats->callocs, __ATOMIC_RELAXED);
+  __atomic_add_fetch (&total_reallocs, stats->reallocs, __ATOMIC_RELAXED);
+  __atomic_add_fetch (&total_aligned, stats->aligned, __ATOMIC_RELAXED);
+  __atomic_add_fetch (&total_frees, stats->frees, __ATOMIC_RELAXED);
+  __atomic_add_fetch (&total_bytes, stats->bytes, __ATOMIC_RELAXED);
+  live = __atomic_add_fetch (&total_live, stats->live, __ATOMIC_RELAXED);
+  
+  peak = __atomic_load_n (&peak_live, __ATOMIC_RELAXED);
+  while (live > peak && 
+         !__atomic_compare_exchange_n (&peak_live, &peak, live, 1, 
+                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    ;
+  
+  stats->mallocs = 0;
+  stats->callocs = 0;
+  stats->reallocs = 0;
+  stats->aligned = 0;
+  stats->frees = 0;
+  stats->bytes = 0;
+  stats->live = 0;
+  stats->calls = 0;
+}
+
+static void
+thread_exit_action (void *data)
+{
+  (void) data;
+  thread_stats.in_hook = 1;
+  flush_thread (&thread_stats);
+}
+
+/*
+ * The thread is registered on its first allocation so that its buffer is 
+ * flushed when it exits.
+ */
+static NOINLINE void
+account_allocation (ThreadStats *stats,
+                    void        *ptr,
+                    size_t       size,
+                    void        *old_ptr)
+{
+  int64_t change = 0;
+  
+  if (!stats->registered)
+    {
+      stats->registered = 1;
+      __atomic_add_fetch (&total_threads, 1, __ATOMIC_RELAXED);
+      pthread_setspecific (thread_key, stats);
+      schedule_sample (stats);
+    }
+  
+  if (old_ptr != NULL)
+    change -= malloc_usable_size (old_ptr);
+  if (ptr != NULL)
+    change += malloc_usable_size (ptr);
+  
+  stats->live += change;
+  stats->bytes += size;
+  stats->calls++;
+  
+  if (ptr != NULL && size > 0)
+    {
+      stats->until_sample -= size;
+      if (stats->until_sample <= 0)
+        {
+          sample_allocation (size);
+          schedule_sample (stats);
+        }
+    }
+  
+  if (stats->live >= FLUSH_BYTES || stats->live <= -FLUSH_BYTES || 
+      stats->calls >= FLUSH_CALLS)
+    flush_thread (stats);
+}
+
+static int
+is_bootstrap (void *ptr)
+{
+  return (char *) ptr >= bootstrap && (char *) ptr < bootstrap + sizeof (bootstrap);
+}
+
+/*
+ * dlsym() can allocate while the real functions are being looked up, 
+ * those few blocks come from a static buffer and are never freed.
+ */
+static void*
+bootstrap_alloc (size_t size)
+{
+  void *ptr;
+  size = (size + 15) & ~(size_t) 15;
+  if (bootstrap_used + size > sizeof (bootstrap))
+    return NULL;
+  ptr = bootstrap + bootstrap_used;
+  bootstrap_used += size;
+  return ptr;
+}
+
+EXPORT void*
+malloc (size_t size)
+{
+  ThreadStats *stats = &thread_stats;
+  void *ptr;
+  
+  if (real_malloc == NULL)
+    {
+      initialize ();
+      if (real_malloc == NULL)
+        return bootstrap_alloc (size);
+    }
+  
+  if (stats->in_hook)
+    return real_malloc (size);
+  
+  stats->in_hook = 1;
+  ptr = real_malloc (size);
+  stats->mallocs++;
+  account_allocation (stats, ptr, size, NULL);
+  stats->in_hook = 0;
+  
+  return ptr;
+}
+
+EXPORT void*
+calloc (size_t n,
+        size_t size)
+{
+  ThreadStats *stats = &thread_stats;
+  void *ptr;
+  
+  if (real_calloc == NULL)
+    {
+      initialize ();
+      if (real_calloc == NULL)
+        return bootstrap_alloc (n * size);
+    }
+  
+  if (stats->in_hook)
+    return real_calloc (n, size);
+  
+  stats->in_hook = 1;
+  ptr = real_calloc (n, size);
+  stats->callocs++;
+  account_allocation (stats, ptr, n * size, NULL);
+  stats->in_hook = 0;
+  
+  return ptr;
+}
+
+/*
+ * A realloc() that moves or resizes a block counts as freeing the old 
+ * size and allocating the new one. It is inlined into realloc() and 
+ * reallocarray() so that SKIP_FRAMES holds for both.
+ */
+static ALWAYS_INLINE void*
+reallocate (void   *ptr,
+            size_t  size)
+{
+  ThreadStats *stats = &thread_stats;
+  size_t old_size;
+  void *new_ptr;
+  
+  if (is_bootstrap (ptr))
+    {
+      size_t available = bootstrap + sizeof (bootstrap) - (char *) ptr;
+      new_ptr = malloc (size);
+      if (new_ptr != NULL)
+        memcpy (new_ptr, ptr, size < available ? size : available);
+      return new_ptr;
+    }
+  
+  if (real_realloc == NULL)
+    initialize ();
+  
+  if (stats->in_hook)
+    return real_realloc (ptr, size);
+  
+  stats->in_hook = 1;
+  old_size = ptr != NULL ? malloc_usable_size (ptr) : 0;
+  new_ptr = real_realloc (ptr, size);
+  stats->reallocs++;
+  if (new_ptr != NULL || size == 0)
+    {
+      stats->live -= old_size;
+      account_allocation (stats, new_ptr, size, NULL);
+    }
+  stats->in_hook = 0;
+  
+  return new_ptr;
+}
+
+EXPORT void*
+realloc (void   *ptr,
+         size_t  size)
+{
+  return reallocate (ptr, size);
+}
+
+EXPORT void*
+reallocarray (void   *ptr,
+              size_t  n,
+              size_t  size)
+{
+  size_t total;
+  
+  if (__builtin_mul_overflow (n, size, &total))
+    {
+      errno = ENOMEM;
+      return NULL;
+    }
+  
+  return reallocate (ptr, total);
+}
+
+/*
+ * The aligned allocators only differ in how they are called, each of them 
+ * counts as one aligned allocation of the size asked for.
+ */
+static ALWAYS_INLINE void
+account_aligned (ThreadStats *stats,
+                 void        *ptr,
+                 size_t       size)
+{
+  stats->aligned++;
+  account_allocation (stats, ptr, size, NULL);
+}
+
+EXPORT int
+posix_memalign (void   **ptr,
+                size_t   alignment,
+                size_t   size)
+{
+  ThreadStats *stats = &thread_stats;
+  int result;
+  
+  if (real_posix_memalign == NULL)
+    {
+      initialize ();
+      if (real_posix_memalign == NULL)
+        return ENOMEM;
+    }
+  
+  if (stats->in_hook)
+    return real_posix_memalign (ptr, alignment, size);
+  
+  stats->in_hook = 1;
+  result = real_posix_memalign (ptr, alignment, size);
+  account_aligned (stats, result == 0 ? *ptr : NULL, size);
+  stats->in_hook = 0;
+  
+  return result;
+}
+
+EXPORT void*
+aligned_alloc (size_t alignment,
+               size_t size)
+{
+  ThreadStats *stats = &thread_stats;
+  void *ptr;
+  
+  if (real_aligned_alloc == NULL)
+    {
+      initialize ();
+      if (real_aligned_alloc == NULL)
+        return NULL;
+    }
+  
+  if (stats->in_hook)
+    return real_aligned_alloc (alignment, size);
+  
+  stats->in_hook = 1;
+  ptr = real_aligned_alloc (alignment, size);
+  account_aligned (stats, ptr, size);
+  stats->in_hook = 0;
+  
+  return ptr;
+}
+
+EXPORT void*
+memalign (size_t alignment,
+          size_t size)
+{
+  ThreadStats *stats = &thread_stats;
+  void *ptr;
+  
+  if (real_memalign == NULL)
+    {
+      initialize ();
+      if (real_memalign == NULL)
+        return NULL;
+    }
+  
+  if (stats->in_hook)
+    return real_memalign (alignment, size);
+  
+  stats->in_hook = 1;
+  ptr = real_memalign (alignment, size);
+  account_aligned (stats, ptr, size);
+  stats->in_hook = 0;
+  
+  return ptr;
+}
+
+EXPORT void*
+valloc (size_t size)
+{
+  ThreadStats *stats = &thread_stats;
+  void *ptr;
+  
+  if (real_valloc == NULL)
+    {
+      initialize ();
+      if (real_valloc == NULL)
+        return NULL;
+    }
+  
+  if (stats->in_hook)
+    return real_valloc (size);
+  
+  stats->in_hook = 1;
+  ptr = real_valloc (size);
+  account_aligned (stats, ptr, size);
+  stats->in_hook = 0;
+  
+  return ptr;
+}
+
+EXPORT void*
+pvalloc (size_t size)
+{
+  ThreadStats *stats = &thread_stats;
+  void *ptr;
+  
+  if (real_pvalloc == NULL)
+    {
+      initialize ();
+      if (real_pvalloc == NULL)
+        return NULL;
+    }
+  
+  if (stats->in_hook)
+    return real_pvalloc (size);
+  
+  stats->in_hook = 1;
+  ptr = real_pvalloc (size);
+  account_aligned (stats, ptr, size);
+  stats->in_hook = 0;
+  
+  return ptr;
+}
+
+EXPORT void
+free (void *ptr)
+{
+  ThreadStats *stats = &thread_stats;
+  
+  if (ptr == NULL || is_bootstrap (ptr))
+    return;
+  
+  if (real_free == NULL)
+    initialize ();
+  
+  if (stats->in_hook)
+    {
+      real_free (ptr);
+      return;
+    }
+  
+  stats->in_hook = 1;
+  stats->frees++;
+  stats->live -= malloc_usable_size (ptr);
+  stats->calls++;
+  real_free (ptr);
+  if (stats->live <= -FLUSH_BYTES || stats->calls >= FLUSH_CALLS)
+    flush_thread (stats);
+  stats->in_hook = 0;
+}
+
+static int
+compare_sites (const void *a,
+               const void *b)
+{
+  const Site *site1 = *(const Site * const *) a;
+  const Site *site2 = *(const Site * const *) b;
+  if (site1->samples != site2->samples)
+    return site1->samples > site2->samples ? -1 : 1;
+  return 0;
+}
+
+/*
+ * Frames are written as the address addr2line wants for their module, 
+ * which is the offset into a shared object or position independent 
+ * executable and the address itself for a fixed one. The address is the 
+ * one of the call, just before the return address backtrace() gives.
+ */
+static void
+write_frame (int   fd,
+             void *frame)
+{
+  Dl_info info;
+  uintptr_t address = (uintptr_t) frame - 1;
+  
+  if (dladdr (frame, &info) == 0 || info.dli_fname == NULL)
+    {
+      dprintf (fd, "frame 0x%lx ? ?\n", (unsigned long) address);
+      return;
+    }
+  
+  if (((ElfW(Ehdr) *) info.dli_fbase)->e_type != ET_EXEC)
+    address -= (uintptr_t) info.dli_fbase;
+  
+  dprintf (fd, "frame 0x%lx %s %s\n", (unsigned long) address, 
+           info.dli_sname != NULL ? info.dli_sname : "?", 
+           info.dli_fname[0] != '\0' ? info.dli_fname : "/proc/self/exe");
+}
+
+/*
+ * Threads still running at exit have not flushed, so their last 
+ * FLUSH_CALLS calls at most are missing from the counts.
+ */
+static void __attribute__ ((destructor))
+launcher_malloc_fini (void)
+{
+  Site *top[TOP_SITES];
+  Site **sorted;
+  uint64_t n_sorted = 0;
+  uint64_t i;
+  int fd;
+  int j;
+  
+  if (output_path[0] == '\0' || getpid () != output_pid)
+    return;
+  
+  thread_stats.in_hook = 1;
+  flush_thread (&thread_stats);
+  
+  fd = open (output_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0)
+    return;
+  
+  pthread_mutex_lock (&sites_mutex);
+  
+  sorted = real_malloc (MAX_SITES * sizeof (Site *));
+  if (sorted != NULL)
+    {
+      for (i = 0; i < MAX_SITES; i++)
+        {
+          if (sites[i].samples > 0)
+            sorted[n_sorted++] = &sites[i];
+        }
+      qsort (sorted, n_sorted, sizeof (Site *), compare_sites);
+      for (i = 0; i < n_sorted && i < TOP_SITES; i++)
+        top[i] = sorted[i];
+      real_free (sorted);
+    }
+  
+  dprintf (fd, "launcher-malloc 1\n");
+  dprintf (fd, "mallocs %llu\n", (unsigned long long) total_mallocs);
+  dprintf (fd, "callocs %llu\n", (unsigned long long) total_callocs);
+  dprintf (fd, "reallocs %llu\n", (unsigned long long) total_reallocs);
+  dprintf (fd, "aligned %llu\n", (unsigned long long) total_aligned);
+  dprintf (fd, "frees %llu\n", (unsigned long long) total_frees);
+  dprintf (fd, "bytes %llu\n", (unsigned long long) total_bytes);
+  dprintf (fd, "peak %lld\n", (long long) peak_live);
+  dprintf (fd, "live %lld\n", (long long) total_live);
+  dprintf (fd, "threads %llu\n", (unsigned long long) total_threads);
+  dprintf (fd, "sample_interval %lld\n", (long long) sample_interval);
+  dprintf (fd, "sites %llu\n", (unsigned long long) n_sites);
+  dprintf (fd, "dropped_samples %llu\n", (unsigned long long) dropped_samples);
+  
+  for (i = 0; i < n_sorted && i < TOP_SITES; i++)
+    {
+      dprintf (fd, "site %llu %llu\n", 
+               (unsigned long long) top[i]->samples, 
+               (unsigned long long) top[i]->sampled_bytes);
+      for (j = 0; j < top[i]->depth; j++)
+        write_frame (fd, top[i]->frames[j]);
+    }
+  
+  pthread_mutex_unlock (&sites_mutex);
+  close (fd);
+}
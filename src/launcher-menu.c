@@ -23,11 +23,23 @@ static void launcher_menu_class_init  (LauncherMenuClass *klass);
 static void launcher_menu_init        (LauncherMenu      *menu);
 static void launcher_menu_finalize    (LauncherMenu      *menu);
 
+static void add_menu_items          (LauncherMenu      *menu,
+                                     GtkAccelGroup     *accel_group);
 static void run_action              (LauncherMenu      *menu);
+static void launch_profile_action   (LauncherMenu      *menu);
+static void benchmark_action        (LauncherMenu      *menu);
+static void benchmark_startup_action (LauncherMenu      *menu);
+static void launch_group_action     (LauncherMenu      *menu);
+static void clear_annotations_action (LauncherMenu      *menu);
                                         
 enum
 {
   RUN,
+  LAUNCH_PROFILE,
+  BENCHMARK,
+  BENCHMARK_STARTUP,
+  LAUNCH_GROUP,
+  CLEAR_ANNOTATIONS,
   LAST_SIGNAL
 };
 
@@ -46,13 +58,53 @@ launcher_menu_class_init (LauncherMenuClass *klass)
                   NULL, NULL, 
                   g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
 
+  launcher_menu_signals[LAUNCH_PROFILE] =
+    g_signal_new ("launch-profile", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherMenuClass, launch_profile),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  launcher_menu_signals[BENCHMARK] =
+    g_signal_new ("benchmark", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherMenuClass, benchmark),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  launcher_menu_signals[BENCHMARK_STARTUP] =
+    g_signal_new ("benchmark-startup", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherMenuClass, benchmark_startup),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  launcher_menu_signals[LAUNCH_GROUP] =
+    g_signal_new ("launch-group", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherMenuClass, launch_group),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  launcher_menu_signals[CLEAR_ANNOTATIONS] =
+    g_signal_new ("clear-annotations", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherMenuClass, clear_annotations),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
   G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) launcher_menu_finalize;
 }
 
 static void
 launcher_menu_init (LauncherMenu *menu)
 {
-  gtk_menu_item_set_label (GTK_MENU_ITEM (menu), "Run Program");
+  gtk_menu_item_set_label (GTK_MENU_ITEM (menu), "Launcher");
 }
 
 static void
@@ -67,14 +119,61 @@ launcher_menu_new (GtkAccelGroup *accel_group)
   GtkWidget *menu;
 
   menu = g_object_new (launcher_menu_get_type (), NULL);
+  add_menu_items (LAUNCHER_MENU (menu), accel_group);
+  return menu;
+}
+
+static void
+add_menu_items (LauncherMenu  *menu,
+                GtkAccelGroup *accel_group)
+{
+  GtkWidget *submenu;
+  GtkWidget *run_item;
+  GtkWidget *launch_profile_item;
+  GtkWidget *benchmark_item;
+  GtkWidget *benchmark_startup_item;
+  GtkWidget *launch_group_item;
+  GtkWidget *clear_annotations_item;
   
-  gtk_widget_add_accelerator (menu, "activate", 
+  submenu = gtk_menu_new ();
+  gtk_menu_item_set_submenu (GTK_MENU_ITEM (menu), submenu);
+  
+  run_item = gtk_menu_item_new_with_label ("Run Program");
+  gtk_widget_add_accelerator (run_item, "activate", 
                               accel_group, GDK_KEY_F8, 0, GTK_ACCEL_VISIBLE);  
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), run_item);
 
-  g_signal_connect_swapped (G_OBJECT (menu), "activate", 
-                            G_CALLBACK (run_action), menu);
+  launch_profile_item = gtk_menu_item_new_with_label ("Launch Profile...");
+  gtk_widget_add_accelerator (launch_profile_item, "activate", 
+                              accel_group, GDK_KEY_F8, GDK_SHIFT_MASK, GTK_ACCEL_VISIBLE);  
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), launch_profile_item);
 
-  return menu;
+  benchmark_item = gtk_menu_item_new_with_label ("Benchmark Program");
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), benchmark_item);
+
+  benchmark_startup_item = gtk_menu_item_new_with_label ("Benchmark Startup");
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), benchmark_startup_item);
+
+  launch_group_item = gtk_menu_item_new_with_label ("Launch Group");
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), launch_group_item);
+
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), gtk_separator_menu_item_new ());
+
+  clear_annotations_item = gtk_menu_item_new_with_label ("Clear Profile Annotations");
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), clear_annotations_item);
+
+  g_signal_connect_swapped (G_OBJECT (run_item), "activate", 
+                            G_CALLBACK (run_action), menu);
+  g_signal_connect_swapped (G_OBJECT (launch_profile_item), "activate", 
+                            G_CALLBACK (launch_profile_action), menu);
+  g_signal_connect_swapped (G_OBJECT (benchmark_item), "activate", 
+                            G_CALLBACK (benchmark_action), menu);
+  g_signal_connect_swapped (G_OBJECT (benchmark_startup_item), "activate", 
+                            G_CALLBACK (benchmark_startup_action), menu);
+  g_signal_connect_swapped (G_OBJECT (launch_group_item), "activate", 
+                            G_CALLBACK (launch_group_action), menu);
+  g_signal_connect_swapped (G_OBJECT (clear_annotations_item), "activate", 
+                            G_CALLBACK (clear_annotations_action), menu);
 }
 
 static void 
@@ -82,3 +181,33 @@ run_action (LauncherMenu *menu)
 {
   g_signal_emit_by_name ((gpointer) menu, "run");
 }
+
+static void 
+launch_profile_action (LauncherMenu *menu) 
+{
+  g_signal_emit_by_name ((gpointer) menu, "launch-profile");
+}
+
+static void 
+benchmark_action (LauncherMenu *menu) 
+{
+  g_signal_emit_by_name ((gpointer) menu, "benchmark");
+}
+
+static void 
+benchmark_startup_action (LauncherMenu *menu) 
+{
+  g_signal_emit_by_name ((gpointer) menu, "benchmark-startup");
+}
+
+static void 
+launch_group_action (LauncherMenu *menu) 
+{
+  g_signal_emit_by_name ((gpointer) menu, "launch-group");
+}
+
+static void 
+clear_annotations_action (LauncherMenu *menu) 
+{
+  g_signal_emit_by_name ((gpointer) menu, "clear-annotations");
+}
@@ -42,6 +42,11 @@ struct _LauncherMenuClass
   GtkMenuItemClass parent_class;
 
   void (*run) (LauncherMenu *menu);
+  void (*launch_profile) (LauncherMenu *menu);
+  void (*benchmark) (LauncherMenu *menu);
+  void (*benchmark_startup) (LauncherMenu *menu);
+  void (*launch_group) (LauncherMenu *menu);
+  void (*clear_annotations) (LauncherMenu *menu);
 };
 
 GType launcher_menu_get_type (void) G_GNUC_CONST;
@@ -0,0 +1,335 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "launcher-monitor-view.h"
+
+/*
+ * One row per process of the launched trees, children indented under their 
+ * parent, with a sparkline of the recent history of every metric next to 
+ * its latest value. The rows are drawn rather than put in a tree view so a 
+ * refresh every second stays a single redraw.
+ */
+
+#define PADDING 4
+#define NAME_WIDTH 220
+#define INDENT 12
+#define SPARKLINE_HEIGHT 20
+
+static void launcher_monitor_view_class_init  (LauncherMonitorViewClass *klass);
+static void launcher_monitor_view_init        (LauncherMonitorView      *monitor_view);
+static void launcher_monitor_view_finalize    (LauncherMonitorView      *monitor_view);
+
+static void changed_action                    (LauncherMonitorView      *monitor_view);
+static gboolean draw_action                   (GtkWidget                *drawing_area,
+                                               cairo_t                  *cr,
+                                               LauncherMonitorView      *monitor_view);
+static void draw_metric                       (LauncherMonitorView      *monitor_view,
+                                               cairo_t                  *cr,
+                                               PangoLayout              *layout,
+                                               guint                     index,
+                                               LauncherMonitorMetric     metric,
+                                               gdouble                   x,
+                                               gdouble                   y,
+                                               gdouble                   width);
+static gchar* format_value                    (LauncherMonitorMetric     metric,
+                                               gdouble                   value);
+static gint get_row_height                    (LauncherMonitorView      *monitor_view);
+
+#define LAUNCHER_MONITOR_VIEW_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_MONITOR_VIEW_TYPE, LauncherMonitorViewPrivate))
+
+typedef struct _LauncherMonitorViewPrivate LauncherMonitorViewPrivate;
+
+struct _LauncherMonitorViewPrivate
+{
+  LauncherMonitor *monitor;
+  GtkWidget       *status_label;
+  GtkWidget       *drawing_area;
+  gint             line_height;
+};
+
+static const gchar *metric_names[LAUNCHER_MONITOR_N_METRICS] = 
+{
+  "CPU", 
+  "RSS", 
+  "Threads", 
+  "Read", 
+  "Write", 
+  "Switches"
+};
+
+G_DEFINE_TYPE (LauncherMonitorView, launcher_monitor_view, GTK_TYPE_BOX)
+
+static void
+launcher_monitor_view_class_init (LauncherMonitorViewClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_monitor_view_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherMonitorViewPrivate));
+}
+
+static void
+launcher_monitor_view_init (LauncherMonitorView *monitor_view)
+{
+  LauncherMonitorViewPrivate *priv;
+  GtkWidget *scrolled_window;
+
+  priv = LAUNCHER_MONITOR_VIEW_GET_PRIVATE (monitor_view);
+  priv->monitor = NULL;
+  priv->line_height = 0;
+
+  gtk_orientable_set_orientation (GTK_ORIENTABLE (monitor_view), GTK_ORIENTATION_VERTICAL);
+  
+  priv->status_label = gtk_label_new ("Nothing launched");
+  gtk_misc_set_alignment (GTK_MISC (priv->status_label), 0, .5);
+  gtk_misc_set_padding (GTK_MISC (priv->status_label), PADDING, 2);
+  gtk_box_pack_start (GTK_BOX (monitor_view), priv->status_label, FALSE, FALSE, 0);
+  
+  priv->drawing_area = gtk_drawing_area_new ();
+  g_signal_connect (G_OBJECT (priv->drawing_area), "draw",
+                    G_CALLBACK (draw_action), monitor_view);
+
+  scrolled_window = gtk_scrolled_window_new (NULL, NULL);
+  gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolled_window),
+                                  GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+  gtk_container_add (GTK_CONTAINER (scrolled_window), priv->drawing_area);
+  gtk_box_pack_start (GTK_BOX (monitor_view), scrolled_window, TRUE, TRUE, 0);
+}
+
+static void
+launcher_monitor_view_finalize (LauncherMonitorView *monitor_view)
+{
+  LauncherMonitorViewPrivate *priv;
+  priv = LAUNCHER_MONITOR_VIEW_GET_PRIVATE (monitor_view);
+  if (priv->monitor != NULL)
+    g_object_remove_weak_pointer (G_OBJECT (priv->monitor), (gpointer *) &priv->monitor);
+  G_OBJECT_CLASS (launcher_monitor_view_parent_class)->finalize (G_OBJECT (monitor_view));
+}
+
+GtkWidget*
+launcher_monitor_view_new (void)
+{
+  return g_object_new (launcher_monitor_view_get_type (), NULL);
+}
+
+/*
+ * The monitor belongs to the engine, the view only watches it.
+ */
+void
+launcher_monitor_view_set_monitor (LauncherMonitorView *monitor_view,
+                                   LauncherMonitor     *monitor)
+{
+  LauncherMonitorViewPrivate *priv;
+  priv = LAUNCHER_MONITOR_VIEW_GET_PRIVATE (monitor_view);
+  
+  priv->monitor = monitor;
+  g_object_add_weak_pointer (G_OBJECT (monitor), (gpointer *) &priv->monitor);
+  g_signal_connect_object (G_OBJECT (monitor), "changed",
+                           G_CALLBACK (changed_action), monitor_view, G_CONNECT_SWAPPED);
+  changed_action (monitor_view);
+}
+
+static void
+changed_action (LauncherMonitorView *monitor_view)
+{
+  LauncherMonitorViewPrivate *priv;
+  guint n_targets;
+  gchar *text;
+  
+  priv = LAUNCHER_MONITOR_VIEW_GET_PRIVATE (monitor_view);
+  
+  n_targets = launcher_monitor_get_n_targets (priv->monitor);
+  
+  if (n_targets == 0)
+    text = g_strdup ("Nothing launched");
+  else
+    text = g_strdup_printf ("%d %s, sampled every second", n_targets, 
+                            n_targets == 1 ? "process" : "processes");
+  gtk_label_set_text (GTK_LABEL (priv->status_label), text);
+  g_free (text);
+  
+  gtk_widget_set_size_request (priv->drawing_area, -1, 
+                               n_targets * get_row_height (monitor_view));
+  gtk_widget_queue_draw (priv->drawing_area);
+}
+
+static gboolean
+draw_action (GtkWidget           *drawing_area,
+             cairo_t             *cr,
+             LauncherMonitorView *monitor_view)
+{
+  LauncherMonitorViewPrivate *priv;
+  GtkStyleContext *context;
+  PangoLayout *layout;
+  GdkRGBA color;
+  gdouble metric_width;
+  gint row_height;
+  guint n_targets;
+  guint i;
+
+  priv = LAUNCHER_MONITOR_VIEW_GET_PRIVATE (monitor_view);
+  
+  if (priv->monitor == NULL)
+    return FALSE;
+  
+  n_targets = launcher_monitor_get_n_targets (priv->monitor);
+  row_height = get_row_height (monitor_view);
+  metric_width = (gdouble) (gtk_widget_get_allocated_width (drawing_area) - NAME_WIDTH) / 
+                 LAUNCHER_MONITOR_N_METRICS;
+  
+  context = gtk_widget_get_style_context (drawing_area);
+  gtk_style_context_get_color (context, GTK_STATE_FLAG_NORMAL, &color);
+  gdk_cairo_set_source_rgba (cr, &color);
+
+  layout = gtk_widget_create_pango_layout (drawing_area, NULL);
+
+  for (i = 0; i < n_targets; i++)
+    {
+      LauncherMonitorMetric metric;
+      gchar *text;
+      gint y;
+      
+      y = i * row_height;
+      
+      text = g_strdup_printf ("%s (%d)", launcher_monitor_get_name (priv->monitor, i), 
+                              launcher_monitor_get_pid (priv->monitor, i));
+      pango_layout_set_text (layout, text, -1);
+      pango_layout_set_width (layout, (NAME_WIDTH - PADDING * 2 - 
+                                       launcher_monitor_get_depth (priv->monitor, i) * INDENT) * 
+                                      PANGO_SCALE);
+      pango_layout_set_ellipsize (layout, PANGO_ELLIPSIZE_END);
+      cairo_move_to (cr, PADDING + launcher_monitor_get_depth (priv->monitor, i) * INDENT, 
+                     y + PADDING);
+      pango_cairo_show_layout (cr, layout);
+      g_free (text);
+      
+      pango_layout_set_width (layout, -1);
+      for (metric = 0; metric < LAUNCHER_MONITOR_N_METRICS; metric++)
+        draw_metric (monitor_view, cr, layout, i, metric, 
+                     NAME_WIDTH + metric * metric_width, y, metric_width);
+    }
+  
+  g_object_unref (layout);
+  return FALSE;
+}
+
+/*
+ * The sparkline is scaled to the largest value it shows, CPU to at least 
+ * one full core so an idle process stays flat.
+ */
+static void
+draw_metric (LauncherMonitorView   *monitor_view,
+             cairo_t               *cr,
+             PangoLayout           *layout,
+             guint                  index,
+             LauncherMonitorMetric  metric,
+             gdouble                x,
+             gdouble                y,
+             gdouble                width)
+{
+  LauncherMonitorViewPrivate *priv;
+  gdouble values[LAUNCHER_MONITOR_HISTORY];
+  gdouble max = 0;
+  gdouble bottom;
+  gdouble step;
+  gchar *value;
+  gchar *text;
+  guint n_values;
+  guint i;
+  
+  priv = LAUNCHER_MONITOR_VIEW_GET_PRIVATE (monitor_view);
+  
+  value = format_value (metric, launcher_monitor_get_value (priv->monitor, index, metric));
+  text = g_strdup_printf ("%s %s", metric_names[metric], value);
+  pango_layout_set_text (layout, text, -1);
+  cairo_move_to (cr, x + PADDING, y + PADDING);
+  pango_cairo_show_layout (cr, layout);
+  g_free (value);
+  g_free (text);
+  
+  n_values = launcher_monitor_get_history (priv->monitor, index, metric, values);
+  if (n_values < 2)
+    return;
+  
+  for (i = 0; i < n_values; i++)
+    max = MAX (max, values[i]);
+  if (metric == LAUNCHER_MONITOR_CPU)
+    max = MAX (max, 100);
+  if (max <= 0)
+    max = 1;
+  
+  bottom = y + PADDING + priv->line_height + SPARKLINE_HEIGHT;
+  step = (width - PADDING * 2) / (LAUNCHER_MONITOR_HISTORY - 1);
+  
+  /* the newest sample is at the right edge, the line grows from there */
+  x += PADDING + (LAUNCHER_MONITOR_HISTORY - n_values) * step;
+  
+  cairo_save (cr);
+  cairo_set_line_width (cr, 1);
+  cairo_move_to (cr, x, bottom - values[0] / max * SPARKLINE_HEIGHT);
+  for (i = 1; i < n_values; i++)
+    cairo_line_to (cr, x + i * step, bottom - values[i] / max * SPARKLINE_HEIGHT);
+  cairo_stroke (cr);
+  cairo_restore (cr);
+}
+
+static gchar*
+format_value (LauncherMonitorMetric metric,
+              gdouble               value)
+{
+  gchar *size;
+  gchar *text;
+  
+  switch (metric)
+    {
+    case LAUNCHER_MONITOR_CPU:
+      return g_strdup_printf ("%.0f%%", value);
+    case LAUNCHER_MONITOR_RSS:
+      return g_format_size_full ((guint64) value * 1024, G_FORMAT_SIZE_IEC_UNITS);
+    case LAUNCHER_MONITOR_THREADS:
+      return g_strdup_printf ("%.0f", value);
+    case LAUNCHER_MONITOR_READ_BYTES:
+    case LAUNCHER_MONITOR_WRITE_BYTES:
+      size = g_format_size_full ((guint64) value, G_FORMAT_SIZE_IEC_UNITS);
+      text = g_strconcat (size, "/s", NULL);
+      g_free (size);
+      return text;
+    case LAUNCHER_MONITOR_CONTEXT_SWITCHES:
+      return g_strdup_printf ("%.0f/s", value);
+    default:
+      return g_strdup ("");
+    }
+}
+
+static gint
+get_row_height (LauncherMonitorView *monitor_view)
+{
+  LauncherMonitorViewPrivate *priv;
+  priv = LAUNCHER_MONITOR_VIEW_GET_PRIVATE (monitor_view);
+
+  if (priv->line_height == 0)
+    {
+      PangoLayout *layout;
+      layout = gtk_widget_create_pango_layout (priv->drawing_area, "X");
+      pango_layout_get_pixel_size (layout, NULL, &priv->line_height);
+      g_object_unref (layout);
+      priv->line_height = MAX (1, priv->line_height);
+    }
+
+  return priv->line_height + SPARKLINE_HEIGHT + PADDING * 3;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_MONITOR_VIEW_H__
+#define	__LAUNCHER_MONITOR_VIEW_H__
+
+#include <gtk/gtk.h>
+#include "launcher-monitor.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_MONITOR_VIEW_TYPE            (launcher_monitor_view_get_type ())
+#define LAUNCHER_MONITOR_VIEW(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_MONITOR_VIEW_TYPE, LauncherMonitorView))
+#define LAUNCHER_MONITOR_VIEW_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_MONITOR_VIEW_TYPE, LauncherMonitorViewClass))
+#define IS_LAUNCHER_MONITOR_VIEW(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_MONITOR_VIEW_TYPE))
+#define IS_LAUNCHER_MONITOR_VIEW_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_MONITOR_VIEW_TYPE))
+
+typedef struct _LauncherMonitorView LauncherMonitorView;
+typedef struct _LauncherMonitorViewClass LauncherMonitorViewClass;
+
+struct _LauncherMonitorView
+{
+  GtkBox parent_instance;
+};
+
+struct _LauncherMonitorViewClass
+{
+  GtkBoxClass parent_class;
+};
+
+GType launcher_monitor_view_get_type (void) G_GNUC_CONST;
+     
+GtkWidget*  launcher_monitor_view_new          (void);
+
+void        launcher_monitor_view_set_monitor  (LauncherMonitorView *monitor_view,
+                                                LauncherMonitor     *monitor);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_MONITOR_VIEW_H__ */
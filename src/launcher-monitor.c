@@ -0,0 +1,589 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "launcher-monitor.h"
+
+/*
+ * Samples every process in the trees of the launched programs once a 
+ * second. The /proc files of a process are opened the first time it is 
+ * seen and read again with pread, which makes the kernel regenerate them, 
+ * so a sample costs a handful of reads and no path lookups. There is one 
+ * timer for all of them and it only runs while something is launched.
+ *
+ * The children of a process are found through the children file of its 
+ * main thread. A child forked from any other thread is missed, which is 
+ * the price of not scanning all of /proc every second.
+ *
+ * Every metric keeps a ring of the last LAUNCHER_MONITOR_HISTORY samples.
+ */
+
+#define INTERVAL 1
+#define MAX_TARGETS 256
+#define READ_SIZE 4096
+
+typedef enum
+{
+  FILE_STAT,
+  FILE_STATM,
+  FILE_IO,
+  FILE_STATUS,
+  FILE_CHILDREN,
+  N_FILES
+} File;
+
+static const gchar *file_names[N_FILES] = 
+{
+  "stat", 
+  "statm", 
+  "io", 
+  "status", 
+  "task/%d/children"
+};
+
+typedef struct
+{
+  GPid     pid;
+  gchar   *name;
+  guint    depth;
+  gint     fds[N_FILES];
+  gboolean seen;
+  gint64   sample_time;
+  guint64  cpu_ticks;
+  guint64  read_bytes;
+  guint64  write_bytes;
+  guint64  context_switches;
+  guint    n_samples;
+  guint    head;
+  gdouble  history[LAUNCHER_MONITOR_N_METRICS][LAUNCHER_MONITOR_HISTORY];
+} Target;
+
+static void launcher_monitor_class_init  (LauncherMonitorClass *klass);
+static void launcher_monitor_init        (LauncherMonitor      *monitor);
+static void launcher_monitor_finalize    (LauncherMonitor      *monitor);
+
+static void process_finished_action      (LauncherMonitor      *monitor,
+                                          LauncherProcess      *process);
+static gboolean sample_action            (LauncherMonitor      *monitor);
+static void visit_target                 (LauncherMonitor      *monitor,
+                                          GPtrArray            *targets,
+                                          GPid                  pid,
+                                          guint                 depth);
+static Target* target_new                (GPid                  pid);
+static void target_free                  (Target               *target);
+static gboolean target_sample            (LauncherMonitor      *monitor,
+                                          Target               *target);
+static gssize read_file                  (Target               *target,
+                                          File                  file,
+                                          gchar                *buffer);
+static guint64 read_field                (const gchar          *contents,
+                                          const gchar          *name);
+static void push_value                   (Target               *target,
+                                          LauncherMonitorMetric metric,
+                                          gdouble               value);
+static void update_timer                 (LauncherMonitor      *monitor);
+
+#define LAUNCHER_MONITOR_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_MONITOR_TYPE, LauncherMonitorPrivate))
+
+typedef struct _LauncherMonitorPrivate LauncherMonitorPrivate;
+
+struct _LauncherMonitorPrivate
+{
+  GList      *processes;
+  GPtrArray  *targets;
+  GHashTable *targets_by_pid;
+  gchar      *buffer;
+  guint       sample_id;
+  glong       clock_ticks;
+  glong       page_size;
+};
+
+enum
+{
+  CHANGED,
+  LAST_SIGNAL
+};
+
+static guint launcher_monitor_signals[LAST_SIGNAL] = { 0 };
+
+G_DEFINE_TYPE (LauncherMonitor, launcher_monitor, G_TYPE_OBJECT)
+
+static void
+launcher_monitor_class_init (LauncherMonitorClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  launcher_monitor_signals[CHANGED] =
+    g_signal_new ("changed", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherMonitorClass, changed),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_monitor_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherMonitorPrivate));
+}
+
+static void
+launcher_monitor_init (LauncherMonitor *monitor)
+{
+  LauncherMonitorPrivate *priv;
+  priv = LAUNCHER_MONITOR_GET_PRIVATE (monitor);
+  priv->processes = NULL;
+  priv->targets = g_ptr_array_new ();
+  priv->targets_by_pid = g_hash_table_new_full (g_direct_hash, g_direct_equal, 
+                                                NULL, (GDestroyNotify) target_free);
+  priv->buffer = g_malloc (READ_SIZE);
+  priv->sample_id = 0;
+  priv->clock_ticks = sysconf (_SC_CLK_TCK);
+  priv->page_size = sysconf (_SC_PAGESIZE);
+}
+
+static void
+launcher_monitor_finalize (LauncherMonitor *monitor)
+{
+  LauncherMonitorPrivate *priv;
+  GList *list;
+  
+  priv = LAUNCHER_MONITOR_GET_PRIVATE (monitor);
+  
+  if (priv->sample_id != 0)
+    g_source_remove (priv->sample_id);
+  
+  for (list = priv->processes; list != NULL; list = list->next)
+    {
+      g_signal_handlers_disconnect_by_func (list->data, process_finished_action, monitor);
+      g_object_unref (list->data);
+    }
+  g_list_free (priv->processes);
+  
+  g_ptr_array_free (priv->targets, TRUE);
+  g_hash_table_destroy (priv->targets_by_pid);
+  g_free (priv->buffer);
+  
+  G_OBJECT_CLASS (launcher_monitor_parent_class)->finalize (G_OBJECT (monitor));
+}
+
+LauncherMonitor*
+launcher_monitor_new (void)
+{
+  return LAUNCHER_MONITOR (g_object_new (launcher_monitor_get_type (), NULL));
+}
+
+/*
+ * The process and everything it starts is sampled until it finishes.
+ */
+void
+launcher_monitor_add_process (LauncherMonitor *monitor,
+                              LauncherProcess *process)
+{
+  LauncherMonitorPrivate *priv;
+  priv = LAUNCHER_MONITOR_GET_PRIVATE (monitor);
+  
+  if (launcher_process_get_state (process) != LAUNCHER_PROCESS_RUNNING)
+    return;
+  
+  priv->processes = g_list_append (priv->processes, g_object_ref (process));
+  g_signal_connect_swapped (G_OBJECT (process), "finished",
+                            G_CALLBACK (process_finished_action), monitor);
+  
+  sample_action (monitor);
+  update_timer (monitor);
+}
+
+static void
+process_finished_action (LauncherMonitor *monitor,
+                         LauncherProcess *process)
+{
+  LauncherMonitorPrivate *priv;
+  priv = LAUNCHER_MONITOR_GET_PRIVATE (monitor);
+  
+  g_signal_handlers_disconnect_by_func (process, process_finished_action, monitor);
+  priv->processes = g_list_remove (priv->processes, process);
+  g_object_unref (process);
+  
+  sample_action (monitor);
+  update_timer (monitor);
+}
+
+/*
+ * Walks the trees from the launched processes so that the targets come 
+ * out parents first, a process that is not reached anymore has exited 
+ * or was handed to another parent and is dropped.
+ */
+static gboolean
+sample_action (LauncherMonitor *monitor)
+{
+  LauncherMonitorPrivate *priv;
+  GHashTableIter iter;
+  GPtrArray *targets;
+  Target *target;
+  GList *list;
+  
+  priv = LAUNCHER_MONITOR_GET_PRIVATE (monitor);
+  
+  targets = g_ptr_array_new ();
+  
+  for (list = priv->processes; list != NULL; list = list->next)
+    visit_target (monitor, targets, launcher_process_get_pid (list->data), 0);
+  
+  g_hash_table_iter_init (&iter, priv->targets_by_pid);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &target))
+    {
+      if (!target->seen)
+        g_hash_table_iter_remove (&iter);
+      else
+        target->seen = FALSE;
+    }
+  
+  g_ptr_array_free (priv->targets, TRUE);
+  priv->targets = targets;
+  
+  g_signal_emit_by_name ((gpointer) monitor, "changed");
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+visit_target (LauncherMonitor *monitor,
+              GPtrArray       *targets,
+              GPid             pid,
+              guint            depth)
+{
+  LauncherMonitorPrivate *priv;
+  Target *target;
+  gchar **children;
+  gchar **child;
+  gssize length;
+  
+  priv = LAUNCHER_MONITOR_GET_PRIVATE (monitor);
+  
+  target = g_hash_table_lookup (priv->targets_by_pid, GINT_TO_POINTER (pid));
+  if (target != NULL && target->seen)
+    return;
+  
+  if (target == NULL)
+    {
+      if (g_hash_table_size (priv->targets_by_pid) >= MAX_TARGETS)
+        return;
+      target = target_new (pid);
+      g_hash_table_insert (priv->targets_by_pid, GINT_TO_POINTER (pid), target);
+    }
+  
+  if (!target_sample (monitor, target))
+    return;
+  
+  target->seen = TRUE;
+  target->depth = depth;
+  g_ptr_array_add (targets, target);
+  
+  length = read_file (target, FILE_CHILDREN, priv->buffer);
+  if (length <= 0)
+    return;
+  
+  children = g_strsplit (priv->buffer, " ", -1);
+  for (child = children; *child != NULL; child++)
+    {
+      GPid child_pid = atoi (*child);
+      if (child_pid > 0)
+        visit_target (monitor, targets, child_pid, depth + 1);
+    }
+  g_strfreev (children);
+}
+
+static Target*
+target_new (GPid pid)
+{
+  Target *target;
+  gint i;
+  
+  target = g_slice_new0 (Target);
+  target->pid = pid;
+  
+  for (i = 0; i < N_FILES; i++)
+    {
+      gchar *file_name;
+      gchar *path;
+      
+      file_name = g_strdup_printf (file_names[i], pid);
+      path = g_strdup_printf ("/proc/%d/%s", pid, file_name);
+      target->fds[i] = open (path, O_RDONLY | O_CLOEXEC);
+      g_free (file_name);
+      g_free (path);
+    }
+  
+  return target;
+}
+
+static void
+target_free (Target *target)
+{
+  gint i;
+  for (i = 0; i < N_FILES; i++)
+    if (target->fds[i] >= 0)
+      close (target->fds[i]);
+  g_free (target->name);
+  g_slice_free (Target, target);
+}
+
+/*
+ * A file that could not be opened, io of a process owned by somebody else 
+ * for one, leaves its metrics at zero. Returns FALSE once the process is 
+ * gone, the open files keep pointing at it so a reused pid is never read.
+ */
+static gboolean
+target_sample (LauncherMonitor *monitor,
+               Target          *target)
+{
+  LauncherMonitorPrivate *priv;
+  gchar *buffer;
+  gchar *name_start;
+  gchar *name_end;
+  gulong utime = 0;
+  gulong stime = 0;
+  glong threads = 0;
+  gulong resident = 0;
+  guint64 read_bytes = 0;
+  guint64 write_bytes = 0;
+  guint64 context_switches = 0;
+  gint64 now;
+  gdouble elapsed;
+  
+  priv = LAUNCHER_MONITOR_GET_PRIVATE (monitor);
+  buffer = priv->buffer;
+  
+  if (read_file (target, FILE_STAT, buffer) <= 0)
+    return FALSE;
+  
+  /* the command name may contain spaces and parentheses */
+  name_start = strchr (buffer, '(');
+  name_end = strrchr (buffer, ')');
+  if (name_start == NULL || name_end == NULL || name_end < name_start)
+    return FALSE;
+  
+  if (target->name == NULL)
+    target->name = g_strndup (name_start + 1, name_end - name_start - 1);
+  
+  /* a zombie is as good as gone */
+  if (name_end[2] == 'Z')
+    return FALSE;
+  
+  sscanf (name_end + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu %*d %*d %*d %*d %ld", 
+          &utime, &stime, &threads);
+  
+  if (read_file (target, FILE_STATM, buffer) > 0)
+    sscanf (buffer, "%*u %lu", &resident);
+  
+  if (read_file (target, FILE_IO, buffer) > 0)
+    {
+      read_bytes = read_field (buffer, "read_bytes:");
+      write_bytes = read_field (buffer, "write_bytes:");
+    }
+  
+  if (read_file (target, FILE_STATUS, buffer) > 0)
+    context_switches = read_field (buffer, "voluntary_ctxt_switches:") + 
+                       read_field (buffer, "nonvoluntary_ctxt_switches:");
+  
+  now = g_get_monotonic_time ();
+  elapsed = target->n_samples > 0 ? (gdouble) (now - target->sample_time) / G_USEC_PER_SEC : 0;
+  
+  if (elapsed > 0)
+    {
+      push_value (target, LAUNCHER_MONITOR_CPU, 
+                  100.0 * (utime + stime - target->cpu_ticks) / priv->clock_ticks / elapsed);
+      push_value (target, LAUNCHER_MONITOR_READ_BYTES, (read_bytes - target->read_bytes) / elapsed);
+      push_value (target, LAUNCHER_MONITOR_WRITE_BYTES, (write_bytes - target->write_bytes) / elapsed);
+      push_value (target, LAUNCHER_MONITOR_CONTEXT_SWITCHES, 
+                  (context_switches - target->context_switches) / elapsed);
+    }
+  else
+    {
+      push_value (target, LAUNCHER_MONITOR_CPU, 0);
+      push_value (target, LAUNCHER_MONITOR_READ_BYTES, 0);
+      push_value (target, LAUNCHER_MONITOR_WRITE_BYTES, 0);
+      push_value (target, LAUNCHER_MONITOR_CONTEXT_SWITCHES, 0);
+    }
+  push_value (target, LAUNCHER_MONITOR_RSS, (gdouble) resident * priv->page_size / 1024);
+  push_value (target, LAUNCHER_MONITOR_THREADS, threads);
+  
+  target->head = (target->head + 1) % LAUNCHER_MONITOR_HISTORY;
+  target->n_samples = MIN (target->n_samples + 1, LAUNCHER_MONITOR_HISTORY);
+  target->sample_time = now;
+  target->cpu_ticks = utime + stime;
+  target->read_bytes = read_bytes;
+  target->write_bytes = write_bytes;
+  target->context_switches = context_switches;
+  
+  return TRUE;
+}
+
+/*
+ * Reads the whole file into the buffer and terminates it.
+ */
+static gssize
+read_file (Target *target,
+           File    file,
+           gchar  *buffer)
+{
+  gssize length;
+  
+  if (target->fds[file] < 0)
+    return -1;
+  
+  do
+    length = pread (target->fds[file], buffer, READ_SIZE - 1, 0);
+  while (length < 0 && errno == EINTR);
+  
+  if (length < 0)
+    return -1;
+  
+  buffer[length] = '\0';
+  return length;
+}
+
+static guint64
+read_field (const gchar *contents,
+            const gchar *name)
+{
+  const gchar *line;
+  
+  line = strstr (contents, name);
+  if (line == NULL)
+    return 0;
+  
+  return g_ascii_strtoull (line + strlen (name), NULL, 10);
+}
+
+/*
+ * The value goes into the slot at head, which moves on once all metrics 
+ * of the sample are in.
+ */
+static void
+push_value (Target                *target,
+            LauncherMonitorMetric  metric,
+            gdouble                value)
+{
+  target->history[metric][target->head] = MAX (0, value);
+}
+
+static void
+update_timer (LauncherMonitor *monitor)
+{
+  LauncherMonitorPrivate *priv;
+  priv = LAUNCHER_MONITOR_GET_PRIVATE (monitor);
+  
+  if (priv->processes != NULL && priv->sample_id == 0)
+    {
+      priv->sample_id = g_timeout_add_seconds (INTERVAL, (GSourceFunc) sample_action, monitor);
+    }
+  else if (priv->processes == NULL && priv->sample_id != 0)
+    {
+      g_source_remove (priv->sample_id);
+      priv->sample_id = 0;
+    }
+}
+
+guint
+launcher_monitor_get_n_targets (LauncherMonitor *monitor)
+{
+  return LAUNCHER_MONITOR_GET_PRIVATE (monitor)->targets->len;
+}
+
+GPid
+launcher_monitor_get_pid (LauncherMonitor *monitor,
+                          guint            index)
+{
+  LauncherMonitorPrivate *priv;
+  Target *target;
+  priv = LAUNCHER_MONITOR_GET_PRIVATE (monitor);
+  target = g_ptr_array_index (priv->targets, index);
+  return target->pid;
+}
+
+const gchar*
+launcher_monitor_get_name (LauncherMonitor *monitor,
+                           guint            index)
+{
+  LauncherMonitorPrivate *priv;
+  Target *target;
+  priv = LAUNCHER_MONITOR_GET_PRIVATE (monitor);
+  target = g_ptr_array_index (priv->targets, index);
+  return target->name;
+}
+
+/*
+ * Zero for a launched process, one for its children and so on.
+ */
+guint
+launcher_monitor_get_depth (LauncherMonitor *monitor,
+                            guint            index)
+{
+  LauncherMonitorPrivate *priv;
+  Target *target;
+  priv = LAUNCHER_MONITOR_GET_PRIVATE (monitor);
+  target = g_ptr_array_index (priv->targets, index);
+  return target->depth;
+}
+
+/*
+ * The latest sample of the metric.
+ */
+gdouble
+launcher_monitor_get_value (LauncherMonitor       *monitor,
+                            guint                  index,
+                            LauncherMonitorMetric  metric)
+{
+  LauncherMonitorPrivate *priv;
+  Target *target;
+  priv = LAUNCHER_MONITOR_GET_PRIVATE (monitor);
+  target = g_ptr_array_index (priv->targets, index);
+  return target->history[metric][(target->head + LAUNCHER_MONITOR_HISTORY - 1) % 
+                                 LAUNCHER_MONITOR_HISTORY];
+}
+
+/*
+ * Copies the samples of the metric into values, which has room for 
+ * LAUNCHER_MONITOR_HISTORY of them, oldest first. Returns how many there 
+ * are.
+ */
+guint
+launcher_monitor_get_history (LauncherMonitor       *monitor,
+                              guint                  index,
+                              LauncherMonitorMetric  metric,
+                              gdouble               *values)
+{
+  LauncherMonitorPrivate *priv;
+  Target *target;
+  guint first;
+  guint i;
+  
+  priv = LAUNCHER_MONITOR_GET_PRIVATE (monitor);
+  target = g_ptr_array_index (priv->targets, index);
+  
+  first = (target->head + LAUNCHER_MONITOR_HISTORY - target->n_samples) % LAUNCHER_MONITOR_HISTORY;
+  for (i = 0; i < target->n_samples; i++)
+    values[i] = target->history[metric][(first + i) % LAUNCHER_MONITOR_HISTORY];
+  
+  return target->n_samples;
+}
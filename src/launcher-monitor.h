@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_MONITOR_H__
+#define	__LAUNCHER_MONITOR_H__
+
+#include <gio/gio.h>
+#include "launcher-process.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_MONITOR_TYPE            (launcher_monitor_get_type ())
+#define LAUNCHER_MONITOR(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_MONITOR_TYPE, LauncherMonitor))
+#define LAUNCHER_MONITOR_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_MONITOR_TYPE, LauncherMonitorClass))
+#define IS_LAUNCHER_MONITOR(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_MONITOR_TYPE))
+#define IS_LAUNCHER_MONITOR_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_MONITOR_TYPE))
+
+#define LAUNCHER_MONITOR_HISTORY 120
+
+typedef struct _LauncherMonitor LauncherMonitor;
+typedef struct _LauncherMonitorClass LauncherMonitorClass;
+
+/*
+ * CPU is in percent of one core, RSS in KiB and the others per second 
+ * except for the number of threads.
+ */
+typedef enum
+{
+  LAUNCHER_MONITOR_CPU,
+  LAUNCHER_MONITOR_RSS,
+  LAUNCHER_MONITOR_THREADS,
+  LAUNCHER_MONITOR_READ_BYTES,
+  LAUNCHER_MONITOR_WRITE_BYTES,
+  LAUNCHER_MONITOR_CONTEXT_SWITCHES,
+  LAUNCHER_MONITOR_N_METRICS
+} LauncherMonitorMetric;
+
+struct _LauncherMonitor
+{
+  GObject parent_instance;
+};
+
+struct _LauncherMonitorClass
+{
+  GObjectClass parent_class;
+
+  void (*changed) (LauncherMonitor *monitor);
+};
+
+GType launcher_monitor_get_type (void) G_GNUC_CONST;
+
+LauncherMonitor*  launcher_monitor_new            (void);
+
+void              launcher_monitor_add_process    (LauncherMonitor       *monitor,
+                                                   LauncherProcess       *process);
+
+guint             launcher_monitor_get_n_targets  (LauncherMonitor       *monitor);
+GPid              launcher_monitor_get_pid        (LauncherMonitor       *monitor,
+                                                   guint                  index);
+const gchar*      launcher_monitor_get_name       (LauncherMonitor       *monitor,
+                                                   guint                  index);
+guint             launcher_monitor_get_depth      (LauncherMonitor       *monitor,
+                                                   guint                  index);
+gdouble           launcher_monitor_get_value      (LauncherMonitor       *monitor,
+                                                   guint                  index,
+                                                   LauncherMonitorMetric  metric);
+guint             launcher_monitor_get_history    (LauncherMonitor       *monitor,
+                                                   guint                  index,
+                                                   LauncherMonitorMetric  metric,
+                                                   gdouble               *values);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_MONITOR_H__ */
@@ -0,0 +1,331 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include "launcher-output-buffer.h"
+
+/*
+ * The buffer is a ring of fixed size chunks. Complete lines are copied into 
+ * the newest chunk and when the ring is full the oldest chunk is recycled, 
+ * so no matter how much a program writes the memory used stays bounded at 
+ * N_CHUNKS chunks of CHUNK_SIZE bytes and CHUNK_LINES line offsets. Empty 
+ * lines take no bytes, the line limit is what moves them on to the next 
+ * chunk.
+ */
+
+#define CHUNK_SIZE (64 * 1024)
+#define CHUNK_LINES (CHUNK_SIZE / 8)
+#define N_CHUNKS 64
+#define STDERR_FLAG (1u << 31)
+
+static void launcher_output_buffer_class_init  (LauncherOutputBufferClass *klass);
+static void launcher_output_buffer_init        (LauncherOutputBuffer      *buffer);
+static void launcher_output_buffer_finalize    (LauncherOutputBuffer      *buffer);
+
+typedef struct
+{
+  gchar  *data;
+  guint   used;
+  GArray *lines;
+} Chunk;
+
+static void commit_line                        (LauncherOutputBuffer      *buffer,
+                                                const gchar               *text,
+                                                gsize                      length,
+                                                gboolean                   is_stderr);
+static Chunk* next_chunk                       (LauncherOutputBuffer      *buffer);
+
+#define LAUNCHER_OUTPUT_BUFFER_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_OUTPUT_BUFFER_TYPE, LauncherOutputBufferPrivate))
+
+typedef struct _LauncherOutputBufferPrivate LauncherOutputBufferPrivate;
+
+struct _LauncherOutputBufferPrivate
+{
+  Chunk    chunks[N_CHUNKS];
+  guint    head;
+  guint    count;
+  guint    n_lines;
+  guint64  dropped_lines;
+  GString *pending[2];
+};
+
+enum
+{
+  CHANGED,
+  LAST_SIGNAL
+};
+
+static guint launcher_output_buffer_signals[LAST_SIGNAL] = { 0 };
+
+G_DEFINE_TYPE (LauncherOutputBuffer, launcher_output_buffer, G_TYPE_OBJECT)
+
+static void 
+launcher_output_buffer_class_init (LauncherOutputBufferClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  launcher_output_buffer_signals[CHANGED] =
+    g_signal_new ("changed", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherOutputBufferClass, changed),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_output_buffer_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherOutputBufferPrivate));
+}
+
+static void
+launcher_output_buffer_init (LauncherOutputBuffer *buffer)
+{
+  LauncherOutputBufferPrivate *priv;
+  gint i;
+
+  priv = LAUNCHER_OUTPUT_BUFFER_GET_PRIVATE (buffer);
+
+  for (i = 0; i < N_CHUNKS; i++)
+    {
+      priv->chunks[i].data = NULL;
+      priv->chunks[i].used = 0;
+      priv->chunks[i].lines = NULL;
+    }
+
+  priv->head = 0;
+  priv->count = 0;
+  priv->n_lines = 0;
+  priv->dropped_lines = 0;
+  priv->pending[0] = g_string_new (NULL);
+  priv->pending[1] = g_string_new (NULL);
+}
+
+static void
+launcher_output_buffer_finalize (LauncherOutputBuffer *buffer)
+{
+  LauncherOutputBufferPrivate *priv;
+  gint i;
+
+  priv = LAUNCHER_OUTPUT_BUFFER_GET_PRIVATE (buffer);
+
+  for (i = 0; i < N_CHUNKS; i++)
+    {
+      g_free (priv->chunks[i].data);
+      if (priv->chunks[i].lines != NULL)
+        g_array_free (priv->chunks[i].lines, TRUE);
+    }
+
+  g_string_free (priv->pending[0], TRUE);
+  g_string_free (priv->pending[1], TRUE);
+
+  G_OBJECT_CLASS (launcher_output_buffer_parent_class)->finalize (G_OBJECT (buffer));
+}
+
+LauncherOutputBuffer*
+launcher_output_buffer_new (void)
+{
+  return LAUNCHER_OUTPUT_BUFFER (g_object_new (launcher_output_buffer_get_type (), NULL));
+}
+
+void
+launcher_output_buffer_append (LauncherOutputBuffer *buffer,
+                               const gchar          *data,
+                               gsize                 length,
+                               gboolean              is_stderr)
+{
+  LauncherOutputBufferPrivate *priv;
+  GString *pending;
+  
+  priv = LAUNCHER_OUTPUT_BUFFER_GET_PRIVATE (buffer);
+  pending = priv->pending[is_stderr ? 1 : 0];
+  
+  while (length > 0)
+    {
+      const gchar *newline;
+      gsize segment;
+      
+      newline = memchr (data, '\n', length);
+      if (newline == NULL)
+        {
+          g_string_append_len (pending, data, length);
+          if (pending->len >= CHUNK_SIZE)
+            {
+              commit_line (buffer, pending->str, pending->len, is_stderr);
+              g_string_truncate (pending, 0);
+            }
+          break;
+        }
+      
+      segment = newline - data;
+      if (pending->len > 0)
+        {
+          g_string_append_len (pending, data, segment);
+          commit_line (buffer, pending->str, pending->len, is_stderr);
+          g_string_truncate (pending, 0);
+        }
+      else
+        {
+          commit_line (buffer, data, segment, is_stderr);
+        }
+
+      data += segment + 1;
+      length -= segment + 1;
+    }
+
+  g_signal_emit_by_name ((gpointer) buffer, "changed");
+}
+
+void
+launcher_output_buffer_flush (LauncherOutputBuffer *buffer)
+{
+  LauncherOutputBufferPrivate *priv;
+  gint i;
+  
+  priv = LAUNCHER_OUTPUT_BUFFER_GET_PRIVATE (buffer);
+  
+  for (i = 0; i < 2; i++)
+    {
+      if (priv->pending[i]->len > 0)
+        {
+          commit_line (buffer, priv->pending[i]->str, priv->pending[i]->len, i == 1);
+          g_string_truncate (priv->pending[i], 0);
+        }
+    }
+
+  g_signal_emit_by_name ((gpointer) buffer, "changed");
+}
+
+static void
+commit_line (LauncherOutputBuffer *buffer,
+             const gchar          *text,
+             gsize                 length,
+             gboolean              is_stderr)
+{
+  LauncherOutputBufferPrivate *priv;
+  Chunk *chunk = NULL;
+  guint32 entry;
+  
+  priv = LAUNCHER_OUTPUT_BUFFER_GET_PRIVATE (buffer);
+
+  if (length > 0 && text[length - 1] == '\r')
+    length--;
+  if (length > CHUNK_SIZE)
+    length = CHUNK_SIZE;
+  
+  if (priv->count > 0)
+    chunk = &priv->chunks[(priv->head + priv->count - 1) % N_CHUNKS];
+  
+  if (chunk == NULL || chunk->used + length > CHUNK_SIZE || 
+      chunk->lines->len >= CHUNK_LINES)
+    chunk = next_chunk (buffer);
+  
+  memcpy (chunk->data + chunk->used, text, length);
+  entry = chunk->used | (is_stderr ? STDERR_FLAG : 0);
+  g_array_append_val (chunk->lines, entry);
+  chunk->used += length;
+  priv->n_lines++;
+}
+
+static Chunk*
+next_chunk (LauncherOutputBuffer *buffer)
+{
+  LauncherOutputBufferPrivate *priv;
+  Chunk *chunk;
+  
+  priv = LAUNCHER_OUTPUT_BUFFER_GET_PRIVATE (buffer);
+  
+  if (priv->count < N_CHUNKS)
+    {
+      chunk = &priv->chunks[(priv->head + priv->count) % N_CHUNKS];
+      priv->count++;
+    }
+  else
+    {
+      chunk = &priv->chunks[priv->head];
+      priv->head = (priv->head + 1) % N_CHUNKS;
+      priv->n_lines -= chunk->lines->len;
+      priv->dropped_lines += chunk->lines->len;
+    }
+  
+  if (chunk->data == NULL)
+    {
+      chunk->data = g_malloc (CHUNK_SIZE);
+      chunk->lines = g_array_new (FALSE, FALSE, sizeof (guint32));
+    }
+  
+  chunk->used = 0;
+  g_array_set_size (chunk->lines, 0);
+  
+  return chunk;
+}
+
+guint
+launcher_output_buffer_get_n_lines (LauncherOutputBuffer *buffer)
+{
+  return LAUNCHER_OUTPUT_BUFFER_GET_PRIVATE (buffer)->n_lines;
+}
+
+guint64
+launcher_output_buffer_get_dropped_lines (LauncherOutputBuffer *buffer)
+{
+  return LAUNCHER_OUTPUT_BUFFER_GET_PRIVATE (buffer)->dropped_lines;
+}
+
+const gchar*
+launcher_output_buffer_get_line (LauncherOutputBuffer *buffer,
+                                 guint                 index,
+                                 gsize                *length,
+                                 gboolean             *is_stderr)
+{
+  LauncherOutputBufferPrivate *priv;
+  guint i;
+  
+  priv = LAUNCHER_OUTPUT_BUFFER_GET_PRIVATE (buffer);
+  
+  for (i = 0; i < priv->count; i++)
+    {
+      Chunk *chunk = &priv->chunks[(priv->head + i) % N_CHUNKS];
+      guint32 entry;
+      guint start;
+      guint end;
+
+      if (index >= chunk->lines->len)
+        {
+          index -= chunk->lines->len;
+          continue;
+        }
+      
+      entry = g_array_index (chunk->lines, guint32, index);
+      start = entry & ~STDERR_FLAG;
+      if (index + 1 < chunk->lines->len)
+        end = g_array_index (chunk->lines, guint32, index + 1) & ~STDERR_FLAG;
+      else
+        end = chunk->used;
+      
+      if (length != NULL)
+        *length = end - start;
+      if (is_stderr != NULL)
+        *is_stderr = (entry & STDERR_FLAG) != 0;
+      
+      return chunk->data + start;
+    }
+
+  if (length != NULL)
+    *length = 0;
+  return NULL;
+}
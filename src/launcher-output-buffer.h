@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_OUTPUT_BUFFER_H__
+#define	__LAUNCHER_OUTPUT_BUFFER_H__
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_OUTPUT_BUFFER_TYPE            (launcher_output_buffer_get_type ())
+#define LAUNCHER_OUTPUT_BUFFER(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_OUTPUT_BUFFER_TYPE, LauncherOutputBuffer))
+#define LAUNCHER_OUTPUT_BUFFER_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_OUTPUT_BUFFER_TYPE, LauncherOutputBufferClass))
+#define IS_LAUNCHER_OUTPUT_BUFFER(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_OUTPUT_BUFFER_TYPE))
+#define IS_LAUNCHER_OUTPUT_BUFFER_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_OUTPUT_BUFFER_TYPE))
+
+typedef struct _LauncherOutputBuffer LauncherOutputBuffer;
+typedef struct _LauncherOutputBufferClass LauncherOutputBufferClass;
+
+struct _LauncherOutputBuffer
+{
+  GObject parent_instance;
+};
+
+struct _LauncherOutputBufferClass
+{
+  GObjectClass parent_class;
+
+  void (*changed) (LauncherOutputBuffer *buffer);
+};
+
+GType launcher_output_buffer_get_type (void) G_GNUC_CONST;
+
+LauncherOutputBuffer*  launcher_output_buffer_new               (void);
+
+void                   launcher_output_buffer_append            (LauncherOutputBuffer *buffer,
+                                                                 const gchar          *data,
+                                                                 gsize                 length,
+                                                                 gboolean              is_stderr);
+void                   launcher_output_buffer_flush             (LauncherOutputBuffer *buffer);
+guint                  launcher_output_buffer_get_n_lines       (LauncherOutputBuffer *buffer);
+guint64                launcher_output_buffer_get_dropped_lines (LauncherOutputBuffer *buffer);
+const gchar*           launcher_output_buffer_get_line          (LauncherOutputBuffer *buffer,
+                                                                 guint                 index,
+                                                                 gsize                *length,
+                                                                 gboolean             *is_stderr);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_OUTPUT_BUFFER_H__ */
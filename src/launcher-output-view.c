@@ -0,0 +1,507 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include "launcher-output-view.h"
+
+#define PADDING 4
+#define SCROLL_LINES 3
+
+static void launcher_output_view_class_init  (LauncherOutputViewClass *klass);
+static void launcher_output_view_init        (LauncherOutputView      *output_view);
+static void launcher_output_view_finalize    (LauncherOutputView      *output_view);
+
+static void disconnect_process               (LauncherOutputView      *output_view);
+static void buffer_changed_action            (LauncherOutputView      *output_view);
+static gboolean tick_action                  (GtkWidget               *drawing_area,
+                                              GdkFrameClock           *frame_clock,
+                                              LauncherOutputView      *output_view);
+static void update_adjustment                (LauncherOutputView      *output_view);
+static void update_status                    (LauncherOutputView      *output_view);
+static gboolean draw_action                  (GtkWidget               *drawing_area,
+                                              cairo_t                 *cr,
+                                              LauncherOutputView      *output_view);
+static gboolean scroll_action                (GtkWidget               *drawing_area,
+                                              GdkEventScroll          *event,
+                                              LauncherOutputView      *output_view);
+static void size_allocate_action             (LauncherOutputView      *output_view);
+static gint get_line_height                  (LauncherOutputView      *output_view);
+static gchar* make_valid                     (const gchar             *text,
+                                              gsize                    length);
+
+#define LAUNCHER_OUTPUT_VIEW_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_OUTPUT_VIEW_TYPE, LauncherOutputViewPrivate))
+
+typedef struct _LauncherOutputViewPrivate LauncherOutputViewPrivate;
+
+struct _LauncherOutputViewPrivate
+{
+  LauncherProcess      *process;
+  GtkWidget            *status_label;
+  GtkWidget            *drawing_area;
+  GtkAdjustment        *adjustment;
+  PangoFontDescription *font;
+  gint                  line_height;
+  guint64               dropped_lines;
+  gulong                changed_id;
+  gulong                finished_id;
+  gulong                regression_id;
+  guint                 tick_id;
+};
+
+G_DEFINE_TYPE (LauncherOutputView, launcher_output_view, GTK_TYPE_BOX)
+
+static void
+launcher_output_view_class_init (LauncherOutputViewClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_output_view_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherOutputViewPrivate));
+}
+
+static void
+launcher_output_view_init (LauncherOutputView *output_view)
+{
+  LauncherOutputViewPrivate *priv;
+  GtkWidget *hbox;
+  GtkWidget *scrollbar;
+
+  priv = LAUNCHER_OUTPUT_VIEW_GET_PRIVATE (output_view);
+  priv->process = NULL;
+  priv->line_height = 0;
+  priv->dropped_lines = 0;
+  priv->changed_id = 0;
+  priv->finished_id = 0;
+  priv->regression_id = 0;
+  priv->tick_id = 0;
+  priv->font = pango_font_description_from_string ("Monospace");
+
+  gtk_orientable_set_orientation (GTK_ORIENTABLE (output_view), GTK_ORIENTATION_VERTICAL);
+  
+  priv->status_label = gtk_label_new (NULL);
+  gtk_misc_set_alignment (GTK_MISC (priv->status_label), 0, .5);
+  gtk_misc_set_padding (GTK_MISC (priv->status_label), PADDING, 2);
+  gtk_box_pack_start (GTK_BOX (output_view), priv->status_label, FALSE, FALSE, 0);
+
+  priv->adjustment = gtk_adjustment_new (0, 0, 0, 1, 1, 1);
+  g_object_ref_sink (priv->adjustment);
+  
+  priv->drawing_area = gtk_drawing_area_new ();
+  gtk_widget_add_events (priv->drawing_area, GDK_SCROLL_MASK | GDK_SMOOTH_SCROLL_MASK);
+  scrollbar = gtk_scrollbar_new (GTK_ORIENTATION_VERTICAL, priv->adjustment);
+
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
+  gtk_box_pack_start (GTK_BOX (hbox), priv->drawing_area, TRUE, TRUE, 0);
+  gtk_box_pack_start (GTK_BOX (hbox), scrollbar, FALSE, FALSE, 0);
+  gtk_box_pack_start (GTK_BOX (output_view), hbox, TRUE, TRUE, 0);
+  
+  g_signal_connect (G_OBJECT (priv->drawing_area), "draw",
+                    G_CALLBACK (draw_action), output_view);
+  g_signal_connect (G_OBJECT (priv->drawing_area), "scroll-event",
+                    G_CALLBACK (scroll_action), output_view);
+  g_signal_connect_swapped (G_OBJECT (priv->drawing_area), "size-allocate",
+                            G_CALLBACK (size_allocate_action), output_view);
+  g_signal_connect_swapped (G_OBJECT (priv->adjustment), "value-changed",
+                            G_CALLBACK (gtk_widget_queue_draw), priv->drawing_area);
+}
+
+static void
+launcher_output_view_finalize (LauncherOutputView *output_view)
+{
+  LauncherOutputViewPrivate *priv;
+  priv = LAUNCHER_OUTPUT_VIEW_GET_PRIVATE (output_view);
+  disconnect_process (output_view);
+  g_object_unref (priv->adjustment);
+  pango_font_description_free (priv->font);
+  G_OBJECT_CLASS (launcher_output_view_parent_class)->finalize (G_OBJECT (output_view));
+}
+
+GtkWidget*
+launcher_output_view_new (void)
+{
+  return g_object_new (launcher_output_view_get_type (), NULL);
+}
+
+/*
+ * A new run of the project takes the place of the previous one, the view 
+ * follows the end of the output until it is scrolled back.
+ */
+void
+launcher_output_view_set_process (LauncherOutputView *output_view,
+                                  LauncherProcess    *process)
+{
+  LauncherOutputViewPrivate *priv;
+  LauncherOutputBuffer *buffer;
+
+  priv = LAUNCHER_OUTPUT_VIEW_GET_PRIVATE (output_view);
+  
+  if (priv->process == process)
+    return;
+  
+  disconnect_process (output_view);
+  
+  priv->process = g_object_ref (process);
+  buffer = launcher_process_get_output (process);
+  priv->dropped_lines = launcher_output_buffer_get_dropped_lines (buffer);
+  
+  priv->changed_id = g_signal_connect_swapped (G_OBJECT (buffer), "changed",
+                                               G_CALLBACK (buffer_changed_action), output_view);
+  priv->finished_id = g_signal_connect_swapped (G_OBJECT (process), "finished",
+                                                G_CALLBACK (update_status), output_view);
+  priv->regression_id = g_signal_connect_swapped (G_OBJECT (process), "regression",
+                                                  G_CALLBACK (update_status), output_view);
+
+  gtk_adjustment_set_value (priv->adjustment, 0);
+  update_adjustment (output_view);
+  update_status (output_view);
+  gtk_widget_queue_draw (priv->drawing_area);
+}
+
+LauncherProcess*
+launcher_output_view_get_process (LauncherOutputView *output_view)
+{
+  return LAUNCHER_OUTPUT_VIEW_GET_PRIVATE (output_view)->process;
+}
+
+static void
+disconnect_process (LauncherOutputView *output_view)
+{
+  LauncherOutputViewPrivate *priv;
+  priv = LAUNCHER_OUTPUT_VIEW_GET_PRIVATE (output_view);
+  
+  if (priv->tick_id != 0)
+    {
+      gtk_widget_remove_tick_callback (priv->drawing_area, priv->tick_id);
+      priv->tick_id = 0;
+    }
+
+  if (priv->process == NULL)
+    return;
+  
+  g_signal_handler_disconnect (launcher_process_get_output (priv->process), priv->changed_id);
+  g_signal_handler_disconnect (priv->process, priv->finished_id);
+  g_signal_handler_disconnect (priv->process, priv->regression_id);
+  g_object_unref (priv->process);
+  priv->process = NULL;
+}
+
+/*
+ * Programs can write far more lines per second than is worth drawing, so 
+ * appends only schedule a tick and all the work is done once per frame.
+ */
+static void
+buffer_changed_action (LauncherOutputView *output_view)
+{
+  LauncherOutputViewPrivate *priv;
+  priv = LAUNCHER_OUTPUT_VIEW_GET_PRIVATE (output_view);
+
+  if (priv->tick_id != 0)
+    return;
+    
+  priv->tick_id = gtk_widget_add_tick_callback (priv->drawing_area, 
+                                                (GtkTickCallback) tick_action,
+                                                output_view, NULL);
+}
+
+static gboolean
+tick_action (GtkWidget          *drawing_area,
+             GdkFrameClock      *frame_clock,
+             LauncherOutputView *output_view)
+{
+  LauncherOutputViewPrivate *priv;
+  priv = LAUNCHER_OUTPUT_VIEW_GET_PRIVATE (output_view);
+  priv->tick_id = 0;
+  update_adjustment (output_view);
+  gtk_widget_queue_draw (drawing_area);
+  return G_SOURCE_REMOVE;
+}
+
+static void
+update_adjustment (LauncherOutputView *output_view)
+{
+  LauncherOutputViewPrivate *priv;
+  LauncherOutputBuffer *buffer;
+  gdouble value;
+  gdouble page_size;
+  gdouble upper;
+  gboolean follow;
+  guint64 dropped_lines;
+  guint n_lines;
+  gint rows;
+
+  priv = LAUNCHER_OUTPUT_VIEW_GET_PRIVATE (output_view);
+  
+  if (priv->process == NULL)
+    return;
+  
+  buffer = launcher_process_get_output (priv->process);
+  n_lines = launcher_output_buffer_get_n_lines (buffer);
+  dropped_lines = launcher_output_buffer_get_dropped_lines (buffer);
+
+  rows = MAX (1, gtk_widget_get_allocated_height (priv->drawing_area) / get_line_height (output_view));
+
+  value = gtk_adjustment_get_value (priv->adjustment);
+  page_size = gtk_adjustment_get_page_size (priv->adjustment);
+  upper = gtk_adjustment_get_upper (priv->adjustment);
+  follow = value + page_size >= upper;
+  
+  if (follow)
+    value = MAX (0, (gdouble) n_lines - rows);
+  else
+    value = MAX (0, value - (gdouble) (dropped_lines - priv->dropped_lines));
+
+  priv->dropped_lines = dropped_lines;
+
+  gtk_adjustment_configure (priv->adjustment, value, 0, n_lines, 1, rows, rows);
+}
+
+static void
+update_status (LauncherOutputView *output_view)
+{
+  LauncherOutputViewPrivate *priv;
+  LauncherConfig *config;
+  const LauncherHistoryRegression *regression;
+  const LauncherCounterValues *counters;
+  const gchar *executable;
+  gdouble seconds;
+  gchar *text = NULL;
+
+  priv = LAUNCHER_OUTPUT_VIEW_GET_PRIVATE (output_view);
+  
+  config = launcher_process_get_config (priv->process);
+  executable = launcher_config_get_executable (config);
+  seconds = launcher_process_get_run_time (priv->process) / (gdouble) G_USEC_PER_SEC;
+  
+  switch (launcher_process_get_state (priv->process))
+    {
+    case LAUNCHER_PROCESS_STARTING:
+    case LAUNCHER_PROCESS_RUNNING:
+      text = g_strdup_printf ("%s (pid %d) is running", executable,
+                              launcher_process_get_pid (priv->process));
+      break;
+    case LAUNCHER_PROCESS_EXITED:
+      text = g_strdup_printf ("%s exited with status %d after %.2f seconds", executable,
+                              launcher_process_get_exit_status (priv->process), seconds);
+      break;
+    case LAUNCHER_PROCESS_SIGNALED:
+      text = g_strdup_printf ("%s was terminated by signal %d after %.2f seconds", executable,
+                              launcher_process_get_exit_status (priv->process), seconds);
+      break;
+    case LAUNCHER_PROCESS_FAILED:
+      text = g_strdup_printf ("%s failed", executable);
+      break;
+    }
+  
+  counters = launcher_process_get_counters (priv->process);
+  if (counters != NULL)
+    {
+      gchar *summary;
+      summary = launcher_counter_values_format (counters);
+      if (summary != NULL)
+        {
+          gchar *full;
+          full = g_strdup_printf ("%s - %s", text, summary);
+          g_free (text);
+          text = full;
+        }
+      g_free (summary);
+    }
+
+  if (launcher_process_get_launch_latency (priv->process) >= 0)
+    {
+      gchar *latency;
+      gint64 cold_latency = launcher_process_get_cold_latency (priv->process);
+      if (launcher_process_get_warm (priv->process) && cold_latency >= 0)
+        latency = g_strdup_printf ("%s - first output after %" G_GINT64_FORMAT " ms warm, "
+                                   "%" G_GINT64_FORMAT " ms cold on average", text, 
+                                   launcher_process_get_launch_latency (priv->process) / 1000,
+                                   cold_latency / 1000);
+      else
+        latency = g_strdup_printf ("%s - first output after %" G_GINT64_FORMAT " ms %s", text, 
+                                   launcher_process_get_launch_latency (priv->process) / 1000,
+                                   launcher_process_get_warm (priv->process) ? "warm" : "cold");
+      g_free (text);
+      text = latency;
+    }
+
+  if (launcher_process_get_restart_latency (priv->process) >= 0)
+    {
+      gchar *restarted;
+      restarted = g_strdup_printf ("%s - restarted %" G_GINT64_FORMAT " ms after the change", text, 
+                                   launcher_process_get_restart_latency (priv->process) / 1000);
+      g_free (text);
+      text = restarted;
+    }
+
+  regression = launcher_process_get_regression (priv->process);
+  if (regression != NULL && regression->detected)
+    {
+      gchar *warning;
+      warning = g_strdup_printf ("%s - %.0f%% slower than the recent baseline (p = %.4f)", 
+                                 text, (regression->slowdown - 1) * 100, regression->p_value);
+      g_free (text);
+      text = warning;
+    }
+
+  gtk_label_set_text (GTK_LABEL (priv->status_label), text);
+  g_free (text);
+}
+
+static gboolean
+draw_action (GtkWidget          *drawing_area,
+             cairo_t            *cr,
+             LauncherOutputView *output_view)
+{
+  LauncherOutputViewPrivate *priv;
+  LauncherOutputBuffer *buffer;
+  GtkStyleContext *context;
+  PangoLayout *layout;
+  GdkRGBA color;
+  guint first;
+  guint n_lines;
+  gint line_height;
+  gint height;
+  gint i;
+
+  priv = LAUNCHER_OUTPUT_VIEW_GET_PRIVATE (output_view);
+  
+  if (priv->process == NULL)
+    return FALSE;
+  
+  buffer = launcher_process_get_output (priv->process);
+  n_lines = launcher_output_buffer_get_n_lines (buffer);
+  first = (guint) gtk_adjustment_get_value (priv->adjustment);
+  line_height = get_line_height (output_view);
+  height = gtk_widget_get_allocated_height (drawing_area);
+  
+  context = gtk_widget_get_style_context (drawing_area);
+  gtk_style_context_get_color (context, GTK_STATE_FLAG_NORMAL, &color);
+
+  layout = gtk_widget_create_pango_layout (drawing_area, NULL);
+  pango_layout_set_font_description (layout, priv->font);
+
+  for (i = 0; i * line_height < height && first + i < n_lines; i++)
+    {
+      const gchar *text;
+      gboolean is_stderr;
+      gsize length;
+      
+      text = launcher_output_buffer_get_line (buffer, first + i, &length, &is_stderr);
+      
+      if (g_utf8_validate (text, length, NULL))
+        {
+          pango_layout_set_text (layout, text, length);
+        }
+      else
+        {
+          gchar *valid = make_valid (text, length);
+          pango_layout_set_text (layout, valid, -1);
+          g_free (valid);
+        }
+      
+      if (is_stderr)
+        cairo_set_source_rgb (cr, 0.8, 0.1, 0.1);
+      else
+        gdk_cairo_set_source_rgba (cr, &color);
+      
+      cairo_move_to (cr, PADDING, i * line_height);
+      pango_cairo_show_layout (cr, layout);
+    }
+  
+  g_object_unref (layout);
+  return FALSE;
+}
+
+static gboolean
+scroll_action (GtkWidget          *drawing_area,
+               GdkEventScroll     *event,
+               LauncherOutputView *output_view)
+{
+  LauncherOutputViewPrivate *priv;
+  gdouble value;
+  gdouble delta = 0;
+
+  priv = LAUNCHER_OUTPUT_VIEW_GET_PRIVATE (output_view);
+  
+  switch (event->direction)
+    {
+    case GDK_SCROLL_UP:
+      delta = -SCROLL_LINES;
+      break;
+    case GDK_SCROLL_DOWN:
+      delta = SCROLL_LINES;
+      break;
+    case GDK_SCROLL_SMOOTH:
+      delta = event->delta_y * SCROLL_LINES;
+      break;
+    default:
+      return FALSE;
+    }
+
+  value = gtk_adjustment_get_value (priv->adjustment) + delta;
+  value = CLAMP (value, 0, gtk_adjustment_get_upper (priv->adjustment) - 
+                           gtk_adjustment_get_page_size (priv->adjustment));
+  gtk_adjustment_set_value (priv->adjustment, value);
+  return TRUE;
+}
+
+static void
+size_allocate_action (LauncherOutputView *output_view)
+{
+  update_adjustment (output_view);
+}
+
+static gint
+get_line_height (LauncherOutputView *output_view)
+{
+  LauncherOutputViewPrivate *priv;
+  priv = LAUNCHER_OUTPUT_VIEW_GET_PRIVATE (output_view);
+
+  if (priv->line_height == 0)
+    {
+      PangoLayout *layout;
+      layout = gtk_widget_create_pango_layout (priv->drawing_area, "X");
+      pango_layout_set_font_description (layout, priv->font);
+      pango_layout_get_pixel_size (layout, NULL, &priv->line_height);
+      g_object_unref (layout);
+      priv->line_height = MAX (1, priv->line_height);
+    }
+
+  return priv->line_height;
+}
+
+static gchar*
+make_valid (const gchar *text,
+            gsize        length)
+{
+  GString *string;
+  const gchar *end;
+  
+  string = g_string_sized_new (length);
+  
+  while (!g_utf8_validate (text, length, &end))
+    {
+      g_string_append_len (string, text, end - text);
+      g_string_append_c (string, '?');
+      length -= end - text + 1;
+      text = end + 1;
+    }
+
+  g_string_append_len (string, text, length);
+  return g_string_free (string, FALSE);
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "launcher-output.h"
+#include "launcher-output-view.h"
+
+static void launcher_output_class_init  (LauncherOutputClass *klass);
+static void launcher_output_init        (LauncherOutput      *output);
+
+static GtkWidget* find_view             (LauncherOutput      *output,
+                                         gpointer             project);
+static void update_tab                  (LauncherOutput      *output,
+                                         GtkWidget           *view);
+static void process_finished_action     (LauncherOutput      *output,
+                                         LauncherProcess     *process);
+static gchar* get_process_label         (LauncherProcess     *process);
+
+#define LAUNCHER_OUTPUT_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_OUTPUT_TYPE, LauncherOutputPrivate))
+
+typedef struct _LauncherOutputPrivate LauncherOutputPrivate;
+
+struct _LauncherOutputPrivate
+{
+  GtkWidget *notebook;
+};
+
+G_DEFINE_TYPE (LauncherOutput, launcher_output, GTK_TYPE_BOX)
+
+static void
+launcher_output_class_init (LauncherOutputClass *klass)
+{
+  g_type_class_add_private (klass, sizeof (LauncherOutputPrivate));
+}
+
+/*
+ * Every project gets a tab of its own whose label shows the state of its 
+ * last run. The tabs only show up once there is more than one project.
+ */
+static void
+launcher_output_init (LauncherOutput *output)
+{
+  LauncherOutputPrivate *priv;
+  priv = LAUNCHER_OUTPUT_GET_PRIVATE (output);
+
+  gtk_orientable_set_orientation (GTK_ORIENTABLE (output), GTK_ORIENTATION_VERTICAL);
+  
+  priv->notebook = gtk_notebook_new ();
+  gtk_notebook_set_scrollable (GTK_NOTEBOOK (priv->notebook), TRUE);
+  gtk_notebook_set_show_border (GTK_NOTEBOOK (priv->notebook), FALSE);
+  gtk_notebook_set_show_tabs (GTK_NOTEBOOK (priv->notebook), FALSE);
+  gtk_box_pack_start (GTK_BOX (output), priv->notebook, TRUE, TRUE, 0);
+}
+
+GtkWidget*
+launcher_output_new (void)
+{
+  return g_object_new (launcher_output_get_type (), NULL);
+}
+
+/*
+ * A new process for a project takes the place of the previous one in the 
+ * tab of the project, which is brought to the front.
+ */
+void
+launcher_output_set_process (LauncherOutput  *output,
+                             LauncherProcess *process)
+{
+  LauncherOutputPrivate *priv;
+  LauncherProcess *previous;
+  GtkWidget *view;
+  gpointer project;
+
+  priv = LAUNCHER_OUTPUT_GET_PRIVATE (output);
+  
+  project = launcher_config_get_project (launcher_process_get_config (process));
+  
+  view = find_view (output, project);
+  if (view == NULL)
+    {
+      GtkWidget *label;
+      view = launcher_output_view_new ();
+      label = gtk_label_new (NULL);
+      g_object_set_data (G_OBJECT (view), "project", project);
+      gtk_notebook_append_page (GTK_NOTEBOOK (priv->notebook), view, label);
+      gtk_widget_show (label);
+      gtk_widget_show_all (view);
+    }
+  
+  previous = launcher_output_view_get_process (LAUNCHER_OUTPUT_VIEW (view));
+  if (previous != process)
+    {
+      if (previous != NULL)
+        g_signal_handlers_disconnect_by_func (previous, process_finished_action, output);
+      g_signal_connect_object (G_OBJECT (process), "finished",
+                               G_CALLBACK (process_finished_action), output, G_CONNECT_SWAPPED);
+      launcher_output_view_set_process (LAUNCHER_OUTPUT_VIEW (view), process);
+    }
+  
+  update_tab (output, view);
+  
+  gtk_notebook_set_show_tabs (GTK_NOTEBOOK (priv->notebook), 
+                              gtk_notebook_get_n_pages (GTK_NOTEBOOK (priv->notebook)) > 1);
+  gtk_notebook_set_current_page (GTK_NOTEBOOK (priv->notebook), 
+                                 gtk_notebook_page_num (GTK_NOTEBOOK (priv->notebook), view));
+}
+
+/*
+ * The process of the tab in front, or NULL when nothing was launched yet.
+ */
+LauncherProcess*
+launcher_output_get_process (LauncherOutput *output)
+{
+  LauncherOutputPrivate *priv;
+  GtkWidget *view;
+  gint page;
+  
+  priv = LAUNCHER_OUTPUT_GET_PRIVATE (output);
+  
+  page = gtk_notebook_get_current_page (GTK_NOTEBOOK (priv->notebook));
+  if (page < 0)
+    return NULL;
+  
+  view = gtk_notebook_get_nth_page (GTK_NOTEBOOK (priv->notebook), page);
+  return launcher_output_view_get_process (LAUNCHER_OUTPUT_VIEW (view));
+}
+
+static GtkWidget*
+find_view (LauncherOutput *output,
+           gpointer        project)
+{
+  LauncherOutputPrivate *priv;
+  gint n_pages;
+  gint i;
+  
+  priv = LAUNCHER_OUTPUT_GET_PRIVATE (output);
+  
+  n_pages = gtk_notebook_get_n_pages (GTK_NOTEBOOK (priv->notebook));
+  for (i = 0; i < n_pages; i++)
+    {
+      GtkWidget *view;
+      view = gtk_notebook_get_nth_page (GTK_NOTEBOOK (priv->notebook), i);
+      if (g_object_get_data (G_OBJECT (view), "project") == project)
+        return view;
+    }
+  
+  return NULL;
+}
+
+static void
+update_tab (LauncherOutput *output,
+            GtkWidget      *view)
+{
+  LauncherOutputPrivate *priv;
+  LauncherProcess *process;
+  GtkWidget *label;
+  gchar *text;
+  
+  priv = LAUNCHER_OUTPUT_GET_PRIVATE (output);
+  
+  process = launcher_output_view_get_process (LAUNCHER_OUTPUT_VIEW (view));
+  label = gtk_notebook_get_tab_label (GTK_NOTEBOOK (priv->notebook), view);
+  
+  text = get_process_label (process);
+  gtk_label_set_text (GTK_LABEL (label), text);
+  g_free (text);
+}
+
+static void
+process_finished_action (LauncherOutput  *output,
+                         LauncherProcess *process)
+{
+  GtkWidget *view;
+  
+  view = find_view (output, launcher_config_get_project (launcher_process_get_config (process)));
+  if (view != NULL && 
+      launcher_output_view_get_process (LAUNCHER_OUTPUT_VIEW (view)) == process)
+    update_tab (output, view);
+}
+
+static gchar*
+get_process_label (LauncherProcess *process)
+{
+  const gchar *state = NULL;
+
+  switch (launcher_process_get_state (process))
+    {
+    case LAUNCHER_PROCESS_STARTING:
+    case LAUNCHER_PROCESS_RUNNING:
+      state = "running";
+      break;
+    case LAUNCHER_PROCESS_EXITED:
+      state = launcher_process_get_exit_status (process) == 0 ? "exited" : "failed";
+      break;
+    case LAUNCHER_PROCESS_SIGNALED:
+      state = "killed";
+      break;
+    case LAUNCHER_PROCESS_FAILED:
+      state = "failed";
+      break;
+    }
+  
+  return g_strdup_printf ("%s (%s)", launcher_config_get_project_name (launcher_process_get_config (process)), state);
+}
@@ -24,6 +24,13 @@
 #include "launcher-menu.h"
 #include "launcher-project-properties.h"
 #include "launcher-projects-popup.h"
+#include "launcher-output.h"
+#include "launcher-benchmark-view.h"
+#include "launcher-sweep-view.h"
+#include "launcher-jobs-view.h"
+#include "launcher-monitor-view.h"
+#include "launcher-crash-view.h"
+#include "launcher-reports.h"
 
 G_MODULE_EXPORT void activate   (CodeSlayer *codeslayer);
 G_MODULE_EXPORT void deactivate (CodeSlayer *codeslayer);
@@ -31,6 +38,13 @@ G_MODULE_EXPORT void deactivate (CodeSlayer *codeslayer);
 static GtkWidget *menu;
 static GtkWidget *project_properties;
 static GtkWidget *projects_popup;
+static GtkWidget *output;
+static GtkWidget *benchmark_view;
+static GtkWidget *sweep_view;
+static GtkWidget *jobs_view;
+static GtkWidget *monitor_view;
+static GtkWidget *crash_view;
+static GtkWidget *reports;
 static LauncherEngine *engine;
 
 G_MODULE_EXPORT void
@@ -42,11 +56,27 @@ activate (CodeSlayer *codeslayer)
 
   project_properties = launcher_project_properties_new ();
   projects_popup = launcher_projects_popup_new ();
-  engine = launcher_engine_new (codeslayer, menu, project_properties, projects_popup);
+  output = launcher_output_new ();
+  benchmark_view = launcher_benchmark_view_new ();
+  sweep_view = launcher_sweep_view_new ();
+  jobs_view = launcher_jobs_view_new ();
+  monitor_view = launcher_monitor_view_new ();
+  crash_view = launcher_crash_view_new ();
+  reports = launcher_reports_new ();
+  engine = launcher_engine_new (codeslayer, menu, project_properties, projects_popup, 
+                                output, benchmark_view, sweep_view, jobs_view, 
+                                monitor_view, crash_view, reports);
 
   codeslayer_add_to_menu_bar (codeslayer, GTK_MENU_ITEM (menu));
   codeslayer_add_to_projects_popup (codeslayer, GTK_MENU_ITEM (projects_popup));
   codeslayer_add_to_project_properties (codeslayer, project_properties, "Launcher");
+  codeslayer_add_to_bottom_pane (codeslayer, output, "Launcher");
+  codeslayer_add_to_bottom_pane (codeslayer, benchmark_view, "Benchmark");
+  codeslayer_add_to_bottom_pane (codeslayer, sweep_view, "Sweep");
+  codeslayer_add_to_bottom_pane (codeslayer, jobs_view, "Jobs");
+  codeslayer_add_to_bottom_pane (codeslayer, monitor_view, "Monitor");
+  codeslayer_add_to_bottom_pane (codeslayer, crash_view, "Crashes");
+  codeslayer_add_to_bottom_pane (codeslayer, reports, "Reports");
 }
 
 G_MODULE_EXPORT void 
@@ -55,5 +85,12 @@ deactivate (CodeSlayer *codeslayer)
   codeslayer_remove_from_menu_bar (codeslayer, GTK_MENU_ITEM (menu));
   codeslayer_remove_from_projects_popup (codeslayer, GTK_MENU_ITEM (projects_popup));
   codeslayer_remove_from_project_properties (codeslayer, project_properties);
+  codeslayer_remove_from_bottom_pane (codeslayer, output);
+  codeslayer_remove_from_bottom_pane (codeslayer, benchmark_view);
+  codeslayer_remove_from_bottom_pane (codeslayer, sweep_view);
+  codeslayer_remove_from_bottom_pane (codeslayer, jobs_view);
+  codeslayer_remove_from_bottom_pane (codeslayer, monitor_view);
+  codeslayer_remove_from_bottom_pane (codeslayer, crash_view);
+  codeslayer_remove_from_bottom_pane (codeslayer, reports);
   g_object_unref (engine);
 }
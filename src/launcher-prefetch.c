@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include "launcher-prefetch.h"
+
+static void prefetch_thread  (GTask        *task,
+                              gpointer      source_object,
+                              gchar       **files,
+                              GCancellable *cancellable);
+
+/*
+ * Asks the kernel to read the executable and the files it mapped last time, 
+ * mostly shared libraries, into the page cache. The reads are started from 
+ * a thread and nobody waits for them, a later launch just finds the pages.
+ */
+void
+launcher_prefetch (const gchar *executable,
+                   gchar      **files)
+{
+  GPtrArray *paths;
+  GTask *task;
+  
+  paths = g_ptr_array_new ();
+  g_ptr_array_add (paths, g_strdup (executable));
+  for (; files != NULL && *files != NULL; files++)
+    if (g_strcmp0 (*files, executable) != 0)
+      g_ptr_array_add (paths, g_strdup (*files));
+  g_ptr_array_add (paths, NULL);
+
+  task = g_task_new (NULL, NULL, NULL, NULL);
+  g_task_set_task_data (task, g_ptr_array_free (paths, FALSE), (GDestroyNotify) g_strfreev);
+  g_task_run_in_thread (task, (GTaskThreadFunc) prefetch_thread);
+  g_object_unref (task);
+}
+
+static void
+prefetch_thread (GTask        *task,
+                 gpointer      source_object,
+                 gchar       **files,
+                 GCancellable *cancellable)
+{
+  for (; *files != NULL; files++)
+    {
+      gint fd;
+      fd = open (*files, O_RDONLY | O_CLOEXEC);
+      if (fd < 0)
+        continue;
+      posix_fadvise (fd, 0, 0, POSIX_FADV_WILLNEED);
+      close (fd);
+    }
+  
+  g_task_return_boolean (task, TRUE);
+}
@@ -0,0 +1,365 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include "launcher-probe.h"
+
+/*
+ * A probe waits for a launched process to become ready. Everything runs on 
+ * the main loop: the port and the file are polled, the log is matched as 
+ * lines arrive in the output buffer. The wait fails when the process 
+ * finishes first or the timeout passes.
+ */
+
+#define POLL_INTERVAL 50
+
+typedef struct
+{
+  GTask             *task;
+  LauncherProbeType  type;
+  gchar             *host;
+  guint16            port;
+  gchar             *file_path;
+  GRegex            *regex;
+  guint64            next_line;
+  GSocketClient     *client;
+  gboolean           connecting;
+  gboolean           completed;
+  guint              poll_id;
+  guint              timeout_id;
+  gulong             changed_id;
+  gulong             finished_id;
+  gulong             cancelled_id;
+} Probe;
+
+static void start_polling         (Probe         *probe);
+static gboolean poll_action       (Probe         *probe);
+static void connected_action      (GSocketClient *client,
+                                   GAsyncResult  *result,
+                                   Probe         *probe);
+static void output_changed_action (Probe         *probe);
+static void finished_action       (Probe         *probe);
+static gboolean timeout_action    (Probe         *probe);
+static void cancelled_action      (GCancellable  *cancellable,
+                                   Probe         *probe);
+static gboolean complete_action   (GTask         *task);
+static void complete              (Probe         *probe,
+                                   GError        *error);
+static void probe_free            (Probe         *probe);
+
+/*
+ * The spec is one of tcp:PORT, tcp:HOST:PORT, log:REGEX or file:PATH.
+ */
+gboolean
+launcher_probe_parse (const gchar        *spec,
+                      LauncherProbeType  *type,
+                      gchar             **target,
+                      GError            **error)
+{
+  const gchar *colon;
+  
+  *type = LAUNCHER_PROBE_NONE;
+  *target = NULL;
+  
+  if (spec == NULL || *spec == '\0')
+    return TRUE;
+  
+  colon = strchr (spec, ':');
+  if (colon != NULL && colon[1] != '\0')
+    {
+      if (strncmp (spec, "tcp:", 4) == 0)
+        *type = LAUNCHER_PROBE_TCP;
+      else if (strncmp (spec, "log:", 4) == 0)
+        *type = LAUNCHER_PROBE_LOG;
+      else if (strncmp (spec, "file:", 5) == 0)
+        *type = LAUNCHER_PROBE_FILE;
+    }
+  
+  if (*type == LAUNCHER_PROBE_NONE)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, 
+                   "Unknown readiness probe '%s', expected tcp:PORT, log:REGEX or file:PATH", spec);
+      return FALSE;
+    }
+  
+  *target = g_strdup (colon + 1);
+  return TRUE;
+}
+
+void
+launcher_probe_wait_async (LauncherProcess      *process,
+                           LauncherProbeType     type,
+                           const gchar          *target,
+                           gint                  timeout,
+                           GCancellable         *cancellable,
+                           GAsyncReadyCallback   callback,
+                           gpointer              user_data)
+{
+  Probe *probe;
+  GError *error = NULL;
+  
+  probe = g_slice_new0 (Probe);
+  probe->task = g_task_new (process, cancellable, callback, user_data);
+  probe->type = type;
+  g_task_set_task_data (probe->task, probe, (GDestroyNotify) probe_free);
+  
+  switch (type)
+    {
+    case LAUNCHER_PROBE_NONE:
+      break;
+    case LAUNCHER_PROBE_TCP:
+      {
+        const gchar *port = strrchr (target, ':');
+        probe->host = port != NULL ? g_strndup (target, port - target) : g_strdup ("localhost");
+        probe->port = (guint16) g_ascii_strtoull (port != NULL ? port + 1 : target, NULL, 10);
+        probe->client = g_socket_client_new ();
+        if (probe->port == 0)
+          g_set_error (&error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, 
+                       "Invalid port in readiness probe tcp:%s", target);
+      }
+      break;
+    case LAUNCHER_PROBE_LOG:
+      probe->regex = g_regex_new (target, G_REGEX_OPTIMIZE, 0, &error);
+      break;
+    case LAUNCHER_PROBE_FILE:
+      probe->file_path = g_strdup (target);
+      break;
+    }
+  
+  if (error != NULL || type == LAUNCHER_PROBE_NONE)
+    {
+      complete (probe, error);
+      return;
+    }
+  
+  probe->finished_id = g_signal_connect_swapped (G_OBJECT (process), "finished",
+                                                 G_CALLBACK (finished_action), probe);
+  
+  if (timeout > 0)
+    probe->timeout_id = g_timeout_add_seconds (timeout, (GSourceFunc) timeout_action, probe);
+  
+  if (cancellable != NULL)
+    probe->cancelled_id = g_cancellable_connect (cancellable, G_CALLBACK (cancelled_action), 
+                                                 probe, NULL);
+  
+  if (type == LAUNCHER_PROBE_LOG)
+    {
+      LauncherOutputBuffer *buffer;
+      buffer = launcher_process_get_output (process);
+      probe->changed_id = g_signal_connect_swapped (G_OBJECT (buffer), "changed",
+                                                    G_CALLBACK (output_changed_action), probe);
+      output_changed_action (probe);
+    }
+  else
+    {
+      start_polling (probe);
+    }
+}
+
+gboolean
+launcher_probe_wait_finish (LauncherProcess  *process,
+                            GAsyncResult     *result,
+                            GError          **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, process), FALSE);
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+static void
+start_polling (Probe *probe)
+{
+  if (poll_action (probe))
+    probe->poll_id = g_timeout_add (POLL_INTERVAL, (GSourceFunc) poll_action, probe);
+}
+
+static gboolean
+poll_action (Probe *probe)
+{
+  if (probe->type == LAUNCHER_PROBE_FILE)
+    {
+      if (!g_file_test (probe->file_path, G_FILE_TEST_EXISTS))
+        return G_SOURCE_CONTINUE;
+      probe->poll_id = 0;
+      complete (probe, NULL);
+      return G_SOURCE_REMOVE;
+    }
+  
+  /* one connection attempt at a time, a refused port fails quickly */
+  if (!probe->connecting)
+    {
+      probe->connecting = TRUE;
+      g_object_ref (probe->task);
+      g_socket_client_connect_to_host_async (probe->client, probe->host, probe->port, 
+                                             NULL, (GAsyncReadyCallback) connected_action, 
+                                             probe);
+    }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+connected_action (GSocketClient *client,
+                  GAsyncResult  *result,
+                  Probe         *probe)
+{
+  GSocketConnection *connection;
+  GTask *task = probe->task;
+  
+  probe->connecting = FALSE;
+  
+  connection = g_socket_client_connect_to_host_finish (client, result, NULL);
+  if (connection != NULL)
+    {
+      g_io_stream_close (G_IO_STREAM (connection), NULL, NULL);
+      g_object_unref (connection);
+      complete (probe, NULL);
+    }
+
+  g_object_unref (task);
+}
+
+/*
+ * Only the lines that arrived since the last change are matched, lines 
+ * that were dropped from the buffer in between are skipped.
+ */
+static void
+output_changed_action (Probe *probe)
+{
+  LauncherProcess *process;
+  LauncherOutputBuffer *buffer;
+  guint64 dropped_lines;
+  guint n_lines;
+  guint i;
+  
+  process = g_task_get_source_object (probe->task);
+  buffer = launcher_process_get_output (process);
+  n_lines = launcher_output_buffer_get_n_lines (buffer);
+  dropped_lines = launcher_output_buffer_get_dropped_lines (buffer);
+  
+  i = probe->next_line > dropped_lines ? probe->next_line - dropped_lines : 0;
+  
+  for (; i < n_lines; i++)
+    {
+      const gchar *text;
+      gboolean is_stderr;
+      gsize length;
+      
+      text = launcher_output_buffer_get_line (buffer, i, &length, &is_stderr);
+      if (g_regex_match_full (probe->regex, text, length, 0, 0, NULL, NULL))
+        {
+          complete (probe, NULL);
+          return;
+        }
+    }
+  
+  probe->next_line = dropped_lines + n_lines;
+}
+
+static void
+finished_action (Probe *probe)
+{
+  complete (probe, g_error_new (G_IO_ERROR, G_IO_ERROR_FAILED, 
+                                "The process finished before it was ready"));
+}
+
+static gboolean
+timeout_action (Probe *probe)
+{
+  probe->timeout_id = 0;
+  complete (probe, g_error_new (G_IO_ERROR, G_IO_ERROR_TIMED_OUT, 
+                                "The process was not ready in time"));
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * Runs in whatever context cancelled, the task is returned from an idle 
+ * so that it never completes inside g_cancellable_connect.
+ */
+static void
+cancelled_action (GCancellable *cancellable,
+                  Probe        *probe)
+{
+  g_idle_add_full (G_PRIORITY_DEFAULT, (GSourceFunc) complete_action, 
+                   g_object_ref (probe->task), g_object_unref);
+}
+
+static gboolean
+complete_action (GTask *task)
+{
+  complete (g_task_get_task_data (task), 
+            g_error_new (G_IO_ERROR, G_IO_ERROR_CANCELLED, "The wait was cancelled"));
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * Tears down every source that could still fire, so the task is returned 
+ * exactly once.
+ */
+static void
+complete (Probe  *probe,
+          GError *error)
+{
+  GTask *task = probe->task;
+  LauncherProcess *process;
+  
+  if (probe->completed)
+    {
+      if (error != NULL)
+        g_error_free (error);
+      return;
+    }
+  
+  probe->completed = TRUE;
+  process = g_task_get_source_object (task);
+  
+  if (probe->poll_id != 0)
+    g_source_remove (probe->poll_id);
+  if (probe->timeout_id != 0)
+    g_source_remove (probe->timeout_id);
+  if (probe->changed_id != 0)
+    g_signal_handler_disconnect (launcher_process_get_output (process), probe->changed_id);
+  if (probe->finished_id != 0)
+    g_signal_handler_disconnect (process, probe->finished_id);
+  if (probe->cancelled_id != 0)
+    g_cancellable_disconnect (g_task_get_cancellable (task), probe->cancelled_id);
+  
+  probe->poll_id = 0;
+  probe->timeout_id = 0;
+  probe->changed_id = 0;
+  probe->finished_id = 0;
+  probe->cancelled_id = 0;
+  
+  if (error != NULL)
+    g_task_return_error (task, error);
+  else
+    g_task_return_boolean (task, TRUE);
+  
+  g_object_unref (task);
+}
+
+static void
+probe_free (Probe *probe)
+{
+  g_free (probe->host);
+  g_free (probe->file_path);
+  if (probe->regex != NULL)
+    g_regex_unref (probe->regex);
+  if (probe->client != NULL)
+    g_object_unref (probe->client);
+  g_slice_free (Probe, probe);
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_PROBE_H__
+#define	__LAUNCHER_PROBE_H__
+
+#include <gio/gio.h>
+#include "launcher-process.h"
+
+G_BEGIN_DECLS
+
+typedef enum
+{
+  LAUNCHER_PROBE_NONE,
+  LAUNCHER_PROBE_TCP,
+  LAUNCHER_PROBE_LOG,
+  LAUNCHER_PROBE_FILE
+} LauncherProbeType;
+
+gboolean  launcher_probe_parse        (const gchar          *spec,
+                                       LauncherProbeType    *type,
+                                       gchar               **target,
+                                       GError              **error);
+
+void      launcher_probe_wait_async   (LauncherProcess      *process,
+                                       LauncherProbeType     type,
+                                       const gchar          *target,
+                                       gint                  timeout,
+                                       GCancellable         *cancellable,
+                                       GAsyncReadyCallback   callback,
+                                       gpointer              user_data);
+gboolean  launcher_probe_wait_finish  (LauncherProcess      *process,
+                                       GAsyncResult         *result,
+                                       GError              **error);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_PROBE_H__ */
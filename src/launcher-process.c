@@ -0,0 +1,1048 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <glib-unix.h>
+#include <gio/gunixinputstream.h>
+#include "launcher-process.h"
+
+static void launcher_process_class_init  (LauncherProcessClass *klass);
+static void launcher_process_init        (LauncherProcess      *process);
+static void launcher_process_finalize    (LauncherProcess      *process);
+
+static gboolean spawn_child              (LauncherProcess      *process,
+                                          gchar               **argv,
+                                          GError              **error);
+static gpointer wait_thread              (LauncherProcess      *process);
+static gboolean reap_action              (LauncherProcess      *process);
+static void read_stream                  (LauncherProcess      *process,
+                                          GInputStream         *stream);
+static void read_action                  (GInputStream         *stream,
+                                          GAsyncResult         *result,
+                                          LauncherProcess      *process);
+static gboolean sample_action             (LauncherProcess      *process);
+static gboolean kill_action               (LauncherProcess      *process);
+static void watch_child                   (LauncherProcess      *process);
+static void child_setup                   (gpointer              data);
+static void read_mapped_files             (LauncherProcess      *process);
+static void check_watchdog                (LauncherProcess      *process);
+
+#define READ_SIZE 65536
+#define SAMPLE_INTERVAL 250
+
+/* 
+ * The stand-by shell blocks on fd 3 until it is released and then replaces 
+ * itself with the program. Closing the pipe instead makes it exit quietly.
+ */
+#define STANDBY_SCRIPT "read line <&3 || exit 127; exec 3<&-; exec \"$@\""
+#define STANDBY_FD 3
+
+#define LAUNCHER_PROCESS_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_PROCESS_TYPE, LauncherProcessPrivate))
+
+typedef struct _LauncherProcessPrivate LauncherProcessPrivate;
+
+struct _LauncherProcessPrivate
+{
+  LauncherConfig       *config;
+  GInputStream         *stdout_stream;
+  GInputStream         *stderr_stream;
+  LauncherOutputBuffer *output;
+  GPid                  pid;
+  LauncherProcessState  state;
+  gint64                start_time;
+  gint64                start_monotonic;
+  gint64                end_monotonic;
+  gint                  exit_status;
+  gint64                cpu_time;
+  gint64                max_rss;
+  guint                 sample_id;
+  LauncherHistoryRegression *regression;
+  LauncherProfiler      profiler;
+  gchar                *profile_path;
+  gchar                *working_directory;
+  gchar               **environment;
+  gint64                restart_latency;
+  guint                 kill_id;
+  gint                  release_fd;
+  gint                  standby_fd;
+  gboolean              warm;
+  gint64                launch_latency;
+  gint64                cold_latency;
+  gchar               **mapped_files;
+  LauncherCounters     *counters;
+  LauncherCounterValues *counter_values;
+  LauncherResources    *resources;
+  gchar                *program;
+  gboolean              core_dumps;
+  gboolean              core_dumped;
+  gboolean              watchdog;
+  gint64                last_output;
+  LauncherProcessHang   hang;
+};
+
+enum
+{
+  FINISHED,
+  REGRESSION,
+  HUNG,
+  LAST_SIGNAL
+};
+
+static guint launcher_process_signals[LAST_SIGNAL] = { 0 };
+
+G_DEFINE_TYPE (LauncherProcess, launcher_process, G_TYPE_OBJECT)
+
+static void 
+launcher_process_class_init (LauncherProcessClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  launcher_process_signals[FINISHED] =
+    g_signal_new ("finished", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherProcessClass, finished),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  launcher_process_signals[REGRESSION] =
+    g_signal_new ("regression", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherProcessClass, regression),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  launcher_process_signals[HUNG] =
+    g_signal_new ("hung", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherProcessClass, hung),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_process_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherProcessPrivate));
+}
+
+static void
+launcher_process_init (LauncherProcess *process)
+{
+  LauncherProcessPrivate *priv;
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  priv->config = NULL;
+  priv->stdout_stream = NULL;
+  priv->stderr_stream = NULL;
+  priv->output = launcher_output_buffer_new ();
+  priv->pid = 0;
+  priv->state = LAUNCHER_PROCESS_STARTING;
+  priv->start_time = 0;
+  priv->start_monotonic = 0;
+  priv->end_monotonic = 0;
+  priv->exit_status = 0;
+  priv->cpu_time = 0;
+  priv->max_rss = 0;
+  priv->sample_id = 0;
+  priv->regression = NULL;
+  priv->profiler = LAUNCHER_PROFILER_NONE;
+  priv->profile_path = NULL;
+  priv->working_directory = NULL;
+  priv->environment = NULL;
+  priv->restart_latency = -1;
+  priv->kill_id = 0;
+  priv->release_fd = -1;
+  priv->standby_fd = -1;
+  priv->warm = FALSE;
+  priv->launch_latency = -1;
+  priv->cold_latency = -1;
+  priv->mapped_files = NULL;
+  priv->counters = NULL;
+  priv->counter_values = NULL;
+  priv->resources = NULL;
+  priv->program = NULL;
+  priv->core_dumps = FALSE;
+  priv->core_dumped = FALSE;
+  priv->watchdog = FALSE;
+  priv->last_output = 0;
+  priv->hang = LAUNCHER_PROCESS_HANG_NONE;
+}
+
+static void
+launcher_process_finalize (LauncherProcess *process)
+{
+  LauncherProcessPrivate *priv;
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  if (priv->sample_id != 0)
+    g_source_remove (priv->sample_id);
+  if (priv->kill_id != 0)
+    g_source_remove (priv->kill_id);
+  if (priv->release_fd >= 0)
+    close (priv->release_fd);
+  g_strfreev (priv->mapped_files);
+  g_free (priv->regression);
+  g_free (priv->profile_path);
+  g_free (priv->working_directory);
+  g_strfreev (priv->environment);
+  g_free (priv->program);
+  g_free (priv->counter_values);
+  if (priv->counters)
+    g_object_unref (priv->counters);
+  if (priv->resources)
+    g_object_unref (priv->resources);
+  if (priv->stdout_stream)
+    g_object_unref (priv->stdout_stream);
+  if (priv->stderr_stream)
+    g_object_unref (priv->stderr_stream);
+  if (priv->config)
+    g_object_unref (priv->config);
+  g_object_unref (priv->output);
+  G_OBJECT_CLASS (launcher_process_parent_class)->finalize (G_OBJECT (process));
+}
+
+LauncherProcess*
+launcher_process_new (LauncherConfig *config)
+{
+  LauncherProcessPrivate *priv;
+  LauncherProcess *process;
+
+  process = LAUNCHER_PROCESS (g_object_new (launcher_process_get_type (), NULL));
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  priv->config = g_object_ref (config);
+
+  return process;
+}
+
+gboolean
+launcher_process_spawn (LauncherProcess  *process,
+                        gchar           **argv,
+                        GError          **error)
+{
+  LauncherProcessPrivate *priv;
+  gboolean spawned;
+  
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+
+  priv->start_time = g_get_real_time ();
+  priv->start_monotonic = g_get_monotonic_time ();
+
+  /* counting a profiler would only measure the profiler */
+  if (launcher_config_get_counters (priv->config) && 
+      priv->profiler == LAUNCHER_PROFILER_NONE)
+    {
+      priv->counters = launcher_counters_new ();
+    }
+  
+  spawned = spawn_child (process, argv, error);
+  
+  if (priv->counters != NULL)
+    launcher_counters_receive (priv->counters);
+  
+  if (!spawned)
+    {
+      priv->state = LAUNCHER_PROCESS_FAILED;
+      priv->end_monotonic = g_get_monotonic_time ();
+      return FALSE;
+    }
+
+  priv->state = LAUNCHER_PROCESS_RUNNING;
+  priv->last_output = priv->start_monotonic;
+  priv->sample_id = g_timeout_add (SAMPLE_INTERVAL, (GSourceFunc) sample_action, process);
+  watch_child (process);
+  
+  return TRUE;
+}
+
+/*
+ * Forks a stand-by child with its pipes, environment and working directory 
+ * in place, parked just before the exec of the argv. The process stays 
+ * in the starting state until launcher_process_release() lets it go. 
+ * Counters are not supported since they would count the parked shell.
+ */
+gboolean
+launcher_process_prespawn (LauncherProcess  *process,
+                           gchar           **argv,
+                           GError          **error)
+{
+  LauncherProcessPrivate *priv;
+  GPtrArray *standby_argv;
+  gboolean spawned;
+  gint fds[2];
+  
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  
+  if (!g_unix_open_pipe (fds, FD_CLOEXEC, error))
+    return FALSE;
+
+  standby_argv = g_ptr_array_new ();
+  g_ptr_array_add (standby_argv, "/bin/sh");
+  g_ptr_array_add (standby_argv, "-c");
+  g_ptr_array_add (standby_argv, STANDBY_SCRIPT);
+  g_ptr_array_add (standby_argv, "sh");
+  for (; *argv != NULL; argv++)
+    g_ptr_array_add (standby_argv, *argv);
+  g_ptr_array_add (standby_argv, NULL);
+  
+  priv->standby_fd = fds[0];
+  spawned = spawn_child (process, (gchar **) standby_argv->pdata, error);
+  close (fds[0]);
+  priv->standby_fd = -1;
+  g_ptr_array_free (standby_argv, TRUE);
+  
+  if (!spawned)
+    {
+      close (fds[1]);
+      priv->state = LAUNCHER_PROCESS_FAILED;
+      return FALSE;
+    }
+
+  priv->release_fd = fds[1];
+  watch_child (process);
+  
+  return TRUE;
+}
+
+/*
+ * Lets a stand-by child exec the program. Returns FALSE when it is no 
+ * longer waiting, in which case a normal spawn is needed.
+ */
+gboolean
+launcher_process_release (LauncherProcess *process)
+{
+  LauncherProcessPrivate *priv;
+  gssize written;
+  
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  
+  if (priv->release_fd < 0 || priv->state != LAUNCHER_PROCESS_STARTING)
+    return FALSE;
+  
+  priv->start_time = g_get_real_time ();
+  priv->start_monotonic = g_get_monotonic_time ();
+  
+  do
+    written = write (priv->release_fd, "\n", 1);
+  while (written < 0 && errno == EINTR);
+  
+  close (priv->release_fd);
+  priv->release_fd = -1;
+  
+  if (written != 1)
+    return FALSE;
+
+  priv->warm = TRUE;
+  priv->state = LAUNCHER_PROCESS_RUNNING;
+  priv->last_output = priv->start_monotonic;
+  priv->sample_id = g_timeout_add (SAMPLE_INTERVAL, (GSourceFunc) sample_action, process);
+  
+  return TRUE;
+}
+
+/*
+ * Sends a stand-by child away without running the program.
+ */
+void
+launcher_process_discard (LauncherProcess *process)
+{
+  LauncherProcessPrivate *priv;
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  
+  if (priv->release_fd < 0)
+    return;
+  
+  close (priv->release_fd);
+  priv->release_fd = -1;
+}
+
+/*
+ * The child is not reaped by GLib, wait_thread() and reap_action() do it 
+ * with wait4() so that its rusage is kept.
+ */
+static gboolean
+spawn_child (LauncherProcess  *process,
+             gchar           **argv,
+             GError          **error)
+{
+  LauncherProcessPrivate *priv;
+  GSpawnChildSetupFunc setup = NULL;
+  gint stdout_fd;
+  gint stderr_fd;
+  
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  
+  if (priv->counters != NULL || priv->resources != NULL || 
+      priv->core_dumps || priv->standby_fd >= 0)
+    setup = child_setup;
+  
+  if (!g_spawn_async_with_pipes (priv->working_directory, argv, priv->environment, 
+                                 G_SPAWN_DO_NOT_REAP_CHILD | G_SPAWN_SEARCH_PATH | 
+                                 G_SPAWN_SEARCH_PATH_FROM_ENVP,
+                                 setup, priv, &priv->pid, 
+                                 NULL, &stdout_fd, &stderr_fd, error))
+    return FALSE;
+  
+  priv->stdout_stream = g_unix_input_stream_new (stdout_fd, TRUE);
+  priv->stderr_stream = g_unix_input_stream_new (stderr_fd, TRUE);
+  
+  return TRUE;
+}
+
+/*
+ * Runs in the child between the fork and the exec, so only async-signal-safe 
+ * calls are allowed. The stand-by pipe is moved to its fd here, dup2() 
+ * clears close-on-exec on the copy. The soft core limit can be raised up 
+ * to the hard one without privileges.
+ */
+static void
+child_setup (gpointer data)
+{
+  LauncherProcessPrivate *priv = data;
+  if (priv->standby_fd >= 0)
+    {
+      if (priv->standby_fd == STANDBY_FD)
+        fcntl (STANDBY_FD, F_SETFD, 0);
+      else
+        dup2 (priv->standby_fd, STANDBY_FD);
+    }
+  if (priv->core_dumps)
+    {
+      struct rlimit limit;
+      if (getrlimit (RLIMIT_CORE, &limit) == 0)
+        {
+          limit.rlim_cur = limit.rlim_max;
+          setrlimit (RLIMIT_CORE, &limit);
+        }
+    }
+  if (priv->resources != NULL)
+    launcher_resources_child_setup (priv->resources);
+  if (priv->counters != NULL)
+    launcher_counters_child_setup (priv->counters);
+}
+
+static void
+watch_child (LauncherProcess *process)
+{
+  LauncherProcessPrivate *priv;
+  GThread *thread;
+  
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  
+  read_stream (process, priv->stdout_stream);
+  read_stream (process, priv->stderr_stream);
+  
+  thread = g_thread_new ("launcher-wait", (GThreadFunc) wait_thread, g_object_ref (process));
+  g_thread_unref (thread);
+}
+
+/*
+ * Only waits for the child to exit and leaves it a zombie. It is reaped 
+ * on the main thread, so its pid can not be reused while terminate() may 
+ * still signal it.
+ */
+static gpointer
+wait_thread (LauncherProcess *process)
+{
+  LauncherProcessPrivate *priv;
+  siginfo_t info;
+  
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  
+  while (waitid (P_PID, priv->pid, &info, WEXITED | WNOWAIT) < 0 && errno == EINTR);
+  
+  g_main_context_invoke_full (NULL, G_PRIORITY_DEFAULT, 
+                              (GSourceFunc) reap_action,
+                              process, g_object_unref);
+  return NULL;
+}
+
+/*
+ * The cpu time and high water mark come from the rusage of the child, 
+ * so a run that is over before the first sample still has them.
+ */
+static gboolean
+reap_action (LauncherProcess *process)
+{
+  LauncherProcessPrivate *priv;
+  struct rusage usage;
+  gint status;
+  gint result;
+  
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  
+  priv->end_monotonic = g_get_monotonic_time ();
+  
+  if (priv->sample_id != 0)
+    {
+      g_source_remove (priv->sample_id);
+      priv->sample_id = 0;
+    }
+
+  if (priv->kill_id != 0)
+    {
+      g_source_remove (priv->kill_id);
+      priv->kill_id = 0;
+    }
+
+  do
+    result = wait4 (priv->pid, &status, 0, &usage);
+  while (result < 0 && errno == EINTR);
+  
+  if (result < 0)
+    {
+      priv->state = LAUNCHER_PROCESS_FAILED;
+      g_warning ("Not able to wait for %s: %s", 
+                 launcher_config_get_executable (priv->config), g_strerror (errno));
+    }
+  else
+    {
+      priv->cpu_time = (gint64) (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * G_USEC_PER_SEC + 
+                       usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+      priv->max_rss = usage.ru_maxrss;
+      
+      if (WIFSIGNALED (status))
+        {
+          priv->state = LAUNCHER_PROCESS_SIGNALED;
+          priv->exit_status = WTERMSIG (status);
+          priv->core_dumped = WCOREDUMP (status);
+        }
+      else
+        {
+          priv->state = LAUNCHER_PROCESS_EXITED;
+          priv->exit_status = WEXITSTATUS (status);
+        }
+    }
+  
+  g_spawn_close_pid (priv->pid);
+  
+  if (priv->counters != NULL)
+    {
+      priv->counter_values = g_new (LauncherCounterValues, 1);
+      launcher_counters_read (priv->counters, priv->counter_values);
+      g_object_unref (priv->counters);
+      priv->counters = NULL;
+    }
+
+  g_signal_emit_by_name ((gpointer) process, "finished");
+  
+  return G_SOURCE_REMOVE;
+}
+
+static void
+read_stream (LauncherProcess *process,
+             GInputStream    *stream)
+{
+  g_input_stream_read_bytes_async (stream, READ_SIZE, G_PRIORITY_DEFAULT, NULL, 
+                                   (GAsyncReadyCallback) read_action, 
+                                   g_object_ref (process));
+}
+
+static void
+read_action (GInputStream    *stream,
+             GAsyncResult    *result,
+             LauncherProcess *process)
+{
+  LauncherProcessPrivate *priv;
+  GBytes *bytes;
+  gconstpointer data;
+  gsize size;
+  gboolean is_stderr;
+  
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+
+  bytes = g_input_stream_read_bytes_finish (stream, result, NULL);
+  if (bytes == NULL || g_bytes_get_size (bytes) == 0)
+    {
+      if (bytes != NULL)
+        g_bytes_unref (bytes);
+      launcher_output_buffer_flush (priv->output);
+      g_object_unref (process);
+      return;
+    }
+
+  priv->last_output = g_get_monotonic_time ();
+  if (priv->launch_latency < 0 && priv->start_monotonic > 0)
+    priv->launch_latency = priv->last_output - priv->start_monotonic;
+
+  is_stderr = stream == priv->stderr_stream;
+  data = g_bytes_get_data (bytes, &size);
+  launcher_output_buffer_append (priv->output, data, size, is_stderr);
+  g_bytes_unref (bytes);
+  
+  read_stream (process, stream);
+  g_object_unref (process);
+}
+
+/*
+ * Keeps the cpu time and high water mark current for the live display 
+ * while the child runs, the final values are taken from its rusage.
+ */
+static gboolean
+sample_action (LauncherProcess *process)
+{
+  LauncherProcessPrivate *priv;
+  gchar *path;
+  gchar *contents;
+  
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  
+  if (priv->mapped_files == NULL)
+    read_mapped_files (process);
+  
+  path = g_strdup_printf ("/proc/%d/stat", priv->pid);
+  if (g_file_get_contents (path, &contents, NULL, NULL))
+    {
+      gchar *fields;
+      gulong utime;
+      gulong stime;
+
+      /* the command name may contain spaces so skip past it */
+      fields = strrchr (contents, ')');
+      if (fields != NULL &&
+          sscanf (fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", 
+                  &utime, &stime) == 2)
+        priv->cpu_time = (gint64) (utime + stime) * G_USEC_PER_SEC / sysconf (_SC_CLK_TCK);
+
+      g_free (contents);
+    }
+  g_free (path);
+
+  path = g_strdup_printf ("/proc/%d/status", priv->pid);
+  if (g_file_get_contents (path, &contents, NULL, NULL))
+    {
+      gchar *line;
+      line = strstr (contents, "VmHWM:");
+      if (line != NULL)
+        priv->max_rss = g_ascii_strtoll (line + strlen ("VmHWM:"), NULL, 10);
+      g_free (contents);
+    }
+  g_free (path);
+  
+  if (priv->watchdog && priv->hang == LAUNCHER_PROCESS_HANG_NONE)
+    check_watchdog (process);
+
+  return G_SOURCE_CONTINUE;
+}
+
+/*
+ * Fires "hung" once, when the run has taken longer than the timeout of its 
+ * config or has not written anything for the idle timeout. What to do about 
+ * it is left to the caller, which usually samples the stacks and terminates.
+ */
+static void
+check_watchdog (LauncherProcess *process)
+{
+  LauncherProcessPrivate *priv;
+  gint64 now;
+  gint timeout;
+  gint idle_timeout;
+  
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  
+  now = g_get_monotonic_time ();
+  timeout = launcher_config_get_timeout (priv->config);
+  idle_timeout = launcher_config_get_idle_timeout (priv->config);
+  
+  if (timeout > 0 && now - priv->start_monotonic >= timeout * G_USEC_PER_SEC)
+    priv->hang = LAUNCHER_PROCESS_HANG_TIMEOUT;
+  else if (idle_timeout > 0 && now - priv->last_output >= idle_timeout * G_USEC_PER_SEC)
+    priv->hang = LAUNCHER_PROCESS_HANG_IDLE;
+  else
+    return;
+  
+  g_signal_emit_by_name ((gpointer) process, "hung");
+}
+
+/*
+ * Remembers the executable and shared libraries the program has mapped, 
+ * which is what a prefetch needs to read ahead before the next run.
+ */
+static void
+read_mapped_files (LauncherProcess *process)
+{
+  LauncherProcessPrivate *priv;
+  GHashTable *seen;
+  GPtrArray *files;
+  gchar *path;
+  gchar *contents;
+  gchar **lines;
+  gchar **line;
+  
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  
+  path = g_strdup_printf ("/proc/%d/maps", priv->pid);
+  if (!g_file_get_contents (path, &contents, NULL, NULL))
+    {
+      g_free (path);
+      return;
+    }
+  g_free (path);
+  
+  seen = g_hash_table_new (g_str_hash, g_str_equal);
+  files = g_ptr_array_new ();
+  
+  lines = g_strsplit (contents, "\n", -1);
+  for (line = lines; *line != NULL; line++)
+    {
+      gchar *file;
+      file = strchr (*line, '/');
+      if (file == NULL || g_hash_table_contains (seen, file))
+        continue;
+      g_hash_table_add (seen, file);
+      g_ptr_array_add (files, g_strdup (file));
+    }
+  g_ptr_array_add (files, NULL);
+  
+  priv->mapped_files = (gchar**) g_ptr_array_free (files, FALSE);
+  
+  g_hash_table_destroy (seen);
+  g_strfreev (lines);
+  g_free (contents);
+}
+
+LauncherConfig*
+launcher_process_get_config (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->config;
+}
+
+GPid
+launcher_process_get_pid (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->pid;
+}
+
+LauncherProcessState
+launcher_process_get_state (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->state;
+}
+
+gint64
+launcher_process_get_start_time (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->start_time;
+}
+
+gint64
+launcher_process_get_run_time (LauncherProcess *process)
+{
+  LauncherProcessPrivate *priv;
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  
+  if (priv->start_monotonic == 0)
+    return 0;
+  
+  if (priv->end_monotonic == 0)
+    return g_get_monotonic_time () - priv->start_monotonic;
+
+  return priv->end_monotonic - priv->start_monotonic;
+}
+
+gint
+launcher_process_get_exit_status (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->exit_status;
+}
+
+LauncherOutputBuffer*
+launcher_process_get_output (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->output;
+}
+
+gint64
+launcher_process_get_cpu_time (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->cpu_time;
+}
+
+gint64
+launcher_process_get_max_rss (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->max_rss;
+}
+
+const LauncherHistoryRegression*
+launcher_process_get_regression (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->regression;
+}
+
+void
+launcher_process_set_regression (LauncherProcess                 *process,
+                                 const LauncherHistoryRegression *regression)
+{
+  LauncherProcessPrivate *priv;
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  g_free (priv->regression);
+  priv->regression = g_memdup (regression, sizeof (LauncherHistoryRegression));
+  g_signal_emit_by_name ((gpointer) process, "regression");
+}
+
+LauncherProfiler
+launcher_process_get_profiler (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->profiler;
+}
+
+const gchar*
+launcher_process_get_profile_path (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->profile_path;
+}
+
+void
+launcher_process_set_profile (LauncherProcess  *process,
+                              LauncherProfiler  profiler,
+                              const gchar      *profile_path)
+{
+  LauncherProcessPrivate *priv;
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  priv->profiler = profiler;
+  g_free (priv->profile_path);
+  priv->profile_path = g_strdup (profile_path);
+}
+
+const LauncherCounterValues*
+launcher_process_get_counters (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->counter_values;
+}
+
+/*
+ * The affinity, priorities and limits applied to the child before exec.
+ */
+void
+launcher_process_set_resources (LauncherProcess   *process,
+                                LauncherResources *resources)
+{
+  LauncherProcessPrivate *priv;
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  if (priv->resources)
+    g_object_unref (priv->resources);
+  priv->resources = NULL;
+  if (resources != NULL && !launcher_resources_is_empty (resources))
+    priv->resources = g_object_ref (resources);
+}
+
+void
+launcher_process_set_working_directory (LauncherProcess *process,
+                                        const gchar     *working_directory)
+{
+  LauncherProcessPrivate *priv;
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  g_free (priv->working_directory);
+  priv->working_directory = g_strdup (working_directory);
+}
+
+const gchar*
+launcher_process_get_working_directory (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->working_directory;
+}
+
+/*
+ * The complete environment of the child, the one of the editor when NULL.
+ */
+void
+launcher_process_set_environment (LauncherProcess  *process,
+                                  gchar           **environment)
+{
+  LauncherProcessPrivate *priv;
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  g_strfreev (priv->environment);
+  priv->environment = g_strdupv (environment);
+}
+
+/*
+ * The program the command runs, before any wrapper was put in front of it, 
+ * so that a core can be matched with its executable.
+ */
+void
+launcher_process_set_program (LauncherProcess *process,
+                              const gchar     *program)
+{
+  LauncherProcessPrivate *priv;
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  g_free (priv->program);
+  priv->program = g_strdup (program);
+}
+
+const gchar*
+launcher_process_get_program (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->program;
+}
+
+/*
+ * Raises the core size limit of the child to the hard limit, which is 
+ * usually unlimited, so that a crash leaves a core behind.
+ */
+void
+launcher_process_set_core_dumps (LauncherProcess *process,
+                                 gboolean         core_dumps)
+{
+  LAUNCHER_PROCESS_GET_PRIVATE (process)->core_dumps = core_dumps;
+}
+
+/*
+ * Whether the kernel reported a core for a process that was signaled.
+ */
+gboolean
+launcher_process_get_core_dumped (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->core_dumped;
+}
+
+/*
+ * Holds the run to the timeout and idle timeout of its config. Builds 
+ * share the config but not its timeouts, so they are not watched.
+ */
+void
+launcher_process_set_watchdog (LauncherProcess *process,
+                               gboolean         watchdog)
+{
+  LAUNCHER_PROCESS_GET_PRIVATE (process)->watchdog = watchdog;
+}
+
+LauncherProcessHang
+launcher_process_get_hang (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->hang;
+}
+
+/*
+ * Why the watchdog fired, in words, or NULL when it did not.
+ */
+gchar*
+launcher_process_get_hang_reason (LauncherProcess *process)
+{
+  LauncherProcessPrivate *priv;
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  
+  switch (priv->hang)
+    {
+    case LAUNCHER_PROCESS_HANG_TIMEOUT:
+      return g_strdup_printf ("still running after %d seconds", 
+                              launcher_config_get_timeout (priv->config));
+    case LAUNCHER_PROCESS_HANG_IDLE:
+      return g_strdup_printf ("no output for %d seconds", 
+                              launcher_config_get_idle_timeout (priv->config));
+    default:
+      return NULL;
+    }
+}
+
+/*
+ * Asks the process to exit with SIGTERM and kills it when it is still 
+ * running after the timeout. The "finished" signal tells when it is gone.
+ */
+void
+launcher_process_terminate (LauncherProcess *process,
+                            guint            timeout)
+{
+  LauncherProcessPrivate *priv;
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  
+  if (priv->state != LAUNCHER_PROCESS_RUNNING || priv->kill_id != 0)
+    return;
+  
+  kill (priv->pid, SIGTERM);
+  priv->kill_id = g_timeout_add (timeout, (GSourceFunc) kill_action, process);
+}
+
+static gboolean
+kill_action (LauncherProcess *process)
+{
+  LauncherProcessPrivate *priv;
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  priv->kill_id = 0;
+  kill (priv->pid, SIGKILL);
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * The time from the change that caused a restart in watch mode until this 
+ * process was spawned, or -1 when it was not restarted.
+ */
+gint64
+launcher_process_get_restart_latency (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->restart_latency;
+}
+
+void
+launcher_process_set_restart_latency (LauncherProcess *process,
+                                      gint64           restart_latency)
+{
+  LauncherProcessPrivate *priv;
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  priv->restart_latency = restart_latency;
+}
+
+/*
+ * The time from the launch until the first output arrived, or -1 when 
+ * nothing was written.
+ */
+gint64
+launcher_process_get_launch_latency (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->launch_latency;
+}
+
+/*
+ * Whether the process was released from a stand-by child.
+ */
+gboolean
+launcher_process_get_warm (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->warm;
+}
+
+/*
+ * The average launch latency of the cold runs to compare a warm run 
+ * with, or -1 when there is none yet.
+ */
+gint64
+launcher_process_get_cold_latency (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->cold_latency;
+}
+
+void
+launcher_process_set_cold_latency (LauncherProcess *process,
+                                   gint64           cold_latency)
+{
+  LauncherProcessPrivate *priv;
+  priv = LAUNCHER_PROCESS_GET_PRIVATE (process);
+  priv->cold_latency = cold_latency;
+}
+
+gchar**
+launcher_process_get_mapped_files (LauncherProcess *process)
+{
+  return LAUNCHER_PROCESS_GET_PRIVATE (process)->mapped_files;
+}
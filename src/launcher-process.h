@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_PROCESS_H__
+#define	__LAUNCHER_PROCESS_H__
+
+#include <gio/gio.h>
+#include "launcher-config.h"
+#include "launcher-output-buffer.h"
+#include "launcher-history.h"
+#include "launcher-counters.h"
+#include "launcher-resources.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_PROCESS_TYPE            (launcher_process_get_type ())
+#define LAUNCHER_PROCESS(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_PROCESS_TYPE, LauncherProcess))
+#define LAUNCHER_PROCESS_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_PROCESS_TYPE, LauncherProcessClass))
+#define IS_LAUNCHER_PROCESS(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_PROCESS_TYPE))
+#define IS_LAUNCHER_PROCESS_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_PROCESS_TYPE))
+
+typedef struct _LauncherProcess LauncherProcess;
+typedef struct _LauncherProcessClass LauncherProcessClass;
+
+typedef enum
+{
+  LAUNCHER_PROCESS_STARTING,
+  LAUNCHER_PROCESS_RUNNING,
+  LAUNCHER_PROCESS_EXITED,
+  LAUNCHER_PROCESS_SIGNALED,
+  LAUNCHER_PROCESS_FAILED
+} LauncherProcessState;
+
+typedef enum
+{
+  LAUNCHER_PROCESS_HANG_NONE,
+  LAUNCHER_PROCESS_HANG_TIMEOUT,
+  LAUNCHER_PROCESS_HANG_IDLE
+} LauncherProcessHang;
+
+struct _LauncherProcess
+{
+  GObject parent_instance;
+};
+
+struct _LauncherProcessClass
+{
+  GObjectClass parent_class;
+
+  void (*finished) (LauncherProcess *process);
+  void (*regression) (LauncherProcess *process);
+  void (*hung) (LauncherProcess *process);
+};
+
+GType launcher_process_get_type (void) G_GNUC_CONST;
+
+LauncherProcess*      launcher_process_new              (LauncherConfig   *config);
+
+gboolean              launcher_process_spawn            (LauncherProcess  *process,
+                                                         gchar           **argv,
+                                                         GError          **error);
+gboolean              launcher_process_prespawn         (LauncherProcess  *process,
+                                                         gchar           **argv,
+                                                         GError          **error);
+gboolean              launcher_process_release          (LauncherProcess  *process);
+void                  launcher_process_discard          (LauncherProcess  *process);
+
+LauncherConfig*       launcher_process_get_config       (LauncherProcess  *process);
+GPid                  launcher_process_get_pid          (LauncherProcess  *process);
+LauncherProcessState  launcher_process_get_state        (LauncherProcess  *process);
+gint64                launcher_process_get_start_time   (LauncherProcess  *process);
+gint64                launcher_process_get_run_time     (LauncherProcess  *process);
+gint                  launcher_process_get_exit_status  (LauncherProcess  *process);
+gint64                launcher_process_get_cpu_time     (LauncherProcess  *process);
+gint64                launcher_process_get_max_rss      (LauncherProcess  *process);
+const LauncherHistoryRegression* launcher_process_get_regression (LauncherProcess *process);
+void                  launcher_process_set_regression   (LauncherProcess  *process,
+                                                         const LauncherHistoryRegression *regression);
+LauncherOutputBuffer* launcher_process_get_output       (LauncherProcess  *process);
+LauncherProfiler      launcher_process_get_profiler     (LauncherProcess  *process);
+const gchar*          launcher_process_get_profile_path (LauncherProcess  *process);
+void                  launcher_process_set_profile      (LauncherProcess  *process,
+                                                         LauncherProfiler  profiler,
+                                                         const gchar      *profile_path);
+const LauncherCounterValues* launcher_process_get_counters (LauncherProcess *process);
+void                  launcher_process_set_resources    (LauncherProcess  *process,
+                                                         LauncherResources *resources);
+void                  launcher_process_set_working_directory (LauncherProcess *process,
+                                                              const gchar     *working_directory);
+const gchar*          launcher_process_get_working_directory (LauncherProcess *process);
+void                  launcher_process_set_environment  (LauncherProcess  *process,
+                                                         gchar           **environment);
+void                  launcher_process_set_program      (LauncherProcess  *process,
+                                                         const gchar      *program);
+const gchar*          launcher_process_get_program      (LauncherProcess  *process);
+void                  launcher_process_set_core_dumps   (LauncherProcess  *process,
+                                                         gboolean          core_dumps);
+gboolean              launcher_process_get_core_dumped  (LauncherProcess  *process);
+void                  launcher_process_set_watchdog     (LauncherProcess  *process,
+                                                         gboolean          watchdog);
+LauncherProcessHang   launcher_process_get_hang         (LauncherProcess  *process);
+gchar*                launcher_process_get_hang_reason  (LauncherProcess  *process);
+void                  launcher_process_terminate        (LauncherProcess  *process,
+                                                         guint             timeout);
+gint64                launcher_process_get_restart_latency (LauncherProcess *process);
+void                  launcher_process_set_restart_latency (LauncherProcess *process,
+                                                            gint64           restart_latency);
+gint64                launcher_process_get_launch_latency (LauncherProcess *process);
+gboolean              launcher_process_get_warm         (LauncherProcess  *process);
+gint64                launcher_process_get_cold_latency (LauncherProcess  *process);
+void                  launcher_process_set_cold_latency (LauncherProcess  *process,
+                                                         gint64            cold_latency);
+gchar**               launcher_process_get_mapped_files (LauncherProcess  *process);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_PROCESS_H__ */
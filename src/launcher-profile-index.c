@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include "launcher-profile-index.h"
+
+/*
+ * The index holds one entry for every profile of every project it was told 
+ * about, with the text the quick-pick matches against already folded to 
+ * lower case. A project is only read again when its launcher.conf changes, 
+ * opening the quick-pick never touches the disk.
+ */
+
+static void launcher_profile_index_class_init  (LauncherProfileIndexClass *klass);
+static void launcher_profile_index_init        (LauncherProfileIndex      *index);
+static void launcher_profile_index_finalize    (LauncherProfileIndex      *index);
+
+typedef struct
+{
+  const LauncherProfileEntry *entry;
+  gint                        score;
+} Match;
+
+static LauncherProfileEntry* entry_new  (CodeSlayerProject    *project,
+                                         const gchar          *name,
+                                         GKeyFile             *key_file,
+                                         const gchar          *section);
+static void entry_free                  (LauncherProfileEntry *entry);
+static gint fuzzy_score                 (const gchar          *query,
+                                         const gchar          *key);
+static gint compare_matches             (const Match          *match1,
+                                         const Match          *match2);
+
+#define LAUNCHER_PROFILE_INDEX_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_PROFILE_INDEX_TYPE, LauncherProfileIndexPrivate))
+
+typedef struct _LauncherProfileIndexPrivate LauncherProfileIndexPrivate;
+
+struct _LauncherProfileIndexPrivate
+{
+  GHashTable *projects;
+};
+
+G_DEFINE_TYPE (LauncherProfileIndex, launcher_profile_index, G_TYPE_OBJECT)
+
+static void 
+launcher_profile_index_class_init (LauncherProfileIndexClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_profile_index_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherProfileIndexPrivate));
+}
+
+static void
+launcher_profile_index_init (LauncherProfileIndex *index)
+{
+  LauncherProfileIndexPrivate *priv;
+  priv = LAUNCHER_PROFILE_INDEX_GET_PRIVATE (index);
+  priv->projects = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, 
+                                          (GDestroyNotify) g_ptr_array_unref);
+}
+
+static void
+launcher_profile_index_finalize (LauncherProfileIndex *index)
+{
+  LauncherProfileIndexPrivate *priv;
+  priv = LAUNCHER_PROFILE_INDEX_GET_PRIVATE (index);
+  g_hash_table_destroy (priv->projects);
+  G_OBJECT_CLASS (launcher_profile_index_parent_class)->finalize (G_OBJECT (index));
+}
+
+LauncherProfileIndex*
+launcher_profile_index_new (void)
+{
+  return LAUNCHER_PROFILE_INDEX (g_object_new (launcher_profile_index_get_type (), NULL));
+}
+
+gboolean
+launcher_profile_index_has_project (LauncherProfileIndex *index,
+                                    CodeSlayerProject    *project)
+{
+  LauncherProfileIndexPrivate *priv;
+  priv = LAUNCHER_PROFILE_INDEX_GET_PRIVATE (index);
+  return g_hash_table_contains (priv->projects, project);
+}
+
+/*
+ * Replaces the entries of the project with the profiles in the key file, 
+ * the other projects are left alone. A NULL key file indexes the project 
+ * as having no profiles.
+ */
+void
+launcher_profile_index_update (LauncherProfileIndex *index,
+                               CodeSlayerProject    *project,
+                               GKeyFile             *key_file)
+{
+  LauncherProfileIndexPrivate *priv;
+  GPtrArray *entries;
+  gchar **groups;
+  gchar **group;
+  
+  priv = LAUNCHER_PROFILE_INDEX_GET_PRIVATE (index);
+  
+  entries = g_ptr_array_new_with_free_func ((GDestroyNotify) entry_free);
+  
+  if (key_file != NULL)
+    {
+      groups = g_key_file_get_groups (key_file, NULL);
+      for (group = groups; *group != NULL; group++)
+        {
+          if (g_strcmp0 (*group, LAUNCHER_PROFILE_MAIN) == 0)
+            g_ptr_array_add (entries, entry_new (project, NULL, key_file, *group));
+          else if (g_str_has_prefix (*group, LAUNCHER_PROFILE_PREFIX))
+            g_ptr_array_add (entries, entry_new (project, *group + strlen (LAUNCHER_PROFILE_PREFIX), 
+                                                 key_file, *group));
+        }
+      g_strfreev (groups);
+    }
+  
+  g_hash_table_replace (priv->projects, project, entries);
+}
+
+void
+launcher_profile_index_remove (LauncherProfileIndex *index,
+                               CodeSlayerProject    *project)
+{
+  LauncherProfileIndexPrivate *priv;
+  priv = LAUNCHER_PROFILE_INDEX_GET_PRIVATE (index);
+  g_hash_table_remove (priv->projects, project);
+}
+
+/*
+ * Returns the best matches first, at most limit of them. The entries 
+ * belong to the index and are only valid until it changes.
+ */
+GPtrArray*
+launcher_profile_index_search (LauncherProfileIndex *index,
+                               const gchar          *query,
+                               guint                 limit)
+{
+  LauncherProfileIndexPrivate *priv;
+  GHashTableIter iter;
+  GPtrArray *entries;
+  GPtrArray *results;
+  GArray *matches;
+  gchar *folded;
+  guint i;
+  
+  priv = LAUNCHER_PROFILE_INDEX_GET_PRIVATE (index);
+  
+  folded = g_ascii_strdown (query != NULL ? query : "", -1);
+  g_strstrip (folded);
+  matches = g_array_new (FALSE, FALSE, sizeof (Match));
+  
+  g_hash_table_iter_init (&iter, priv->projects);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &entries))
+    {
+      for (i = 0; i < entries->len; i++)
+        {
+          Match match;
+          match.entry = g_ptr_array_index (entries, i);
+          match.score = fuzzy_score (folded, match.entry->key);
+          if (match.score >= 0)
+            g_array_append_val (matches, match);
+        }
+    }
+  
+  g_array_sort (matches, (GCompareFunc) compare_matches);
+  
+  results = g_ptr_array_new ();
+  for (i = 0; i < matches->len && i < limit; i++)
+    g_ptr_array_add (results, (gpointer) g_array_index (matches, Match, i).entry);
+  
+  g_array_free (matches, TRUE);
+  g_free (folded);
+  
+  return results;
+}
+
+static LauncherProfileEntry*
+entry_new (CodeSlayerProject *project,
+           const gchar       *name,
+           GKeyFile          *key_file,
+           const gchar       *section)
+{
+  LauncherProfileEntry *entry;
+  gchar *executable;
+  gchar *parameters;
+  gchar *key;
+  
+  executable = g_key_file_get_string (key_file, section, "executable", NULL);
+  parameters = g_key_file_get_string (key_file, section, "parameters", NULL);
+  
+  entry = g_slice_new (LauncherProfileEntry);
+  entry->project = project;
+  entry->name = g_strdup (name);
+  entry->label = g_strconcat (codeslayer_project_get_name (project), ": ", 
+                              name != NULL ? name : LAUNCHER_PROFILE_MAIN, NULL);
+  entry->detail = g_strjoin (" ", executable != NULL ? executable : "", 
+                             parameters != NULL ? parameters : "", NULL);
+  
+  key = g_strconcat (entry->label, " ", entry->detail, NULL);
+  entry->key = g_ascii_strdown (key, -1);
+  g_free (key);
+  
+  g_free (executable);
+  g_free (parameters);
+  
+  return entry;
+}
+
+static void
+entry_free (LauncherProfileEntry *entry)
+{
+  g_free (entry->name);
+  g_free (entry->label);
+  g_free (entry->detail);
+  g_free (entry->key);
+  g_slice_free (LauncherProfileEntry, entry);
+}
+
+/*
+ * The characters of the query have to appear in the key in order. Runs of 
+ * consecutive characters and characters at the start of a word count 
+ * more, and so does an early first match. Returns -1 when there is no 
+ * match.
+ */
+static gint
+fuzzy_score (const gchar *query,
+             const gchar *key)
+{
+  const gchar *position = key;
+  const gchar *last = NULL;
+  gint score = 0;
+  
+  for (; *query != '\0'; query++)
+    {
+      const gchar *found;
+      
+      if (*query == ' ')
+        continue;
+      
+      found = strchr (position, *query);
+      if (found == NULL)
+        return -1;
+      
+      score += 1;
+      if (last != NULL && found == last + 1)
+        score += 5;
+      if (found == key || strchr (" :/-_.", found[-1]) != NULL)
+        score += 3;
+      if (last == NULL)
+        score += MAX (0, 10 - (gint) (found - key));
+      
+      last = found;
+      position = found + 1;
+    }
+  
+  return score;
+}
+
+static gint
+compare_matches (const Match *match1,
+                 const Match *match2)
+{
+  if (match1->score != match2->score)
+    return match2->score - match1->score;
+  return g_strcmp0 (match1->entry->label, match2->entry->label);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_PROFILE_INDEX_H__
+#define	__LAUNCHER_PROFILE_INDEX_H__
+
+#include <gtk/gtk.h>
+#include <codeslayer/codeslayer.h>
+#include "launcher-core.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_PROFILE_INDEX_TYPE            (launcher_profile_index_get_type ())
+#define LAUNCHER_PROFILE_INDEX(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_PROFILE_INDEX_TYPE, LauncherProfileIndex))
+#define LAUNCHER_PROFILE_INDEX_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_PROFILE_INDEX_TYPE, LauncherProfileIndexClass))
+#define IS_LAUNCHER_PROFILE_INDEX(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_PROFILE_INDEX_TYPE))
+#define IS_LAUNCHER_PROFILE_INDEX_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_PROFILE_INDEX_TYPE))
+
+typedef struct _LauncherProfileIndex LauncherProfileIndex;
+typedef struct _LauncherProfileIndexClass LauncherProfileIndexClass;
+
+/*
+ * The name is NULL for the main profile of the project.
+ */
+typedef struct
+{
+  CodeSlayerProject *project;
+  gchar             *name;
+  gchar             *label;
+  gchar             *detail;
+  gchar             *key;
+} LauncherProfileEntry;
+
+struct _LauncherProfileIndex
+{
+  GObject parent_instance;
+};
+
+struct _LauncherProfileIndexClass
+{
+  GObjectClass parent_class;
+};
+
+GType launcher_profile_index_get_type (void) G_GNUC_CONST;
+
+LauncherProfileIndex*  launcher_profile_index_new            (void);
+
+gboolean               launcher_profile_index_has_project    (LauncherProfileIndex *index,
+                                                              CodeSlayerProject    *project);
+void                   launcher_profile_index_update         (LauncherProfileIndex *index,
+                                                              CodeSlayerProject    *project,
+                                                              GKeyFile             *key_file);
+void                   launcher_profile_index_remove         (LauncherProfileIndex *index,
+                                                              CodeSlayerProject    *project);
+GPtrArray*             launcher_profile_index_search         (LauncherProfileIndex *index,
+                                                              const gchar          *query,
+                                                              guint                 limit);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_PROFILE_INDEX_H__ */
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "launcher-profile-picker.h"
+
+/*
+ * The quick-pick is a modal dialog with an entry on top of the matching 
+ * profiles. Every key stroke searches the index again, the arrow keys move 
+ * through the list without leaving the entry and enter launches.
+ */
+
+#define MAX_ROWS 200
+
+enum
+{
+  LABEL = 0,
+  DETAIL,
+  PROJECT,
+  NAME,
+  COLUMNS
+};
+
+typedef struct
+{
+  LauncherProfileIndex *index;
+  GtkWidget            *dialog;
+  GtkListStore         *store;
+  GtkWidget            *tree;
+} Picker;
+
+static void search_action         (GtkEntry          *entry,
+                                   Picker            *picker);
+static gboolean key_press_action  (GtkWidget         *entry,
+                                   GdkEventKey       *event,
+                                   Picker            *picker);
+static void activate_action       (GtkEntry          *entry,
+                                   Picker            *picker);
+static void row_activated_action  (GtkTreeView       *tree_view,
+                                   GtkTreePath       *path,
+                                   GtkTreeViewColumn *column,
+                                   Picker            *picker);
+
+/*
+ * Returns TRUE with the project and the name of the picked profile, the 
+ * name is NULL for the main profile and has to be freed.
+ */
+gboolean
+launcher_profile_picker_run (LauncherProfileIndex  *index,
+                             CodeSlayerProject    **project,
+                             gchar                **name)
+{
+  Picker picker;
+  GtkWidget *content_area;
+  GtkWidget *entry;
+  GtkWidget *scrolled_window;
+  GtkCellRenderer *renderer;
+  GtkTreeViewColumn *column;
+  GtkTreeSelection *selection;
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  gboolean picked = FALSE;
+  
+  picker.index = index;
+  picker.dialog = gtk_dialog_new_with_buttons ("Launch Profile", NULL, GTK_DIALOG_MODAL,
+                                               GTK_STOCK_CANCEL, GTK_RESPONSE_CANCEL,
+                                               GTK_STOCK_EXECUTE, GTK_RESPONSE_OK,
+                                               NULL);
+  gtk_dialog_set_default_response (GTK_DIALOG (picker.dialog), GTK_RESPONSE_OK);
+  gtk_window_set_default_size (GTK_WINDOW (picker.dialog), 600, 400);
+  
+  picker.store = gtk_list_store_new (COLUMNS, G_TYPE_STRING, G_TYPE_STRING, 
+                                     G_TYPE_POINTER, G_TYPE_STRING);
+  picker.tree = gtk_tree_view_new_with_model (GTK_TREE_MODEL (picker.store));
+  gtk_tree_view_set_headers_visible (GTK_TREE_VIEW (picker.tree), FALSE);
+  gtk_tree_view_set_enable_search (GTK_TREE_VIEW (picker.tree), FALSE);
+  
+  renderer = gtk_cell_renderer_text_new ();
+  column = gtk_tree_view_column_new_with_attributes (NULL, renderer, "text", LABEL, NULL);
+  gtk_tree_view_append_column (GTK_TREE_VIEW (picker.tree), column);
+  
+  renderer = gtk_cell_renderer_text_new ();
+  g_object_set (renderer, "foreground", "gray", "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+  column = gtk_tree_view_column_new_with_attributes (NULL, renderer, "text", DETAIL, NULL);
+  gtk_tree_view_column_set_expand (column, TRUE);
+  gtk_tree_view_append_column (GTK_TREE_VIEW (picker.tree), column);
+  
+  scrolled_window = gtk_scrolled_window_new (NULL, NULL);
+  gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolled_window), 
+                                  GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_container_add (GTK_CONTAINER (scrolled_window), picker.tree);
+  
+  entry = gtk_entry_new ();
+  
+  content_area = gtk_dialog_get_content_area (GTK_DIALOG (picker.dialog));
+  gtk_container_set_border_width (GTK_CONTAINER (content_area), 8);
+  gtk_box_set_spacing (GTK_BOX (content_area), 4);
+  gtk_box_pack_start (GTK_BOX (content_area), entry, FALSE, FALSE, 0);
+  gtk_box_pack_start (GTK_BOX (content_area), scrolled_window, TRUE, TRUE, 0);
+  gtk_widget_show_all (content_area);
+  
+  g_signal_connect (G_OBJECT (entry), "changed",
+                    G_CALLBACK (search_action), &picker);
+  g_signal_connect (G_OBJECT (entry), "key-press-event",
+                    G_CALLBACK (key_press_action), &picker);
+  g_signal_connect (G_OBJECT (entry), "activate",
+                    G_CALLBACK (activate_action), &picker);
+  g_signal_connect (G_OBJECT (picker.tree), "row-activated",
+                    G_CALLBACK (row_activated_action), &picker);
+  
+  search_action (GTK_ENTRY (entry), &picker);
+  gtk_widget_grab_focus (entry);
+  
+  if (gtk_dialog_run (GTK_DIALOG (picker.dialog)) == GTK_RESPONSE_OK)
+    {
+      selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (picker.tree));
+      if (gtk_tree_selection_get_selected (selection, &model, &iter))
+        {
+          gtk_tree_model_get (model, &iter, PROJECT, project, NAME, name, -1);
+          picked = TRUE;
+        }
+    }
+  
+  gtk_widget_destroy (picker.dialog);
+  g_object_unref (picker.store);
+  
+  return picked;
+}
+
+/*
+ * The rows hold copies of the entries, the index may change while the 
+ * dialog runs its own main loop.
+ */
+static void
+search_action (GtkEntry *entry,
+               Picker   *picker)
+{
+  GtkTreeSelection *selection;
+  GtkTreeIter iter;
+  GPtrArray *results;
+  guint i;
+  
+  results = launcher_profile_index_search (picker->index, gtk_entry_get_text (entry), MAX_ROWS);
+  
+  gtk_list_store_clear (picker->store);
+  for (i = 0; i < results->len; i++)
+    {
+      const LauncherProfileEntry *profile = g_ptr_array_index (results, i);
+      gtk_list_store_append (picker->store, &iter);
+      gtk_list_store_set (picker->store, &iter, 
+                          LABEL, profile->label,
+                          DETAIL, profile->detail,
+                          PROJECT, profile->project,
+                          NAME, profile->name,
+                          -1);
+    }
+  g_ptr_array_free (results, TRUE);
+  
+  selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (picker->tree));
+  if (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (picker->store), &iter))
+    gtk_tree_selection_select_iter (selection, &iter);
+}
+
+static gboolean
+key_press_action (GtkWidget   *entry,
+                  GdkEventKey *event,
+                  Picker      *picker)
+{
+  GtkTreeSelection *selection;
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  GtkTreePath *path;
+  
+  if (event->keyval != GDK_KEY_Up && event->keyval != GDK_KEY_Down)
+    return FALSE;
+  
+  selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (picker->tree));
+  if (!gtk_tree_selection_get_selected (selection, &model, &iter))
+    return TRUE;
+  
+  if (event->keyval == GDK_KEY_Down)
+    {
+      if (!gtk_tree_model_iter_next (model, &iter))
+        return TRUE;
+    }
+  else
+    {
+      path = gtk_tree_model_get_path (model, &iter);
+      if (!gtk_tree_path_prev (path) || !gtk_tree_model_get_iter (model, &iter, path))
+        {
+          gtk_tree_path_free (path);
+          return TRUE;
+        }
+      gtk_tree_path_free (path);
+    }
+  
+  gtk_tree_selection_select_iter (selection, &iter);
+  path = gtk_tree_model_get_path (model, &iter);
+  gtk_tree_view_scroll_to_cell (GTK_TREE_VIEW (picker->tree), path, NULL, FALSE, 0, 0);
+  gtk_tree_path_free (path);
+  
+  return TRUE;
+}
+
+static void
+activate_action (GtkEntry *entry,
+                 Picker   *picker)
+{
+  gtk_dialog_response (GTK_DIALOG (picker->dialog), GTK_RESPONSE_OK);
+}
+
+static void
+row_activated_action (GtkTreeView       *tree_view,
+                      GtkTreePath       *path,
+                      GtkTreeViewColumn *column,
+                      Picker            *picker)
+{
+  gtk_dialog_response (GTK_DIALOG (picker->dialog), GTK_RESPONSE_OK);
+}
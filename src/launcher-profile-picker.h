@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_PROFILE_PICKER_H__
+#define	__LAUNCHER_PROFILE_PICKER_H__
+
+#include <gtk/gtk.h>
+#include "launcher-profile-index.h"
+
+G_BEGIN_DECLS
+
+gboolean  launcher_profile_picker_run  (LauncherProfileIndex  *index,
+                                        CodeSlayerProject    **project,
+                                        gchar                **name);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_PROFILE_PICKER_H__ */
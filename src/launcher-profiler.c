@@ -0,0 +1,658 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include "launcher-profiler.h"
+
+#define SUMMARY_LINES 25
+#define SUMMARY_SITES 20
+#define SITE_CALLERS 3
+
+#ifndef LAUNCHER_MALLOC_LIBRARY
+#define LAUNCHER_MALLOC_LIBRARY "liblaunchermalloc.so"
+#endif
+
+static const gchar *names[] = { "none", "perf", "callgrind", "massif", "heaptrack", "malloc", NULL };
+static const gchar *extensions[] = { "", "data", "out", "out", "data", "out", NULL };
+
+typedef struct
+{
+  gchar *address;
+  gchar *symbol;
+  gchar *module;
+  gchar *function;
+  gchar *location;
+} MallocFrame;
+
+typedef struct
+{
+  guint64    samples;
+  guint64    sampled_bytes;
+  GPtrArray *frames;
+} MallocSite;
+
+static gchar* find_output_file          (LauncherProfiler  profiler,
+                                         const gchar      *output_path);
+static void communicate_action          (GSubprocess      *subprocess,
+                                         GAsyncResult     *result,
+                                         GTask            *task);
+static gchar* extract_summary           (LauncherProfiler  profiler,
+                                         const gchar      *output);
+static gchar* extract_lines             (gchar           **lines,
+                                         gint              start,
+                                         const gchar      *prefix,
+                                         gboolean          stop_at_blank);
+static void summarize_malloc_thread     (GTask            *task,
+                                         gpointer          source_object,
+                                         gchar            *file_path,
+                                         GCancellable     *cancellable);
+static gchar* summarize_malloc          (const gchar      *contents);
+static void symbolize_frames            (GPtrArray        *sites);
+static void malloc_frame_free           (MallocFrame      *frame);
+static void malloc_site_free            (MallocSite       *site);
+
+const gchar*
+launcher_profiler_to_string (LauncherProfiler profiler)
+{
+  return names[profiler];
+}
+
+LauncherProfiler
+launcher_profiler_from_string (const gchar *string)
+{
+  gint i;
+  for (i = 0; names[i] != NULL; i++)
+    {
+      if (g_strcmp0 (string, names[i]) == 0)
+        return i;
+    }
+  return LAUNCHER_PROFILER_NONE;
+}
+
+gchar*
+launcher_profiler_create_output_path (LauncherProfiler  profiler,
+                                      const gchar      *folder_path)
+{
+  GDateTime *now;
+  gchar *timestamp;
+  gchar *file_name;
+  gchar *file_path;
+  
+  now = g_date_time_new_now_local ();
+  timestamp = g_date_time_format (now, "%Y%m%d-%H%M%S");
+  file_name = g_strdup_printf ("%s.%s.%s", names[profiler], timestamp, extensions[profiler]);
+  file_path = g_build_filename (folder_path, file_name, NULL);
+  
+  g_date_time_unref (now);
+  g_free (timestamp);
+  g_free (file_name);
+  
+  return file_path;
+}
+
+gchar**
+launcher_profiler_wrap_argv (LauncherProfiler   profiler,
+                             gchar            **argv,
+                             gchar            **envp,
+                             const gchar       *output_path)
+{
+  GPtrArray *array;
+  const gchar *preload;
+  gint i;
+  
+  array = g_ptr_array_new ();
+  
+  switch (profiler)
+    {
+    case LAUNCHER_PROFILER_NONE:
+      break;
+    case LAUNCHER_PROFILER_PERF:
+      g_ptr_array_add (array, g_strdup ("perf"));
+      g_ptr_array_add (array, g_strdup ("record"));
+      g_ptr_array_add (array, g_strdup ("-g"));
+      g_ptr_array_add (array, g_strdup ("-o"));
+      g_ptr_array_add (array, g_strdup (output_path));
+      g_ptr_array_add (array, g_strdup ("--"));
+      break;
+    case LAUNCHER_PROFILER_CALLGRIND:
+      g_ptr_array_add (array, g_strdup ("valgrind"));
+      g_ptr_array_add (array, g_strdup ("--tool=callgrind"));
+      g_ptr_array_add (array, g_strconcat ("--callgrind-out-file=", output_path, NULL));
+      break;
+    case LAUNCHER_PROFILER_MASSIF:
+      g_ptr_array_add (array, g_strdup ("valgrind"));
+      g_ptr_array_add (array, g_strdup ("--tool=massif"));
+      g_ptr_array_add (array, g_strconcat ("--massif-out-file=", output_path, NULL));
+      break;
+    case LAUNCHER_PROFILER_HEAPTRACK:
+      g_ptr_array_add (array, g_strdup ("heaptrack"));
+      g_ptr_array_add (array, g_strdup ("-o"));
+      g_ptr_array_add (array, g_strdup (output_path));
+      break;
+    case LAUNCHER_PROFILER_MALLOC:
+      /* a preloaded allocator stays, the profiler goes in front of it */
+      preload = envp != NULL ? g_environ_getenv (envp, "LD_PRELOAD") : g_getenv ("LD_PRELOAD");
+      g_ptr_array_add (array, g_strdup ("env"));
+      if (preload != NULL && *preload != '\0')
+        g_ptr_array_add (array, g_strconcat ("LD_PRELOAD=", LAUNCHER_MALLOC_LIBRARY, ":", preload, NULL));
+      else
+        g_ptr_array_add (array, g_strconcat ("LD_PRELOAD=", LAUNCHER_MALLOC_LIBRARY, NULL));
+      g_ptr_array_add (array, g_strconcat ("LAUNCHER_MALLOC_OUTPUT=", output_path, NULL));
+      break;
+    }
+  
+  for (i = 0; argv[i] != NULL; i++)
+    g_ptr_array_add (array, g_strdup (argv[i]));
+  
+  g_ptr_array_add (array, NULL);
+  return (gchar **) g_ptr_array_free (array, FALSE);
+}
+
+void
+launcher_profiler_summarize_async (LauncherProfiler     profiler,
+                                   const gchar         *output_path,
+                                   GCancellable        *cancellable,
+                                   GAsyncReadyCallback  callback,
+                                   gpointer             user_data)
+{
+  GSubprocess *subprocess;
+  GError *error = NULL;
+  GTask *task;
+  gchar *file_path;
+
+  task = g_task_new (NULL, cancellable, callback, user_data);
+  g_task_set_task_data (task, GINT_TO_POINTER (profiler), NULL);
+  
+  file_path = find_output_file (profiler, output_path);
+  if (file_path == NULL)
+    {
+      g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+                               "The profiler did not write %s", output_path);
+      g_object_unref (task);
+      return;
+    }
+  
+  /* the preload library writes its own report, there is no tool to run */
+  if (profiler == LAUNCHER_PROFILER_MALLOC)
+    {
+      g_task_set_task_data (task, file_path, g_free);
+      g_task_run_in_thread (task, (GTaskThreadFunc) summarize_malloc_thread);
+      g_object_unref (task);
+      return;
+    }
+  
+  switch (profiler)
+    {
+    case LAUNCHER_PROFILER_PERF:
+      subprocess = g_subprocess_new (G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, 
+                                     &error, "perf", "report", "--stdio", "--no-children", "-g", "none",
+                                     "--sort", "symbol", "-i", file_path, NULL);
+      break;
+    case LAUNCHER_PROFILER_CALLGRIND:
+      subprocess = g_subprocess_new (G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, 
+                                     &error, "callgrind_annotate", file_path, NULL);
+      break;
+    case LAUNCHER_PROFILER_MASSIF:
+      subprocess = g_subprocess_new (G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, 
+                                     &error, "ms_print", file_path, NULL);
+      break;
+    case LAUNCHER_PROFILER_HEAPTRACK:
+      subprocess = g_subprocess_new (G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, 
+                                     &error, "heaptrack_print", file_path, NULL);
+      break;
+    default:
+      subprocess = NULL;
+      g_set_error (&error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "No profiler was used");
+      break;
+    }
+  
+  g_free (file_path);
+
+  if (subprocess == NULL)
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  g_subprocess_communicate_utf8_async (subprocess, NULL, cancellable, 
+                                       (GAsyncReadyCallback) communicate_action, task);
+  g_object_unref (subprocess);
+}
+
+gchar*
+launcher_profiler_summarize_finish (GAsyncResult  *result,
+                                    GError       **error)
+{
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/*
+ * heaptrack decides on the compression itself and appends the extension 
+ * to the name it was given.
+ */
+static gchar*
+find_output_file (LauncherProfiler  profiler,
+                  const gchar      *output_path)
+{
+  if (profiler == LAUNCHER_PROFILER_HEAPTRACK)
+    {
+      const gchar *suffixes[] = { ".zst", ".gz", NULL };
+      gint i;
+      for (i = 0; suffixes[i] != NULL; i++)
+        {
+          gchar *file_path;
+          file_path = g_strconcat (output_path, suffixes[i], NULL);
+          if (g_file_test (file_path, G_FILE_TEST_EXISTS))
+            return file_path;
+          g_free (file_path);
+        }
+    }
+
+  if (g_file_test (output_path, G_FILE_TEST_EXISTS))
+    return g_strdup (output_path);
+
+  return NULL;
+}
+
+static void
+communicate_action (GSubprocess  *subprocess,
+                    GAsyncResult *result,
+                    GTask        *task)
+{
+  LauncherProfiler profiler;
+  GError *error = NULL;
+  gchar *output = NULL;
+  
+  if (!g_subprocess_communicate_utf8_finish (subprocess, result, &output, NULL, &error))
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+  
+  profiler = GPOINTER_TO_INT (g_task_get_task_data (task));
+  g_task_return_pointer (task, extract_summary (profiler, output), g_free);
+  g_object_unref (task);
+  g_free (output);
+}
+
+/*
+ * Each tool prints a lot more than is useful at a glance, so only the 
+ * section naming the hot functions or the peak allocation sites is kept.
+ */
+static gchar*
+extract_summary (LauncherProfiler  profiler,
+                 const gchar      *output)
+{
+  gchar **lines;
+  gchar *summary = NULL;
+  gint i;
+  
+  if (output == NULL)
+    return g_strdup ("");
+
+  lines = g_strsplit (output, "\n", -1);
+  
+  switch (profiler)
+    {
+    case LAUNCHER_PROFILER_PERF:
+      summary = extract_lines (lines, 0, NULL, FALSE);
+      break;
+    case LAUNCHER_PROFILER_CALLGRIND:
+      for (i = 0; lines[i] != NULL; i++)
+        {
+          if (strstr (lines[i], "file:function") != NULL && lines[i + 1] != NULL)
+            {
+              summary = extract_lines (lines, i + 2, NULL, TRUE);
+              break;
+            }
+        }
+      break;
+    case LAUNCHER_PROFILER_MASSIF:
+      for (i = g_strv_length (lines) - 1; i >= 0; i--)
+        {
+          if (strstr (lines[i], "(peak)") != NULL)
+            {
+              summary = extract_lines (lines, i + 1, "->", FALSE);
+              break;
+            }
+        }
+      break;
+    case LAUNCHER_PROFILER_HEAPTRACK:
+      for (i = 0; lines[i] != NULL; i++)
+        {
+          if (g_str_has_prefix (lines[i], "PEAK MEMORY CONSUMERS"))
+            {
+              summary = extract_lines (lines, i + 1, NULL, FALSE);
+              break;
+            }
+        }
+      break;
+    default:
+      break;
+    }
+  
+  if (summary == NULL || *summary == '\0')
+    {
+      g_free (summary);
+      summary = extract_lines (lines, 0, NULL, FALSE);
+    }
+
+  g_strfreev (lines);
+  return summary;
+}
+
+static gchar*
+extract_lines (gchar       **lines,
+               gint          start,
+               const gchar  *prefix,
+               gboolean      stop_at_blank)
+{
+  GString *string;
+  gint count = 0;
+  gint i;
+  
+  string = g_string_new (NULL);
+  
+  for (i = start; lines[i] != NULL && count < SUMMARY_LINES; i++)
+    {
+      gchar *line = lines[i];
+      
+      if (strspn (line, " \t\r") == strlen (line))
+        {
+          if (stop_at_blank && count > 0)
+            break;
+          continue;
+        }
+      
+      if (line[0] == '#')
+        continue;
+      
+      if (prefix != NULL && !g_str_has_prefix (line, prefix))
+        continue;
+      
+      g_string_append (string, line);
+      g_string_append_c (string, '\n');
+      count++;
+    }
+
+  return g_string_free (string, FALSE);
+}
+
+static void
+summarize_malloc_thread (GTask        *task,
+                         gpointer      source_object,
+                         gchar        *file_path,
+                         GCancellable *cancellable)
+{
+  GError *error = NULL;
+  gchar *contents;
+  
+  if (!g_file_get_contents (file_path, &contents, NULL, &error))
+    {
+      g_task_return_error (task, error);
+      return;
+    }
+  
+  g_task_return_pointer (task, summarize_malloc (contents), g_free);
+  g_free (contents);
+}
+
+/*
+ * The sites were sampled about once every sample_interval bytes, so each 
+ * sample of a site stands for about that many bytes allocated there.
+ */
+static gchar*
+summarize_malloc (const gchar *contents)
+{
+  GString *string;
+  GPtrArray *sites;
+  MallocSite *site = NULL;
+  gchar **lines;
+  guint64 mallocs = 0, callocs = 0, reallocs = 0, aligned = 0, frees = 0;
+  guint64 bytes = 0, threads = 0, sample_interval = 0;
+  gint64 peak = 0, live = 0;
+  gchar *bytes_size, *peak_size, *live_size;
+  guint i;
+  
+  sites = g_ptr_array_new_with_free_func ((GDestroyNotify) malloc_site_free);
+  lines = g_strsplit (contents, "\n", -1);
+  
+  for (i = 0; lines[i] != NULL; i++)
+    {
+      gchar **fields;
+      
+      fields = g_strsplit (lines[i], " ", 4);
+      if (g_strv_length (fields) < 2)
+        {
+          g_strfreev (fields);
+          continue;
+        }
+      
+      if (g_strcmp0 (fields[0], "mallocs") == 0)
+        mallocs = g_ascii_strtoull (fields[1], NULL, 10);
+      else if (g_strcmp0 (fields[0], "callocs") == 0)
+        callocs = g_ascii_strtoull (fields[1], NULL, 10);
+      else if (g_strcmp0 (fields[0], "reallocs") == 0)
+        reallocs = g_ascii_strtoull (fields[1], NULL, 10);
+      else if (g_strcmp0 (fields[0], "aligned") == 0)
+        aligned = g_ascii_strtoull (fields[1], NULL, 10);
+      else if (g_strcmp0 (fields[0], "frees") == 0)
+        frees = g_ascii_strtoull (fields[1], NULL, 10);
+      else if (g_strcmp0 (fields[0], "bytes") == 0)
+        bytes = g_ascii_strtoull (fields[1], NULL, 10);
+      else if (g_strcmp0 (fields[0], "peak") == 0)
+        peak = MAX (g_ascii_strtoll (fields[1], NULL, 10), 0);
+      else if (g_strcmp0 (fields[0], "live") == 0)
+        live = MAX (g_ascii_strtoll (fields[1], NULL, 10), 0);
+      else if (g_strcmp0 (fields[0], "threads") == 0)
+        threads = g_ascii_strtoull (fields[1], NULL, 10);
+      else if (g_strcmp0 (fields[0], "sample_interval") == 0)
+        sample_interval = g_ascii_strtoull (fields[1], NULL, 10);
+      else if (g_strcmp0 (fields[0], "site") == 0 && fields[2] != NULL)
+        {
+          site = NULL;
+          if (sites->len < SUMMARY_SITES)
+            {
+              site = g_new0 (MallocSite, 1);
+              site->samples = g_ascii_strtoull (fields[1], NULL, 10);
+              site->sampled_bytes = g_ascii_strtoull (fields[2], NULL, 10);
+              site->frames = g_ptr_array_new_with_free_func ((GDestroyNotify) malloc_frame_free);
+              g_ptr_array_add (sites, site);
+            }
+        }
+      else if (g_strcmp0 (fields[0], "frame") == 0 && site != NULL && 
+               g_strv_length (fields) == 4)
+        {
+          MallocFrame *frame;
+          frame = g_new0 (MallocFrame, 1);
+          frame->address = g_strdup (fields[1]);
+          frame->symbol = g_strdup (fields[2]);
+          frame->module = g_strdup (fields[3]);
+          g_ptr_array_add (site->frames, frame);
+        }
+      
+      g_strfreev (fields);
+    }
+  
+  g_strfreev (lines);
+  
+  symbolize_frames (sites);
+  
+  bytes_size = g_format_size (bytes);
+  peak_size = g_format_size (peak);
+  live_size = g_format_size (live);
+  
+  string = g_string_new (NULL);
+  g_string_append_printf (string, "%" G_GUINT64_FORMAT " allocations (%" G_GUINT64_FORMAT " malloc, %" 
+                          G_GUINT64_FORMAT " calloc, %" G_GUINT64_FORMAT " realloc, %" 
+                          G_GUINT64_FORMAT " aligned), %" G_GUINT64_FORMAT " frees, %" 
+                          G_GUINT64_FORMAT " threads\n", 
+                          mallocs + callocs + reallocs + aligned, mallocs, callocs, reallocs, 
+                          aligned, frees, threads);
+  g_string_append_printf (string, "%s allocated, %s peak, %s live at exit\n", 
+                          bytes_size, peak_size, live_size);
+  
+  if (sites->len > 0)
+    g_string_append_printf (string, "\ntop allocation sites (sampled every %" G_GUINT64_FORMAT " bytes)\n", 
+                            sample_interval);
+  
+  for (i = 0; i < sites->len; i++)
+    {
+      MallocFrame *frame;
+      gchar *estimate;
+      guint j;
+      
+      site = g_ptr_array_index (sites, i);
+      estimate = g_format_size (site->samples * sample_interval);
+      
+      g_string_append_printf (string, "%5.1f%%  ~%s  (%" G_GUINT64_FORMAT " samples)\n", 
+                              bytes > 0 ? MIN (100.0 * site->samples * sample_interval / bytes, 100.0) : 0.0, 
+                              estimate, site->samples);
+      
+      for (j = 0; j < site->frames->len && j <= SITE_CALLERS; j++)
+        {
+          frame = g_ptr_array_index (site->frames, j);
+          g_string_append_printf (string, "    %s %s", j == 0 ? "at" : "<-", 
+                                  frame->function != NULL ? frame->function : frame->symbol);
+          if (frame->location != NULL)
+            g_string_append_printf (string, " (%s)", frame->location);
+          g_string_append_c (string, '\n');
+        }
+      
+      g_free (estimate);
+    }
+  
+  g_free (bytes_size);
+  g_free (peak_size);
+  g_free (live_size);
+  g_ptr_array_unref (sites);
+  
+  return g_string_free (string, FALSE);
+}
+
+/*
+ * The library only has the dynamic symbols at hand, so the frames that 
+ * are shown are run through addr2line once per module for the function 
+ * and line the debug info gives.
+ */
+static void
+symbolize_frames (GPtrArray *sites)
+{
+  GHashTable *modules;
+  GHashTableIter iter;
+  gpointer key, value;
+  guint i, j;
+  
+  modules = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, 
+                                   (GDestroyNotify) g_ptr_array_unref);
+  
+  for (i = 0; i < sites->len; i++)
+    {
+      MallocSite *site = g_ptr_array_index (sites, i);
+      for (j = 0; j < site->frames->len && j <= SITE_CALLERS; j++)
+        {
+          MallocFrame *frame = g_ptr_array_index (site->frames, j);
+          GPtrArray *frames;
+          
+          if (g_strcmp0 (frame->module, "?") == 0)
+            continue;
+          
+          frames = g_hash_table_lookup (modules, frame->module);
+          if (frames == NULL)
+            {
+              frames = g_ptr_array_new ();
+              g_hash_table_insert (modules, frame->module, frames);
+            }
+          g_ptr_array_add (frames, frame);
+        }
+    }
+  
+  g_hash_table_iter_init (&iter, modules);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      GPtrArray *frames = value;
+      GPtrArray *argv;
+      GSubprocess *subprocess;
+      gchar *output = NULL;
+      gchar **lines;
+      guint n_lines;
+      
+      argv = g_ptr_array_new ();
+      g_ptr_array_add (argv, "addr2line");
+      g_ptr_array_add (argv, "-C");
+      g_ptr_array_add (argv, "-f");
+      g_ptr_array_add (argv, "-e");
+      g_ptr_array_add (argv, key);
+      for (i = 0; i < frames->len; i++)
+        g_ptr_array_add (argv, ((MallocFrame *) g_ptr_array_index (frames, i))->address);
+      g_ptr_array_add (argv, NULL);
+      
+      subprocess = g_subprocess_newv ((const gchar * const *) argv->pdata, 
+                                      G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, 
+                                      NULL);
+      g_ptr_array_free (argv, TRUE);
+      
+      if (subprocess == NULL)
+        continue;
+      
+      if (!g_subprocess_communicate_utf8 (subprocess, NULL, NULL, &output, NULL, NULL) || 
+          output == NULL)
+        {
+          g_object_unref (subprocess);
+          continue;
+        }
+      
+      /* two lines per address, the function and then file:line */
+      lines = g_strsplit (output, "\n", -1);
+      n_lines = g_strv_length (lines);
+      for (i = 0; i < frames->len && 2 * i + 1 < n_lines; i++)
+        {
+          MallocFrame *frame = g_ptr_array_index (frames, i);
+          if (g_strcmp0 (lines[2 * i], "??") != 0)
+            frame->function = g_strdup (lines[2 * i]);
+          if (!g_str_has_prefix (lines[2 * i + 1], "??"))
+            frame->location = g_path_get_basename (lines[2 * i + 1]);
+        }
+      
+      g_strfreev (lines);
+      g_free (output);
+      g_object_unref (subprocess);
+    }
+  
+  g_hash_table_destroy (modules);
+}
+
+static void
+malloc_frame_free (MallocFrame *frame)
+{
+  g_free (frame->address);
+  g_free (frame->symbol);
+  g_free (frame->module);
+  g_free (frame->function);
+  g_free (frame->location);
+  g_free (frame);
+}
+
+static void
+malloc_site_free (MallocSite *site)
+{
+  g_ptr_array_unref (site->frames);
+  g_free (site);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_PROFILER_H__
+#define	__LAUNCHER_PROFILER_H__
+
+#include <gio/gio.h>
+#include "launcher-config.h"
+
+G_BEGIN_DECLS
+
+const gchar*      launcher_profiler_to_string          (LauncherProfiler      profiler);
+LauncherProfiler  launcher_profiler_from_string        (const gchar          *string);
+
+gchar*            launcher_profiler_create_output_path (LauncherProfiler      profiler,
+                                                        const gchar          *folder_path);
+gchar**           launcher_profiler_wrap_argv          (LauncherProfiler      profiler,
+                                                        gchar               **argv,
+                                                        gchar               **envp,
+                                                        const gchar          *output_path);
+
+void              launcher_profiler_summarize_async    (LauncherProfiler      profiler,
+                                                        const gchar          *output_path,
+                                                        GCancellable         *cancellable,
+                                                        GAsyncReadyCallback   callback,
+                                                        gpointer              user_data);
+gchar*            launcher_profiler_summarize_finish   (GAsyncResult         *result,
+                                                        GError              **error);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_PROFILER_H__ */
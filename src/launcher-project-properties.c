@@ -17,6 +17,7 @@
  */
 
 #include "launcher-project-properties.h"
+#include "launcher-profile-index.h"
 
 static void launcher_project_properties_class_init  (LauncherProjectPropertiesClass *klass);
 static void launcher_project_properties_init        (LauncherProjectProperties      *project_properties);
@@ -39,9 +40,32 @@ typedef struct _LauncherProjectPropertiesPrivate LauncherProjectPropertiesPrivat
 struct _LauncherProjectPropertiesPrivate
 {
   CodeSlayerProject *project;
+  GtkWidget         *name_entry;
   GtkWidget         *executable_entry;
   GtkWidget         *parameters_entry;
   GtkWidget         *terminal_check_button;
+  GtkWidget         *runs_spin_button;
+  GtkWidget         *warmups_spin_button;
+  GtkWidget         *profiler_combo_box;
+  GtkWidget         *counters_check_button;
+  GtkWidget         *order_spin_button;
+  GtkWidget         *delay_spin_button;
+  GtkWidget         *build_entry;
+  GtkWidget         *watch_check_button;
+  GtkWidget         *ignore_entry;
+  GtkWidget         *debounce_spin_button;
+  GtkWidget         *standby_check_button;
+  GtkWidget         *prefetch_check_button;
+  GtkWidget         *affinity_entry;
+  GtkWidget         *nice_spin_button;
+  GtkWidget         *ionice_entry;
+  GtkWidget         *limits_entry;
+  GtkWidget         *cgroup_entry;
+  GtkWidget         *build_folder_entry;
+  GtkWidget         *environment_text_view;
+  GtkWidget         *instances_spin_button;
+  GtkWidget         *timeout_spin_button;
+  GtkWidget         *idle_timeout_spin_button;
 };
 
 enum
@@ -95,6 +119,9 @@ add_form (LauncherProjectProperties *project_properties)
   LauncherProjectPropertiesPrivate *priv;
   GtkWidget *grid;
 
+  GtkWidget *name_label;
+  GtkWidget *name_entry;
+
   GtkWidget *executable_label;
   GtkWidget *executable_entry;
 
@@ -105,15 +132,91 @@ add_form (LauncherProjectProperties *project_properties)
   GtkWidget *hbox;
   GtkWidget *terminal_check_button;
 
+  GtkWidget *runs_label;
+  GtkWidget *runs_spin_button;
+
+  GtkWidget *warmups_label;
+  GtkWidget *warmups_spin_button;
+
+  GtkWidget *profiler_label;
+  GtkWidget *profiler_combo_box;
+
+  GtkWidget *counters_check_button;
+
+  GtkWidget *order_label;
+  GtkWidget *order_spin_button;
+
+  GtkWidget *delay_label;
+  GtkWidget *delay_spin_button;
+
+  GtkWidget *build_label;
+  GtkWidget *build_entry;
+
+  GtkWidget *watch_check_button;
+
+  GtkWidget *ignore_label;
+  GtkWidget *ignore_entry;
+
+  GtkWidget *debounce_label;
+  GtkWidget *debounce_spin_button;
+
+  GtkWidget *standby_check_button;
+  GtkWidget *prefetch_check_button;
+
+  GtkWidget *affinity_label;
+  GtkWidget *affinity_entry;
+
+  GtkWidget *nice_label;
+  GtkWidget *nice_spin_button;
+
+  GtkWidget *ionice_label;
+  GtkWidget *ionice_entry;
+
+  GtkWidget *limits_label;
+  GtkWidget *limits_entry;
+
+  GtkWidget *cgroup_label;
+  GtkWidget *cgroup_entry;
+
+  GtkWidget *build_folder_label;
+  GtkWidget *build_folder_entry;
+
+  GtkWidget *environment_label;
+  GtkWidget *environment_text_view;
+  GtkWidget *scrolled_window;
+
+  GtkWidget *instances_label;
+  GtkWidget *instances_spin_button;
+
+  GtkWidget *timeout_label;
+  GtkWidget *timeout_spin_button;
+
+  GtkWidget *idle_timeout_label;
+  GtkWidget *idle_timeout_spin_button;
+
   priv = LAUNCHER_PROJECT_PROPERTIES_GET_PRIVATE (project_properties);
 
   grid = gtk_grid_new ();
   gtk_grid_set_row_spacing (GTK_GRID (grid), 2);
 
+  name_label = gtk_label_new (_("Profile:"));
+  gtk_misc_set_alignment (GTK_MISC (name_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (name_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), name_label, 0, 0, 1, 1);
+  
+  name_entry = gtk_entry_new ();
+  priv->name_entry = name_entry;
+  gtk_entry_set_width_chars (GTK_ENTRY (name_entry), 50);
+  gtk_entry_set_placeholder_text (GTK_ENTRY (name_entry), LAUNCHER_PROFILE_MAIN);
+  gtk_widget_set_tooltip_text (name_entry, 
+                               _("Saving under another name adds a profile, Shift+F8 picks one"));
+  gtk_grid_attach_next_to (GTK_GRID (grid), name_entry, name_label, 
+                           GTK_POS_RIGHT, 1, 1);
+
   executable_label = gtk_label_new (_("Executable:"));
   gtk_misc_set_alignment (GTK_MISC (executable_label), 1, .5);
   gtk_misc_set_padding (GTK_MISC (executable_label), 4, 0);
-  gtk_grid_attach (GTK_GRID (grid), executable_label, 0, 0, 1, 1);
+  gtk_grid_attach (GTK_GRID (grid), executable_label, 0, 1, 1, 1);
                     
   executable_entry = gtk_entry_new ();
   priv->executable_entry = executable_entry;
@@ -126,7 +229,7 @@ add_form (LauncherProjectProperties *project_properties)
   parameters_label = gtk_label_new (_("Parameters:"));
   gtk_misc_set_alignment (GTK_MISC (parameters_label), 1, .5);
   gtk_misc_set_padding (GTK_MISC (parameters_label), 4, 0);
-  gtk_grid_attach (GTK_GRID (grid), parameters_label, 0, 1, 1, 1);
+  gtk_grid_attach (GTK_GRID (grid), parameters_label, 0, 2, 1, 1);
   
   parameters_entry = gtk_entry_new ();
   priv->parameters_entry = parameters_entry;
@@ -135,13 +238,275 @@ add_form (LauncherProjectProperties *project_properties)
                            GTK_POS_RIGHT, 1, 1);
 
   spacer = gtk_label_new ("");
-  gtk_grid_attach (GTK_GRID (grid), spacer, 0, 2, 1, 1);
+  gtk_grid_attach (GTK_GRID (grid), spacer, 0, 3, 1, 1);
 
   terminal_check_button = gtk_check_button_new_with_label (_("Run In Terminal"));
   priv->terminal_check_button = terminal_check_button;
   hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);                      
   gtk_box_pack_start (GTK_BOX (hbox), terminal_check_button, FALSE, FALSE, 0);
   gtk_grid_attach_next_to (GTK_GRID (grid), hbox, spacer, GTK_POS_RIGHT, 1, 1);
+
+  runs_label = gtk_label_new (_("Benchmark Runs:"));
+  gtk_misc_set_alignment (GTK_MISC (runs_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (runs_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), runs_label, 0, 4, 1, 1);
+  
+  runs_spin_button = gtk_spin_button_new_with_range (1, 10000, 1);
+  priv->runs_spin_button = runs_spin_button;
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);                      
+  gtk_box_pack_start (GTK_BOX (hbox), runs_spin_button, FALSE, FALSE, 0);
+  gtk_grid_attach_next_to (GTK_GRID (grid), hbox, runs_label, GTK_POS_RIGHT, 1, 1);
+
+  warmups_label = gtk_label_new (_("Warmup Runs:"));
+  gtk_misc_set_alignment (GTK_MISC (warmups_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (warmups_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), warmups_label, 0, 5, 1, 1);
+  
+  warmups_spin_button = gtk_spin_button_new_with_range (0, 1000, 1);
+  priv->warmups_spin_button = warmups_spin_button;
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);                      
+  gtk_box_pack_start (GTK_BOX (hbox), warmups_spin_button, FALSE, FALSE, 0);
+  gtk_grid_attach_next_to (GTK_GRID (grid), hbox, warmups_label, GTK_POS_RIGHT, 1, 1);
+
+  profiler_label = gtk_label_new (_("Profiler:"));
+  gtk_misc_set_alignment (GTK_MISC (profiler_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (profiler_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), profiler_label, 0, 6, 1, 1);
+  
+  /* the order matches LauncherProfiler */
+  profiler_combo_box = gtk_combo_box_text_new ();
+  priv->profiler_combo_box = profiler_combo_box;
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (profiler_combo_box), _("None"));
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (profiler_combo_box), _("perf record"));
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (profiler_combo_box), _("Callgrind"));
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (profiler_combo_box), _("Massif"));
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (profiler_combo_box), _("Heaptrack"));
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (profiler_combo_box), _("Allocations (preload)"));
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);                      
+  gtk_box_pack_start (GTK_BOX (hbox), profiler_combo_box, FALSE, FALSE, 0);
+  gtk_grid_attach_next_to (GTK_GRID (grid), hbox, profiler_label, GTK_POS_RIGHT, 1, 1);
+
+  spacer = gtk_label_new ("");
+  gtk_grid_attach (GTK_GRID (grid), spacer, 0, 7, 1, 1);
+
+  counters_check_button = gtk_check_button_new_with_label (_("Collect Performance Counters"));
+  priv->counters_check_button = counters_check_button;
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);                      
+  gtk_box_pack_start (GTK_BOX (hbox), counters_check_button, FALSE, FALSE, 0);
+  gtk_grid_attach_next_to (GTK_GRID (grid), hbox, spacer, GTK_POS_RIGHT, 1, 1);
+
+  order_label = gtk_label_new (_("Launch Order:"));
+  gtk_misc_set_alignment (GTK_MISC (order_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (order_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), order_label, 0, 8, 1, 1);
+  
+  order_spin_button = gtk_spin_button_new_with_range (0, 100, 1);
+  priv->order_spin_button = order_spin_button;
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);                      
+  gtk_box_pack_start (GTK_BOX (hbox), order_spin_button, FALSE, FALSE, 0);
+  gtk_grid_attach_next_to (GTK_GRID (grid), hbox, order_label, GTK_POS_RIGHT, 1, 1);
+
+  delay_label = gtk_label_new (_("Launch Delay (ms):"));
+  gtk_misc_set_alignment (GTK_MISC (delay_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (delay_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), delay_label, 0, 9, 1, 1);
+  
+  delay_spin_button = gtk_spin_button_new_with_range (0, 60000, 100);
+  priv->delay_spin_button = delay_spin_button;
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);                      
+  gtk_box_pack_start (GTK_BOX (hbox), delay_spin_button, FALSE, FALSE, 0);
+  gtk_grid_attach_next_to (GTK_GRID (grid), hbox, delay_label, GTK_POS_RIGHT, 1, 1);
+
+  build_label = gtk_label_new (_("Build Command:"));
+  gtk_misc_set_alignment (GTK_MISC (build_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (build_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), build_label, 0, 10, 1, 1);
+  
+  build_entry = gtk_entry_new ();
+  priv->build_entry = build_entry;
+  gtk_entry_set_width_chars (GTK_ENTRY (build_entry), 50);
+  gtk_entry_set_placeholder_text (GTK_ENTRY (build_entry), "make -j8");
+  gtk_grid_attach_next_to (GTK_GRID (grid), build_entry, build_label, 
+                           GTK_POS_RIGHT, 1, 1);
+
+  spacer = gtk_label_new ("");
+  gtk_grid_attach (GTK_GRID (grid), spacer, 0, 11, 1, 1);
+
+  watch_check_button = gtk_check_button_new_with_label (_("Rerun When Sources Change"));
+  priv->watch_check_button = watch_check_button;
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);                      
+  gtk_box_pack_start (GTK_BOX (hbox), watch_check_button, FALSE, FALSE, 0);
+  gtk_grid_attach_next_to (GTK_GRID (grid), hbox, spacer, GTK_POS_RIGHT, 1, 1);
+
+  ignore_label = gtk_label_new (_("Watch Ignore:"));
+  gtk_misc_set_alignment (GTK_MISC (ignore_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (ignore_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), ignore_label, 0, 12, 1, 1);
+  
+  ignore_entry = gtk_entry_new ();
+  priv->ignore_entry = ignore_entry;
+  gtk_entry_set_width_chars (GTK_ENTRY (ignore_entry), 50);
+  gtk_entry_set_placeholder_text (GTK_ENTRY (ignore_entry), "build;*.log;doc/*");
+  gtk_grid_attach_next_to (GTK_GRID (grid), ignore_entry, ignore_label, 
+                           GTK_POS_RIGHT, 1, 1);
+
+  debounce_label = gtk_label_new (_("Watch Debounce (ms):"));
+  gtk_misc_set_alignment (GTK_MISC (debounce_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (debounce_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), debounce_label, 0, 13, 1, 1);
+  
+  debounce_spin_button = gtk_spin_button_new_with_range (0, 10000, 50);
+  priv->debounce_spin_button = debounce_spin_button;
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);                      
+  gtk_box_pack_start (GTK_BOX (hbox), debounce_spin_button, FALSE, FALSE, 0);
+  gtk_grid_attach_next_to (GTK_GRID (grid), hbox, debounce_label, GTK_POS_RIGHT, 1, 1);
+
+  spacer = gtk_label_new ("");
+  gtk_grid_attach (GTK_GRID (grid), spacer, 0, 14, 1, 1);
+
+  standby_check_button = gtk_check_button_new_with_label (_("Keep A Stand-By Process For The Next Run"));
+  priv->standby_check_button = standby_check_button;
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);                      
+  gtk_box_pack_start (GTK_BOX (hbox), standby_check_button, FALSE, FALSE, 0);
+  gtk_grid_attach_next_to (GTK_GRID (grid), hbox, spacer, GTK_POS_RIGHT, 1, 1);
+
+  spacer = gtk_label_new ("");
+  gtk_grid_attach (GTK_GRID (grid), spacer, 0, 15, 1, 1);
+
+  prefetch_check_button = gtk_check_button_new_with_label (_("Prefetch Executable And Libraries After Build"));
+  priv->prefetch_check_button = prefetch_check_button;
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);                      
+  gtk_box_pack_start (GTK_BOX (hbox), prefetch_check_button, FALSE, FALSE, 0);
+  gtk_grid_attach_next_to (GTK_GRID (grid), hbox, spacer, GTK_POS_RIGHT, 1, 1);
+
+  affinity_label = gtk_label_new (_("CPU Affinity:"));
+  gtk_misc_set_alignment (GTK_MISC (affinity_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (affinity_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), affinity_label, 0, 16, 1, 1);
+  
+  affinity_entry = gtk_entry_new ();
+  priv->affinity_entry = affinity_entry;
+  gtk_entry_set_width_chars (GTK_ENTRY (affinity_entry), 50);
+  gtk_entry_set_placeholder_text (GTK_ENTRY (affinity_entry), "0-3,6");
+  gtk_grid_attach_next_to (GTK_GRID (grid), affinity_entry, affinity_label, 
+                           GTK_POS_RIGHT, 1, 1);
+
+  nice_label = gtk_label_new (_("Nice:"));
+  gtk_misc_set_alignment (GTK_MISC (nice_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (nice_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), nice_label, 0, 17, 1, 1);
+  
+  nice_spin_button = gtk_spin_button_new_with_range (-20, 19, 1);
+  priv->nice_spin_button = nice_spin_button;
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);                      
+  gtk_box_pack_start (GTK_BOX (hbox), nice_spin_button, FALSE, FALSE, 0);
+  gtk_grid_attach_next_to (GTK_GRID (grid), hbox, nice_label, GTK_POS_RIGHT, 1, 1);
+
+  ionice_label = gtk_label_new (_("IO Priority:"));
+  gtk_misc_set_alignment (GTK_MISC (ionice_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (ionice_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), ionice_label, 0, 18, 1, 1);
+  
+  ionice_entry = gtk_entry_new ();
+  priv->ionice_entry = ionice_entry;
+  gtk_entry_set_width_chars (GTK_ENTRY (ionice_entry), 50);
+  gtk_entry_set_placeholder_text (GTK_ENTRY (ionice_entry), "best-effort:7, realtime:0 or idle");
+  gtk_grid_attach_next_to (GTK_GRID (grid), ionice_entry, ionice_label, 
+                           GTK_POS_RIGHT, 1, 1);
+
+  limits_label = gtk_label_new (_("Resource Limits:"));
+  gtk_misc_set_alignment (GTK_MISC (limits_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (limits_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), limits_label, 0, 19, 1, 1);
+  
+  limits_entry = gtk_entry_new ();
+  priv->limits_entry = limits_entry;
+  gtk_entry_set_width_chars (GTK_ENTRY (limits_entry), 50);
+  gtk_entry_set_placeholder_text (GTK_ENTRY (limits_entry), "as=4G nofile=1024 core=0");
+  gtk_grid_attach_next_to (GTK_GRID (grid), limits_entry, limits_label, 
+                           GTK_POS_RIGHT, 1, 1);
+
+  cgroup_label = gtk_label_new (_("Cgroup Limits:"));
+  gtk_misc_set_alignment (GTK_MISC (cgroup_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (cgroup_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), cgroup_label, 0, 20, 1, 1);
+  
+  cgroup_entry = gtk_entry_new ();
+  priv->cgroup_entry = cgroup_entry;
+  gtk_entry_set_width_chars (GTK_ENTRY (cgroup_entry), 50);
+  gtk_entry_set_placeholder_text (GTK_ENTRY (cgroup_entry), "memory=2G cpu=150%");
+  gtk_grid_attach_next_to (GTK_GRID (grid), cgroup_entry, cgroup_label, 
+                           GTK_POS_RIGHT, 1, 1);
+
+  build_folder_label = gtk_label_new (_("Build Folder:"));
+  gtk_misc_set_alignment (GTK_MISC (build_folder_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (build_folder_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), build_folder_label, 0, 21, 1, 1);
+  
+  build_folder_entry = gtk_entry_new ();
+  priv->build_folder_entry = build_folder_entry;
+  gtk_entry_set_width_chars (GTK_ENTRY (build_folder_entry), 50);
+  gtk_entry_set_placeholder_text (GTK_ENTRY (build_folder_entry), "${project_folder}/build");
+  gtk_grid_attach_next_to (GTK_GRID (grid), build_folder_entry, build_folder_label, 
+                           GTK_POS_RIGHT, 1, 1);
+
+  environment_label = gtk_label_new (_("Environment:"));
+  gtk_misc_set_alignment (GTK_MISC (environment_label), 1, 0);
+  gtk_misc_set_padding (GTK_MISC (environment_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), environment_label, 0, 22, 1, 1);
+  
+  environment_text_view = gtk_text_view_new ();
+  priv->environment_text_view = environment_text_view;
+  gtk_widget_set_tooltip_text (environment_text_view, 
+                               _("One per line: NAME=value, NAME^=value to prepend, "
+                                 "NAME+=value to append or -NAME to unset"));
+  scrolled_window = gtk_scrolled_window_new (NULL, NULL);
+  gtk_scrolled_window_set_shadow_type (GTK_SCROLLED_WINDOW (scrolled_window), GTK_SHADOW_IN);
+  gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolled_window), 
+                                  GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_widget_set_size_request (scrolled_window, -1, 80);
+  gtk_container_add (GTK_CONTAINER (scrolled_window), environment_text_view);
+  gtk_grid_attach_next_to (GTK_GRID (grid), scrolled_window, environment_label, 
+                           GTK_POS_RIGHT, 1, 1);
+
+  instances_label = gtk_label_new (_("Max Instances:"));
+  gtk_misc_set_alignment (GTK_MISC (instances_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (instances_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), instances_label, 0, 23, 1, 1);
+  
+  instances_spin_button = gtk_spin_button_new_with_range (0, 256, 1);
+  priv->instances_spin_button = instances_spin_button;
+  gtk_widget_set_tooltip_text (instances_spin_button, 
+                               _("Runs of this profile allowed at once, 0 for no limit"));
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);                      
+  gtk_box_pack_start (GTK_BOX (hbox), instances_spin_button, FALSE, FALSE, 0);
+  gtk_grid_attach_next_to (GTK_GRID (grid), hbox, instances_label, GTK_POS_RIGHT, 1, 1);
+
+  timeout_label = gtk_label_new (_("Timeout:"));
+  gtk_misc_set_alignment (GTK_MISC (timeout_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (timeout_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), timeout_label, 0, 24, 1, 1);
+  
+  timeout_spin_button = gtk_spin_button_new_with_range (0, 86400, 1);
+  priv->timeout_spin_button = timeout_spin_button;
+  gtk_widget_set_tooltip_text (timeout_spin_button, 
+                               _("Seconds a run may take before its stacks are sampled and it is terminated, 0 for no limit"));
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);                      
+  gtk_box_pack_start (GTK_BOX (hbox), timeout_spin_button, FALSE, FALSE, 0);
+  gtk_grid_attach_next_to (GTK_GRID (grid), hbox, timeout_label, GTK_POS_RIGHT, 1, 1);
+
+  idle_timeout_label = gtk_label_new (_("Idle Timeout:"));
+  gtk_misc_set_alignment (GTK_MISC (idle_timeout_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (idle_timeout_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), idle_timeout_label, 0, 25, 1, 1);
+  
+  idle_timeout_spin_button = gtk_spin_button_new_with_range (0, 86400, 1);
+  priv->idle_timeout_spin_button = idle_timeout_spin_button;
+  gtk_widget_set_tooltip_text (idle_timeout_spin_button, 
+                               _("Seconds a run may go without output before its stacks are sampled and it is terminated, 0 for no limit"));
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);                      
+  gtk_box_pack_start (GTK_BOX (hbox), idle_timeout_spin_button, FALSE, FALSE, 0);
+  gtk_grid_attach_next_to (GTK_GRID (grid), hbox, idle_timeout_label, GTK_POS_RIGHT, 1, 1);
                       
   gtk_box_pack_start (GTK_BOX (project_properties), grid, FALSE, FALSE, 3);
 
@@ -212,17 +577,101 @@ launcher_project_properties_opened (LauncherProjectProperties *project_propertie
       parameters = launcher_config_get_parameters (config);
       terminal = launcher_config_get_terminal (config);
 
+      gtk_entry_set_text (GTK_ENTRY (priv->name_entry), 
+                          launcher_config_get_name (config) != NULL ? 
+                          launcher_config_get_name (config) : "");
       gtk_entry_set_text (GTK_ENTRY (priv->executable_entry), executable);
       gtk_entry_set_text (GTK_ENTRY (priv->parameters_entry), parameters);
       gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (priv->terminal_check_button),
                                     terminal);
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->runs_spin_button), 
+                                 launcher_config_get_benchmark_runs (config));
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->warmups_spin_button), 
+                                 launcher_config_get_benchmark_warmups (config));
+      gtk_combo_box_set_active (GTK_COMBO_BOX (priv->profiler_combo_box), 
+                                launcher_config_get_profiler (config));
+      gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (priv->counters_check_button),
+                                    launcher_config_get_counters (config));
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->order_spin_button), 
+                                 launcher_config_get_launch_order (config));
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->delay_spin_button), 
+                                 launcher_config_get_launch_delay (config));
+      gtk_entry_set_text (GTK_ENTRY (priv->build_entry), 
+                          launcher_config_get_build_command (config) != NULL ? 
+                          launcher_config_get_build_command (config) : "");
+      gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (priv->watch_check_button),
+                                    launcher_config_get_watch (config));
+      gtk_entry_set_text (GTK_ENTRY (priv->ignore_entry), 
+                          launcher_config_get_watch_ignore (config) != NULL ? 
+                          launcher_config_get_watch_ignore (config) : "");
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->debounce_spin_button), 
+                                 launcher_config_get_watch_debounce (config));
+      gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (priv->standby_check_button),
+                                    launcher_config_get_standby (config));
+      gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (priv->prefetch_check_button),
+                                    launcher_config_get_prefetch (config));
+      gtk_entry_set_text (GTK_ENTRY (priv->affinity_entry), 
+                          launcher_config_get_cpu_affinity (config) != NULL ? 
+                          launcher_config_get_cpu_affinity (config) : "");
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->nice_spin_button), 
+                                 launcher_config_get_nice (config));
+      gtk_entry_set_text (GTK_ENTRY (priv->ionice_entry), 
+                          launcher_config_get_io_priority (config) != NULL ? 
+                          launcher_config_get_io_priority (config) : "");
+      gtk_entry_set_text (GTK_ENTRY (priv->limits_entry), 
+                          launcher_config_get_resource_limits (config) != NULL ? 
+                          launcher_config_get_resource_limits (config) : "");
+      gtk_entry_set_text (GTK_ENTRY (priv->cgroup_entry), 
+                          launcher_config_get_cgroup_limits (config) != NULL ? 
+                          launcher_config_get_cgroup_limits (config) : "");
+      gtk_entry_set_text (GTK_ENTRY (priv->build_folder_entry), 
+                          launcher_config_get_build_folder (config) != NULL ? 
+                          launcher_config_get_build_folder (config) : "");
+      gtk_text_buffer_set_text (gtk_text_view_get_buffer (GTK_TEXT_VIEW (priv->environment_text_view)), 
+                                launcher_config_get_environment (config) != NULL ? 
+                                launcher_config_get_environment (config) : "", -1);
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->instances_spin_button), 
+                                 launcher_config_get_max_instances (config));
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->timeout_spin_button), 
+                                 launcher_config_get_timeout (config));
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->idle_timeout_spin_button), 
+                                 launcher_config_get_idle_timeout (config));
     }
   else
     {
+      gtk_entry_set_text (GTK_ENTRY (priv->name_entry), "");
       gtk_entry_set_text (GTK_ENTRY (priv->executable_entry), "");
       gtk_entry_set_text (GTK_ENTRY (priv->parameters_entry), "");
       gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (priv->terminal_check_button),
                                     FALSE);
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->runs_spin_button), 10);
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->warmups_spin_button), 1);
+      gtk_combo_box_set_active (GTK_COMBO_BOX (priv->profiler_combo_box), 
+                                LAUNCHER_PROFILER_NONE);
+      gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (priv->counters_check_button),
+                                    FALSE);
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->order_spin_button), 0);
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->delay_spin_button), 0);
+      gtk_entry_set_text (GTK_ENTRY (priv->build_entry), "");
+      gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (priv->watch_check_button),
+                                    FALSE);
+      gtk_entry_set_text (GTK_ENTRY (priv->ignore_entry), "");
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->debounce_spin_button), 200);
+      gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (priv->standby_check_button),
+                                    FALSE);
+      gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (priv->prefetch_check_button),
+                                    FALSE);
+      gtk_entry_set_text (GTK_ENTRY (priv->affinity_entry), "");
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->nice_spin_button), 0);
+      gtk_entry_set_text (GTK_ENTRY (priv->ionice_entry), "");
+      gtk_entry_set_text (GTK_ENTRY (priv->limits_entry), "");
+      gtk_entry_set_text (GTK_ENTRY (priv->cgroup_entry), "");
+      gtk_entry_set_text (GTK_ENTRY (priv->build_folder_entry), "");
+      gtk_text_buffer_set_text (gtk_text_view_get_buffer (GTK_TEXT_VIEW (priv->environment_text_view)), 
+                                "", -1);
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->instances_spin_button), 0);
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->timeout_spin_button), 0);
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->idle_timeout_spin_button), 0);
     }
 }
 
@@ -232,49 +681,197 @@ launcher_project_properties_saved (LauncherProjectProperties *project_properties
                                    CodeSlayerProject         *project)
 {
   LauncherProjectPropertiesPrivate *priv;
+  gchar *name;
   gchar *executable;
   gchar *parameters;
+  gchar *build_command;
+  gchar *watch_ignore;
+  gchar *cpu_affinity;
+  gchar *io_priority;
+  gchar *resource_limits;
+  gchar *cgroup_limits;
+  gchar *build_folder;
+  gchar *environment;
+  GtkTextBuffer *buffer;
+  GtkTextIter start;
+  GtkTextIter end;
   gboolean terminal;
+  gint benchmark_runs;
+  gint benchmark_warmups;
+  LauncherProfiler profiler;
+  gboolean counters;
+  gint launch_order;
+  gint launch_delay;
+  gboolean watch;
+  gint watch_debounce;
+  gboolean standby;
+  gboolean prefetch;
+  gint nice;
+  gint max_instances;
+  gint timeout;
+  gint idle_timeout;
 
   priv = LAUNCHER_PROJECT_PROPERTIES_GET_PRIVATE (project_properties);
   
+  name = g_strdup (gtk_entry_get_text (GTK_ENTRY (priv->name_entry)));
   executable = g_strdup (gtk_entry_get_text (GTK_ENTRY (priv->executable_entry)));
   parameters = g_strdup (gtk_entry_get_text (GTK_ENTRY (priv->parameters_entry)));
+  build_command = g_strdup (gtk_entry_get_text (GTK_ENTRY (priv->build_entry)));
+  watch_ignore = g_strdup (gtk_entry_get_text (GTK_ENTRY (priv->ignore_entry)));
+  cpu_affinity = g_strdup (gtk_entry_get_text (GTK_ENTRY (priv->affinity_entry)));
+  io_priority = g_strdup (gtk_entry_get_text (GTK_ENTRY (priv->ionice_entry)));
+  resource_limits = g_strdup (gtk_entry_get_text (GTK_ENTRY (priv->limits_entry)));
+  cgroup_limits = g_strdup (gtk_entry_get_text (GTK_ENTRY (priv->cgroup_entry)));
+  build_folder = g_strdup (gtk_entry_get_text (GTK_ENTRY (priv->build_folder_entry)));
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (priv->environment_text_view));
+  gtk_text_buffer_get_bounds (buffer, &start, &end);
+  environment = gtk_text_buffer_get_text (buffer, &start, &end, FALSE);
   terminal = gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (priv->terminal_check_button));
+  benchmark_runs = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->runs_spin_button));
+  benchmark_warmups = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->warmups_spin_button));
+  profiler = gtk_combo_box_get_active (GTK_COMBO_BOX (priv->profiler_combo_box));
+  counters = gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (priv->counters_check_button));
+  launch_order = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->order_spin_button));
+  launch_delay = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->delay_spin_button));
+  watch = gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (priv->watch_check_button));
+  watch_debounce = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->debounce_spin_button));
+  standby = gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (priv->standby_check_button));
+  prefetch = gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (priv->prefetch_check_button));
+  nice = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->nice_spin_button));
+  max_instances = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->instances_spin_button));
+  timeout = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->timeout_spin_button));
+  idle_timeout = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->idle_timeout_spin_button));
   
+  g_strstrip (name);
   g_strstrip (executable);
   g_strstrip (parameters);
+  g_strstrip (build_command);
+  g_strstrip (watch_ignore);
+  g_strstrip (cpu_affinity);
+  g_strstrip (io_priority);
+  g_strstrip (resource_limits);
+  g_strstrip (cgroup_limits);
+  g_strstrip (build_folder);
+  g_strstrip (environment);
   
   if (config != NULL)
     {
-      if (g_strcmp0 (executable, launcher_config_get_executable (config)) == 0 &&
+      if (g_strcmp0 (*name != '\0' ? name : NULL, launcher_config_get_name (config)) == 0 &&
+          g_strcmp0 (executable, launcher_config_get_executable (config)) == 0 &&
           g_strcmp0 (parameters, launcher_config_get_parameters (config)) == 0 &&
-          terminal == launcher_config_get_terminal (config))
+          g_strcmp0 (build_command, launcher_config_get_build_command (config)) == 0 &&
+          terminal == launcher_config_get_terminal (config) &&
+          benchmark_runs == launcher_config_get_benchmark_runs (config) &&
+          benchmark_warmups == launcher_config_get_benchmark_warmups (config) &&
+          profiler == launcher_config_get_profiler (config) &&
+          counters == launcher_config_get_counters (config) &&
+          launch_order == launcher_config_get_launch_order (config) &&
+          launch_delay == launcher_config_get_launch_delay (config) &&
+          watch == launcher_config_get_watch (config) &&
+          g_strcmp0 (watch_ignore, launcher_config_get_watch_ignore (config)) == 0 &&
+          watch_debounce == launcher_config_get_watch_debounce (config) &&
+          standby == launcher_config_get_standby (config) &&
+          prefetch == launcher_config_get_prefetch (config) &&
+          g_strcmp0 (cpu_affinity, launcher_config_get_cpu_affinity (config)) == 0 &&
+          nice == launcher_config_get_nice (config) &&
+          g_strcmp0 (io_priority, launcher_config_get_io_priority (config)) == 0 &&
+          g_strcmp0 (resource_limits, launcher_config_get_resource_limits (config)) == 0 &&
+          g_strcmp0 (cgroup_limits, launcher_config_get_cgroup_limits (config)) == 0 &&
+          g_strcmp0 (build_folder, launcher_config_get_build_folder (config)) == 0 &&
+          g_strcmp0 (environment, launcher_config_get_environment (config)) == 0 &&
+          max_instances == launcher_config_get_max_instances (config) &&
+          timeout == launcher_config_get_timeout (config) &&
+          idle_timeout == launcher_config_get_idle_timeout (config))
         {
+          g_free (name);
           g_free (executable);
           g_free (parameters);
+          g_free (build_command);
+          g_free (watch_ignore);
+          g_free (cpu_affinity);
+          g_free (io_priority);
+          g_free (resource_limits);
+          g_free (cgroup_limits);
+          g_free (build_folder);
+          g_free (environment);
           return;
         }
 
+      launcher_config_set_name (config, name);
       launcher_config_set_executable (config, executable);
       launcher_config_set_parameters (config, parameters);
+      launcher_config_set_build_command (config, build_command);
       launcher_config_set_terminal (config, terminal);
+      launcher_config_set_benchmark_runs (config, benchmark_runs);
+      launcher_config_set_benchmark_warmups (config, benchmark_warmups);
+      launcher_config_set_profiler (config, profiler);
+      launcher_config_set_counters (config, counters);
+      launcher_config_set_launch_order (config, launch_order);
+      launcher_config_set_launch_delay (config, launch_delay);
+      launcher_config_set_watch (config, watch);
+      launcher_config_set_watch_ignore (config, watch_ignore);
+      launcher_config_set_watch_debounce (config, watch_debounce);
+      launcher_config_set_standby (config, standby);
+      launcher_config_set_prefetch (config, prefetch);
+      launcher_config_set_cpu_affinity (config, cpu_affinity);
+      launcher_config_set_nice (config, nice);
+      launcher_config_set_io_priority (config, io_priority);
+      launcher_config_set_resource_limits (config, resource_limits);
+      launcher_config_set_cgroup_limits (config, cgroup_limits);
+      launcher_config_set_build_folder (config, build_folder);
+      launcher_config_set_environment (config, environment);
+      launcher_config_set_max_instances (config, max_instances);
+      launcher_config_set_timeout (config, timeout);
+      launcher_config_set_idle_timeout (config, idle_timeout);
       g_signal_emit_by_name((gpointer)project_properties, "save-config", config);
     }
   else if (entry_has_text (priv->executable_entry))
     {
       LauncherConfig *config;
       config = launcher_config_new ();
-      launcher_config_set_project (config, project);
+      launcher_config_set_project (config, project, codeslayer_project_get_name (project),
+                                   codeslayer_project_get_folder_path (project));
+      launcher_config_set_name (config, name);
       launcher_config_set_executable (config, executable);
       launcher_config_set_parameters (config, parameters);
+      launcher_config_set_build_command (config, build_command);
       launcher_config_set_terminal (config, terminal);
+      launcher_config_set_benchmark_runs (config, benchmark_runs);
+      launcher_config_set_benchmark_warmups (config, benchmark_warmups);
+      launcher_config_set_profiler (config, profiler);
+      launcher_config_set_counters (config, counters);
+      launcher_config_set_launch_order (config, launch_order);
+      launcher_config_set_launch_delay (config, launch_delay);
+      launcher_config_set_watch (config, watch);
+      launcher_config_set_watch_ignore (config, watch_ignore);
+      launcher_config_set_watch_debounce (config, watch_debounce);
+      launcher_config_set_standby (config, standby);
+      launcher_config_set_prefetch (config, prefetch);
+      launcher_config_set_cpu_affinity (config, cpu_affinity);
+      launcher_config_set_nice (config, nice);
+      launcher_config_set_io_priority (config, io_priority);
+      launcher_config_set_resource_limits (config, resource_limits);
+      launcher_config_set_cgroup_limits (config, cgroup_limits);
+      launcher_config_set_build_folder (config, build_folder);
+      launcher_config_set_environment (config, environment);
+      launcher_config_set_max_instances (config, max_instances);
+      launcher_config_set_timeout (config, timeout);
+      launcher_config_set_idle_timeout (config, idle_timeout);
       g_signal_emit_by_name((gpointer)project_properties, "save-config", config);
       g_object_unref (config);
     }
     
+  g_free (name);
   g_free (executable);
   g_free (parameters);
+  g_free (build_command);
+  g_free (watch_ignore);
+  g_free (cpu_affinity);
+  g_free (io_priority);
+  g_free (resource_limits);
+  g_free (cgroup_limits);
+  g_free (build_folder);
+  g_free (environment);
 }
 
 static gboolean
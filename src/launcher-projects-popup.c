@@ -23,12 +23,22 @@ static void launcher_projects_popup_class_init  (LauncherProjectsPopupClass *kla
 static void launcher_projects_popup_init        (LauncherProjectsPopup      *projects_popup);
 static void launcher_projects_popup_finalize    (LauncherProjectsPopup      *projects_popup);
 
+static void add_menu_items                      (LauncherProjectsPopup      *projects_popup);
 static void run_action                          (LauncherProjectsPopup      *projects_popup, 
                                                  GList                      *selections);
+static void benchmark_action                    (LauncherProjectsPopup      *projects_popup, 
+                                                 GList                      *selections);
+static void benchmark_startup_action            (LauncherProjectsPopup      *projects_popup, 
+                                                 GList                      *selections);
+static void launch_group_action                 (LauncherProjectsPopup      *projects_popup, 
+                                                 GList                      *selections);
                                         
 enum
 {
   RUN,
+  BENCHMARK,
+  BENCHMARK_STARTUP,
+  LAUNCH_GROUP,
   LAST_SIGNAL
 };
 
@@ -47,13 +57,37 @@ launcher_projects_popup_class_init (LauncherProjectsPopupClass *klass)
                   NULL, NULL, 
                   g_cclosure_marshal_VOID__POINTER, G_TYPE_NONE, 1, G_TYPE_POINTER);
 
+  launcher_projects_popup_signals[BENCHMARK] =
+    g_signal_new ("benchmark", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherProjectsPopupClass, benchmark),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__POINTER, G_TYPE_NONE, 1, G_TYPE_POINTER);
+
+  launcher_projects_popup_signals[BENCHMARK_STARTUP] =
+    g_signal_new ("benchmark-startup", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherProjectsPopupClass, benchmark_startup),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__POINTER, G_TYPE_NONE, 1, G_TYPE_POINTER);
+
+  launcher_projects_popup_signals[LAUNCH_GROUP] =
+    g_signal_new ("launch-group", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherProjectsPopupClass, launch_group),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__POINTER, G_TYPE_NONE, 1, G_TYPE_POINTER);
+
   G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) launcher_projects_popup_finalize;
 }
 
 static void
 launcher_projects_popup_init (LauncherProjectsPopup *projects_popup)
 {
-  gtk_menu_item_set_label (GTK_MENU_ITEM (projects_popup), "Run Program");
+  gtk_menu_item_set_label (GTK_MENU_ITEM (projects_popup), "Launcher");
 }
 
 static void
@@ -68,11 +102,42 @@ launcher_projects_popup_new ()
   GtkWidget *projects_popup;
   
   projects_popup = g_object_new (launcher_projects_popup_get_type (), NULL);
+  add_menu_items (LAUNCHER_PROJECTS_POPUP (projects_popup));
+  return projects_popup;
+}
 
-  g_signal_connect_swapped (G_OBJECT (projects_popup), "projects-menu-selected", 
-                            G_CALLBACK (run_action), projects_popup);
+static void
+add_menu_items (LauncherProjectsPopup *projects_popup)
+{
+  GtkWidget *submenu;
+  GtkWidget *run_item;
+  GtkWidget *benchmark_item;
+  GtkWidget *benchmark_startup_item;
+  GtkWidget *launch_group_item;
+  
+  submenu = gtk_menu_new ();
+  gtk_menu_item_set_submenu (GTK_MENU_ITEM (projects_popup), submenu);
+  
+  run_item = codeslayer_menu_item_new_with_label ("Run Program");
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), run_item);
 
-  return projects_popup;
+  benchmark_item = codeslayer_menu_item_new_with_label ("Benchmark Program");
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), benchmark_item);
+
+  benchmark_startup_item = codeslayer_menu_item_new_with_label ("Benchmark Startup");
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), benchmark_startup_item);
+
+  launch_group_item = codeslayer_menu_item_new_with_label ("Launch Group");
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), launch_group_item);
+
+  g_signal_connect_swapped (G_OBJECT (run_item), "projects-menu-selected", 
+                            G_CALLBACK (run_action), projects_popup);
+  g_signal_connect_swapped (G_OBJECT (benchmark_item), "projects-menu-selected", 
+                            G_CALLBACK (benchmark_action), projects_popup);
+  g_signal_connect_swapped (G_OBJECT (benchmark_startup_item), "projects-menu-selected", 
+                            G_CALLBACK (benchmark_startup_action), projects_popup);
+  g_signal_connect_swapped (G_OBJECT (launch_group_item), "projects-menu-selected", 
+                            G_CALLBACK (launch_group_action), projects_popup);
 }
 
 static void 
@@ -81,3 +146,24 @@ run_action (LauncherProjectsPopup *projects_popup,
 {
   g_signal_emit_by_name ((gpointer) projects_popup, "run", selections);
 }
+
+static void 
+benchmark_action (LauncherProjectsPopup *projects_popup, 
+                  GList                 *selections) 
+{
+  g_signal_emit_by_name ((gpointer) projects_popup, "benchmark", selections);
+}
+
+static void 
+benchmark_startup_action (LauncherProjectsPopup *projects_popup, 
+                          GList                 *selections) 
+{
+  g_signal_emit_by_name ((gpointer) projects_popup, "benchmark-startup", selections);
+}
+
+static void 
+launch_group_action (LauncherProjectsPopup *projects_popup, 
+                     GList                 *selections) 
+{
+  g_signal_emit_by_name ((gpointer) projects_popup, "launch-group", selections);
+}
@@ -42,6 +42,9 @@ struct _LauncherProjectsPopupClass
   CodeSlayerMenuItemClass parent_class;
 
   void (*run) (LauncherProjectsPopup *menu);
+  void (*benchmark) (LauncherProjectsPopup *menu);
+  void (*benchmark_startup) (LauncherProjectsPopup *menu);
+  void (*launch_group) (LauncherProjectsPopup *menu);
 };
 
 GType launcher_projects_popup_get_type (void) G_GNUC_CONST;
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "launcher-reports.h"
+
+/*
+ * A list of reports on the left and the text of the selected report on the 
+ * right. Reports are produced after a run finishes, for example the summary 
+ * of a profile, and are kept until the plugin is deactivated.
+ */
+
+static void launcher_reports_class_init  (LauncherReportsClass *klass);
+static void launcher_reports_init        (LauncherReports      *reports);
+static void launcher_reports_finalize    (LauncherReports      *reports);
+
+static void selection_changed_action     (LauncherReports      *reports,
+                                          GtkTreeSelection     *selection);
+
+#define LAUNCHER_REPORTS_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_REPORTS_TYPE, LauncherReportsPrivate))
+
+typedef struct _LauncherReportsPrivate LauncherReportsPrivate;
+
+struct _LauncherReportsPrivate
+{
+  GtkWidget    *tree;
+  GtkListStore *store;
+  GtkWidget    *text_view;
+};
+
+enum
+{
+  TITLE = 0,
+  TEXT,
+  COLUMNS
+};
+
+G_DEFINE_TYPE (LauncherReports, launcher_reports, GTK_TYPE_PANED)
+
+static void
+launcher_reports_class_init (LauncherReportsClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_reports_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherReportsPrivate));
+}
+
+static void
+launcher_reports_init (LauncherReports *reports)
+{
+  LauncherReportsPrivate *priv;
+  GtkCellRenderer *renderer;
+  GtkTreeViewColumn *column;
+  GtkTreeSelection *selection;
+  GtkWidget *tree_window;
+  GtkWidget *text_window;
+  PangoFontDescription *font_description;
+
+  priv = LAUNCHER_REPORTS_GET_PRIVATE (reports);
+
+  gtk_orientable_set_orientation (GTK_ORIENTABLE (reports), GTK_ORIENTATION_HORIZONTAL);
+  
+  priv->store = gtk_list_store_new (COLUMNS, G_TYPE_STRING, G_TYPE_STRING);
+  priv->tree = gtk_tree_view_new_with_model (GTK_TREE_MODEL (priv->store));
+  gtk_tree_view_set_headers_visible (GTK_TREE_VIEW (priv->tree), FALSE);
+  
+  renderer = gtk_cell_renderer_text_new ();
+  column = gtk_tree_view_column_new_with_attributes ("Report", renderer, "text", TITLE, NULL);
+  gtk_tree_view_append_column (GTK_TREE_VIEW (priv->tree), column);
+  
+  selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (priv->tree));
+  gtk_tree_selection_set_mode (selection, GTK_SELECTION_BROWSE);
+  g_signal_connect_swapped (G_OBJECT (selection), "changed",
+                            G_CALLBACK (selection_changed_action), reports);
+
+  tree_window = gtk_scrolled_window_new (NULL, NULL);
+  gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (tree_window),
+                                  GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_widget_set_size_request (tree_window, 220, -1);
+  gtk_container_add (GTK_CONTAINER (tree_window), priv->tree);
+  gtk_paned_pack1 (GTK_PANED (reports), tree_window, FALSE, FALSE);
+  
+  priv->text_view = gtk_text_view_new ();
+  gtk_text_view_set_editable (GTK_TEXT_VIEW (priv->text_view), FALSE);
+  gtk_text_view_set_cursor_visible (GTK_TEXT_VIEW (priv->text_view), FALSE);
+  font_description = pango_font_description_from_string ("Monospace");
+  gtk_widget_override_font (priv->text_view, font_description);
+  pango_font_description_free (font_description);
+  
+  text_window = gtk_scrolled_window_new (NULL, NULL);
+  gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (text_window),
+                                  GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_container_add (GTK_CONTAINER (text_window), priv->text_view);
+  gtk_paned_pack2 (GTK_PANED (reports), text_window, TRUE, FALSE);
+}
+
+static void
+launcher_reports_finalize (LauncherReports *reports)
+{
+  LauncherReportsPrivate *priv;
+  priv = LAUNCHER_REPORTS_GET_PRIVATE (reports);
+  g_object_unref (priv->store);
+  G_OBJECT_CLASS (launcher_reports_parent_class)->finalize (G_OBJECT (reports));
+}
+
+GtkWidget*
+launcher_reports_new (void)
+{
+  return g_object_new (launcher_reports_get_type (), NULL);
+}
+
+void
+launcher_reports_add (LauncherReports *reports,
+                      const gchar     *title,
+                      const gchar     *text)
+{
+  LauncherReportsPrivate *priv;
+  GtkTreeSelection *selection;
+  GtkTreeIter iter;
+
+  priv = LAUNCHER_REPORTS_GET_PRIVATE (reports);
+
+  gtk_list_store_prepend (priv->store, &iter);
+  gtk_list_store_set (priv->store, &iter, TITLE, title, TEXT, text, -1);
+  
+  selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (priv->tree));
+  gtk_tree_selection_select_iter (selection, &iter);
+}
+
+static void
+selection_changed_action (LauncherReports  *reports,
+                          GtkTreeSelection *selection)
+{
+  LauncherReportsPrivate *priv;
+  GtkTextBuffer *buffer;
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  gchar *text = NULL;
+
+  priv = LAUNCHER_REPORTS_GET_PRIVATE (reports);
+  
+  if (gtk_tree_selection_get_selected (selection, &model, &iter))
+    gtk_tree_model_get (model, &iter, TEXT, &text, -1);
+  
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (priv->text_view));
+  gtk_text_buffer_set_text (buffer, text != NULL ? text : "", -1);
+  g_free (text);
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_REPORTS_H__
+#define	__LAUNCHER_REPORTS_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_REPORTS_TYPE            (launcher_reports_get_type ())
+#define LAUNCHER_REPORTS(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_REPORTS_TYPE, LauncherReports))
+#define LAUNCHER_REPORTS_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_REPORTS_TYPE, LauncherReportsClass))
+#define IS_LAUNCHER_REPORTS(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_REPORTS_TYPE))
+#define IS_LAUNCHER_REPORTS_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_REPORTS_TYPE))
+
+typedef struct _LauncherReports LauncherReports;
+typedef struct _LauncherReportsClass LauncherReportsClass;
+
+struct _LauncherReports
+{
+  GtkPaned parent_instance;
+};
+
+struct _LauncherReportsClass
+{
+  GtkPanedClass parent_class;
+};
+
+GType launcher_reports_get_type (void) G_GNUC_CONST;
+     
+GtkWidget*  launcher_reports_new  (void);
+
+void        launcher_reports_add  (LauncherReports *reports,
+                                   const gchar     *title,
+                                   const gchar     *text);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_REPORTS_H__ */
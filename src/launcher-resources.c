@@ -0,0 +1,539 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include "launcher-resources.h"
+
+/*
+ * Everything is parsed up front so that the child, between fork and exec, 
+ * only makes system calls. A failure there cannot be reported back, so it 
+ * is written to the stderr of the child where it shows in the output.
+ *
+ * Cgroup limits need a cgroup of their own, which an unprivileged user gets 
+ * from systemd as a transient scope, so those wrap the argv instead.
+ */
+
+static void launcher_resources_class_init  (LauncherResourcesClass *klass);
+static void launcher_resources_init        (LauncherResources      *resources);
+static void launcher_resources_finalize    (LauncherResources      *resources);
+
+static gboolean parse_affinity             (LauncherResources      *resources,
+                                            const gchar            *affinity,
+                                            GError                **error);
+static gboolean parse_io_priority          (LauncherResources      *resources,
+                                            const gchar            *io_priority,
+                                            GError                **error);
+static gboolean parse_limits               (LauncherResources      *resources,
+                                            const gchar            *limits,
+                                            GError                **error);
+static gboolean parse_cgroup_limits        (LauncherResources      *resources,
+                                            const gchar            *limits,
+                                            GError                **error);
+static gboolean parse_size                 (const gchar            *text,
+                                            rlim_t                 *size);
+static void child_error                    (const gchar            *message);
+
+#define IOPRIO_WHO_PROCESS 1
+#define IOPRIO_CLASS_SHIFT 13
+
+typedef enum
+{
+  LIMIT_ADDRESS_SPACE,
+  LIMIT_OPEN_FILES,
+  LIMIT_CORE_SIZE,
+  LIMIT_LAST
+} Limit;
+
+static const gchar *limit_names[LIMIT_LAST] = { "as", "nofile", "core" };
+static const gint limit_resources[LIMIT_LAST] = { RLIMIT_AS, RLIMIT_NOFILE, RLIMIT_CORE };
+
+#define LAUNCHER_RESOURCES_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_RESOURCES_TYPE, LauncherResourcesPrivate))
+
+typedef struct _LauncherResourcesPrivate LauncherResourcesPrivate;
+
+struct _LauncherResourcesPrivate
+{
+  gboolean   has_affinity;
+  cpu_set_t  affinity;
+  gint       nice;
+  gint       io_priority;
+  gboolean   has_limits[LIMIT_LAST];
+  rlim_t     limits[LIMIT_LAST];
+  gchar     *memory_max;
+  gchar     *cpu_max;
+};
+
+G_DEFINE_TYPE (LauncherResources, launcher_resources, G_TYPE_OBJECT)
+
+static void
+launcher_resources_class_init (LauncherResourcesClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_resources_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherResourcesPrivate));
+}
+
+static void
+launcher_resources_init (LauncherResources *resources)
+{
+  LauncherResourcesPrivate *priv;
+  gint i;
+  
+  priv = LAUNCHER_RESOURCES_GET_PRIVATE (resources);
+  priv->has_affinity = FALSE;
+  CPU_ZERO (&priv->affinity);
+  priv->nice = 0;
+  priv->io_priority = -1;
+  for (i = 0; i < LIMIT_LAST; i++)
+    priv->has_limits[i] = FALSE;
+  priv->memory_max = NULL;
+  priv->cpu_max = NULL;
+}
+
+static void
+launcher_resources_finalize (LauncherResources *resources)
+{
+  LauncherResourcesPrivate *priv;
+  priv = LAUNCHER_RESOURCES_GET_PRIVATE (resources);
+  g_free (priv->memory_max);
+  g_free (priv->cpu_max);
+  G_OBJECT_CLASS (launcher_resources_parent_class)->finalize (G_OBJECT (resources));
+}
+
+/*
+ * Returns NULL and sets the error when one of the settings of the config 
+ * can not be understood.
+ */
+LauncherResources*
+launcher_resources_new (LauncherConfig  *config,
+                        GError         **error)
+{
+  LauncherResourcesPrivate *priv;
+  LauncherResources *resources;
+
+  resources = LAUNCHER_RESOURCES (g_object_new (launcher_resources_get_type (), NULL));
+  priv = LAUNCHER_RESOURCES_GET_PRIVATE (resources);
+  
+  priv->nice = launcher_config_get_nice (config);
+  
+  if (!parse_affinity (resources, launcher_config_get_cpu_affinity (config), error) ||
+      !parse_io_priority (resources, launcher_config_get_io_priority (config), error) ||
+      !parse_limits (resources, launcher_config_get_resource_limits (config), error) ||
+      !parse_cgroup_limits (resources, launcher_config_get_cgroup_limits (config), error))
+    {
+      g_object_unref (resources);
+      return NULL;
+    }
+
+  return resources;
+}
+
+gboolean
+launcher_resources_is_empty (LauncherResources *resources)
+{
+  LauncherResourcesPrivate *priv;
+  gint i;
+  
+  priv = LAUNCHER_RESOURCES_GET_PRIVATE (resources);
+  
+  for (i = 0; i < LIMIT_LAST; i++)
+    if (priv->has_limits[i])
+      return FALSE;
+  
+  return !priv->has_affinity && priv->nice == 0 && priv->io_priority < 0 &&
+         priv->memory_max == NULL && priv->cpu_max == NULL;
+}
+
+/*
+ * Whether the program has to run in a systemd scope, see wrap_argv().
+ */
+gboolean
+launcher_resources_has_cgroup (LauncherResources *resources)
+{
+  LauncherResourcesPrivate *priv;
+  priv = LAUNCHER_RESOURCES_GET_PRIVATE (resources);
+  return priv->memory_max != NULL || priv->cpu_max != NULL;
+}
+
+/*
+ * Copies the configured affinity into the cpu_set_t at cpus. Returns FALSE 
+ * and leaves it alone when the config does not set one.
+ */
+gboolean
+launcher_resources_get_affinity (LauncherResources *resources,
+                                 gpointer           cpus)
+{
+  LauncherResourcesPrivate *priv;
+  priv = LAUNCHER_RESOURCES_GET_PRIVATE (resources);
+  
+  if (!priv->has_affinity)
+    return FALSE;
+  
+  memcpy (cpus, &priv->affinity, sizeof (cpu_set_t));
+  return TRUE;
+}
+
+/*
+ * Runs in the child before exec.
+ */
+void
+launcher_resources_child_setup (gpointer resources)
+{
+  LauncherResourcesPrivate *priv;
+  gint i;
+  
+  priv = LAUNCHER_RESOURCES_GET_PRIVATE (resources);
+  
+  if (priv->has_affinity && 
+      sched_setaffinity (0, sizeof (cpu_set_t), &priv->affinity) != 0)
+    child_error ("launcher: not able to set the cpu affinity\n");
+  
+  if (priv->nice != 0 && setpriority (PRIO_PROCESS, 0, priv->nice) != 0)
+    child_error ("launcher: not able to set the nice level\n");
+  
+  if (priv->io_priority >= 0 && 
+      syscall (SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, priv->io_priority) != 0)
+    child_error ("launcher: not able to set the io priority\n");
+  
+  for (i = 0; i < LIMIT_LAST; i++)
+    {
+      struct rlimit limit;
+      
+      if (!priv->has_limits[i] || getrlimit (limit_resources[i], &limit) != 0)
+        continue;
+      
+      /* an unprivileged process can only lower the hard limit */
+      limit.rlim_cur = priv->limits[i];
+      if (limit.rlim_max != RLIM_INFINITY && 
+          (priv->limits[i] == RLIM_INFINITY || priv->limits[i] > limit.rlim_max))
+        limit.rlim_cur = limit.rlim_max;
+      
+      if (setrlimit (limit_resources[i], &limit) != 0)
+        child_error ("launcher: not able to set a resource limit\n");
+    }
+}
+
+/*
+ * Takes the argv and returns it, or a new one that starts the program in 
+ * a transient systemd scope with the cgroup limits. The scope runs the 
+ * program in the same process, so the pid stays the one that was spawned.
+ */
+gchar**
+launcher_resources_wrap_argv (LauncherResources  *resources,
+                              gchar             **argv)
+{
+  LauncherResourcesPrivate *priv;
+  GPtrArray *wrapped;
+  gchar **arg;
+  
+  priv = LAUNCHER_RESOURCES_GET_PRIVATE (resources);
+  
+  if (priv->memory_max == NULL && priv->cpu_max == NULL)
+    return argv;
+  
+  wrapped = g_ptr_array_new ();
+  g_ptr_array_add (wrapped, g_strdup ("systemd-run"));
+  g_ptr_array_add (wrapped, g_strdup ("--user"));
+  g_ptr_array_add (wrapped, g_strdup ("--scope"));
+  g_ptr_array_add (wrapped, g_strdup ("--quiet"));
+  g_ptr_array_add (wrapped, g_strdup ("--collect"));
+  if (priv->memory_max != NULL)
+    {
+      g_ptr_array_add (wrapped, g_strdup ("-p"));
+      g_ptr_array_add (wrapped, g_strconcat ("MemoryMax=", priv->memory_max, NULL));
+      /* without this the limit only pushes the program into swap */
+      g_ptr_array_add (wrapped, g_strdup ("-p"));
+      g_ptr_array_add (wrapped, g_strdup ("MemorySwapMax=0"));
+    }
+  if (priv->cpu_max != NULL)
+    {
+      g_ptr_array_add (wrapped, g_strdup ("-p"));
+      g_ptr_array_add (wrapped, g_strconcat ("CPUQuota=", priv->cpu_max, NULL));
+    }
+  g_ptr_array_add (wrapped, g_strdup ("--"));
+  
+  for (arg = argv; *arg != NULL; arg++)
+    g_ptr_array_add (wrapped, *arg);
+  g_ptr_array_add (wrapped, NULL);
+  
+  g_free (argv);
+  return (gchar**) g_ptr_array_free (wrapped, FALSE);
+}
+
+/*
+ * A list like 0-3,6 in the format of taskset and /sys.
+ */
+static gboolean
+parse_affinity (LauncherResources  *resources,
+                const gchar        *affinity,
+                GError            **error)
+{
+  LauncherResourcesPrivate *priv;
+  gchar **ranges;
+  gchar **range;
+  
+  priv = LAUNCHER_RESOURCES_GET_PRIVATE (resources);
+  
+  if (affinity == NULL || *affinity == '\0')
+    return TRUE;
+  
+  ranges = g_strsplit (affinity, ",", -1);
+  for (range = ranges; *range != NULL; range++)
+    {
+      gchar *end;
+      guint64 first;
+      guint64 last;
+      
+      first = g_ascii_strtoull (g_strstrip (*range), &end, 10);
+      last = first;
+      if (end != *range && *end == '-')
+        last = g_ascii_strtoull (end + 1, &end, 10);
+      
+      if (end == *range || *end != '\0' || last < first || last >= CPU_SETSIZE)
+        {
+          g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                       "The cpu affinity %s is not a list like 0-3,6.", affinity);
+          g_strfreev (ranges);
+          return FALSE;
+        }
+      
+      for (; first <= last; first++)
+        CPU_SET (first, &priv->affinity);
+    }
+  g_strfreev (ranges);
+
+  priv->has_affinity = TRUE;
+  return TRUE;
+}
+
+/*
+ * The classes of ionice: idle, best-effort[:level] or realtime[:level] 
+ * where the level goes from 0, the highest, to 7.
+ */
+static gboolean
+parse_io_priority (LauncherResources  *resources,
+                   const gchar        *io_priority,
+                   GError            **error)
+{
+  LauncherResourcesPrivate *priv;
+  const gchar *level_text;
+  gint io_class;
+  gint level = 4;
+  
+  priv = LAUNCHER_RESOURCES_GET_PRIVATE (resources);
+  
+  if (io_priority == NULL || *io_priority == '\0')
+    return TRUE;
+  
+  if (g_str_has_prefix (io_priority, "realtime"))
+    io_class = 1;
+  else if (g_str_has_prefix (io_priority, "best-effort"))
+    io_class = 2;
+  else if (g_str_has_prefix (io_priority, "idle"))
+    io_class = 3;
+  else
+    io_class = 0;
+
+  level_text = strchr (io_priority, ':');
+  if (level_text != NULL)
+    {
+      gchar *end;
+      level = g_ascii_strtoll (level_text + 1, &end, 10);
+      if (end == level_text + 1 || *end != '\0')
+        level = -1;
+    }
+
+  if (io_class == 0 || level < 0 || level > 7 || (io_class == 3 && level_text != NULL))
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                   "The io priority %s is not idle, best-effort:0-7 or realtime:0-7.", 
+                   io_priority);
+      return FALSE;
+    }
+  
+  priv->io_priority = io_class << IOPRIO_CLASS_SHIFT | (io_class == 3 ? 0 : level);
+  return TRUE;
+}
+
+/*
+ * Settings like as=4G nofile=1024 core=0, where a size may be unlimited.
+ */
+static gboolean
+parse_limits (LauncherResources  *resources,
+              const gchar        *limits,
+              GError            **error)
+{
+  LauncherResourcesPrivate *priv;
+  gchar **settings;
+  gchar **setting;
+  
+  priv = LAUNCHER_RESOURCES_GET_PRIVATE (resources);
+  
+  if (limits == NULL || *limits == '\0')
+    return TRUE;
+  
+  settings = g_strsplit_set (limits, " \t", -1);
+  for (setting = settings; *setting != NULL; setting++)
+    {
+      gchar *value;
+      gint i;
+      
+      if (**setting == '\0')
+        continue;
+      
+      value = strchr (*setting, '=');
+      if (value != NULL)
+        *value++ = '\0';
+      
+      for (i = 0; i < LIMIT_LAST; i++)
+        if (g_strcmp0 (*setting, limit_names[i]) == 0)
+          break;
+
+      if (value == NULL || i == LIMIT_LAST || !parse_size (value, &priv->limits[i]))
+        {
+          g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                       "The resource limits %s are not like as=4G nofile=1024 core=0.", limits);
+          g_strfreev (settings);
+          return FALSE;
+        }
+      
+      priv->has_limits[i] = TRUE;
+    }
+  g_strfreev (settings);
+  
+  return TRUE;
+}
+
+/*
+ * Settings like memory=2G cpu=150%, passed on to systemd as MemoryMax 
+ * and CPUQuota which end up in memory.max and cpu.max of the scope.
+ */
+static gboolean
+parse_cgroup_limits (LauncherResources  *resources,
+                     const gchar        *limits,
+                     GError            **error)
+{
+  LauncherResourcesPrivate *priv;
+  gchar **settings;
+  gchar **setting;
+  gchar *program;
+  
+  priv = LAUNCHER_RESOURCES_GET_PRIVATE (resources);
+  
+  if (limits == NULL || *limits == '\0')
+    return TRUE;
+  
+  settings = g_strsplit_set (limits, " \t", -1);
+  for (setting = settings; *setting != NULL; setting++)
+    {
+      rlim_t size;
+      
+      if (**setting == '\0')
+        continue;
+      
+      if (g_str_has_prefix (*setting, "memory=") && 
+          parse_size (*setting + strlen ("memory="), &size) && size != RLIM_INFINITY)
+        {
+          g_free (priv->memory_max);
+          priv->memory_max = g_strdup (*setting + strlen ("memory="));
+        }
+      else if (g_str_has_prefix (*setting, "cpu=") && g_str_has_suffix (*setting, "%") &&
+               g_ascii_strtoull (*setting + strlen ("cpu="), NULL, 10) > 0)
+        {
+          g_free (priv->cpu_max);
+          priv->cpu_max = g_strdup (*setting + strlen ("cpu="));
+        }
+      else
+        {
+          g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                       "The cgroup limits %s are not like memory=2G cpu=150%%.", limits);
+          g_strfreev (settings);
+          return FALSE;
+        }
+    }
+  g_strfreev (settings);
+  
+  program = g_find_program_in_path ("systemd-run");
+  if (program == NULL)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+                   "Cgroup limits need systemd-run, which was not found.");
+      return FALSE;
+    }
+  g_free (program);
+  
+  return TRUE;
+}
+
+static gboolean
+parse_size (const gchar *text,
+            rlim_t      *size)
+{
+  gchar *end;
+  guint64 value;
+  
+  if (g_strcmp0 (text, "unlimited") == 0)
+    {
+      *size = RLIM_INFINITY;
+      return TRUE;
+    }
+  
+  value = g_ascii_strtoull (text, &end, 10);
+  if (end == text)
+    return FALSE;
+  
+  switch (*end)
+    {
+    case 'K':
+      value <<= 10;
+      end++;
+      break;
+    case 'M':
+      value <<= 20;
+      end++;
+      break;
+    case 'G':
+      value <<= 30;
+      end++;
+      break;
+    }
+  
+  if (*end != '\0')
+    return FALSE;
+  
+  *size = value;
+  return TRUE;
+}
+
+static void
+child_error (const gchar *message)
+{
+  gssize written;
+  written = write (STDERR_FILENO, message, strlen (message));
+  (void) written;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_RESOURCES_H__
+#define	__LAUNCHER_RESOURCES_H__
+
+#include <glib-object.h>
+#include "launcher-config.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_RESOURCES_TYPE            (launcher_resources_get_type ())
+#define LAUNCHER_RESOURCES(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_RESOURCES_TYPE, LauncherResources))
+#define LAUNCHER_RESOURCES_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_RESOURCES_TYPE, LauncherResourcesClass))
+#define IS_LAUNCHER_RESOURCES(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_RESOURCES_TYPE))
+#define IS_LAUNCHER_RESOURCES_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_RESOURCES_TYPE))
+
+typedef struct _LauncherResources LauncherResources;
+typedef struct _LauncherResourcesClass LauncherResourcesClass;
+
+struct _LauncherResources
+{
+  GObject parent_instance;
+};
+
+struct _LauncherResourcesClass
+{
+  GObjectClass parent_class;
+};
+
+GType launcher_resources_get_type (void) G_GNUC_CONST;
+
+LauncherResources*  launcher_resources_new          (LauncherConfig     *config,
+                                                     GError            **error);
+
+gboolean            launcher_resources_is_empty     (LauncherResources  *resources);
+gboolean            launcher_resources_has_cgroup   (LauncherResources  *resources);
+gboolean            launcher_resources_get_affinity (LauncherResources  *resources,
+                                                     gpointer            cpus);
+void                launcher_resources_child_setup  (gpointer            resources);
+gchar**             launcher_resources_wrap_argv    (LauncherResources  *resources,
+                                                     gchar             **argv);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_RESOURCES_H__ */
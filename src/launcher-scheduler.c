@@ -0,0 +1,408 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "launcher-scheduler.h"
+
+/*
+ * The queue every run, sweep and benchmark started from the menus goes 
+ * through, so that holding down the run key or a watch restarting in a 
+ * loop can not fork more programs than the machine has cores.
+ *
+ * At most max jobs run at the same time, and a config with a limit on its 
+ * instances only starts when fewer runs of it are running than that. A 
+ * job over its config's limit is passed by the jobs behind it. Sweeps and 
+ * benchmarks are exclusive: only one of them runs at a time, nothing 
+ * starts while it runs, and nothing behind a waiting one passes it. 
+ * They do not wait for plain runs though, those are often servers that 
+ * never finish and would hold a measurement back forever.
+ *
+ * The queue is ordered by priority and then by the order jobs were 
+ * submitted in. The scheduler never stops a running job on its own, the 
+ * engine tells it when whatever a job started has finished.
+ */
+
+static void launcher_scheduler_class_init  (LauncherSchedulerClass *klass);
+static void launcher_scheduler_init        (LauncherScheduler      *scheduler);
+static void launcher_scheduler_finalize    (LauncherScheduler      *scheduler);
+
+static void dispatch                       (LauncherScheduler      *scheduler);
+static LauncherJob* next_job               (LauncherScheduler      *scheduler);
+static gboolean has_exclusive              (LauncherScheduler      *scheduler);
+static gboolean has_instance               (LauncherScheduler      *scheduler,
+                                            LauncherJob            *job);
+static gint compare_jobs                   (LauncherJob            *job1,
+                                            LauncherJob            *job2);
+static void destroy_job                    (LauncherJob            *job);
+static void emit_changed                   (LauncherScheduler      *scheduler);
+
+#define LAUNCHER_SCHEDULER_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_SCHEDULER_TYPE, LauncherSchedulerPrivate))
+
+typedef struct _LauncherSchedulerPrivate LauncherSchedulerPrivate;
+
+struct _LauncherSchedulerPrivate
+{
+  GList    *queued;
+  GList    *running;
+  guint     n_running;
+  gint      max_jobs;
+  guint     next_id;
+  gboolean  dispatching;
+};
+
+enum
+{
+  CHANGED,
+  LAST_SIGNAL
+};
+
+static guint launcher_scheduler_signals[LAST_SIGNAL] = { 0 };
+
+G_DEFINE_TYPE (LauncherScheduler, launcher_scheduler, G_TYPE_OBJECT)
+
+static void
+launcher_scheduler_class_init (LauncherSchedulerClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  launcher_scheduler_signals[CHANGED] =
+    g_signal_new ("changed", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherSchedulerClass, changed),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_scheduler_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherSchedulerPrivate));
+}
+
+static void
+launcher_scheduler_init (LauncherScheduler *scheduler)
+{
+  LauncherSchedulerPrivate *priv;
+  priv = LAUNCHER_SCHEDULER_GET_PRIVATE (scheduler);
+  priv->queued = NULL;
+  priv->running = NULL;
+  priv->n_running = 0;
+  priv->max_jobs = g_get_num_processors ();
+  priv->next_id = 1;
+  priv->dispatching = FALSE;
+}
+
+/*
+ * Whatever is still running is cancelled, the jobs are marked as finished 
+ * so that a late callback can tell nobody is waiting for it anymore.
+ */
+static void
+launcher_scheduler_finalize (LauncherScheduler *scheduler)
+{
+  LauncherSchedulerPrivate *priv;
+  priv = LAUNCHER_SCHEDULER_GET_PRIVATE (scheduler);
+  g_list_free_full (priv->queued, (GDestroyNotify) destroy_job);
+  g_list_free_full (priv->running, (GDestroyNotify) destroy_job);
+  G_OBJECT_CLASS (launcher_scheduler_parent_class)->finalize (G_OBJECT (scheduler));
+}
+
+LauncherScheduler*
+launcher_scheduler_new (void)
+{
+  return LAUNCHER_SCHEDULER (g_object_new (launcher_scheduler_get_type (), NULL));
+}
+
+/*
+ * Defaults to the number of processors.
+ */
+gint
+launcher_scheduler_get_max_jobs (LauncherScheduler *scheduler)
+{
+  return LAUNCHER_SCHEDULER_GET_PRIVATE (scheduler)->max_jobs;
+}
+
+/*
+ * Lowering the limit lets the running jobs finish, it only holds back 
+ * the queued ones.
+ */
+void
+launcher_scheduler_set_max_jobs (LauncherScheduler *scheduler,
+                                 gint               max_jobs)
+{
+  LauncherSchedulerPrivate *priv;
+  priv = LAUNCHER_SCHEDULER_GET_PRIVATE (scheduler);
+  priv->max_jobs = MAX (max_jobs, 1);
+  dispatch (scheduler);
+  emit_changed (scheduler);
+}
+
+/*
+ * The func is called with the data when the job starts, which can be 
+ * right away. The returned job is owned by the scheduler and stays valid 
+ * until it is finished or cancelled.
+ */
+LauncherJob*
+launcher_scheduler_submit (LauncherScheduler *scheduler,
+                           LauncherConfig    *config,
+                           LauncherJobKind    kind,
+                           LauncherJobFunc    func,
+                           gpointer           data)
+{
+  LauncherSchedulerPrivate *priv;
+  LauncherJob *job;
+  
+  priv = LAUNCHER_SCHEDULER_GET_PRIVATE (scheduler);
+  
+  job = launcher_job_new (priv->next_id++, config, kind, func, data);
+  priv->queued = g_list_insert_sorted (priv->queued, job, (GCompareFunc) compare_jobs);
+  
+  dispatch (scheduler);
+  emit_changed (scheduler);
+  
+  return job;
+}
+
+void
+launcher_scheduler_finish (LauncherScheduler *scheduler,
+                           LauncherJob       *job)
+{
+  LauncherSchedulerPrivate *priv;
+  priv = LAUNCHER_SCHEDULER_GET_PRIVATE (scheduler);
+  
+  if (g_list_find (priv->running, job) == NULL)
+    return;
+  
+  priv->running = g_list_remove (priv->running, job);
+  priv->n_running--;
+  launcher_job_set_state (job, LAUNCHER_JOB_FINISHED);
+  g_object_unref (job);
+  
+  dispatch (scheduler);
+  emit_changed (scheduler);
+}
+
+/*
+ * A queued job is dropped right away. A running job has its cancellable 
+ * cancelled and stays in the list until what it started has stopped.
+ */
+void
+launcher_scheduler_cancel (LauncherScheduler *scheduler,
+                           LauncherJob       *job)
+{
+  LauncherSchedulerPrivate *priv;
+  priv = LAUNCHER_SCHEDULER_GET_PRIVATE (scheduler);
+  
+  if (launcher_job_get_state (job) == LAUNCHER_JOB_RUNNING)
+    {
+      g_cancellable_cancel (launcher_job_get_cancellable (job));
+      return;
+    }
+  
+  if (g_list_find (priv->queued, job) == NULL)
+    return;
+  
+  priv->queued = g_list_remove (priv->queued, job);
+  destroy_job (job);
+  
+  /* the cancelled job may have been an exclusive one holding up the rest */
+  dispatch (scheduler);
+  emit_changed (scheduler);
+}
+
+void
+launcher_scheduler_set_priority (LauncherScheduler *scheduler,
+                                 LauncherJob       *job,
+                                 gint               priority)
+{
+  LauncherSchedulerPrivate *priv;
+  priv = LAUNCHER_SCHEDULER_GET_PRIVATE (scheduler);
+  
+  if (g_list_find (priv->queued, job) == NULL)
+    return;
+  
+  launcher_job_set_priority (job, priority);
+  priv->queued = g_list_sort (priv->queued, (GCompareFunc) compare_jobs);
+  
+  dispatch (scheduler);
+  emit_changed (scheduler);
+}
+
+LauncherJob*
+launcher_scheduler_lookup (LauncherScheduler *scheduler,
+                           guint              id)
+{
+  LauncherSchedulerPrivate *priv;
+  GList *list;
+  
+  priv = LAUNCHER_SCHEDULER_GET_PRIVATE (scheduler);
+  
+  for (list = priv->running; list != NULL; list = list->next)
+    if (launcher_job_get_id (list->data) == id)
+      return list->data;
+  
+  for (list = priv->queued; list != NULL; list = list->next)
+    if (launcher_job_get_id (list->data) == id)
+      return list->data;
+  
+  return NULL;
+}
+
+/*
+ * The running jobs in the order they started followed by the queued jobs 
+ * in the order they will start. Free the list with g_list_free.
+ */
+GList*
+launcher_scheduler_get_jobs (LauncherScheduler *scheduler)
+{
+  LauncherSchedulerPrivate *priv;
+  priv = LAUNCHER_SCHEDULER_GET_PRIVATE (scheduler);
+  return g_list_concat (g_list_copy (priv->running), g_list_copy (priv->queued));
+}
+
+/*
+ * A job can submit, finish or cancel jobs while it starts. Those calls 
+ * only change the lists, the loop here sees the changes when it looks 
+ * for the next job.
+ */
+static void
+dispatch (LauncherScheduler *scheduler)
+{
+  LauncherSchedulerPrivate *priv;
+  LauncherJob *job;
+  
+  priv = LAUNCHER_SCHEDULER_GET_PRIVATE (scheduler);
+  
+  if (priv->dispatching)
+    return;
+  
+  priv->dispatching = TRUE;
+  
+  while ((job = next_job (scheduler)) != NULL)
+    {
+      priv->queued = g_list_remove (priv->queued, job);
+      priv->running = g_list_append (priv->running, job);
+      priv->n_running++;
+      
+      if (!launcher_job_start (job) && g_list_find (priv->running, job) != NULL)
+        {
+          priv->running = g_list_remove (priv->running, job);
+          priv->n_running--;
+          launcher_job_set_state (job, LAUNCHER_JOB_FINISHED);
+          g_object_unref (job);
+        }
+    }
+  
+  priv->dispatching = FALSE;
+}
+
+static LauncherJob*
+next_job (LauncherScheduler *scheduler)
+{
+  LauncherSchedulerPrivate *priv;
+  GList *list;
+  
+  priv = LAUNCHER_SCHEDULER_GET_PRIVATE (scheduler);
+  
+  if (has_exclusive (scheduler))
+    return NULL;
+  
+  for (list = priv->queued; list != NULL; list = list->next)
+    {
+      LauncherJob *job = list->data;
+      
+      if (launcher_job_is_exclusive (job))
+        return job;
+      
+      if (priv->n_running >= (guint) priv->max_jobs)
+        return NULL;
+      
+      if (!has_instance (scheduler, job))
+        return job;
+    }
+  
+  return NULL;
+}
+
+/*
+ * Whether a sweep or benchmark is running, it need not be the first 
+ * running job since it does not wait for the runs before it.
+ */
+static gboolean
+has_exclusive (LauncherScheduler *scheduler)
+{
+  LauncherSchedulerPrivate *priv;
+  GList *list;
+  
+  priv = LAUNCHER_SCHEDULER_GET_PRIVATE (scheduler);
+  
+  for (list = priv->running; list != NULL; list = list->next)
+    if (launcher_job_is_exclusive (list->data))
+      return TRUE;
+  
+  return FALSE;
+}
+
+/*
+ * Whether the config of the job already runs as many times as it may.
+ */
+static gboolean
+has_instance (LauncherScheduler *scheduler,
+              LauncherJob       *job)
+{
+  LauncherSchedulerPrivate *priv;
+  GList *list;
+  gint max_instances;
+  gint n_instances = 0;
+  
+  priv = LAUNCHER_SCHEDULER_GET_PRIVATE (scheduler);
+  
+  max_instances = launcher_config_get_max_instances (launcher_job_get_config (job));
+  if (max_instances <= 0)
+    return FALSE;
+  
+  for (list = priv->running; list != NULL; list = list->next)
+    if (launcher_job_same_profile (list->data, job))
+      n_instances++;
+  
+  return n_instances >= max_instances;
+}
+
+static gint
+compare_jobs (LauncherJob *job1,
+              LauncherJob *job2)
+{
+  gint priority1 = launcher_job_get_priority (job1);
+  gint priority2 = launcher_job_get_priority (job2);
+  
+  if (priority1 != priority2)
+    return priority1 > priority2 ? -1 : 1;
+  
+  return launcher_job_get_id (job1) < launcher_job_get_id (job2) ? -1 : 1;
+}
+
+static void
+destroy_job (LauncherJob *job)
+{
+  launcher_job_set_state (job, LAUNCHER_JOB_FINISHED);
+  g_cancellable_cancel (launcher_job_get_cancellable (job));
+  g_object_unref (job);
+}
+
+static void
+emit_changed (LauncherScheduler *scheduler)
+{
+  g_signal_emit_by_name ((gpointer) scheduler, "changed");
+}
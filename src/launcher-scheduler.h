@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_SCHEDULER_H__
+#define	__LAUNCHER_SCHEDULER_H__
+
+#include <gio/gio.h>
+#include "launcher-config.h"
+#include "launcher-job.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_SCHEDULER_TYPE            (launcher_scheduler_get_type ())
+#define LAUNCHER_SCHEDULER(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_SCHEDULER_TYPE, LauncherScheduler))
+#define LAUNCHER_SCHEDULER_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_SCHEDULER_TYPE, LauncherSchedulerClass))
+#define IS_LAUNCHER_SCHEDULER(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_SCHEDULER_TYPE))
+#define IS_LAUNCHER_SCHEDULER_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_SCHEDULER_TYPE))
+
+typedef struct _LauncherScheduler LauncherScheduler;
+typedef struct _LauncherSchedulerClass LauncherSchedulerClass;
+
+struct _LauncherScheduler
+{
+  GObject parent_instance;
+};
+
+struct _LauncherSchedulerClass
+{
+  GObjectClass parent_class;
+
+  void (*changed) (LauncherScheduler *scheduler);
+};
+
+GType launcher_scheduler_get_type (void) G_GNUC_CONST;
+
+LauncherScheduler*  launcher_scheduler_new           (void);
+
+gint                launcher_scheduler_get_max_jobs  (LauncherScheduler *scheduler);
+void                launcher_scheduler_set_max_jobs  (LauncherScheduler *scheduler,
+                                                      gint               max_jobs);
+
+LauncherJob*        launcher_scheduler_submit        (LauncherScheduler *scheduler,
+                                                      LauncherConfig    *config,
+                                                      LauncherJobKind    kind,
+                                                      LauncherJobFunc    func,
+                                                      gpointer           data);
+void                launcher_scheduler_finish        (LauncherScheduler *scheduler,
+                                                      LauncherJob       *job);
+void                launcher_scheduler_cancel        (LauncherScheduler *scheduler,
+                                                      LauncherJob       *job);
+void                launcher_scheduler_set_priority  (LauncherScheduler *scheduler,
+                                                      LauncherJob       *job,
+                                                      gint               priority);
+
+LauncherJob*        launcher_scheduler_lookup        (LauncherScheduler *scheduler,
+                                                      guint              id);
+GList*              launcher_scheduler_get_jobs      (LauncherScheduler *scheduler);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_SCHEDULER_H__ */
@@ -0,0 +1,463 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include <sys/wait.h>
+#include "launcher-sweep-view.h"
+
+static void launcher_sweep_view_class_init  (LauncherSweepViewClass *klass);
+static void launcher_sweep_view_init        (LauncherSweepView      *sweep_view);
+static void launcher_sweep_view_finalize    (LauncherSweepView      *sweep_view);
+
+static void add_column                      (LauncherSweepView      *sweep_view,
+                                             const gchar            *title,
+                                             gint                    column);
+static void format_cell                     (GtkTreeViewColumn      *tree_column,
+                                             GtkCellRenderer        *renderer,
+                                             GtkTreeModel           *model,
+                                             GtkTreeIter            *iter,
+                                             gpointer                column);
+static void progress_action                 (LauncherSweepView      *sweep_view);
+static void export_action                   (LauncherSweepView      *sweep_view);
+static gboolean write_csv                   (LauncherSweepView      *sweep_view,
+                                             const gchar            *file_path,
+                                             GError                **error);
+static gchar* quote_csv                     (const gchar            *value);
+static gchar* format_status                 (gint                    status);
+static void disconnect_sweep                (LauncherSweepView      *sweep_view);
+
+#define LAUNCHER_SWEEP_VIEW_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_SWEEP_VIEW_TYPE, LauncherSweepViewPrivate))
+
+typedef struct _LauncherSweepViewPrivate LauncherSweepViewPrivate;
+
+struct _LauncherSweepViewPrivate
+{
+  LauncherSweep *sweep;
+  GtkWidget     *status_label;
+  GtkWidget     *export_button;
+  GtkWidget     *tree;
+  GtkListStore  *store;
+  gulong         progress_id;
+  guint          n_rows;
+  gboolean       finished;
+};
+
+enum
+{
+  PARAMETERS = 0,
+  STATUS,
+  WALL_TIME,
+  USER_TIME,
+  SYSTEM_TIME,
+  MAX_RSS,
+  CPUS,
+  COLUMNS
+};
+
+G_DEFINE_TYPE (LauncherSweepView, launcher_sweep_view, GTK_TYPE_BOX)
+
+static void
+launcher_sweep_view_class_init (LauncherSweepViewClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_sweep_view_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherSweepViewPrivate));
+}
+
+static void
+launcher_sweep_view_init (LauncherSweepView *sweep_view)
+{
+  LauncherSweepViewPrivate *priv;
+  GtkWidget *hbox;
+  GtkWidget *scrolled_window;
+
+  priv = LAUNCHER_SWEEP_VIEW_GET_PRIVATE (sweep_view);
+  priv->sweep = NULL;
+  priv->progress_id = 0;
+  priv->n_rows = 0;
+  priv->finished = FALSE;
+
+  gtk_orientable_set_orientation (GTK_ORIENTABLE (sweep_view), GTK_ORIENTATION_VERTICAL);
+  
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
+  gtk_box_pack_start (GTK_BOX (sweep_view), hbox, FALSE, FALSE, 0);
+  
+  priv->status_label = gtk_label_new (NULL);
+  gtk_misc_set_alignment (GTK_MISC (priv->status_label), 0, .5);
+  gtk_misc_set_padding (GTK_MISC (priv->status_label), 4, 2);
+  gtk_box_pack_start (GTK_BOX (hbox), priv->status_label, TRUE, TRUE, 0);
+  
+  priv->export_button = gtk_button_new_with_label ("Export CSV");
+  gtk_button_set_relief (GTK_BUTTON (priv->export_button), GTK_RELIEF_NONE);
+  gtk_widget_set_sensitive (priv->export_button, FALSE);
+  gtk_box_pack_start (GTK_BOX (hbox), priv->export_button, FALSE, FALSE, 0);
+  g_signal_connect_swapped (G_OBJECT (priv->export_button), "clicked",
+                            G_CALLBACK (export_action), sweep_view);
+  
+  priv->store = gtk_list_store_new (COLUMNS, G_TYPE_STRING, G_TYPE_INT, G_TYPE_INT64, 
+                                    G_TYPE_INT64, G_TYPE_INT64, G_TYPE_LONG, G_TYPE_STRING);
+  priv->tree = gtk_tree_view_new_with_model (GTK_TREE_MODEL (priv->store));
+  
+  add_column (sweep_view, "Parameters", PARAMETERS);
+  add_column (sweep_view, "Status", STATUS);
+  add_column (sweep_view, "Wall Time", WALL_TIME);
+  add_column (sweep_view, "User Time", USER_TIME);
+  add_column (sweep_view, "System Time", SYSTEM_TIME);
+  add_column (sweep_view, "Max RSS", MAX_RSS);
+  add_column (sweep_view, "CPUs", CPUS);
+
+  scrolled_window = gtk_scrolled_window_new (NULL, NULL);
+  gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolled_window),
+                                  GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_container_add (GTK_CONTAINER (scrolled_window), priv->tree);
+  gtk_box_pack_start (GTK_BOX (sweep_view), scrolled_window, TRUE, TRUE, 0);
+}
+
+static void
+launcher_sweep_view_finalize (LauncherSweepView *sweep_view)
+{
+  LauncherSweepViewPrivate *priv;
+  priv = LAUNCHER_SWEEP_VIEW_GET_PRIVATE (sweep_view);
+  disconnect_sweep (sweep_view);
+  g_object_unref (priv->store);
+  G_OBJECT_CLASS (launcher_sweep_view_parent_class)->finalize (G_OBJECT (sweep_view));
+}
+
+GtkWidget*
+launcher_sweep_view_new (void)
+{
+  return g_object_new (launcher_sweep_view_get_type (), NULL);
+}
+
+/*
+ * The store keeps the raw numbers so that sorting a column sorts by value, 
+ * the cells are formatted when they are drawn.
+ */
+static void
+add_column (LauncherSweepView *sweep_view,
+            const gchar       *title,
+            gint               column)
+{
+  LauncherSweepViewPrivate *priv;
+  GtkCellRenderer *renderer;
+  GtkTreeViewColumn *tree_column;
+  
+  priv = LAUNCHER_SWEEP_VIEW_GET_PRIVATE (sweep_view);
+  
+  renderer = gtk_cell_renderer_text_new ();
+  tree_column = gtk_tree_view_column_new ();
+  gtk_tree_view_column_set_title (tree_column, title);
+  gtk_tree_view_column_pack_start (tree_column, renderer, TRUE);
+  
+  if (column == PARAMETERS || column == CPUS)
+    {
+      gtk_tree_view_column_add_attribute (tree_column, renderer, "text", column);
+    }
+  else
+    {
+      g_object_set (renderer, "xalign", 1.0, NULL);
+      gtk_tree_view_column_set_cell_data_func (tree_column, renderer, format_cell, 
+                                               GINT_TO_POINTER (column), NULL);
+    }
+
+  gtk_tree_view_column_set_sort_column_id (tree_column, column);
+  gtk_tree_view_column_set_expand (tree_column, column == PARAMETERS);
+  gtk_tree_view_append_column (GTK_TREE_VIEW (priv->tree), tree_column);
+}
+
+static void
+format_cell (GtkTreeViewColumn *tree_column,
+             GtkCellRenderer   *renderer,
+             GtkTreeModel      *model,
+             GtkTreeIter       *iter,
+             gpointer           column)
+{
+  gchar *text = NULL;
+  
+  switch (GPOINTER_TO_INT (column))
+    {
+    case STATUS:
+      {
+        gint status;
+        gtk_tree_model_get (model, iter, STATUS, &status, -1);
+        text = format_status (status);
+      }
+      break;
+    case WALL_TIME:
+    case USER_TIME:
+    case SYSTEM_TIME:
+      {
+        gint64 time;
+        gtk_tree_model_get (model, iter, GPOINTER_TO_INT (column), &time, -1);
+        text = g_strdup_printf ("%.3f ms", time / 1000.0);
+      }
+      break;
+    case MAX_RSS:
+      {
+        glong max_rss;
+        gtk_tree_model_get (model, iter, MAX_RSS, &max_rss, -1);
+        text = g_strdup_printf ("%ld KiB", max_rss);
+      }
+      break;
+    }
+  
+  g_object_set (renderer, "text", text, NULL);
+  g_free (text);
+}
+
+void
+launcher_sweep_view_set_sweep (LauncherSweepView *sweep_view,
+                               LauncherSweep     *sweep)
+{
+  LauncherSweepViewPrivate *priv;
+  priv = LAUNCHER_SWEEP_VIEW_GET_PRIVATE (sweep_view);
+  
+  disconnect_sweep (sweep_view);
+
+  priv->sweep = g_object_ref (sweep);
+  priv->progress_id = g_signal_connect_swapped (G_OBJECT (sweep), "progress",
+                                                G_CALLBACK (progress_action), sweep_view);
+  
+  priv->finished = FALSE;
+  priv->n_rows = 0;
+  gtk_list_store_clear (priv->store);
+  gtk_widget_set_sensitive (priv->export_button, FALSE);
+  progress_action (sweep_view);
+}
+
+static void
+disconnect_sweep (LauncherSweepView *sweep_view)
+{
+  LauncherSweepViewPrivate *priv;
+  priv = LAUNCHER_SWEEP_VIEW_GET_PRIVATE (sweep_view);
+  
+  if (priv->sweep == NULL)
+    return;
+
+  g_signal_handler_disconnect (priv->sweep, priv->progress_id);
+  g_object_unref (priv->sweep);
+  priv->sweep = NULL;
+}
+
+/*
+ * Adds the rows for the results that arrived since the last call.
+ */
+static void
+progress_action (LauncherSweepView *sweep_view)
+{
+  LauncherSweepViewPrivate *priv;
+  LauncherConfig *config;
+  guint n_results;
+  gchar *text;
+  
+  priv = LAUNCHER_SWEEP_VIEW_GET_PRIVATE (sweep_view);
+  
+  n_results = launcher_sweep_get_n_results (priv->sweep);
+  
+  for (; priv->n_rows < n_results; priv->n_rows++)
+    {
+      const LauncherSweepResult *result;
+      GtkTreeIter iter;
+      gchar *cpus;
+      
+      result = launcher_sweep_get_result (priv->sweep, priv->n_rows);
+      if (result->n_cpus > 1)
+        cpus = g_strdup_printf ("%d-%d", result->first_cpu, result->first_cpu + result->n_cpus - 1);
+      else
+        cpus = g_strdup_printf ("%d", result->first_cpu);
+      
+      gtk_list_store_append (priv->store, &iter);
+      gtk_list_store_set (priv->store, &iter,
+                          PARAMETERS, result->parameters,
+                          STATUS, result->status,
+                          WALL_TIME, result->wall_time,
+                          USER_TIME, result->user_time,
+                          SYSTEM_TIME, result->system_time,
+                          MAX_RSS, result->max_rss,
+                          CPUS, cpus,
+                          -1);
+      g_free (cpus);
+    }
+  
+  if (priv->finished)
+    return;
+  
+  config = launcher_sweep_get_config (priv->sweep);
+  text = g_strdup_printf ("Sweeping %s: %d of %d runs", 
+                          launcher_config_get_executable (config),
+                          n_results, launcher_sweep_get_n_runs (priv->sweep));
+  gtk_label_set_text (GTK_LABEL (priv->status_label), text);
+  g_free (text);
+}
+
+void
+launcher_sweep_view_show_results (LauncherSweepView *sweep_view,
+                                  const GError      *error)
+{
+  LauncherSweepViewPrivate *priv;
+  LauncherConfig *config;
+  gchar *text;
+  
+  priv = LAUNCHER_SWEEP_VIEW_GET_PRIVATE (sweep_view);
+  
+  progress_action (sweep_view);
+  priv->finished = TRUE;
+  
+  config = launcher_sweep_get_config (priv->sweep);
+  
+  if (error != NULL)
+    text = g_strdup_printf ("Sweep of %s failed: %s", 
+                            launcher_config_get_executable (config), error->message);
+  else
+    text = g_strdup_printf ("%s: %d runs on %d concurrent slots", 
+                            launcher_config_get_executable (config),
+                            launcher_sweep_get_n_results (priv->sweep),
+                            launcher_sweep_get_n_slots (priv->sweep));
+
+  gtk_label_set_text (GTK_LABEL (priv->status_label), text);
+  gtk_widget_set_sensitive (priv->export_button, priv->n_rows > 0);
+  g_free (text);
+}
+
+static void
+export_action (LauncherSweepView *sweep_view)
+{
+  GtkWidget *dialog;
+  
+  dialog = gtk_file_chooser_dialog_new ("Export Sweep Results", 
+                                        NULL,
+                                        GTK_FILE_CHOOSER_ACTION_SAVE,
+                                        GTK_STOCK_CANCEL,
+                                        GTK_RESPONSE_CANCEL,
+                                        GTK_STOCK_SAVE,
+                                        GTK_RESPONSE_OK, 
+                                        NULL);
+  
+  gtk_dialog_set_default_response (GTK_DIALOG (dialog), GTK_RESPONSE_OK);
+  gtk_file_chooser_set_do_overwrite_confirmation (GTK_FILE_CHOOSER (dialog), TRUE);
+  gtk_file_chooser_set_current_name (GTK_FILE_CHOOSER (dialog), "sweep.csv");
+
+  if (gtk_dialog_run (GTK_DIALOG (dialog)) == GTK_RESPONSE_OK)
+    {
+      GError *error = NULL;
+      gchar *file_path;
+      
+      file_path = gtk_file_chooser_get_filename (GTK_FILE_CHOOSER (dialog));
+      if (!write_csv (sweep_view, file_path, &error))
+        {
+          LauncherSweepViewPrivate *priv;
+          priv = LAUNCHER_SWEEP_VIEW_GET_PRIVATE (sweep_view);
+          gtk_label_set_text (GTK_LABEL (priv->status_label), error->message);
+          g_error_free (error);
+        }
+      g_free (file_path);
+    }
+
+  gtk_widget_destroy (dialog);
+}
+
+/*
+ * Rows are written in the order they are shown, so a sorted table exports 
+ * sorted.
+ */
+static gboolean
+write_csv (LauncherSweepView  *sweep_view,
+           const gchar        *file_path,
+           GError            **error)
+{
+  LauncherSweepViewPrivate *priv;
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  GString *string;
+  gboolean valid;
+  gboolean result;
+  
+  priv = LAUNCHER_SWEEP_VIEW_GET_PRIVATE (sweep_view);
+  model = GTK_TREE_MODEL (priv->store);
+  
+  string = g_string_new ("parameters,status,wall_time_us,user_time_us,system_time_us,max_rss_kib,cpus\n");
+  
+  for (valid = gtk_tree_model_get_iter_first (model, &iter); valid; 
+       valid = gtk_tree_model_iter_next (model, &iter))
+    {
+      gchar *parameters;
+      gchar *cpus;
+      gchar *quoted;
+      gchar *status;
+      gint status_code;
+      gint64 wall_time;
+      gint64 user_time;
+      gint64 system_time;
+      glong max_rss;
+      
+      gtk_tree_model_get (model, &iter, 
+                          PARAMETERS, &parameters,
+                          STATUS, &status_code,
+                          WALL_TIME, &wall_time,
+                          USER_TIME, &user_time,
+                          SYSTEM_TIME, &system_time,
+                          MAX_RSS, &max_rss,
+                          CPUS, &cpus,
+                          -1);
+      
+      quoted = quote_csv (parameters);
+      status = format_status (status_code);
+      g_string_append_printf (string, "%s,%s,%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT 
+                              ",%" G_GINT64_FORMAT ",%ld,%s\n", 
+                              quoted, status, wall_time, user_time, system_time, 
+                              max_rss, cpus);
+      g_free (quoted);
+      g_free (status);
+      g_free (parameters);
+      g_free (cpus);
+    }
+  
+  result = g_file_set_contents (file_path, string->str, string->len, error);
+  g_string_free (string, TRUE);
+  return result;
+}
+
+static gchar*
+quote_csv (const gchar *value)
+{
+  GString *string;
+  const gchar *pointer;
+  
+  if (strpbrk (value, ",\"\n") == NULL)
+    return g_strdup (value);
+
+  string = g_string_new ("\"");
+  for (pointer = value; *pointer != '\0'; pointer++)
+    {
+      if (*pointer == '"')
+        g_string_append_c (string, '"');
+      g_string_append_c (string, *pointer);
+    }
+  g_string_append_c (string, '"');
+  
+  return g_string_free (string, FALSE);
+}
+
+static gchar*
+format_status (gint status)
+{
+  if (WIFEXITED (status))
+    return g_strdup_printf ("%d", WEXITSTATUS (status));
+  return g_strdup_printf ("signal %d", WTERMSIG (status));
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_SWEEP_VIEW_H__
+#define	__LAUNCHER_SWEEP_VIEW_H__
+
+#include <gtk/gtk.h>
+#include "launcher-sweep.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_SWEEP_VIEW_TYPE            (launcher_sweep_view_get_type ())
+#define LAUNCHER_SWEEP_VIEW(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_SWEEP_VIEW_TYPE, LauncherSweepView))
+#define LAUNCHER_SWEEP_VIEW_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_SWEEP_VIEW_TYPE, LauncherSweepViewClass))
+#define IS_LAUNCHER_SWEEP_VIEW(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_SWEEP_VIEW_TYPE))
+#define IS_LAUNCHER_SWEEP_VIEW_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_SWEEP_VIEW_TYPE))
+
+typedef struct _LauncherSweepView LauncherSweepView;
+typedef struct _LauncherSweepViewClass LauncherSweepViewClass;
+
+struct _LauncherSweepView
+{
+  GtkBox parent_instance;
+};
+
+struct _LauncherSweepViewClass
+{
+  GtkBoxClass parent_class;
+};
+
+GType launcher_sweep_view_get_type (void) G_GNUC_CONST;
+     
+GtkWidget*  launcher_sweep_view_new           (void);
+
+void        launcher_sweep_view_set_sweep     (LauncherSweepView *sweep_view,
+                                               LauncherSweep     *sweep);
+void        launcher_sweep_view_show_results  (LauncherSweepView *sweep_view,
+                                               const GError      *error);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_SWEEP_VIEW_H__ */
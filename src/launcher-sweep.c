@@ -0,0 +1,641 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "launcher-sweep.h"
+
+/*
+ * A sweep runs the executable once for every combination of the placeholders 
+ * in the parameters, so "--threads={1,2} --batch={64,256}" is four runs. The 
+ * runs are spread over one worker thread per slot, where every slot owns a 
+ * disjoint set of the CPUs the editor is allowed to use and pins its children 
+ * to them, so that concurrent runs do not steal each other's cores. A cpu 
+ * affinity in the config takes the place of the editor's CPUs, the other 
+ * resource settings are applied to every run as they are for a single one.
+ */
+
+static void launcher_sweep_class_init  (LauncherSweepClass *klass);
+static void launcher_sweep_init        (LauncherSweep      *sweep);
+static void launcher_sweep_finalize    (LauncherSweep      *sweep);
+
+typedef struct
+{
+  LauncherSweep *sweep;
+  GCancellable  *cancellable;
+  cpu_set_t      cpus;
+  gint           first_cpu;
+  gint           n_cpus;
+  GPid           pid;
+  GError        *error;
+} Slot;
+
+static const gchar* find_placeholder   (const gchar        *string,
+                                        const gchar       **end);
+static void run_thread                 (GTask              *task,
+                                        LauncherSweep      *sweep,
+                                        gpointer            task_data,
+                                        GCancellable       *cancellable);
+static gpointer slot_thread            (Slot               *slot);
+static gboolean run_once               (Slot               *slot,
+                                        gchar             **argv,
+                                        LauncherSweepResult *result,
+                                        GError            **error);
+static void child_setup                (Slot               *slot);
+static void cancelled_action           (GCancellable       *cancellable,
+                                        LauncherSweep      *sweep);
+static gboolean progress_action        (LauncherSweep      *sweep);
+static void result_free                (LauncherSweepResult *result);
+
+#define LAUNCHER_SWEEP_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_SWEEP_TYPE, LauncherSweepPrivate))
+
+typedef struct _LauncherSweepPrivate LauncherSweepPrivate;
+
+struct _LauncherSweepPrivate
+{
+  LauncherConfig    *config;
+  GPtrArray         *parameters;
+  GPtrArray         *argvs;
+  gchar            **environment;
+  LauncherResources *resources;
+  GPtrArray         *results;
+  Slot              *slots;
+  GMutex             mutex;
+  guint              next;
+  guint              n_slots;
+};
+
+enum
+{
+  PROGRESS,
+  LAST_SIGNAL
+};
+
+static guint launcher_sweep_signals[LAST_SIGNAL] = { 0 };
+
+G_DEFINE_TYPE (LauncherSweep, launcher_sweep, G_TYPE_OBJECT)
+
+static void 
+launcher_sweep_class_init (LauncherSweepClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  launcher_sweep_signals[PROGRESS] =
+    g_signal_new ("progress", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherSweepClass, progress),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_sweep_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherSweepPrivate));
+}
+
+static void
+launcher_sweep_init (LauncherSweep *sweep)
+{
+  LauncherSweepPrivate *priv;
+  priv = LAUNCHER_SWEEP_GET_PRIVATE (sweep);
+  priv->config = NULL;
+  priv->parameters = g_ptr_array_new_with_free_func (g_free);
+  priv->argvs = g_ptr_array_new_with_free_func ((GDestroyNotify) g_strfreev);
+  priv->results = g_ptr_array_new_with_free_func ((GDestroyNotify) result_free);
+  priv->environment = NULL;
+  priv->resources = NULL;
+  priv->slots = NULL;
+  g_mutex_init (&priv->mutex);
+  priv->next = 0;
+  priv->n_slots = 0;
+}
+
+static void
+launcher_sweep_finalize (LauncherSweep *sweep)
+{
+  LauncherSweepPrivate *priv;
+  priv = LAUNCHER_SWEEP_GET_PRIVATE (sweep);
+  if (priv->config)
+    g_object_unref (priv->config);
+  g_ptr_array_unref (priv->parameters);
+  g_ptr_array_unref (priv->argvs);
+  g_ptr_array_unref (priv->results);
+  g_strfreev (priv->environment);
+  if (priv->resources)
+    g_object_unref (priv->resources);
+  g_mutex_clear (&priv->mutex);
+  G_OBJECT_CLASS (launcher_sweep_parent_class)->finalize (G_OBJECT (sweep));
+}
+
+LauncherSweep*
+launcher_sweep_new (LauncherConfig *config)
+{
+  LauncherSweepPrivate *priv;
+  LauncherSweep *sweep;
+
+  sweep = LAUNCHER_SWEEP (g_object_new (launcher_sweep_get_type (), NULL));
+  priv = LAUNCHER_SWEEP_GET_PRIVATE (sweep);
+  priv->config = g_object_ref (config);
+
+  return sweep;
+}
+
+/*
+ * A placeholder is a brace pair holding at least one comma. A brace right 
+ * after a $ is left alone so that ${name} style text passes through.
+ */
+static const gchar*
+find_placeholder (const gchar  *string,
+                  const gchar **end)
+{
+  const gchar *start;
+  
+  for (start = strchr (string, '{'); start != NULL; start = strchr (start + 1, '{'))
+    {
+      const gchar *close;
+      const gchar *comma;
+      const gchar *open;
+      
+      if (start > string && start[-1] == '$')
+        continue;
+      
+      close = strchr (start + 1, '}');
+      if (close == NULL)
+        return NULL;
+      
+      open = strchr (start + 1, '{');
+      if (open != NULL && open < close)
+        continue;
+      
+      comma = strchr (start + 1, ',');
+      if (comma == NULL || comma > close)
+        continue;
+      
+      *end = close + 1;
+      return start;
+    }
+  
+  return NULL;
+}
+
+gboolean
+launcher_sweep_has_placeholders (const gchar *parameters)
+{
+  const gchar *end;
+  return parameters != NULL && find_placeholder (parameters, &end) != NULL;
+}
+
+/*
+ * Returns every combination with the last placeholder changing fastest.
+ */
+gchar**
+launcher_sweep_expand (const gchar *parameters)
+{
+  GPtrArray *parts;
+  GPtrArray *expanded;
+  const gchar *pointer;
+  const gchar *start;
+  const gchar *end;
+  guint *indexes;
+  guint i;
+  
+  parts = g_ptr_array_new_with_free_func ((GDestroyNotify) g_strfreev);
+  
+  pointer = parameters;
+  while ((start = find_placeholder (pointer, &end)) != NULL)
+    {
+      gchar **literal;
+      gchar *alternatives;
+      
+      literal = g_new0 (gchar*, 2);
+      literal[0] = g_strndup (pointer, start - pointer);
+      g_ptr_array_add (parts, literal);
+      
+      alternatives = g_strndup (start + 1, end - start - 2);
+      g_ptr_array_add (parts, g_strsplit (alternatives, ",", -1));
+      g_free (alternatives);
+      
+      pointer = end;
+    }
+  
+  if (*pointer != '\0')
+    {
+      gchar **literal;
+      literal = g_new0 (gchar*, 2);
+      literal[0] = g_strdup (pointer);
+      g_ptr_array_add (parts, literal);
+    }
+  
+  expanded = g_ptr_array_new ();
+  indexes = g_new0 (guint, parts->len + 1);
+
+  for (;;)
+    {
+      GString *string;
+      gint part;
+      
+      string = g_string_new (NULL);
+      for (i = 0; i < parts->len; i++)
+        g_string_append (string, ((gchar **) g_ptr_array_index (parts, i))[indexes[i]]);
+      g_ptr_array_add (expanded, g_string_free (string, FALSE));
+      
+      for (part = parts->len - 1; part >= 0; part--)
+        {
+          gchar **alternatives = g_ptr_array_index (parts, part);
+          if (alternatives[++indexes[part]] != NULL)
+            break;
+          indexes[part] = 0;
+        }
+      
+      if (part < 0)
+        break;
+    }
+  
+  g_free (indexes);
+  g_ptr_array_unref (parts);
+  g_ptr_array_add (expanded, NULL);
+  return (gchar **) g_ptr_array_free (expanded, FALSE);
+}
+
+void
+launcher_sweep_add_run (LauncherSweep  *sweep,
+                        const gchar    *parameters,
+                        gchar         **argv)
+{
+  LauncherSweepPrivate *priv;
+  priv = LAUNCHER_SWEEP_GET_PRIVATE (sweep);
+  g_ptr_array_add (priv->parameters, g_strdup (parameters));
+  g_ptr_array_add (priv->argvs, g_strdupv (argv));
+}
+
+/*
+ * The complete environment of every run, the one of the editor when NULL.
+ */
+void
+launcher_sweep_set_environment (LauncherSweep  *sweep,
+                                gchar         **environment)
+{
+  LauncherSweepPrivate *priv;
+  priv = LAUNCHER_SWEEP_GET_PRIVATE (sweep);
+  g_strfreev (priv->environment);
+  priv->environment = g_strdupv (environment);
+}
+
+/*
+ * The affinity, priorities and limits applied to every run.
+ */
+void
+launcher_sweep_set_resources (LauncherSweep     *sweep,
+                              LauncherResources *resources)
+{
+  LauncherSweepPrivate *priv;
+  priv = LAUNCHER_SWEEP_GET_PRIVATE (sweep);
+  if (priv->resources)
+    g_object_unref (priv->resources);
+  priv->resources = g_object_ref (resources);
+}
+
+void
+launcher_sweep_run_async (LauncherSweep       *sweep,
+                          GCancellable        *cancellable,
+                          GAsyncReadyCallback  callback,
+                          gpointer             user_data)
+{
+  GTask *task;
+  task = g_task_new (sweep, cancellable, callback, user_data);
+  g_task_run_in_thread (task, (GTaskThreadFunc) run_thread);
+  g_object_unref (task);
+}
+
+gboolean
+launcher_sweep_run_finish (LauncherSweep  *sweep,
+                           GAsyncResult   *result,
+                           GError        **error)
+{
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+static void
+run_thread (GTask         *task,
+            LauncherSweep *sweep,
+            gpointer       task_data,
+            GCancellable  *cancellable)
+{
+  LauncherSweepPrivate *priv;
+  cpu_set_t allowed;
+  gint *cpus;
+  gint n_cpus = 0;
+  gint per_slot;
+  Slot *slots;
+  GThread **threads;
+  GError *error = NULL;
+  gulong cancelled_id = 0;
+  guint i;
+  gint j;
+
+  priv = LAUNCHER_SWEEP_GET_PRIVATE (sweep);
+  
+  CPU_ZERO (&allowed);
+  if ((priv->resources == NULL || 
+       !launcher_resources_get_affinity (priv->resources, &allowed)) &&
+      sched_getaffinity (0, sizeof (cpu_set_t), &allowed) != 0)
+    CPU_SET (0, &allowed);
+  
+  cpus = g_new (gint, CPU_SETSIZE);
+  for (j = 0; j < CPU_SETSIZE; j++)
+    {
+      if (CPU_ISSET (j, &allowed))
+        cpus[n_cpus++] = j;
+    }
+  
+  priv->n_slots = MAX (1, MIN ((guint) n_cpus, priv->argvs->len));
+  per_slot = MAX (1, n_cpus / (gint) priv->n_slots);
+  
+  slots = g_new0 (Slot, priv->n_slots);
+  threads = g_new0 (GThread*, priv->n_slots);
+  
+  g_mutex_lock (&priv->mutex);
+  priv->slots = slots;
+  g_mutex_unlock (&priv->mutex);
+  
+  if (cancellable != NULL)
+    cancelled_id = g_cancellable_connect (cancellable, G_CALLBACK (cancelled_action), 
+                                          sweep, NULL);
+  
+  for (i = 0; i < priv->n_slots; i++)
+    {
+      Slot *slot = &slots[i];
+      slot->sweep = sweep;
+      slot->cancellable = cancellable;
+      slot->first_cpu = cpus[(i * per_slot) % MAX (n_cpus, 1)];
+      slot->n_cpus = per_slot;
+      CPU_ZERO (&slot->cpus);
+      for (j = 0; j < per_slot; j++)
+        CPU_SET (cpus[(i * per_slot + j) % MAX (n_cpus, 1)], &slot->cpus);
+      
+      threads[i] = g_thread_new ("launcher-sweep", (GThreadFunc) slot_thread, slot);
+    }
+  
+  for (i = 0; i < priv->n_slots; i++)
+    {
+      g_thread_join (threads[i]);
+      if (slots[i].error != NULL)
+        {
+          if (error == NULL)
+            error = slots[i].error;
+          else
+            g_error_free (slots[i].error);
+        }
+    }
+  
+  if (cancellable != NULL)
+    g_cancellable_disconnect (cancellable, cancelled_id);
+  
+  g_mutex_lock (&priv->mutex);
+  priv->slots = NULL;
+  g_mutex_unlock (&priv->mutex);
+  
+  g_free (threads);
+  g_free (slots);
+  g_free (cpus);
+  
+  if (g_task_return_error_if_cancelled (task))
+    {
+      if (error != NULL)
+        g_error_free (error);
+      return;
+    }
+  
+  if (error != NULL)
+    g_task_return_error (task, error);
+  else
+    g_task_return_boolean (task, TRUE);
+}
+
+static gpointer
+slot_thread (Slot *slot)
+{
+  LauncherSweepPrivate *priv;
+  
+  priv = LAUNCHER_SWEEP_GET_PRIVATE (slot->sweep);
+  
+  for (;;)
+    {
+      LauncherSweepResult *result;
+      guint index;
+      
+      if (g_cancellable_is_cancelled (slot->cancellable))
+        break;
+      
+      g_mutex_lock (&priv->mutex);
+      index = priv->next++;
+      g_mutex_unlock (&priv->mutex);
+      
+      if (index >= priv->argvs->len)
+        break;
+      
+      result = g_new0 (LauncherSweepResult, 1);
+      result->parameters = g_strdup (g_ptr_array_index (priv->parameters, index));
+      result->first_cpu = slot->first_cpu;
+      result->n_cpus = slot->n_cpus;
+      
+      if (!run_once (slot, g_ptr_array_index (priv->argvs, index), result, &slot->error))
+        {
+          result_free (result);
+          break;
+        }
+      
+      g_mutex_lock (&priv->mutex);
+      g_ptr_array_add (priv->results, result);
+      g_mutex_unlock (&priv->mutex);
+      
+      g_main_context_invoke_full (NULL, G_PRIORITY_DEFAULT, 
+                                  (GSourceFunc) progress_action,
+                                  g_object_ref (slot->sweep), g_object_unref);
+    }
+  
+  return NULL;
+}
+
+static gboolean
+run_once (Slot                 *slot,
+          gchar               **argv,
+          LauncherSweepResult  *result,
+          GError              **error)
+{
+  LauncherSweepPrivate *priv;
+  struct rusage usage;
+  siginfo_t info;
+  gint64 start;
+  GPid pid;
+  gint status;
+  
+  priv = LAUNCHER_SWEEP_GET_PRIVATE (slot->sweep);
+  start = g_get_monotonic_time ();
+
+  if (!g_spawn_async (NULL, argv, priv->environment, 
+                      G_SPAWN_DO_NOT_REAP_CHILD | G_SPAWN_SEARCH_PATH | G_SPAWN_SEARCH_PATH_FROM_ENVP | 
+                      G_SPAWN_STDOUT_TO_DEV_NULL | G_SPAWN_STDERR_TO_DEV_NULL,
+                      (GSpawnChildSetupFunc) child_setup, slot, &pid, error))
+    return FALSE;
+  
+  /* a cancel that came before the pid was published still has to kill it */
+  g_mutex_lock (&priv->mutex);
+  slot->pid = pid;
+  if (g_cancellable_is_cancelled (slot->cancellable))
+    kill (pid, SIGKILL);
+  g_mutex_unlock (&priv->mutex);
+  
+  /* left a zombie until the pid is withdrawn, so a cancel never kills a reused pid */
+  while (waitid (P_PID, pid, &info, WEXITED | WNOWAIT) < 0 && errno == EINTR);
+  
+  g_mutex_lock (&priv->mutex);
+  slot->pid = 0;
+  g_mutex_unlock (&priv->mutex);
+  
+  while (wait4 (pid, &status, 0, &usage) < 0)
+    {
+      if (errno != EINTR)
+        {
+          g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                       "Not able to wait for %s: %s", argv[0], g_strerror (errno));
+          g_spawn_close_pid (pid);
+          return FALSE;
+        }
+    }
+  
+  result->wall_time = g_get_monotonic_time () - start;
+  result->user_time = (gint64) usage.ru_utime.tv_sec * G_USEC_PER_SEC + usage.ru_utime.tv_usec;
+  result->system_time = (gint64) usage.ru_stime.tv_sec * G_USEC_PER_SEC + usage.ru_stime.tv_usec;
+  result->max_rss = usage.ru_maxrss;
+  result->status = status;
+
+  g_spawn_close_pid (pid);
+  return TRUE;
+}
+
+/*
+ * Runs in the child after fork. The slot's CPUs are a subset of the 
+ * configured affinity, so they are set last.
+ */
+static void
+child_setup (Slot *slot)
+{
+  LauncherSweepPrivate *priv;
+  priv = LAUNCHER_SWEEP_GET_PRIVATE (slot->sweep);
+  if (priv->resources != NULL)
+    launcher_resources_child_setup (priv->resources);
+  sched_setaffinity (0, sizeof (cpu_set_t), &slot->cpus);
+}
+
+/*
+ * Runs in the thread that cancelled, the runs still going are killed so 
+ * that the sweep does not wait for them to finish.
+ */
+static void
+cancelled_action (GCancellable  *cancellable,
+                  LauncherSweep *sweep)
+{
+  LauncherSweepPrivate *priv;
+  guint i;
+  
+  priv = LAUNCHER_SWEEP_GET_PRIVATE (sweep);
+  
+  g_mutex_lock (&priv->mutex);
+  for (i = 0; priv->slots != NULL && i < priv->n_slots; i++)
+    if (priv->slots[i].pid > 0)
+      kill (priv->slots[i].pid, SIGKILL);
+  g_mutex_unlock (&priv->mutex);
+}
+
+static gboolean
+progress_action (LauncherSweep *sweep)
+{
+  g_signal_emit_by_name ((gpointer) sweep, "progress");
+  return G_SOURCE_REMOVE;
+}
+
+static void
+result_free (LauncherSweepResult *result)
+{
+  g_free (result->parameters);
+  g_free (result);
+}
+
+LauncherConfig*
+launcher_sweep_get_config (LauncherSweep *sweep)
+{
+  return LAUNCHER_SWEEP_GET_PRIVATE (sweep)->config;
+}
+
+guint
+launcher_sweep_get_n_runs (LauncherSweep *sweep)
+{
+  return LAUNCHER_SWEEP_GET_PRIVATE (sweep)->argvs->len;
+}
+
+guint
+launcher_sweep_get_n_slots (LauncherSweep *sweep)
+{
+  return LAUNCHER_SWEEP_GET_PRIVATE (sweep)->n_slots;
+}
+
+guint
+launcher_sweep_get_n_results (LauncherSweep *sweep)
+{
+  LauncherSweepPrivate *priv;
+  guint n_results;
+  
+  priv = LAUNCHER_SWEEP_GET_PRIVATE (sweep);
+  
+  g_mutex_lock (&priv->mutex);
+  n_results = priv->results->len;
+  g_mutex_unlock (&priv->mutex);
+  
+  return n_results;
+}
+
+/*
+ * Results are allocated one by one so the returned pointer stays valid while 
+ * the workers keep adding to the array.
+ */
+const LauncherSweepResult*
+launcher_sweep_get_result (LauncherSweep *sweep,
+                           guint          index)
+{
+  LauncherSweepPrivate *priv;
+  LauncherSweepResult *result;
+  
+  priv = LAUNCHER_SWEEP_GET_PRIVATE (sweep);
+  
+  g_mutex_lock (&priv->mutex);
+  result = g_ptr_array_index (priv->results, index);
+  g_mutex_unlock (&priv->mutex);
+  
+  return result;
+}
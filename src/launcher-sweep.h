@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_SWEEP_H__
+#define	__LAUNCHER_SWEEP_H__
+
+#include <gio/gio.h>
+#include "launcher-config.h"
+#include "launcher-resources.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_SWEEP_TYPE            (launcher_sweep_get_type ())
+#define LAUNCHER_SWEEP(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_SWEEP_TYPE, LauncherSweep))
+#define LAUNCHER_SWEEP_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_SWEEP_TYPE, LauncherSweepClass))
+#define IS_LAUNCHER_SWEEP(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_SWEEP_TYPE))
+#define IS_LAUNCHER_SWEEP_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_SWEEP_TYPE))
+
+typedef struct _LauncherSweep LauncherSweep;
+typedef struct _LauncherSweepClass LauncherSweepClass;
+
+typedef struct
+{
+  gchar  *parameters;
+  gint64  wall_time;
+  gint64  user_time;
+  gint64  system_time;
+  glong   max_rss;
+  gint    status;
+  gint    first_cpu;
+  gint    n_cpus;
+} LauncherSweepResult;
+
+struct _LauncherSweep
+{
+  GObject parent_instance;
+};
+
+struct _LauncherSweepClass
+{
+  GObjectClass parent_class;
+
+  void (*progress) (LauncherSweep *sweep);
+};
+
+GType launcher_sweep_get_type (void) G_GNUC_CONST;
+
+gboolean                   launcher_sweep_has_placeholders  (const gchar          *parameters);
+gchar**                    launcher_sweep_expand            (const gchar          *parameters);
+
+LauncherSweep*             launcher_sweep_new               (LauncherConfig       *config);
+
+void                       launcher_sweep_add_run           (LauncherSweep        *sweep,
+                                                             const gchar          *parameters,
+                                                             gchar               **argv);
+void                       launcher_sweep_set_environment   (LauncherSweep        *sweep,
+                                                             gchar               **environment);
+void                       launcher_sweep_set_resources     (LauncherSweep        *sweep,
+                                                             LauncherResources    *resources);
+
+void                       launcher_sweep_run_async         (LauncherSweep        *sweep,
+                                                             GCancellable         *cancellable,
+                                                             GAsyncReadyCallback   callback,
+                                                             gpointer              user_data);
+gboolean                   launcher_sweep_run_finish        (LauncherSweep        *sweep,
+                                                             GAsyncResult         *result,
+                                                             GError              **error);
+
+LauncherConfig*            launcher_sweep_get_config        (LauncherSweep        *sweep);
+guint                      launcher_sweep_get_n_runs        (LauncherSweep        *sweep);
+guint                      launcher_sweep_get_n_slots       (LauncherSweep        *sweep);
+guint                      launcher_sweep_get_n_results     (LauncherSweep        *sweep);
+const LauncherSweepResult* launcher_sweep_get_result        (LauncherSweep        *sweep,
+                                                             guint                 index);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_SWEEP_H__ */
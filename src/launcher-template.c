@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include "launcher-template.h"
+
+/*
+ * A template is text with ${name} references in it. It is split once into 
+ * literal and variable tokens so that expanding it for a launch is only a 
+ * walk over the tokens. The names below come from the editor, any other 
+ * name is looked up in the environment of the program, and "$${" stands 
+ * for a literal "${".
+ */
+
+typedef enum
+{
+  TOKEN_LITERAL,
+  TOKEN_VARIABLE,
+  TOKEN_ENVIRONMENT
+} TokenType;
+
+typedef struct
+{
+  TokenType         type;
+  LauncherVariable  variable;
+  gchar            *text;
+} Token;
+
+struct _LauncherTemplate
+{
+  GArray *tokens;
+};
+
+static void add_literal   (LauncherTemplate *template,
+                           const gchar      *text,
+                           gsize             length);
+static void add_reference (LauncherTemplate *template,
+                           const gchar      *name,
+                           gsize             length);
+static void token_clear   (Token            *token);
+
+static const gchar *variable_names[LAUNCHER_VARIABLE_COUNT] = 
+{
+  "project_folder",
+  "project_name",
+  "active_file",
+  "build_folder"
+};
+
+LauncherTemplate*
+launcher_template_compile (const gchar *text)
+{
+  LauncherTemplate *template;
+  const gchar *start;
+  const gchar *reference;
+  
+  template = g_slice_new (LauncherTemplate);
+  template->tokens = g_array_new (FALSE, FALSE, sizeof (Token));
+  g_array_set_clear_func (template->tokens, (GDestroyNotify) token_clear);
+  
+  if (text == NULL)
+    return template;
+  
+  start = text;
+  reference = strstr (start, "${");
+  while (reference != NULL)
+    {
+      const gchar *close;
+      
+      if (reference > start && reference[-1] == '$')
+        {
+          add_literal (template, start, reference - start);
+          start = reference + 1;
+          reference = strstr (reference + 2, "${");
+          continue;
+        }
+      
+      close = strchr (reference + 2, '}');
+      if (close == NULL)
+        break;
+      
+      add_literal (template, start, reference - start);
+      add_reference (template, reference + 2, close - reference - 2);
+      start = close + 1;
+      reference = strstr (start, "${");
+    }
+  
+  add_literal (template, start, strlen (start));
+  
+  return template;
+}
+
+void
+launcher_template_free (LauncherTemplate *template)
+{
+  if (template == NULL)
+    return;
+  g_array_free (template->tokens, TRUE);
+  g_slice_free (LauncherTemplate, template);
+}
+
+gboolean
+launcher_template_uses_variable (LauncherTemplate *template,
+                                 LauncherVariable  variable)
+{
+  guint i;
+  
+  for (i = 0; i < template->tokens->len; i++)
+    {
+      Token *token = &g_array_index (template->tokens, Token, i);
+      if (token->type == TOKEN_VARIABLE && token->variable == variable)
+        return TRUE;
+    }
+  
+  return FALSE;
+}
+
+/*
+ * The variables are indexed by LauncherVariable, a reference to one that 
+ * is NULL or to a name missing from the envp expands to nothing.
+ */
+gchar*
+launcher_template_expand (LauncherTemplate  *template,
+                          gchar            **variables,
+                          gchar            **envp)
+{
+  GString *string;
+  guint i;
+  
+  string = g_string_new ("");
+  
+  for (i = 0; i < template->tokens->len; i++)
+    {
+      Token *token = &g_array_index (template->tokens, Token, i);
+      const gchar *value = NULL;
+      
+      switch (token->type)
+        {
+        case TOKEN_LITERAL:
+          value = token->text;
+          break;
+        case TOKEN_VARIABLE:
+          value = variables[token->variable];
+          break;
+        case TOKEN_ENVIRONMENT:
+          value = g_environ_getenv (envp, token->text);
+          break;
+        }
+      
+      if (value != NULL)
+        g_string_append (string, value);
+    }
+  
+  return g_string_free (string, FALSE);
+}
+
+gchar*
+launcher_template_expand_text (const gchar  *text,
+                               gchar       **variables,
+                               gchar       **envp)
+{
+  LauncherTemplate *template;
+  gchar *result;
+  
+  template = launcher_template_compile (text);
+  result = launcher_template_expand (template, variables, envp);
+  launcher_template_free (template);
+  
+  return result;
+}
+
+static void
+add_literal (LauncherTemplate *template,
+             const gchar      *text,
+             gsize             length)
+{
+  Token token;
+  
+  if (length == 0)
+    return;
+  
+  if (template->tokens->len > 0)
+    {
+      Token *last = &g_array_index (template->tokens, Token, template->tokens->len - 1);
+      if (last->type == TOKEN_LITERAL)
+        {
+          gchar *joined = g_strdup_printf ("%s%.*s", last->text, (gint) length, text);
+          g_free (last->text);
+          last->text = joined;
+          return;
+        }
+    }
+  
+  token.type = TOKEN_LITERAL;
+  token.variable = LAUNCHER_VARIABLE_COUNT;
+  token.text = g_strndup (text, length);
+  g_array_append_val (template->tokens, token);
+}
+
+static void
+add_reference (LauncherTemplate *template,
+               const gchar      *name,
+               gsize             length)
+{
+  Token token;
+  gint i;
+  
+  token.type = TOKEN_ENVIRONMENT;
+  token.variable = LAUNCHER_VARIABLE_COUNT;
+  token.text = g_strndup (name, length);
+  g_strstrip (token.text);
+  
+  for (i = 0; i < LAUNCHER_VARIABLE_COUNT; i++)
+    {
+      if (g_strcmp0 (token.text, variable_names[i]) == 0)
+        {
+          token.type = TOKEN_VARIABLE;
+          token.variable = i;
+          break;
+        }
+    }
+  
+  g_array_append_val (template->tokens, token);
+}
+
+static void
+token_clear (Token *token)
+{
+  g_free (token->text);
+}
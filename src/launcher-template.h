@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_TEMPLATE_H__
+#define	__LAUNCHER_TEMPLATE_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef enum
+{
+  LAUNCHER_VARIABLE_PROJECT_FOLDER,
+  LAUNCHER_VARIABLE_PROJECT_NAME,
+  LAUNCHER_VARIABLE_ACTIVE_FILE,
+  LAUNCHER_VARIABLE_BUILD_FOLDER,
+  LAUNCHER_VARIABLE_COUNT
+} LauncherVariable;
+
+typedef struct _LauncherTemplate LauncherTemplate;
+
+LauncherTemplate*  launcher_template_compile       (const gchar       *text);
+void               launcher_template_free          (LauncherTemplate  *template);
+
+gboolean           launcher_template_uses_variable (LauncherTemplate  *template,
+                                                    LauncherVariable   variable);
+gchar*             launcher_template_expand        (LauncherTemplate  *template,
+                                                    gchar            **variables,
+                                                    gchar            **envp);
+gchar*             launcher_template_expand_text   (const gchar       *text,
+                                                    gchar            **variables,
+                                                    gchar            **envp);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_TEMPLATE_H__ */
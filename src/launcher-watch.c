@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "launcher-watch.h"
+
+/*
+ * Turns the source changes of a build into restarts. A burst of changes 
+ * only restarts once, after nothing changed for the debounce window, and 
+ * a previous instance that is still running is terminated before the 
+ * "restart" signal is emitted so the two never overlap.
+ */
+
+#define TERMINATE_TIMEOUT 3000
+
+static void launcher_watch_class_init  (LauncherWatchClass *klass);
+static void launcher_watch_init        (LauncherWatch      *watch);
+static void launcher_watch_finalize    (LauncherWatch      *watch);
+
+static void changed_action             (LauncherWatch      *watch);
+static gboolean debounce_action        (LauncherWatch      *watch);
+static void finished_action            (LauncherWatch      *watch);
+static void clear_process              (LauncherWatch      *watch);
+
+#define LAUNCHER_WATCH_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), LAUNCHER_WATCH_TYPE, LauncherWatchPrivate))
+
+typedef struct _LauncherWatchPrivate LauncherWatchPrivate;
+
+struct _LauncherWatchPrivate
+{
+  LauncherBuild   *build;
+  LauncherProcess *process;
+  guint            debounce;
+  guint            debounce_id;
+  gulong           changed_id;
+  gulong           finished_id;
+  gint64           change_time;
+};
+
+enum
+{
+  RESTART,
+  LAST_SIGNAL
+};
+
+static guint launcher_watch_signals[LAST_SIGNAL] = { 0 };
+
+G_DEFINE_TYPE (LauncherWatch, launcher_watch, G_TYPE_OBJECT)
+
+static void
+launcher_watch_class_init (LauncherWatchClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  launcher_watch_signals[RESTART] =
+    g_signal_new ("restart", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (LauncherWatchClass, restart),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  gobject_class->finalize = (GObjectFinalizeFunc) launcher_watch_finalize;
+  g_type_class_add_private (klass, sizeof (LauncherWatchPrivate));
+}
+
+static void
+launcher_watch_init (LauncherWatch *watch)
+{
+  LauncherWatchPrivate *priv;
+  priv = LAUNCHER_WATCH_GET_PRIVATE (watch);
+  priv->build = NULL;
+  priv->process = NULL;
+  priv->debounce_id = 0;
+  priv->changed_id = 0;
+  priv->finished_id = 0;
+  priv->change_time = 0;
+}
+
+static void
+launcher_watch_finalize (LauncherWatch *watch)
+{
+  LauncherWatchPrivate *priv;
+  priv = LAUNCHER_WATCH_GET_PRIVATE (watch);
+  
+  if (priv->debounce_id != 0)
+    g_source_remove (priv->debounce_id);
+  
+  clear_process (watch);
+  g_signal_handler_disconnect (priv->build, priv->changed_id);
+  g_object_unref (priv->build);
+  
+  G_OBJECT_CLASS (launcher_watch_parent_class)->finalize (G_OBJECT (watch));
+}
+
+/*
+ * The debounce is in milliseconds.
+ */
+LauncherWatch*
+launcher_watch_new (LauncherBuild *build,
+                    guint          debounce)
+{
+  LauncherWatchPrivate *priv;
+  LauncherWatch *watch;
+
+  watch = LAUNCHER_WATCH (g_object_new (launcher_watch_get_type (), NULL));
+  priv = LAUNCHER_WATCH_GET_PRIVATE (watch);
+
+  priv->build = g_object_ref (build);
+  priv->debounce = debounce;
+  priv->changed_id = g_signal_connect_swapped (G_OBJECT (build), "changed",
+                                               G_CALLBACK (changed_action), watch);
+
+  return watch;
+}
+
+/*
+ * The process that has to be terminated before the next restart.
+ */
+void
+launcher_watch_set_process (LauncherWatch   *watch,
+                            LauncherProcess *process)
+{
+  LauncherWatchPrivate *priv;
+  priv = LAUNCHER_WATCH_GET_PRIVATE (watch);
+  clear_process (watch);
+  priv->process = g_object_ref (process);
+}
+
+/*
+ * Returns the time of the change that caused the last restart, once, so 
+ * that a later run by hand is not mistaken for a restart.
+ */
+gint64
+launcher_watch_take_change_time (LauncherWatch *watch)
+{
+  LauncherWatchPrivate *priv;
+  gint64 change_time;
+  
+  priv = LAUNCHER_WATCH_GET_PRIVATE (watch);
+  change_time = priv->change_time;
+  priv->change_time = 0;
+  return change_time;
+}
+
+static void
+changed_action (LauncherWatch *watch)
+{
+  LauncherWatchPrivate *priv;
+  priv = LAUNCHER_WATCH_GET_PRIVATE (watch);
+  
+  if (priv->debounce_id != 0)
+    g_source_remove (priv->debounce_id);
+  
+  priv->debounce_id = g_timeout_add (priv->debounce, (GSourceFunc) debounce_action, watch);
+}
+
+static gboolean
+debounce_action (LauncherWatch *watch)
+{
+  LauncherWatchPrivate *priv;
+  priv = LAUNCHER_WATCH_GET_PRIVATE (watch);
+  
+  priv->debounce_id = 0;
+  priv->change_time = launcher_build_get_change_time (priv->build);
+  
+  /* already waiting for the previous instance to go away */
+  if (priv->finished_id != 0)
+    return G_SOURCE_REMOVE;
+  
+  if (priv->process != NULL && 
+      launcher_process_get_state (priv->process) == LAUNCHER_PROCESS_RUNNING)
+    {
+      priv->finished_id = g_signal_connect_swapped (G_OBJECT (priv->process), "finished",
+                                                    G_CALLBACK (finished_action), watch);
+      launcher_process_terminate (priv->process, TERMINATE_TIMEOUT);
+      return G_SOURCE_REMOVE;
+    }
+  
+  g_signal_emit_by_name ((gpointer) watch, "restart");
+  return G_SOURCE_REMOVE;
+}
+
+static void
+finished_action (LauncherWatch *watch)
+{
+  clear_process (watch);
+  g_signal_emit_by_name ((gpointer) watch, "restart");
+}
+
+static void
+clear_process (LauncherWatch *watch)
+{
+  LauncherWatchPrivate *priv;
+  priv = LAUNCHER_WATCH_GET_PRIVATE (watch);
+  
+  if (priv->process == NULL)
+    return;
+  
+  if (priv->finished_id != 0)
+    g_signal_handler_disconnect (priv->process, priv->finished_id);
+  priv->finished_id = 0;
+  
+  g_object_unref (priv->process);
+  priv->process = NULL;
+}
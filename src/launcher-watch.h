@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __LAUNCHER_WATCH_H__
+#define	__LAUNCHER_WATCH_H__
+
+#include <gio/gio.h>
+#include "launcher-build.h"
+#include "launcher-process.h"
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_WATCH_TYPE            (launcher_watch_get_type ())
+#define LAUNCHER_WATCH(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), LAUNCHER_WATCH_TYPE, LauncherWatch))
+#define LAUNCHER_WATCH_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), LAUNCHER_WATCH_TYPE, LauncherWatchClass))
+#define IS_LAUNCHER_WATCH(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), LAUNCHER_WATCH_TYPE))
+#define IS_LAUNCHER_WATCH_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), LAUNCHER_WATCH_TYPE))
+
+typedef struct _LauncherWatch LauncherWatch;
+typedef struct _LauncherWatchClass LauncherWatchClass;
+
+struct _LauncherWatch
+{
+  GObject parent_instance;
+};
+
+struct _LauncherWatchClass
+{
+  GObjectClass parent_class;
+
+  void (*restart) (LauncherWatch *watch);
+};
+
+GType launcher_watch_get_type (void) G_GNUC_CONST;
+
+LauncherWatch*  launcher_watch_new               (LauncherBuild   *build,
+                                                  guint            debounce);
+
+void            launcher_watch_set_process       (LauncherWatch   *watch,
+                                                  LauncherProcess *process);
+gint64          launcher_watch_take_change_time  (LauncherWatch   *watch);
+
+G_END_DECLS
+
+#endif /* __LAUNCHER_WATCH_H__ */